@@ -1,18 +1,48 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sun Mar  4 21:17:35 PST 2018
-// Last Modified: Sun Mar  4 21:17:38 PST 2018
+// Last Modified: Mon Oct 19 19:58:31 PDT 2026
 // Filename:      cli/binroll.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/cli/binroll.cpp
 // Syntax:        C++11
 // vim:           ts=3 noexpandtab nowrap
 //
 // Description:   Extract a binary pinao roll of note in a score.
+//                The roll of each input file is written to standard
+//                output as soon as the file is read (rather than using
+//                STREAM_INTERFACE, which stores the output of all files
+//                until the end of the input).
 //
 
 #include "humlib.h"
 
-STREAM_INTERFACE(Tool_binroll)
+using namespace hum;
+using namespace std;
+
+int main(int argc, char** argv) {
+	Tool_binroll interface;
+	if (!interface.process(argc, argv)) {
+		interface.getError(cerr);
+		return -1;
+	}
+	HumdrumFileStream instream(static_cast<Options&>(interface));
+	HumdrumFileSet infiles;
+	bool status = true;
+	while (!interface.hasError() && instream.readSingleSegment(infiles)) {
+		for (int i=0; i<infiles.getCount(); i++) {
+			status &= interface.run(infiles[i], cout);
+		}
+	}
+	interface.finally();
+	if (interface.hasWarning()) {
+		interface.getWarning(cerr);
+	}
+	if (interface.hasError()) {
+		interface.getError(cerr);
+		return -1;
+	}
+	return !status;
+}
 
 
 
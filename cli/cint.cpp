@@ -13,7 +13,7 @@
 
 #include "humlib.h"
 
-STREAM_INTERFACE(Tool_cint)
+RAW_STREAM_INTERFACE(Tool_cint)
 
 
 
@@ -0,0 +1,96 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 05:31:08 PDT 2026
+// Last Modified: Mon Oct 19 05:31:12 PDT 2026
+// Filename:      cli/hum2mid.cpp
+// URL:           https://github.com/craigsapp/humlib/blob/master/cli/hum2mid.cpp
+// Syntax:        C++11
+// vim:           ts=3 noexpandtab
+//
+// Description:   Converter from Humdrum **kern data to MIDI files.
+//
+
+#include "HumMidiExport.h"
+#include "HumdrumFile.h"
+#include "MidiFile.h"
+#include "Options.h"
+
+#include <iostream>
+
+using namespace std;
+using namespace hum;
+using namespace smf;
+
+string getOutputName (const string& filename);
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+	Options options;
+	options.define("t|tempo=d:120",  "Tempo if there is no *MM in the data");
+	options.define("q|tpq=i:0",      "Ticks per quarter note (0 = minimum needed)");
+	options.define("v|velocity=i:64","Attack velocity of notes");
+	options.define("o|output=s",     "Save MIDI file to given filename");
+	options.process(argc, argv);
+
+	HumMidiExport exporter;
+	exporter.setDefaultTempo(options.getDouble("tempo"));
+	exporter.setTicksPerQuarterNote(options.getInteger("tpq"));
+	exporter.setVelocity(options.getInteger("velocity"));
+
+	int status = 1;
+	HumdrumFile infile;
+	MidiFile midiout;
+	if (options.getArgCount() == 0) {
+		status &= infile.read(cin);
+		status &= exporter.convert(infile, midiout);
+		midiout.deltaTicks();
+		if (options.getBoolean("output")) {
+			midiout.write(options.getString("output"));
+		} else {
+			cout << midiout;
+		}
+		return !status;
+	}
+
+	for (int i=0; i<options.getArgCount(); i++) {
+		string filename = options.getArg(i+1);
+		if (!infile.read(filename) || !exporter.convert(infile, midiout)) {
+			cerr << "Problem converting " << filename << endl;
+			status = 0;
+			continue;
+		}
+		midiout.deltaTicks();
+		if (options.getArgCount() > 1) {
+			midiout.write(getOutputName(filename));
+		} else if (options.getBoolean("output")) {
+			midiout.write(options.getString("output"));
+		} else {
+			cout << midiout;
+		}
+	}
+
+	return !status;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// getOutputName -- Replace the extension of the input filename with ".mid".
+//
+
+string getOutputName(const string& filename) {
+	size_t slash = filename.rfind('/');
+	size_t dot = filename.rfind('.');
+	if ((dot == string::npos) || ((slash != string::npos) && (dot < slash))) {
+		return filename + ".mid";
+	}
+	return filename.substr(0, dot) + ".mid";
+}
+
+
+
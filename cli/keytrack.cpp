@@ -0,0 +1,18 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 14:07:31 PDT 2026
+// Last Modified: Mon Oct 19 14:07:35 PDT 2026
+// Filename:      cli/keytrack.cpp
+// URL:           https://github.com/craigsapp/humlib/blob/master/cli/keytrack.cpp
+// Syntax:        C++11
+// vim:           ts=3 noexpandtab nowrap
+//
+// Description:   Track the key through a score with a sliding window.
+//
+
+#include "humlib.h"
+
+STREAM_INTERFACE(Tool_keytrack)
+
+
+
@@ -26,13 +26,22 @@ int main(int argc, char** argv) {
 	}
 
 	MuseDataSet infile;
+	infile.setThreadCount(converter.getInteger("threads"));
 	string filename;
 	if (converter.getArgCount() == 0) {
 		filename = "<STDIN>";
 		infile.read(cin);
-	} else {
+	} else if (converter.getArgCount() == 1) {
 		filename = converter.getArg(1);
 		infile.readFile(filename);
+	} else {
+		// each argument is a separate part file of the same score:
+		vector<string> filenames;
+		for (int i=1; i<=converter.getArgCount(); i++) {
+			filenames.push_back(converter.getArg(i));
+		}
+		filename = filenames[0];
+		infile.readPartFiles(filenames);
 	}
 	int partcount = infile.getFileCount();
 	if (partcount == 0) {
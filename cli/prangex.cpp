@@ -12,7 +12,7 @@
 
 #include "humlib.h"
 
-STREAM_INTERFACE(Tool_prange)
+RAW_STREAM_INTERFACE(Tool_prange)
 
 
 
@@ -0,0 +1,110 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 09:12:41 PDT 2026
+// Last Modified: Mon Oct 19 09:12:44 PDT 2026
+// Filename:      HumBinaryIo.h
+// URL:           https://github.com/craigsapp/humlib/blob/master/include/HumBinaryIo.h
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Helper classes for reading and writing the binary
+//                (.humbin) representation of analyzed Humdrum files.
+//                Fixed-size integers are stored in little-endian byte
+//                order regardless of the host architecture, and
+//                variable-length integers are stored in LEB128 format
+//                (with zigzag encoding for signed values).
+//
+
+#ifndef _HUMBINARYIO_H_INCLUDED
+#define _HUMBINARYIO_H_INCLUDED
+
+#include "HumNum.h"
+
+#include <ostream>
+#include <string>
+
+#ifndef _WIN32
+	#include <fcntl.h>       /* open             */
+	#include <sys/mman.h>    /* mmap, munmap     */
+	#include <sys/stat.h>    /* fstat            */
+	#include <unistd.h>      /* close            */
+#endif
+
+namespace hum {
+
+// START_MERGE
+
+class HumBinaryWriter {
+	public:
+		               HumBinaryWriter  (std::ostream& out);
+		              ~HumBinaryWriter  ();
+
+		void           writeUInt8       (int value);
+		void           writeInt32       (int value);
+		void           writeUInt32      (unsigned int value);
+		void           writeUInt64      (unsigned long long value);
+		void           writeVarUInt     (unsigned int value);
+		void           writeVarInt      (int value);
+		void           writeString      (const std::string& value);
+		void           writeHumNum      (const HumNum& value);
+		void           writeBytes       (const char* data, size_t size);
+		bool           isValid          (void);
+
+	private:
+		std::ostream*  m_out;
+};
+
+
+
+class HumBinaryReader {
+	public:
+		               HumBinaryReader  (void);
+		               HumBinaryReader  (const char* data, size_t size);
+		              ~HumBinaryReader  ();
+
+		bool           open             (const std::string& filename);
+		void           close            (void);
+		void           setBuffer        (const char* data, size_t size);
+
+		int            readUInt8        (void);
+		int            readInt32        (void);
+		unsigned int   readUInt32       (void);
+		unsigned long long readUInt64   (void);
+		unsigned int   readVarUInt      (void);
+		int            readVarInt       (void);
+		std::string    readString       (void);
+		void           readString       (std::string& value);
+		HumNum         readHumNum       (void);
+		bool           readBytes        (char* data, size_t size);
+
+		bool           isValid          (void) const { return !m_error; }
+		bool           atEnd            (void) const { return m_pos >= m_size; }
+		size_t         getPosition      (void) const { return m_pos; }
+		size_t         getSize          (void) const { return m_size; }
+
+	protected:
+		bool           require          (size_t count);
+
+	private:
+		const char*    m_data = NULL;
+		size_t         m_size = 0;
+		size_t         m_pos  = 0;
+		bool           m_error = false;
+
+		// m_mapped: true if m_data points to a memory-mapped file that
+		// must be unmapped when closing.
+		bool           m_mapped = false;
+
+		// m_buffer: storage for file contents on systems without mmap().
+		std::string    m_buffer;
+};
+
+
+// END_MERGE
+
+} // end namespace hum
+
+#endif /* _HUMBINARYIO_H_INCLUDED */
+
+
+
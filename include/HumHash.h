@@ -264,6 +264,7 @@ class HumHash {
 		MapNNKV*    parameters;
 		std::string prefix;
 
+	friend class HumdrumFileStructure;
 	friend std::ostream& operator<<(std::ostream& out, const HumHash& hash);
 	friend std::ostream& operator<<(std::ostream& out, HumHash* hash);
 };
@@ -0,0 +1,79 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 05:02:44 PDT 2026
+// Last Modified: Mon Oct 19 21:10:12 PDT 2026
+// Filename:      HumMidiExport.h
+// URL:           https://github.com/craigsapp/humlib/blob/master/include/HumMidiExport.h
+// Syntax:        C++11; humlib
+// vim:           ts=3 noexpandtab
+//
+// Description:   Convert the **kern spines of a Humdrum file into a
+//                MidiFile (from the bundled midifile library).  This class
+//                is not part of the min distribution since it depends on
+//                the midifile library.  Programs which use the min
+//                distribution should include humlib.h before this file.
+//
+
+#ifndef _HUMMIDIEXPORT_H_INCLUDED
+#define _HUMMIDIEXPORT_H_INCLUDED
+
+#ifndef _HUMLIB_H_INCLUDED
+// The min distribution (humlib.h) already defines the Humdrum classes.
+#include "HumdrumFile.h"
+#endif
+#include "MidiFile.h"
+
+#include <string>
+#include <vector>
+
+namespace hum {
+
+class HumMidiExport {
+	public:
+		             HumMidiExport         (void);
+		            ~HumMidiExport         ();
+
+		bool         convert               (HumdrumFile& infile, smf::MidiFile& outfile);
+
+		void         setTicksPerQuarterNote(int tpq) { m_tpq = tpq; }
+		void         setVelocity           (int velocity) { m_velocity = velocity; }
+		void         setDefaultTempo       (double tempo) { m_tempo = tempo; }
+
+	protected:
+		int          getTick               (HumNum timestamp);
+		int          getChannel            (int kernindex);
+		void         addTempos             (HumdrumLine& line, int tick);
+		void         addTrackNames         (HumdrumLine& line, int tick);
+		void         addNotes              (HTp token, int tick);
+		void         addNote               (const std::string& subtoken,
+		                                    int kernindex, int tick, int endtick);
+		void         flushTies             (void);
+
+	private:
+		// m_tpq: ticks per quarter note in the output (0 = use tpq of input).
+		int m_tpq = 0;
+
+		// m_velocity: attack velocity of all notes.
+		int m_velocity = 64;
+
+		// m_tempo: tempo at the start of the file if there is no *MM.
+		double m_tempo = 120.0;
+
+		// Conversion state:
+		smf::MidiFile*    m_midifile = NULL;
+		HumNum            m_scale;           // output ticks per quarter note
+		std::vector<int>  m_trackToKern;     // Humdrum track to **kern index
+		std::vector<bool> m_named;           // true if MIDI track has a name
+		int               m_lastTempoTick = -1; // tick of last tempo change
+
+		// m_tieEnd: the end tick of tied notes which are still sounding,
+		// indexed by **kern index * 128 + MIDI key (-1 if no tie).
+		std::vector<int> m_tieEnd;
+};
+
+} // end namespace hum
+
+#endif /* _HUMMIDIEXPORT_H_INCLUDED */
+
+
+
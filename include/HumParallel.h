@@ -0,0 +1,40 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 22:31:08 PDT 2026
+// Last Modified: Mon Oct 19 22:31:08 PDT 2026
+// Filename:      HumParallel.h
+// URL:           https://github.com/craigsapp/humlib/blob/master/include/HumParallel.h
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Process a list of independent work items (such as files,
+//                parts or blocks of rows) in several threads.
+//
+
+#ifndef _HUMPARALLEL_H_INCLUDED
+#define _HUMPARALLEL_H_INCLUDED
+
+#include <functional>
+
+namespace hum {
+
+// START_MERGE
+
+class HumParallel {
+	public:
+		static int  getThreadCount (int threads, int count);
+		static void run            (int count, int threads,
+		                            const std::function<void(int)>& function);
+		static void runWorkers     (int count, int threads,
+		                            const std::function<void(int, int)>& function);
+};
+
+
+// END_MERGE
+
+} // end namespace hum
+
+#endif /* _HUMPARALLEL_H_INCLUDED */
+
+
+
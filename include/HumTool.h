@@ -15,6 +15,7 @@
 
 #include "Options.h"
 #include "HumdrumFileSet.h"
+#include "HumdrumLineStream.h"
 
 #include <sstream>
 #include <string>
@@ -235,6 +236,46 @@ int main(int argc, char** argv) {                                          \
 
 
 
+//////////////////////////////
+//
+// LINE_INTERFACE -- Use HumdrumLineStream to process one line at a
+//    time, with output sent directly to standard output.  Only tools
+//    which do not need rhythmic or content analysis can use this
+//    interface.
+//
+// function call that the interface must implement:
+//  .run(HumdrumLineStream& instream, ostream& out)
+//
+
+#define LINE_INTERFACE(CLASS)                                              \
+int main(int argc, char** argv) {                                          \
+	hum::CLASS interface;                                                   \
+	if (!interface.process(argc, argv)) {                                   \
+		interface.getError(std::cerr);                                       \
+		return -1;                                                           \
+	}                                                                       \
+	bool status = true;                                                     \
+	if (interface.getArgCount() == 0) {                                     \
+		hum::HumdrumLineStream instream(std::cin);                           \
+		status &= interface.run(instream, std::cout);                        \
+	}                                                                       \
+	for (int i=1; i<=interface.getArgCount(); i++) {                        \
+		hum::HumdrumLineStream instream(interface.getArgument(i));           \
+		status &= interface.run(instream, std::cout);                        \
+	}                                                                       \
+	interface.finally();                                                    \
+	if (interface.hasWarning()) {                                           \
+		interface.getWarning(std::cerr);                                     \
+	}                                                                       \
+	if (interface.hasError()) {                                             \
+		interface.getError(std::cerr);                                       \
+		return -1;                                                           \
+	}                                                                       \
+	return !status;                                                         \
+}
+
+
+
 //////////////////////////////
 //
 // SET_INTERFACE -- Use HumdrumFileSet (multiple file high-memory
@@ -17,6 +17,7 @@
 #include "HumdrumFileContent.h"
 
 #include <iostream>
+#include <memory>
 #include <string>
 
 namespace hum {
@@ -38,9 +39,37 @@ class HumdrumFile : public HUMDRUMFILE_PARENT {
 		                                    const std::string& indent = "\t");
 		std::ostream& printXmlParameterInfo(std::ostream& out, int level,
 		                                    const std::string& indent);
+
+		template <class TYPE>
+		   std::shared_ptr<TYPE> getAnalysis(void);
 };
 
 
+
+//////////////////////////////
+//
+// HumdrumFile::getAnalysis -- Return a derived analysis of the file, such
+//     as a NoteGrid, which is created from the file with the TYPE(HumdrumFile&)
+//     constructor the first time that it is requested.  Later requests
+//     return the same analysis until the file is modified, so that several
+//     tools processing the same file only need to create it once.  Keep
+//     the returned pointer while using the analysis, since the cached copy
+//     is removed when the file changes (including by HumdrumToken::setText).
+//     The analysis is shared with other tools, so do not modify it: create
+//     a separate TYPE(HumdrumFile&) object for that instead.
+//
+
+template <class TYPE>
+std::shared_ptr<TYPE> HumdrumFile::getAnalysis(void) {
+	std::shared_ptr<TYPE> analysis = getCachedAnalysis<TYPE>();
+	if (!analysis) {
+		analysis = std::make_shared<TYPE>(*this);
+		setCachedAnalysis(analysis);
+	}
+	return analysis;
+}
+
+
 // END_MERGE
 
 } // end namespace hum
@@ -22,8 +22,13 @@
 #include "HumdrumLine.h"
 
 #include <iostream>
+#include <map>
+#include <memory>
 #include <string>
 #include <sstream>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 // USING_URI is defined if you want to be able to download Humdrum data
@@ -111,6 +116,9 @@ class HumFileAnalysis {
 
 			m_barlines_analyzed  = false;
 			m_barlines_different = false;
+			m_measures_analyzed  = false;
+
+			m_cache.clear();
 		}
 
 		// m_structure_analyzed: Used to keep track of whether or not
@@ -152,6 +160,17 @@ class HumFileAnalysis {
 		// any barlines that are not all of the same at the same
 		// times.
 		bool m_barlines_different = false;
+
+		// m_measures_analyzed: Used to keep track of whether or not
+		// the measure index has been built.
+		bool m_measures_analyzed = false;
+
+		// m_cache: Derived analyses of the file (such as NoteGrid or
+		// metric levels), indexed by the type of the analysis and an
+		// integer parameter for the analysis (such as a track number).
+		// The analyses are created when first requested and are removed
+		// when the contents of the file change.
+		std::map<std::pair<std::type_index, int>, std::shared_ptr<void>> m_cache;
 };
 
 bool sortTokenPairsByLineIndex(const TokenPair& a, const TokenPair& b);
@@ -192,6 +211,13 @@ class HumdrumFileBase : public HumHash {
 		bool          isRhythmAnalyzed         (void);
 		bool          areStrandsAnalyzed       (void);
 		bool          areStrophesAnalyzed      (void);
+
+		template <class TYPE>
+		   std::shared_ptr<TYPE> getCachedAnalysis (int parameter = 0);
+		template <class TYPE>
+		   void       setCachedAnalysis        (std::shared_ptr<TYPE> analysis,
+		                                        int parameter = 0);
+		void          clearAnalysisCache       (void);
 		void          setFilenameFromSegment   (void);
 
     	template <class TYPE>
@@ -291,6 +317,8 @@ class HumdrumFileBase : public HumHash {
 
 		void          insertLine               (int index, const std::string& line);
 		void          insertLine               (int index, HLp line);
+		void          insertLines              (int index,
+		                                        const std::vector<std::string>& lines);
 
 		HLp           insertNullDataLine                    (HumNum timestamp);
 		HLp           insertNullInterpretationLine          (HumNum timestamp);
@@ -307,6 +335,8 @@ class HumdrumFileBase : public HumHash {
 		HLp           back                     (void);
 		void          makeBooleanTrackList     (std::vector<bool>& spinelist,
 		                                        const std::string& spinestring);
+		static std::string getMergedSpineInfo  (std::vector<std::string>& info,
+		                                        int starti, int extra);
 
 
 		std::vector<HLp> getReferenceRecords(void);
@@ -374,10 +404,9 @@ class HumdrumFileBase : public HumHash {
 		bool          adjustSpines              (HumdrumLine& line,
 		                                         std::vector<std::string>& datatype,
 		                                         std::vector<std::string>& sinfo);
-		std::string   getMergedSpineInfo        (std::vector<std::string>& info,
-		                                         int starti, int extra);
 		bool          stitchLinesTogether       (HumdrumLine& previous,
 		                                         HumdrumLine& next);
+		bool          analyzeGridSpines         (void);
 		void          addToTrackStarts          (HTp token);
 		void          addUniqueTokens           (std::vector<HTp>& target,
 		                                         std::vector<HTp>& source);
@@ -507,6 +536,40 @@ void HumdrumFileBase::initializeArray(std::vector<std::vector<TYPE>>& array, TYP
 }
 
 
+
+//////////////////////////////
+//
+// HumdrumFileBase::getCachedAnalysis -- Return a derived analysis of the
+//     file which was previously stored with setCachedAnalysis().  Returns
+//     an empty pointer if there is no analysis of the given type and
+//     parameter, or if the file has been modified since it was stored.
+//     default value: parameter = 0
+//
+
+template <class TYPE>
+std::shared_ptr<TYPE> HumdrumFileBase::getCachedAnalysis(int parameter) {
+	auto it = m_analyses.m_cache.find(std::make_pair(std::type_index(typeid(TYPE)), parameter));
+	if (it == m_analyses.m_cache.end()) {
+		return std::shared_ptr<TYPE>();
+	}
+	return std::static_pointer_cast<TYPE>(it->second);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBase::setCachedAnalysis -- Store a derived analysis of the
+//     file so that other tools processing the file can reuse it.
+//     default value: parameter = 0
+//
+
+template <class TYPE>
+void HumdrumFileBase::setCachedAnalysis(std::shared_ptr<TYPE> analysis, int parameter) {
+	m_analyses.m_cache[std::make_pair(std::type_index(typeid(TYPE)), parameter)] = analysis;
+}
+
+
 // END_MERGE
 
 } // end namespace hum
@@ -18,6 +18,7 @@
 
 #include <iostream>
 #include <cmath>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -27,6 +28,56 @@ namespace hum {
 
 // START_MERGE
 
+// HumMeasureInfo: an entry in the measure index of a HumdrumFileContent.
+// Track-indexed vectors have an unused zeroth element so that they can
+// be accessed with HumdrumToken::getTrack().
+
+class HumMeasureInfo {
+	public:
+		HumMeasureInfo(void) { clear(); }
+		~HumMeasureInfo() { clear(); }
+		void clear(void) {
+			startLine = -1;
+			stopLine  = -1;
+			number    = -1;
+			spines.clear();
+			clef.clear();
+			keysig.clear();
+			key.clear();
+			timesig.clear();
+			met.clear();
+			tempo.clear();
+		}
+
+		// startLine: line index of the barline which starts the measure,
+		// or 0 for music before the first barline.
+		int startLine;
+
+		// stopLine: line index of the barline which ends the measure, or
+		// the data terminator line for the last measure.
+		int stopLine;
+
+		// number: measure number of the starting barline, or -1 if the
+		// barline is not numbered.
+		int number;
+
+		// spines: number of active subspines for each track at the start
+		// of the measure.
+		std::vector<int> spines;
+
+		// clef, keysig, key, timesig, met, tempo: the prevailing
+		// interpretations for each track at the start of the measure,
+		// or NULL if not yet given.
+		std::vector<HTp> clef;
+		std::vector<HTp> keysig;
+		std::vector<HTp> key;
+		std::vector<HTp> timesig;
+		std::vector<HTp> met;
+		std::vector<HTp> tempo;
+};
+
+
+
 class HumdrumFileContent : public HumdrumFileStructure {
 	public:
 		       HumdrumFileContent         (void);
@@ -66,6 +117,8 @@ class HumdrumFileContent : public HumdrumFileStructure {
 		// in HumdrumFileContent-metlev.cpp
 		void  getMetricLevels             (std::vector<double>& output, int track = 0,
 		                                   double undefined = NAN);
+		std::shared_ptr<std::vector<double>> getCachedMetricLevels(int track = 0);
+
 		// in HumdrumFileContent-timesig.cpp
 		void  getTimeSigs                 (std::vector<std::pair<int, HumNum> >& output,
 		                                   int track = 0);
@@ -110,6 +163,13 @@ class HumdrumFileContent : public HumdrumFileStructure {
 		bool   hasDifferentBarlines       (void);
 		bool   hasDataStraddle            (int line);
 
+		// in HumdrumFileContent-measure.cpp
+		void   analyzeMeasures            (void);
+		int    getMeasureCount            (void);
+		const HumMeasureInfo& getMeasureInfo (int index);
+		int    getMeasureIndexByNumber    (int number);
+		int    getMeasureIndexByLine      (int lineindex);
+
 	protected:
 
 		bool   analyzeKernPhrasings       (HTp spinestart,
@@ -180,6 +240,14 @@ class HumdrumFileContent : public HumdrumFileStructure {
 		void    getBaselines              (std::vector<std::vector<int>>& centerlines);
 		void    createLinkedTies          (std::vector<std::pair<HTp, int>>& starts,
 		                                   std::vector<std::pair<HTp, int>>& ends);
+
+	private:
+		// m_measures: measure index created by analyzeMeasures().
+		std::vector<HumMeasureInfo> m_measures;
+
+		// m_measureNumbers: (measure number, index into m_measures) pairs
+		// sorted by measure number for binary searches.
+		std::vector<std::pair<int, int>> m_measureNumbers;
 };
 
 
@@ -54,6 +54,9 @@ class HumdrumFileStream {
 		int             read               (HumdrumFileSet& infiles);
 		int             readSingleSegment  (HumdrumFileSet& infiles);
 
+		void            setCacheDirectory  (const std::string& directory);
+		std::string     getCacheDirectory  (void) const { return m_cachedir; }
+
 	protected:
 		std::stringstream m_stringbuffer;   // used to read files from a string
 		std::ifstream     m_instream;       // used to read from list of files
@@ -66,6 +69,8 @@ class HumdrumFileStream {
 
 		std::vector<std::string>  m_universals;     // storage for universal comments
 
+		std::string               m_cachedir;       // directory for binary cache files
+
 		// Automatic URL downloading of data from internet in read():
 		void     fillUrlBuffer            (std::stringstream& uribuffer,
 		                                   const std::string& uriname);
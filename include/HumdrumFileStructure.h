@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Aug 17 02:39:28 PDT 2015
-// Last Modified: Tue Feb  4 21:02:30 PST 2020 Strophe analysis
+// Last Modified: Mon Oct 19 17:20:14 PDT 2026 Verify binary cache hashes
 // Filename:      HumdrumFileStructure.h
 // URL:           https://github.com/craigsapp/humlib/blob/master/include/HumdrumFileStructure.h
 // Syntax:        C++11; humlib
@@ -28,6 +28,9 @@ namespace hum {
 
 // START_MERGE
 
+class HumBinaryReader;
+class HumBinaryWriter;
+
 class HumdrumFileStructure : public HumdrumFileBase {
 	public:
 		              HumdrumFileStructure         (void);
@@ -127,6 +130,8 @@ class HumdrumFileStructure : public HumdrumFileBase {
 
 		bool          analyzeStructure             (void);
 		bool          analyzeStructureNoRhythm     (void);
+		bool          analyzeFromTokens            (void);
+		bool          analyzeFromGridTokens        (void);
 		bool          analyzeRhythmStructure       (void);
 		bool          analyzeStrands               (void);
 
@@ -135,10 +140,27 @@ class HumdrumFileStructure : public HumdrumFileBase {
 		std::string   getKernAboveSignifier        (void);
 		std::string   getKernBelowSignifier        (void);
 
+		// binary cache functionality (located in src/HumdrumFileStructure-binary.cpp)
+		bool          writeBinary                  (std::ostream& out);
+		bool          writeBinary                  (const std::string& filename);
+		bool          readBinary                   (const std::string& filename);
+		bool          readBinary                   (const char* data, size_t size);
+		bool          readCached                   (const std::string& filename,
+		                                            const std::string& cachedir);
+		bool          readStringCached             (const std::string& contents,
+		                                            const std::string& cachedir);
+		bool          readStringNoRhythmCached     (const std::string& contents,
+		                                            const std::string& cachedir);
+		static unsigned long long getContentHash   (const std::string& contents);
+		static unsigned long long getLineHash      (const std::string& contents);
+		static std::string getCacheFilename        (const std::string& contents,
+		                                            const std::string& cachedir);
+
 
 	protected:
 		bool          analyzeRhythm                (void);
 		bool          assignRhythmFromRecip        (HTp spinestart);
+		bool          assignGridLineTimes          (void);
 		bool          analyzeMeter                 (void);
 		bool          analyzeTokenDurations        (void);
 		bool          analyzeGlobalParameters      (void);
@@ -174,6 +196,24 @@ class HumdrumFileStructure : public HumdrumFileBase {
 		void          analyzeSignifiers            (void);
 		void          setLineRhythmAnalyzed        (void);
 		bool          prepareMensurationInformation(void);
+		bool          readBinary                   (HumBinaryReader& reader);
+		bool          readBinaryCache              (const std::string& contents,
+		                                            const std::string& cachename);
+		bool          writeBinaryData              (std::ostream& out);
+		bool          writeBinaryCache             (const std::string& cachename);
+		unsigned long long getTextHash             (void);
+		void          writeBinaryTokenRef          (HumBinaryWriter& writer, HTp token);
+		HTp           readBinaryTokenRef           (HumBinaryReader& reader);
+		void          writeBinaryTokenList         (HumBinaryWriter& writer,
+		                                            const std::vector<HTp>& tokens);
+		void          readBinaryTokenList          (HumBinaryReader& reader,
+		                                            std::vector<HTp>& tokens);
+		void          writeBinaryTokenPairs        (HumBinaryWriter& writer,
+		                                            const std::vector<TokenPair>& pairs);
+		void          readBinaryTokenPairs         (HumBinaryReader& reader,
+		                                            std::vector<TokenPair>& pairs);
+		void          writeBinaryHash              (HumBinaryWriter& writer, HumHash& hash);
+		bool          readBinaryHash               (HumBinaryReader& reader, HumHash& hash);
 };
 
 
@@ -0,0 +1,157 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 12:10:32 PDT 2026
+// Last Modified: Mon Oct 19 22:14:07 PDT 2026
+// Filename:      HumdrumLineStream.h
+// URL:           https://github.com/craigsapp/humlib/blob/master/include/HumdrumLineStream.h
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Read Humdrum data one line at a time, keeping track of
+//                spine manipulators but without storing the file in memory
+//                or doing any rhythmic or content analysis.  This is
+//                useful for line-filtering tools that process very large
+//                inputs.
+//
+
+#ifndef _HUMDRUMLINESTREAM_H_INCLUDED
+#define _HUMDRUMLINESTREAM_H_INCLUDED
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace hum {
+
+// START_MERGE
+
+class HumdrumStreamLine {
+	public:
+		                   HumdrumStreamLine   (void);
+		                  ~HumdrumStreamLine   ();
+
+		void               clear               (void);
+
+		const std::string& getText             (void) const { return m_text; }
+		int                getLineIndex        (void) const { return m_lineindex; }
+		int                getLineNumber       (void) const { return m_lineindex + 1; }
+
+		int                getFieldCount       (void) const { return (int)m_fields.size(); }
+		const std::string& token               (int index) const { return m_fields.at(index); }
+		const std::string& getSpineInfo        (int index) const { return m_spineinfo.at(index); }
+		const std::string& getDataType         (int index) const { return m_datatype.at(index); }
+		int                getTrack            (int index) const { return m_track.at(index); }
+
+		bool               isEmpty             (void) const { return m_text.empty(); }
+		bool               isComment           (void) const;
+		bool               isCommentLocal      (void) const;
+		bool               isLocalComment      (void) const { return isCommentLocal(); }
+		bool               isCommentGlobal     (void) const;
+		bool               isGlobalComment     (void) const { return isCommentGlobal(); }
+		bool               isReference         (void) const;
+		bool               isInterpretation    (void) const;
+		bool               isInterp            (void) const { return isInterpretation(); }
+		bool               isExclusive         (void) const;
+		bool               isBarline           (void) const;
+		bool               isData              (void) const;
+		bool               hasSpines           (void) const;
+		bool               isManipulator       (void) const;
+		bool               isTerminator        (void) const;
+		bool               isAllNull           (void) const;
+		bool               equalFieldsQ        (const std::string& exinterp,
+		                                        const std::string& value) const;
+
+	protected:
+		bool               isNullField         (int index) const;
+
+	private:
+		// m_text: the contents of the line, without a newline or a
+		// trailing carriage return.
+		std::string m_text;
+
+		// m_lineindex: line index of the line in the input stream.
+		int m_lineindex;
+
+		// m_fields: tab-separated fields on the line.  Lines without spines
+		// have a single field containing the entire line.
+		std::vector<std::string> m_fields;
+
+		// m_spineinfo: spine information for each field.
+		std::vector<std::string> m_spineinfo;
+
+		// m_datatype: exclusive interpretation for each field.
+		std::vector<std::string> m_datatype;
+
+		// m_track: track number for each field (0 if the line does
+		// not have spines).
+		std::vector<int> m_track;
+
+	friend class HumdrumLineStream;
+};
+
+std::ostream& operator<<(std::ostream& out, const HumdrumStreamLine& line);
+
+
+
+class HumdrumLineStream {
+	public:
+		                   HumdrumLineStream   (void);
+		                   HumdrumLineStream   (std::istream& input);
+		                   HumdrumLineStream   (const std::string& filename);
+		                  ~HumdrumLineStream   ();
+
+		void               setInput            (std::istream& input);
+		bool               open                (const std::string& filename);
+		void               close               (void);
+
+		bool               getLine             (HumdrumStreamLine& line);
+		bool               process             (const std::function<bool(HumdrumStreamLine&)>& callback);
+
+		bool               isValid             (void) const { return m_error.empty(); }
+		const std::string& getParseError       (void) const { return m_error; }
+		int                getMaxTrack         (void) const { return m_maxtrack; }
+
+	protected:
+		void               splitFields         (HumdrumStreamLine& line);
+		bool               assignSpines        (HumdrumStreamLine& line);
+		bool               adjustSpines        (HumdrumStreamLine& line);
+		bool               setParseError       (const std::string& message);
+
+	private:
+		// m_input: the input stream, either external or m_file.
+		std::istream* m_input;
+
+		// m_file: used when reading from a file.
+		std::ifstream m_file;
+
+		// m_urlbuffer: used when reading from a URI.
+		std::stringstream m_urlbuffer;
+
+		// m_lineindex: index of the next line to read.
+		int m_lineindex;
+
+		// m_maxtrack: the number of tracks in the current file.
+		int m_maxtrack;
+
+		// m_datatype, m_spineinfo, m_track: the active spines before
+		// the next line.
+		std::vector<std::string> m_datatype;
+		std::vector<std::string> m_spineinfo;
+		std::vector<int>         m_track;
+
+		// m_error: parse error message if the spine structure is invalid.
+		std::string m_error;
+};
+
+
+// END_MERGE
+
+} // end namespace hum
+
+#endif /* _HUMDRUMLINESTREAM_H_INCLUDED */
+
+
+
@@ -26,7 +26,7 @@ namespace hum {
 // A MuseEventSet is a timestamp and then a list of pointers to all
 // lines in the original file that occur at that time.
 // The MuseData class contains a variable called "sequence" which is
-// a list of MuseEventSet object pointers which are sorted by time.
+// a list of MuseEventSet objects which are sorted by time.
 
 class MuseEventSet {
 	public:
@@ -39,8 +39,9 @@ class MuseEventSet {
 		void               setTime            (HumNum abstime);
 		HumNum             getTime            (void);
 		void               appendRecord       (MuseRecord* arecord);
+		void               reserve            (int count);
 		MuseRecord&        operator[]         (int index);
-		MuseEventSet       operator=          (MuseEventSet& anevent);
+		MuseEventSet&      operator=          (const MuseEventSet& anevent);
 		int                getEventCount      (void);
 
 	protected:
@@ -154,7 +155,7 @@ class MuseData {
 
 	private:
 		std::vector<MuseRecord*>    m_data;
-		std::vector<MuseEventSet*>  m_sequence;
+		std::vector<MuseEventSet>   m_sequence;
 		std::string                 m_name;
 		std::string                 m_error;
 
@@ -166,7 +167,6 @@ class MuseData {
 		int          searchForPitch       (int eventindex, int b40, int track);
 		int          getNextEventIndex    (int startindex, HumNum target);
 		void         constructTimeSequence(void);
-		void         insertEventBackwards (HumNum atime, MuseRecord* arecord);
 		int          getPartNameIndex     (void);
 		void         assignHeaderBodyState(void);
 		void         linkPrintSuggestions (void);
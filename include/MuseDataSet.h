@@ -17,7 +17,9 @@
 #include "MuseData.h"
 #include "HumRegex.h"
 
+#include <functional>
 #include <iostream>
+#include <string>
 #include <vector>
 
 namespace hum {
@@ -34,6 +36,7 @@ class MuseDataSet {
 		int               readPartFile        (const std::string& filename);
 		int               readPartString      (const std::string& data);
 		int               readPart            (std::istream& input);
+		int               readPartFiles       (const std::vector<std::string>& filenames);
 		int               readFile            (const std::string& filename);
 		int               readString          (const std::string& data);
 		int               readString          (std::istream& input);
@@ -45,6 +48,8 @@ class MuseDataSet {
 		void              cleanLineEndings    (void);
 		std::vector<int>  getGroupIndexList   (const std::string& group);
 		int               appendPart          (MuseData* musedata);
+		void              setThreadCount      (int count);
+		int               getThreadCount      (void) { return m_threads; }
 
 		std::string       getError            (void);
 		bool              hasError            (void);
@@ -57,6 +62,7 @@ class MuseDataSet {
 	private:
 		std::vector<MuseData*>  m_part;
 		std::string             m_error;
+		int                     m_threads = 1; // threads for reading parts
 
 	protected:
 		void              analyzeSetType      (std::vector<int>& types,
@@ -65,6 +71,8 @@ class MuseDataSet {
 		                                       std::vector<int>& stopindex,
 		                                       std::vector<std::string>& lines);
 		void              setError            (const std::string& error);
+		bool              readParts           (int count,
+		                                       const std::function<bool(MuseData&, int)>& reader);
 
 };
 
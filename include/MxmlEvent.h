@@ -22,6 +22,7 @@
 #include "pugiconfig.hpp"
 #include "pugixml.hpp"
 
+#include <atomic>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -161,7 +162,7 @@ class MxmlEvent {
 		std::vector<MxmlEvent*> m_links;   // list of secondary chord notes
 		bool               m_linked;       // true if a secondary chord note
 		int                m_sequence;     // ordering of event in XML file
-		static int         m_counter;      // counter for sequence variable
+		static std::atomic<int> m_counter; // counter for sequence variable
 		short              m_staff;        // staff number in part for event
 		short              m_voice;        // voice number in part for event
 		int                m_voiceindex;   // voice index of item (remapping)
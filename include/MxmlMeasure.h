@@ -52,9 +52,12 @@ class MxmlMeasure {
 		              MxmlMeasure        (MxmlPart* part);
 		             ~MxmlMeasure        (void);
 		void          clear              (void);
+		void          releaseEvents      (void);
 		void          enableStems        (void);
 		bool          parseMeasure       (xml_node mel);
 		bool          parseMeasure       (xpath_node mel);
+		xml_node      getNode            (void) const { return m_node; }
+		void          clearNode          (void) { m_node = xml_node(NULL); }
 		void          setStartTimeOfMeasure (HumNum value);
 		void          setStartTimeOfMeasure (void);
 		void          setDuration        (HumNum value);
@@ -127,6 +130,7 @@ class MxmlMeasure {
 		vector<SimultaneousEvents> m_sortedevents; // list of time-sorted events
 		MeasureStyle       m_style;     // measure style type
 		bool               m_stems = false;
+		xml_node           m_node;      // measure element in the XML document
 
 	friend MxmlEvent;
 	friend MxmlPart;
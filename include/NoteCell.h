@@ -28,18 +28,24 @@ namespace hum {
 
 #define GRIDREST NAN
 
+// Bit flags stored with base-40 pitches in NoteGrid:
+#define GRID_PITCH   0x0fff
+#define GRID_SUSTAIN 0x1000
+#define GRID_REST    0x2000
+
 class NoteGrid;
 
 
 class NoteCell {
 	public:
+		       NoteCell             (void) { }
 		       NoteCell             (NoteGrid* owner, HTp token);
-		      ~NoteCell             (void) { clear();                    }
+		      ~NoteCell             (void) { }
 
-		double getSgnDiatonicPitch  (void) { return m_b7;                }
-		double getSgnMidiPitch      (void) { return m_b12;               }
-		double getSgnBase40Pitch    (void) { return m_b40;               }
-		double getSgnAccidental     (void) { return m_accidental;        }
+		double getSgnDiatonicPitch  (void);
+		double getSgnMidiPitch      (void);
+		double getSgnBase40Pitch    (void);
+		double getSgnAccidental     (void);
 
 		double getSgnDiatonicPitchClass(void);
 		double getAbsDiatonicPitchClass(void);
@@ -47,15 +53,15 @@ class NoteCell {
 		double getSgnBase40PitchClass(void);
 		double getAbsBase40PitchClass(void);
 
-		double getAbsDiatonicPitch  (void) { return fabs(m_b7);          }
-		double getAbsMidiPitch      (void) { return fabs(m_b12);         }
-		double getAbsBase40Pitch    (void) { return fabs(m_b40);         }
-		double getAbsAccidental     (void) { return fabs(m_accidental);  }
+		double getAbsDiatonicPitch  (void);
+		double getAbsMidiPitch      (void);
+		double getAbsBase40Pitch    (void);
+		double getAbsAccidental     (void);
 
-		HTp    getToken             (void) { return m_token;             }
-		int    getNextAttackIndex   (void) { return m_nextAttackIndex;   }
-		int    getPrevAttackIndex   (void) { return m_prevAttackIndex;   }
-		int    getCurrAttackIndex   (void) { return m_currAttackIndex;   }
+		HTp    getToken             (void);
+		int    getNextAttackIndex   (void);
+		int    getPrevAttackIndex   (void);
+		int    getCurrAttackIndex   (void);
 		int    getSliceIndex        (void) { return m_timeslice;         }
 		int    getVoiceIndex        (void) { return m_voice;             }
 
@@ -84,34 +90,17 @@ class NoteCell {
 		std::vector<HTp> m_tiedtokens;  // list of tied notes/rests after note attack
 
 	protected:
-		void clear                  (void);
-		void calculateNumericPitches(void);
-		void setVoiceIndex          (int index) { m_voice = index;           }
-		void setSliceIndex          (int index) { m_timeslice = index;       }
-		void setNextAttackIndex     (int index) { m_nextAttackIndex = index; }
-		void setPrevAttackIndex     (int index) { m_prevAttackIndex = index; }
-		void setCurrAttackIndex     (int index) { m_currAttackIndex = index; }
+		void setOwner               (NoteGrid* owner, int voice, int slice);
+		bool isAttached             (void) { return m_owner != NULL;    }
 
 	private:
-		NoteGrid* m_owner; // the NoteGrid to which this cell belongs.
-		HTp m_token;       // pointer to the note in the origina Humdrum file.
-		int m_voice;       // index of the voice in the score the note belongs
-		                   // 0=bottom voice (HumdrumFile ordering of parts)
-		                   // column in NoteGrid.
-		int m_timeslice;   // index for the row in NoteGrid.
-
-		double m_b7;         // diatonic note number; NaN=rest; negative=sustain.
-		double m_b12;        // MIDI note number; NaN=rest; negative=sustain.
-		double m_b40;        // base-40 note number; NaN=rest; negative=sustain.
-		double m_accidental; // chromatic alteration of a diatonic pitch.
-		                     // NaN=no accidental.
-		int m_nextAttackIndex; // index to next note attack (or rest),
-		                       // -1 for undefined (interpred as rest).
-		int m_prevAttackIndex; // index to previous note attack.
-		int m_currAttackIndex; // index to current note attack (useful for
-		                       // finding the start of a sustained note.
-		int m_metertop = 0;    // top number of prevailing meter signature
-		HumNum m_meterbot = 0; // bottom number of prevailing meter signature
+		NoteGrid* m_owner = NULL; // the NoteGrid to which this cell belongs.
+		                          // The pitch and attack data for the cell
+		                          // are stored in the NoteGrid.
+		int m_voice = -1;      // index of the voice in the score the note belongs
+		                       // 0=bottom voice (HumdrumFile ordering of parts)
+		                       // column in NoteGrid.
+		int m_timeslice = -1;  // index for the row in NoteGrid.
 
 	friend NoteGrid;
 };
@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Fri Nov 25 19:41:43 PST 2016
-// Last Modified: Fri Nov 25 19:41:49 PST 2016
+// Last Modified: Mon Oct 19 19:21:37 PDT 2026
 // Filename:      NoteGrid.h
 // URL:           https://github.com/craigsapp/humlib/blob/master/include/NoteGrid.cpp
 // Syntax:        C++11; humlib
@@ -31,8 +31,8 @@ class NoteGrid {
 
 		bool       load                  (HumdrumFile& infile);
 		NoteCell*  cell                  (int voiceindex, int sliceindex);
-		int        getVoiceCount         (void);
-		int        getSliceCount         (void);
+		int        getVoiceCount         (void) { return m_voices; }
+		int        getSliceCount         (void) { return m_slices; }
 		int        getLineIndex          (int sindex);
 		int        getFieldIndex         (int vindex);
 
@@ -45,11 +45,13 @@ class NoteGrid {
 		double     getSgnDiatonicPitch   (int vindex, int sindex);
 		double     getSgnMidiPitch       (int vindex, int sindex);
 		double     getSgnBase40Pitch     (int vindex, int sindex);
+		double     getSgnAccidental      (int vindex, int sindex);
 		string     getSgnKernPitch       (int vindex, int sindex);
 
 		double     getAbsDiatonicPitch   (int vindex, int sindex);
 		double     getAbsMidiPitch       (int vindex, int sindex);
 		double     getAbsBase40Pitch     (int vindex, int sindex);
+		double     getAbsAccidental      (int vindex, int sindex);
 		string     getAbsKernPitch       (int vindex, int sindex);
 
 		bool       isRest                (int vindex, int sindex);
@@ -57,6 +59,11 @@ class NoteGrid {
 		bool       isAttack              (int vindex, int sindex);
 
 		HTp        getToken              (int vindex, int sindex);
+		int        getCurrAttackIndex    (int vindex, int sindex);
+		int        getPrevAttackIndex    (int vindex, int sindex);
+		int        getNextAttackIndex    (int vindex, int sindex);
+		int        getMeterTop           (int vindex, int sindex);
+		HumNum     getMeterBottom        (int vindex, int sindex);
 
 		int        getPrevAttackDiatonic (int vindex, int sindex);
 		int        getNextAttackDiatonic (int vindex, int sindex);
@@ -65,21 +72,245 @@ class NoteGrid {
 		void       printVoiceInfo        (ostream& out, int vindex);
 
 		void       getNoteAndRestAttacks (vector<NoteCell*>& attacks, int vindex);
+		bool       findCell              (HTp token, int& vindex, int& sindex);
+		void       setMeter              (int vindex, int sindex, int top,
+		                                  HumNum bottom);
 		double     getMetricLevel        (int sindex);
 		HumNum     getNoteDuration       (int vindex, int sindex);
 
 	protected:
 		void       buildAttackIndexes    (void);
 		void       buildAttackIndex      (int vindex);
+		void       setPitch              (int index, HTp token);
+		int        getMeterIndex         (HTp token);
+		int        addMeter              (int top, HumNum bottom);
+		int        getIndex              (int vindex, int sindex) {
+		                                    return vindex * m_slices + sindex; }
 
 	private:
-		vector<vector<NoteCell*> > m_grid;
+		// Each array below has one entry for each cell in the grid, stored
+		// voice by voice (index = voice * slicecount + slice), so that
+		// walking through a voice reads consecutive memory.
+
+		// m_cells: NoteCell interface to the grid contents.
+		vector<NoteCell> m_cells;
+
+		// m_tokens: the Humdrum token for each cell (null tokens for
+		// sustained notes and rests).
+		vector<HTp> m_tokens;
+
+		// m_b40: absolute base-40 pitch, combined with the GRID_REST and
+		// GRID_SUSTAIN flags.  m_b7 and m_b12 are the absolute diatonic
+		// and MIDI pitches (not defined for rests).
+		vector<short> m_b40;
+		vector<short> m_b7;
+		vector<short> m_b12;
+
+		// Slice indexes of the current, previous and next note attacks.
+		vector<int> m_currAttack;
+		vector<int> m_prevAttack;
+		vector<int> m_nextAttack;
+
+		// m_meter: index into m_meters for the prevailing meter signature
+		// of each cell.  m_meters[0] is used when there is no meter.
+		vector<short>                  m_meter;
+		vector<pair<int, HumNum>>      m_meters;
+
 		vector<HTp>                m_kernspines;
-		vector<double>             m_metriclevels;
-		HumdrumFile*               m_infile;
+		std::shared_ptr<std::vector<double>> m_metriclevels;
+		HumdrumFile*               m_infile = NULL;
+		int                        m_voices = 0;
+		int                        m_slices = 0;
 };
 
 
+
+//////////////////////////////
+//
+// NoteGrid::getSgnDiatonicPitch -- Return the diatonic pitch number for
+//     the given cell (NaN for rests, negative for sustained notes).
+//
+
+inline double NoteGrid::getSgnDiatonicPitch(int vindex, int sindex) {
+	int index = getIndex(vindex, sindex);
+	int b40 = m_b40[index];
+	if (b40 & GRID_REST) {
+		return GRIDREST;
+	}
+	return (b40 & GRID_SUSTAIN) ? -m_b7[index] : m_b7[index];
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::getAbsDiatonicPitch -- Return the diatonic pitch number for
+//     the given cell (NaN for rests).
+//
+
+inline double NoteGrid::getAbsDiatonicPitch(int vindex, int sindex) {
+	int index = getIndex(vindex, sindex);
+	if (m_b40[index] & GRID_REST) {
+		return GRIDREST;
+	}
+	return m_b7[index];
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::getSgnMidiPitch -- Return the MIDI pitch number for
+//     the given cell (NaN for rests, negative for sustained notes).
+//
+
+inline double NoteGrid::getSgnMidiPitch(int vindex, int sindex) {
+	int index = getIndex(vindex, sindex);
+	int b40 = m_b40[index];
+	if (b40 & GRID_REST) {
+		return GRIDREST;
+	}
+	return (b40 & GRID_SUSTAIN) ? -m_b12[index] : m_b12[index];
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::getAbsMidiPitch -- Return the MIDI pitch number for
+//     the given cell (NaN for rests).
+//
+
+inline double NoteGrid::getAbsMidiPitch(int vindex, int sindex) {
+	int index = getIndex(vindex, sindex);
+	if (m_b40[index] & GRID_REST) {
+		return GRIDREST;
+	}
+	return m_b12[index];
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::getSgnBase40Pitch -- Return the base-40 pitch number for
+//     the given cell (NaN for rests, negative for sustained notes).
+//
+
+inline double NoteGrid::getSgnBase40Pitch(int vindex, int sindex) {
+	int b40 = m_b40[getIndex(vindex, sindex)];
+	if (b40 & GRID_REST) {
+		return GRIDREST;
+	}
+	int pitch = b40 & GRID_PITCH;
+	return (b40 & GRID_SUSTAIN) ? -pitch : pitch;
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::getAbsBase40Pitch -- Return the base-40 pitch number for
+//     the given cell (NaN for rests).
+//
+
+inline double NoteGrid::getAbsBase40Pitch(int vindex, int sindex) {
+	int b40 = m_b40[getIndex(vindex, sindex)];
+	if (b40 & GRID_REST) {
+		return GRIDREST;
+	}
+	return b40 & GRID_PITCH;
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::isRest -- Return true if the cell is a rest.
+//
+
+inline bool NoteGrid::isRest(int vindex, int sindex) {
+	return m_b40[getIndex(vindex, sindex)] & GRID_REST;
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::isAttack -- Return true if the cell is a note attack
+//     (rests are never attacks).
+//
+
+inline bool NoteGrid::isAttack(int vindex, int sindex) {
+	return !(m_b40[getIndex(vindex, sindex)] & (GRID_REST | GRID_SUSTAIN));
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::isSustained -- Return true if the cell is a sustained note,
+//     or a rest which is not the first rest in a sequence of rests.
+//
+
+inline bool NoteGrid::isSustained(int vindex, int sindex) {
+	int index = getIndex(vindex, sindex);
+	int b40 = m_b40[index];
+	if (b40 & GRID_REST) {
+		return m_currAttack[index] != sindex;
+	}
+	return b40 & GRID_SUSTAIN;
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::getToken -- Return the HumdrumToken pointer for
+//     the given cell.
+//
+
+inline HTp NoteGrid::getToken(int vindex, int sindex) {
+	return m_tokens[getIndex(vindex, sindex)];
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::getCurrAttackIndex -- Return the slice index of the attack
+//     of the note (or first rest) for the given cell.
+//
+
+inline int NoteGrid::getCurrAttackIndex(int vindex, int sindex) {
+	return m_currAttack[getIndex(vindex, sindex)];
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::getPrevAttackIndex -- Return the slice index of the
+//     previous note attack before the given cell (-1 if none).
+//
+
+inline int NoteGrid::getPrevAttackIndex(int vindex, int sindex) {
+	return m_prevAttack[getIndex(vindex, sindex)];
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::getNextAttackIndex -- Return the slice index of the
+//     next note attack after the given cell (-1 if none).
+//
+
+inline int NoteGrid::getNextAttackIndex(int vindex, int sindex) {
+	return m_nextAttack[getIndex(vindex, sindex)];
+}
+
+
 // END_MERGE
 
 } // end namespace hum
@@ -17,6 +17,7 @@
 #include "HumNum.h"
 #include "HumdrumFile.h"
 
+#include <fstream>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -34,17 +35,37 @@ class Tool_binroll : public HumTool {
 		bool     run               (HumdrumFile& infile);
 		bool     run               (const std::string& indata, std::ostream& out);
 		bool     run               (HumdrumFile& infile, std::ostream& out);
+		void     finally           (void);
 
 	protected:
-		void     processFile       (HumdrumFile& infile);
-		void     processStrand     (std::vector<std::vector<char>>& roll, HTp starting,
-		                            HTp ending);
-		void     printAnalysis     (HumdrumFile& infile,
-		                            std::vector<std::vector<char>>& roll);
+		void     initialize        (HumdrumFile& infile);
+		void     processFile       (HumdrumFile& infile, std::ostream& out);
+		void     addNotes          (HTp token, int startindex);
+		void     addNote           (int key, int startindex, int endindex);
+		void     writeSlices       (std::ostream& out, int endindex);
+		void     writeSlice        (std::ostream& out,
+		                            const unsigned long long* sounding,
+		                            const unsigned long long* attacks);
+		void     writeNpyHeader    (std::ostream& out, int count);
+		void     printComments     (std::ostream& out, HumdrumFile& infile,
+		                            int startline, int endline);
 
 	private:
-		HumNum    m_duration;
-
+		HumNum    m_duration;         // duration of each time slice
+		bool      m_npyQ = false;     // used with --npy option
+		bool      m_bitplanesQ = false; // used with -b option
+		bool      m_tpqQ = false;     // used with --tpq option
+		int       m_inputCount = 0;   // number of input files processed
+
+		// m_output: file for -o option, which stays open for all input files.
+		std::ofstream m_output;
+
+		// Streaming state: the roll is written one time slice at a time,
+		// so only the state of the 128 MIDI keys is stored.
+		int       m_slice = 0;        // index of next slice to write
+		int       m_ends[128];        // end slice of sounding notes
+		int       m_nextEnds[128];    // end slice of notes starting at m_slice
+		unsigned long long m_attacks[2]; // notes starting at m_slice
 };
 
 // END_MERGE
@@ -16,11 +16,13 @@
 
 #include "HumTool.h"
 #include "HumdrumFile.h"
+#include "HumdrumFileStream.h"
 #include "NoteGrid.h"
 #include "HumRegex.h"
 
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 namespace hum {
 
@@ -64,9 +66,11 @@ class Tool_cint : public HumTool {
 		        ~Tool_cint    () {};
 
 		bool     run                    (HumdrumFileSet& infiles);
+		bool     run                    (HumdrumFileStream& instream);
 		bool     run                    (HumdrumFile& infile);
 		bool     run                    (const std::string& indata, ostream& out);
 		bool     run                    (HumdrumFile& infile, ostream& out);
+		void     finally                (void);
 
 	protected:
 
@@ -139,7 +143,8 @@ class Tool_cint : public HumTool {
 		                                std::vector<std::vector<NoteNode> >& notes,
 		                                int n, int startline, int part1, int part2,
 		                                std::vector<std::vector<std::string> >& retrospective,
-		                                std::string& notemarker, int markstate = 0);
+		                                std::string& notemarker, int markstate = 0,
+		                                std::u16string* key = NULL);
 		int       printCombinationModulePrepare(ostream& out, const std::string& filename,
 		                                std::vector<std::vector<NoteNode> >& notes, int n,
 		                                int startline, int part1, int part2,
@@ -157,6 +162,19 @@ class Tool_cint : public HumTool {
 		int       getTriangleIndex(int number, int num1, int num2);
 		void      adjustKTracks        (std::vector<int>& ktracks, const std::string& koption);
 		int       getMeasure           (HumdrumFile& infile, int line);
+		int       getInterval          (NoteNode& note1, NoteNode& note2, int type,
+		                                int octaveadjust = 0);
+		void      countModules         (HumdrumFile& infile,
+		                                std::unordered_map<std::u16string, int>& counts,
+		                                std::unordered_map<std::u16string, std::string>& names);
+		void      countFileSet         (HumdrumFileSet& infiles);
+		void      countFileStream      (HumdrumFileStream& instream);
+		void      mergeModuleCounts    (std::vector<std::unordered_map<std::u16string, int>>& counts,
+		                                std::vector<std::unordered_map<std::u16string, std::string>>& names);
+		char16_t  getModuleItem        (NoteNode& note1, NoteNode& note2, int type,
+		                                int octaveadjust = 0);
+		void      printModuleStatistics(ostream& out);
+		std::string getJsonString      (const std::string& text);
 
 	private:
 
@@ -201,12 +219,25 @@ class Tool_cint : public HumTool {
 		int       uncrossQ     = 0;      // used with -c option
 		int       retroQ       = 0;      // used with --retro option
 		int       idQ          = 0;      // used with --id option
-		std::vector<std::string> Ids;    // used with --id option
+		int       statsQ       = 0;      // used with --stats option
+		int       jsonQ        = 0;      // used with --json option
+		int       Threads      = 1;      // used with --threads option
 		std::string NoteMarker;          // used with -N option
 		std::string MarkColor;           // used with --color
 		std::string SearchString;
 		std::string Spacer;
 
+		// ModuleCounts: number of times each module occurs in the input
+		// files (used with --stats option).  Modules are indexed by their
+		// intervals packed into 16-bit integers (see getModuleItem).
+		std::unordered_map<std::u16string, int> ModuleCounts;
+
+		// ModuleNames: the text of each module in ModuleCounts.
+		std::unordered_map<std::u16string, std::string> ModuleNames;
+
+		// FileCount: number of files counted with --stats option.
+		int       FileCount    = 0;
+
 };
 
 // END_MERGE
@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jul 29 16:48:22 CEST 2019
-// Last Modified: Mon May  3 15:45:21 PDT 2021
+// Last Modified: Mon Oct 19 16:58:40 PDT 2026
 // Filename:      tool-composite.h
 // URL:           https://github.com/craigsapp/humlib/blob/master/include/tool-composite.h
 // Syntax:        C++11; humlib
@@ -49,6 +49,8 @@ class Tool_composite : public HumTool {
 		                                       const std::string& target);
 		void        extractGroup              (HumdrumFile& infile, const std::string &target);
 		void        getNumericGroupStates     (std::vector<int>& states, HumdrumFile& infile, const std::string& tgroup);
+		void        analyzeGroupOnsets        (HumdrumFile& infile);
+		int         getGroupIndex             (const std::string& group);
 		int         getGroupNoteType          (HumdrumFile& infile, int line, const std::string& group);
 		HumNum      getLineDuration           (HumdrumFile& infile, int index,
 		                                       std::vector<int>& isNull);
@@ -115,7 +117,7 @@ class Tool_composite : public HumTool {
 		void        doTotalAnalyses           (HumdrumFile& infile);
 
 		// Numeric analysis support functions:
-		int         countNoteOnsets           (HTp token);
+		int         countNoteOnsets           (HTp token, bool& attackQ);
 
 		bool        needsCoincidenceMarker    (int line, bool forceQ = false);
 		void        addCoincidenceMarks       (HumdrumFile& infile);
@@ -160,6 +162,20 @@ class Tool_composite : public HumTool {
 		bool        m_nozerosQ           = false;    // used with -Z option
 
 		bool        m_assignedQ          = false;    // used to keep track of group analysis initialization
+		bool        m_onsetsQ            = false;    // used to keep track of onset bitmap initialization
+
+		// Group index of each token on data lines (0 = A, 1 = B, -1 = no group),
+		// filled in by assignGroups().
+		std::vector<std::vector<int>> m_fieldGroups;
+
+		// Onset bitmaps for each line in the input file, with bit 0 for group A
+		// and bit 1 for group B (filled in by analyzeGroupOnsets()):
+		std::vector<int> m_groupAttacks;   // note attack in group on line
+		std::vector<int> m_groupSounding;  // note attack or sustain in group on line
+
+		// Number of note onsets on each line: index 0 for all **kern spines,
+		// index 1 for group A and index 2 for group B.
+		std::vector<std::vector<int>> m_onsetCounts;
 
 		// Data storage for numerical anslysis.
 		//
@@ -17,6 +17,10 @@
 #include "HumdrumFile.h"
 #include "NoteGrid.h"
 
+#include <atomic>
+#include <functional>
+#include <vector>
+
 namespace hum {
 
 // START_MERGE
@@ -56,6 +60,8 @@ class Tool_dissonant : public HumTool {
 		                            NoteGrid& grid, vector<NoteCell*>& attacks,
 		                            vector<vector<string> >& voiceFuncs,
 		                            int vindex);
+		void    runVoiceStage      (int voicecount,
+		                            const std::function<void(int)>& stage);
 
 		void    printColorLegend   (HumdrumFile& infile);
 		int     getNextPitchAttackIndex(NoteGrid& grid, int voicei,
@@ -94,16 +100,17 @@ class Tool_dissonant : public HumTool {
 
 	private:
 		vector<HTp> m_kernspines;
-		bool diss2Q = false;
-		bool diss7Q = false;
-		bool diss4Q = false;
-		bool dissL0Q = false;
-		bool dissL1Q = false;
-		bool dissL2Q = false;
+		std::atomic<bool> diss2Q{false};
+		std::atomic<bool> diss7Q{false};
+		std::atomic<bool> diss4Q{false};
+		std::atomic<bool> dissL0Q{false};
+		std::atomic<bool> dissL1Q{false};
+		std::atomic<bool> dissL2Q{false};
 		bool suppressQ = false;
 		bool voiceFuncsQ = false;
 		bool m_voicenumQ = false;
 		bool m_selfnumQ = false;
+		int  m_threads = 1;      // used with -t option
 
 		vector<string> m_labels;
 
@@ -152,6 +152,10 @@ class Tool_esac2hum : public HumTool {
 		void        initialize          (void);
 
 		void        convertEsacToHumdrum(std::ostream& output, std::istream& infile);
+		void        convertSongs        (std::ostream& output,
+		                                 std::vector<std::vector<std::string>>& songs,
+		                                 std::vector<std::vector<std::string>>& comments);
+		void        copySettings        (const Tool_esac2hum& tool);
 		bool        getSong             (std::vector<std::string>& song, std::istream& infile);
 		void        convertSong         (std::ostream& output, std::vector<std::string>& infile);
 		static std::string trimSpaces   (const std::string& input);
@@ -182,6 +186,7 @@ class Tool_esac2hum : public HumTool {
 		                                   // (Oskar Kolberg: Complete Works)
 		                                   // determined automatically if header line or TRD source contains "DWOK" string.
 		bool        m_analysisQ  = false;  // used with -a option
+		int         m_threads    = 1;      // used with -t option
 
 		int         m_inputline = 0;       // used to keep track if the EsAC input line.
 
@@ -192,6 +197,7 @@ class Tool_esac2hum : public HumTool {
 		std::string m_prevline;
 		std::string m_cutline;
 		std::vector<std::string> m_globalComments;
+		std::string m_conversionDate;      // date printed in !!!ONB record
 
 		bool m_initialized = false;
 		int m_minrhy = 0;
@@ -15,6 +15,8 @@
 
 #include "HumTool.h"
 #include "HumdrumFile.h"
+#include "HumdrumLineStream.h"
+#include "HumRegex.h"
 
 #include <ostream>
 #include <string>
@@ -32,9 +34,12 @@ class Tool_grep : public HumTool {
 		bool     run               (HumdrumFile& infile);
 		bool     run               (const std::string& indata, std::ostream& out);
 		bool     run               (HumdrumFile& infile, std::ostream& out);
+		bool     run               (HumdrumLineStream& instream, std::ostream& out);
 
 	protected:
 		void      processFile         (HumdrumFile& infile);
+		void      processLine         (HumRegex& hre, const std::string& line,
+		                               std::ostream& out);
 		void      initialize          (void);
 
 	private:
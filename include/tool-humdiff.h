@@ -17,8 +17,10 @@
 #include "HumdrumFile.h"
 #include "HumdrumFileSet.h"
 
+#include <map>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace hum {
@@ -90,6 +92,29 @@ class NotePoint {
 };
 
 
+// DiffEdit is one step in the edit script which aligns the notes of a part
+// in the reference score with the notes of the same part in another score.
+class DiffEdit {
+	public:
+		// type :: '=' for matching notes, '-' for a note only in the
+		// reference, '+' for a note only in the other score, and '~' for
+		// a note which was changed.
+		char type     = '=';
+
+		// refindex :: index of the note in the reference part (or -1).
+		int  refindex = -1;
+
+		// altindex :: index of the note in the other part (or -1).
+		int  altindex = -1;
+
+		DiffEdit(char atype, int aref, int aalt) {
+			type     = atype;
+			refindex = aref;
+			altindex = aalt;
+		}
+};
+
+
 // Function declarations:
 
 class Tool_humdiff : public HumTool {
@@ -110,9 +135,35 @@ class Tool_humdiff : public HumTool {
 		void     printNotePoints    (std::vector<NotePoint>& notelist);
 		void     markNote           (NotePoint& np);
 
+		void     alignFiles         (HumdrumFile& reference, HumdrumFile& alternate, int source);
+		void     extractPartNotes   (std::vector<std::vector<NotePoint>>& parts, HumdrumFile& infile);
+		void     getNoteKeys        (std::vector<int>& keys, std::vector<NotePoint>& notes);
+		void     alignNotes         (std::vector<DiffEdit>& edits, const std::vector<int>& a,
+		                             const std::vector<int>& b);
+		void     alignRange         (std::vector<DiffEdit>& edits, const std::vector<int>& a,
+		                             int astart, int aend, const std::vector<int>& b,
+		                             int bstart, int bend);
+		void     bisectRange        (std::vector<DiffEdit>& edits, const std::vector<int>& a,
+		                             int astart, int aend, const std::vector<int>& b,
+		                             int bstart, int bend);
+		void     printAlignment     (std::vector<DiffEdit>& edits, std::vector<NotePoint>& refnotes,
+		                             std::vector<NotePoint>& altnotes, int part, int source);
+		void     printNoteLocation  (NotePoint& np);
+
 	private:
 		int m_marked = 0;
 
+		// m_referenceParts: The notes in each part of the reference score,
+		// (extracted once when aligning with multiple scores).
+		std::vector<std::vector<NotePoint>> m_referenceParts;
+
+		// m_referenceKeys: The note keys for m_referenceParts.
+		std::vector<std::vector<int>> m_referenceKeys;
+
+		// m_noteKeys: Map of pitch/duration pairs to integers used to
+		// compare notes during alignment.
+		std::map<std::pair<int, HumNum>, int> m_noteKeys;
+
 
 };
 
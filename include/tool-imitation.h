@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sat Jun 17 20:18:23 CEST 2017
-// Last Modified: Sat Jun 17 22:40:59 CEST 2017
+// Last Modified: Mon Oct 19 23:02:41 PDT 2026
 // Filename:      tool-imitation.h
 // URL:           https://github.com/craigsapp/humlib/blob/master/include/tool-imitation.h
 // Syntax:        C++11; humlib
@@ -40,6 +40,14 @@ class Tool_imitation : public HumTool {
 		                            vector<vector<NoteCell*>>& attacks,
 		                            vector<vector<double>>& intervals,
 		                            int v1, int v2);
+		void    analyzeImitationBySuffixArray(vector<vector<string>>& results,
+		                            vector<vector<NoteCell*>>& attacks,
+		                            vector<vector<double>>& intervals);
+		void    buildSuffixArray   (vector<int>& sequence, vector<int>& suffixes,
+		                            vector<int>& lcp);
+		void    addImitation       (vector<vector<string>>& results,
+		                            vector<vector<NoteCell*>>& attacks,
+		                            int v1, int i, int v2, int j, int count);
 		void    getIntervals       (vector<double>& intervals,
 		                            vector<NoteCell*>& attacks);
 		int     compareSequences   (vector<NoteCell*>& attack1, vector<double>& seq1,
@@ -84,6 +92,7 @@ class Tool_imitation : public HumTool {
 		bool m_addsearches  = false;
 		bool m_inversion  = false;
 		bool m_retrograde = false;
+		bool m_suffixQ    = false;
 
 		vector<int> m_barlines;
 };
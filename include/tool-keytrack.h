@@ -0,0 +1,99 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 14:07:31 PDT 2026
+// Last Modified: Mon Oct 19 23:41:12 PDT 2026
+// Filename:      tool-keytrack.h
+// URL:           https://github.com/craigsapp/humlib/blob/master/include/tool-keytrack.h
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Track the key through a score with a sliding window.
+//
+
+#ifndef _TOOL_KEYTRACK_H_INCLUDED
+#define _TOOL_KEYTRACK_H_INCLUDED
+
+#include "HumTool.h"
+#include "HumdrumFile.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace hum {
+
+// START_MERGE
+
+class Tool_keytrack : public HumTool {
+	public:
+		            Tool_keytrack          (void);
+		           ~Tool_keytrack          () {};
+
+		bool        run                    (HumdrumFileSet& infiles);
+		bool        run                    (HumdrumFile& infile);
+		bool        run                    (const std::string& indata, std::ostream& out);
+		bool        run                    (HumdrumFile& infile, std::ostream& out);
+
+	protected:
+		void        initialize             (void);
+		void        processFile            (HumdrumFile& infile);
+		void        fillProfiles           (void);
+		void        fillPitchClassCurve    (HumdrumFile& infile);
+		void        fillMeasureTimes       (HumdrumFile& infile);
+		void        getCumulativeHistogram (double* histogram, double timepoint);
+		int         analyzeWindow          (double* correlations, double starttime,
+		                                    double endtime);
+		int         identifyKey            (double* correlations,
+		                                    const double* histogram);
+		void        getMeasureWindow       (int measure, double& starttime,
+		                                    double& endtime);
+		int         getMeasureIndex        (double timepoint);
+		void        addKeySpine            (HumdrumFile& infile);
+		void        printJson              (std::ostream& out, HumdrumFile& infile);
+		void        printJsonEntry         (std::ostream& out, double timepoint,
+		                                    int barnum, double starttime,
+		                                    double endtime);
+		std::string getKeyName             (int key);
+
+	private:
+		double      m_window = 8.0;        // used with -w option
+		double      m_hop = 1.0;           // used with --hop option
+		bool        m_measureQ = false;    // used with -m option
+		bool        m_jsonQ = false;       // used with -j option
+		bool        m_correlationsQ = false; // used with -c option
+		bool        m_krumhanslQ = false;  // used with -k option
+
+		// m_profiles: mean-centered key profiles scaled to unit length,
+		// for the 12 major keys followed by the 12 minor keys.  A Pearson
+		// correlation with a histogram is then a dot product divided by the
+		// length of the mean-centered histogram.
+		double      m_profiles[24][12];
+
+		// m_times: sorted times in quarter notes where notes start or stop.
+		std::vector<double> m_times;
+
+		// m_cumulative: duration-weighted pitch-class histogram of all notes
+		// before each time in m_times (12 values for each time).
+		std::vector<double> m_cumulative;
+
+		// m_sounding: number of notes of each pitch class sounding after
+		// each time in m_times (12 values for each time).
+		std::vector<double> m_sounding;
+
+		// m_measures: start times of measures, followed by the end of the
+		// score (used with -m option).
+		std::vector<double> m_measures;
+
+		// m_barnums: bar number of the barline at the start of each measure
+		// in m_measures, or -1 if there is none (used with -m option).
+		std::vector<int> m_barnums;
+};
+
+// END_MERGE
+
+} // end namespace hum
+
+#endif /* _TOOL_KEYTRACK_H_INCLUDED */
+
+
+
@@ -186,6 +186,8 @@ class Tool_mei2hum : public HumTool {
 		HumNum parseLigature        (xml_node staff, HumNum starttime);
 		int    extractStaffCountByFirstMeasure    (xml_node element);
 		int    extractStaffCountByScoreDef        (xml_node element);
+		xml_node getFirstDescendant               (xml_node element, const char* name);
+		int    countDescendants                   (xml_node element, const char* name);
 		HumNum parseRest            (xml_node chord, HumNum starttime);
 		HumNum parseRest_mensural   (xml_node chord, HumNum starttime);
 		HumNum parseMRest           (xml_node mrest, HumNum starttime);
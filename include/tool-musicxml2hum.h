@@ -219,6 +219,9 @@ class Tool_musicxml2hum : public HumTool {
 		void printResult       (ostream& out, HumdrumFile& outfile);
 		void addMeasureOneNumber(HumdrumFile& infile);
 		bool isUsedHairpin     (pugi::xml_node hairpin, int partindex);
+		bool hasPendingNodes   (void);
+		void releaseMeasureNodes(std::vector<MxmlPart>& partdata, int startm,
+		                        int stopm);
 
 	public:
 
@@ -230,6 +233,8 @@ class Tool_musicxml2hum : public HumTool {
 		bool VoiceDebugQ;
 		bool m_recipQ        = false;
 		bool m_stemsQ        = false;
+		bool m_releaseMeasuresQ = false;
+		int  m_threads       = 1;
 		int  m_slurabove     = 0;
 		int  m_slurbelow     = 0;
 		int  m_staffabove    = 0;
@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Wed Nov 30 20:36:38 PST 2016
-// Last Modified: Wed Nov 30 20:36:41 PST 2016
+// Last Modified: Mon Oct 19 17:52:08 PDT 2026
 // Filename:      tool-myank.h
 // URL:           https://github.com/craigsapp/humlib/blob/master/include/tool-myank.h
 // Syntax:        C++11; humlib
@@ -136,7 +136,12 @@ class Tool_myank : public HumTool {
 		void      printInvisibleMeasure(HumdrumFile& infile, int line);
 		void      fillGlobalDefaults   (HumdrumFile& infile,
 		                                std::vector<MeasureInfo>& measurein,
-		                                std::vector<int>& inmap);
+		                                std::vector<int>& inmap, int first,
+		                                int last);
+		void      fillIndexStates      (std::vector<MyCoord>& output,
+		                                const std::vector<HTp>& states,
+		                                std::vector<bool>& kernQ);
+		int       getGlobalStateType   (HTp token);
 		void      adjustGlobalInterpretations(HumdrumFile& infile, int ii,
 		                                std::vector<MeasureInfo>& outmeasures,
 		                                int index);
@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sat Sep  7 20:13:13 PDT 2019
-// Last Modified: Sat Sep  7 20:13:15 PDT 2019
+// Last Modified: Mon Oct 19 20:14:05 PDT 2026
 // Filename:      tool-pccount.h
 // URL:           https://github.com/craigsapp/humlib/blob/master/include/tool-pccount.h
 // Syntax:        C++11; humlib
@@ -15,6 +15,7 @@
 
 #include "HumTool.h"
 #include "HumdrumFile.h"
+#include "HumdrumFileStream.h"
 
 #include <map>
 #include <ostream>
@@ -25,6 +26,12 @@ namespace hum {
 
 // START_MERGE
 
+class _PitchClassCounts {
+	public:
+		std::string name;         // instrument name of voice ("" if none)
+		double      counts[40];   // counts of base-40 pitch classes
+};
+
 
 class Tool_pccount : public HumTool {
 	public:
@@ -35,6 +42,7 @@ class Tool_pccount : public HumTool {
 		bool  run                       (HumdrumFile& infile);
 		bool  run                       (const std::string& indata, std::ostream& out);
 		bool  run                       (HumdrumFile& infile, std::ostream& out);
+		bool  run                       (HumdrumFileStream& instream);
 
 	protected:
 		void   initialize               (HumdrumFile& infile);
@@ -67,6 +75,14 @@ class Tool_pccount : public HumTool {
 		int     getCount                (const std::string& pitchclass);
 		void    setFactorMaximum        (void);
 		void    setFactorNormalize      (void);
+		void    aggregateFiles          (HumdrumFileStream& instream);
+		void    countFileSegments       (HumdrumFileStream& instream,
+		                                 std::vector<std::string>& names,
+		                                 std::vector<std::vector<_PitchClassCounts>>& counts);
+		std::string getPartName         (HTp sstart);
+		void    mergeCounts             (std::vector<std::vector<_PitchClassCounts>>& counts);
+		void    printFileRows           (std::vector<std::string>& names,
+		                                 std::vector<std::vector<_PitchClassCounts>>& counts);
 
 	private:
 		std::vector<int>               m_rkern;
@@ -84,6 +100,8 @@ class Tool_pccount : public HumTool {
 		bool m_script       = false;
 		bool m_html         = false;
 		bool m_page         = false;
+		bool m_perFile      = false;
+		int  m_threads      = 1;
 		int  m_width        = 500;
 		double m_ratio      = 0.67;
 		bool m_key          = true;
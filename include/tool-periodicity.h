@@ -16,6 +16,7 @@
 #include "HumTool.h"
 #include "HumdrumFile.h"
 
+#include <complex>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -46,8 +47,18 @@ class Tool_periodicity : public HumTool {
 		void     printPeriodicityAnalysis(std::ostream& out, std::vector<std::vector<double>>& analysis);
 		void     printSvgAnalysis(std::ostream& out, std::vector<std::vector<double>>& analysis, HumNum minrhy);
 		void     getColorMapping(double input, double& hue, double& saturation, double& lightness);
+		void     processAutocorrelation(std::vector<double>& grid, HumNum minrhy);
+		void     doAutocorrelation  (std::vector<double>& output, std::vector<double>& grid, int start, int count, int maxlag);
+		void     printAutocorrelation(std::ostream& out, std::vector<double>& analysis, HumNum minrhy);
+		void     printWindowedAutocorrelation(std::ostream& out, std::vector<std::vector<double>>& analysis, std::vector<int>& starts, HumNum minrhy);
+		void     fft                (std::vector<std::complex<double>>& data, bool inverse);
 
 	private:
+		// m_buffer: FFT data for autocorrelation analysis.
+		std::vector<std::complex<double>> m_buffer;
+
+		// m_twiddle: FFT twiddle factors for the current size of m_buffer.
+		std::vector<std::complex<double>> m_twiddle;
 
 };
 
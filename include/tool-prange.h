@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jul 18 11:23:42 PDT 2005
-// Last Modified: Sat Jun  8 17:37:39 PDT 2024 (ported to humlib)
+// Last Modified: Mon Oct 19 20:14:05 PDT 2026
 // Filename:      include/tool-prange.h
 // URL:           https://github.com/craigsapp/humlib/blob/master/include/tool-prange.h
 // Syntax:        C++11; humlib
@@ -15,6 +15,7 @@
 
 #include "HumTool.h"
 #include "HumdrumFileSet.h"
+#include "HumdrumFileStream.h"
 
 #include <map>
 #include <ostream>
@@ -50,6 +51,14 @@ class _VoiceInfo {
 
 
 
+class _VoiceBins {
+	public:
+		std::string         name;      // instrument name of voice ("" if none)
+		std::vector<double> midibins;  // MIDI pitch histogram of voice
+};
+
+
+
 class Tool_prange : public HumTool {
 	public:
 		         Tool_prange       (void);
@@ -59,6 +68,7 @@ class Tool_prange : public HumTool {
 		bool        run               (HumdrumFile& infile);
 		bool        run               (const std::string& indata, std::ostream& out);
 		bool        run               (HumdrumFile& infile, std::ostream& out);
+		bool        run               (HumdrumFileStream& instream);
 
 	protected:
 		void        processFile         (HumdrumFile& infile);
@@ -115,6 +125,14 @@ class Tool_prange : public HumTool {
 		void        doExtremaMarkup             (HumdrumFile& infile);
 		void        applyMarkup                 (std::vector<std::pair<HTp, int>>& notelist,
 		                                         const std::string& mark);
+		void        aggregateFiles              (HumdrumFileStream& instream);
+		void        countFileSegments           (HumdrumFileStream& instream,
+		                                         std::vector<std::string>& names,
+		                                         std::vector<std::vector<_VoiceBins>>& voices);
+		void        printFileRows               (std::ostream& out,
+		                                         const std::string& exinterp,
+		                                         std::vector<std::string>& names,
+		                                         std::vector<std::vector<double>>& bins);
 
 	private:
 
@@ -144,6 +162,9 @@ class Tool_prange : public HumTool {
 		bool m_scoreQ       = false; // for --score option
 		bool m_titleQ       = false; // for --title option
 		bool m_extremaQ     = false; // for --extrema option
+		bool m_aggregateQ   = false; // for --aggregate option
+		bool m_perFileQ     = false; // for --per-file option
+		int  m_threads      = 1;     // for --threads option
 
 		std::string m_highMark = "🌸";
 		std::string m_lowMark  = "🟢";
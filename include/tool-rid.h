@@ -15,6 +15,7 @@
 
 #include "HumTool.h"
 #include "HumdrumFile.h"
+#include "HumdrumLineStream.h"
 
 #include <ostream>
 #include <string>
@@ -32,9 +33,13 @@ class Tool_rid : public HumTool {
 		bool     run               (HumdrumFile& infile);
 		bool     run               (const std::string& indata, std::ostream& out);
 		bool     run               (HumdrumFile& infile, std::ostream& out);
+		bool     run               (HumdrumLineStream& instream, std::ostream& out);
 
 	protected:
 		void     processFile       (HumdrumFile& infile);
+		bool     processStream     (HumdrumLineStream& instream, std::ostream& out);
+		template <class LINE>
+		void     processLine       (LINE& line, std::ostream& out);
 		void     initialize        (void);
 
 	private:
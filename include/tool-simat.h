@@ -18,6 +18,7 @@
 
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace hum {
@@ -108,6 +109,14 @@ class MeasureComparisonGrid {
 		void         analyze                   (MeasureDataSet& set1, MeasureDataSet& set2);
 		void         analyze                   (MeasureDataSet* set1, MeasureDataSet* set2);
 
+		void         setBand                   (int band);
+		void         setTopCount               (int count);
+		void         setThreadCount            (int count);
+		int          getRowCount               (void);
+		int          getColumnCount            (void);
+		bool         isCalculated              (int row, int col);
+		double       getCorrelation7pc         (int row, int col);
+
 		double       getStartTime1             (int index);
 		double       getStopTime1              (int index);
 		double       getDuration1              (int index);
@@ -129,10 +138,58 @@ class MeasureComparisonGrid {
 		void         getColorMapping           (double input, double& hue, double& saturation,
 				 double& lightness);
 
+	protected:
+		static void  prepareFeatures           (MeasureDataSet& set,
+		                                        std::vector<double>& features,
+		                                        std::vector<char>& silent);
+		void         calculateRows             (int startrow, int stoprow);
+		void         calculateTopRow           (int row);
+		static double correlateFeatures        (const double* a, const double* b);
+
 	private:
-		std::vector<std::vector<MeasureComparison>> m_grid;
+		// m_features1, m_features2: The 7-pc histograms of each measure,
+		// mean-centered, normalized to unit length and padded to
+		// m_featureSize values so that the Pearson correlation of two
+		// measures is the dot product of their feature vectors.
+		std::vector<double> m_features1;
+		std::vector<double> m_features2;
+
+		// m_silent1, m_silent2: True for measures without any notes.
+		std::vector<char>   m_silent1;
+		std::vector<char>   m_silent2;
+
+		// m_rows, m_cols: The size of the similarity matrix.
+		int m_rows = 0;
+		int m_cols = 0;
+
+		// m_band: Only compare measures within this distance from the
+		// diagonal (or all measures if negative).
+		int m_band = -1;
+
+		// m_top: Only keep this many of the most similar measures
+		// for each row (or all measures if zero or less).
+		int m_top = 0;
+
+		// m_threads: Number of threads to use for the calculations (or
+		// the number of hardware threads if zero or less).
+		int m_threads = 1;
+
+		// m_values: Correlations stored in row order.  For a full matrix,
+		// each row has m_cols entries.  Otherwise, m_rowStart gives the
+		// index of the first entry of each row in m_values and m_columns
+		// gives the column of each entry.
+		std::vector<double> m_values;
+		std::vector<int>    m_rowStart;
+		std::vector<int>    m_columns;
+
+		// m_topRows: Temporary storage for the top-k calculations.
+		std::vector<std::vector<std::pair<int, double>>> m_topRows;
+
 		MeasureDataSet* m_set1 = NULL;
 		MeasureDataSet* m_set2 = NULL;
+
+		static const int m_featureSize = 8;
+		static const int m_blockSize = 64;
 };
 
 
@@ -254,7 +254,7 @@ bool GridSlice::isDataSlice(void) {
 //////////////////////////////
 //
 // GridSlice::transferTokens -- Create a HumdrumLine and append it to
-//    the data.
+//    the data.  The line stores the timestamp and duration of the slice.
 //
 
 void GridSlice::transferTokens(HumdrumFile& outfile, bool recip) {
@@ -380,6 +380,10 @@ void GridSlice::transferTokens(HumdrumFile& outfile, bool recip) {
 		}
 	}
 
+	// Used by HumdrumFile::analyzeFromGridTokens():
+	line->setDurationFromStart(getTimestamp());
+	line->setDuration(getDuration());
+
 	outfile.appendLine(line);
 }
 
@@ -0,0 +1,471 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 09:12:41 PDT 2026
+// Last Modified: Mon Oct 19 09:12:44 PDT 2026
+// Filename:      HumBinaryIo.cpp
+// URL:           https://github.com/craigsapp/humlib/blob/master/src/HumBinaryIo.cpp
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Helper classes for reading and writing the binary
+//                (.humbin) representation of analyzed Humdrum files.
+//
+
+#include "HumBinaryIo.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+namespace hum {
+
+// START_MERGE
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::HumBinaryWriter --
+//
+
+HumBinaryWriter::HumBinaryWriter(ostream& out) {
+	m_out = &out;
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::~HumBinaryWriter --
+//
+
+HumBinaryWriter::~HumBinaryWriter() {
+	// do nothing
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::writeUInt8 -- Write the lowest byte of the value.
+//
+
+void HumBinaryWriter::writeUInt8(int value) {
+	m_out->put((char)(value & 0xff));
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::writeInt32 -- Write a signed 32-bit integer in
+//     little-endian byte order.
+//
+
+void HumBinaryWriter::writeInt32(int value) {
+	writeUInt32((unsigned int)value);
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::writeUInt32 -- Write an unsigned 32-bit integer in
+//     little-endian byte order.
+//
+
+void HumBinaryWriter::writeUInt32(unsigned int value) {
+	char bytes[4];
+	bytes[0] = (char)(value & 0xff);
+	bytes[1] = (char)((value >> 8) & 0xff);
+	bytes[2] = (char)((value >> 16) & 0xff);
+	bytes[3] = (char)((value >> 24) & 0xff);
+	m_out->write(bytes, 4);
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::writeUInt64 -- Write an unsigned 64-bit integer in
+//     little-endian byte order.
+//
+
+void HumBinaryWriter::writeUInt64(unsigned long long value) {
+	writeUInt32((unsigned int)(value & 0xffffffffULL));
+	writeUInt32((unsigned int)((value >> 32) & 0xffffffffULL));
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::writeVarUInt -- Write an unsigned integer in 7-bit
+//     chunks, with the high bit of each byte set if more bytes follow.
+//     Values less than 128 are stored in a single byte.
+//
+
+void HumBinaryWriter::writeVarUInt(unsigned int value) {
+	while (value >= 0x80) {
+		m_out->put((char)((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	m_out->put((char)value);
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::writeVarInt -- Write a signed integer as a variable-length
+//     integer.  Small negative numbers (such as -1 for undefined values) are
+//     mapped to small positive numbers before storage.
+//
+
+void HumBinaryWriter::writeVarInt(int value) {
+	writeVarUInt(((unsigned int)value << 1) ^ (unsigned int)(value >> 31));
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::writeString -- Write a string preceded by its
+//     byte length.
+//
+
+void HumBinaryWriter::writeString(const string& value) {
+	writeVarUInt((unsigned int)value.size());
+	m_out->write(value.data(), value.size());
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::writeHumNum -- Write a rational number as a
+//    numerator/denominator pair.
+//
+
+void HumBinaryWriter::writeHumNum(const HumNum& value) {
+	writeVarInt(value.getNumerator());
+	writeVarInt(value.getDenominator());
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::writeBytes --
+//
+
+void HumBinaryWriter::writeBytes(const char* data, size_t size) {
+	m_out->write(data, size);
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryWriter::isValid -- Returns false if the output stream
+//     is in an error state.
+//
+
+bool HumBinaryWriter::isValid(void) {
+	return m_out->good();
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::HumBinaryReader --
+//
+
+HumBinaryReader::HumBinaryReader(void) {
+	// do nothing
+}
+
+
+HumBinaryReader::HumBinaryReader(const char* data, size_t size) {
+	setBuffer(data, size);
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::~HumBinaryReader --
+//
+
+HumBinaryReader::~HumBinaryReader() {
+	close();
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::open -- Map a file into memory for reading.  If
+//     memory mapping is not available, then the file contents are
+//     copied into an internal buffer.  Returns false if the file could
+//     not be read.
+//
+
+bool HumBinaryReader::open(const string& filename) {
+	close();
+
+#ifndef _WIN32
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		m_error = true;
+		return false;
+	}
+	struct stat info;
+	if ((fstat(fd, &info) != 0) || (info.st_size <= 0)) {
+		::close(fd);
+		m_error = true;
+		return false;
+	}
+	void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mapping != MAP_FAILED) {
+		m_data   = (const char*)mapping;
+		m_size   = (size_t)info.st_size;
+		m_pos    = 0;
+		m_error  = false;
+		m_mapped = true;
+		return true;
+	}
+#endif
+
+	ifstream input(filename, ios::binary);
+	if (!input.is_open()) {
+		m_error = true;
+		return false;
+	}
+	stringstream contents;
+	contents << input.rdbuf();
+	m_buffer = contents.str();
+	setBuffer(m_buffer.data(), m_buffer.size());
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::close -- Release any mapped file or buffer.
+//
+
+void HumBinaryReader::close(void) {
+#ifndef _WIN32
+	if (m_mapped && m_data) {
+		munmap((void*)m_data, m_size);
+	}
+#endif
+	m_mapped = false;
+	m_data   = NULL;
+	m_size   = 0;
+	m_pos    = 0;
+	m_error  = false;
+	m_buffer.clear();
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::setBuffer -- Read from external memory (which is not
+//     owned by the reader).
+//
+
+void HumBinaryReader::setBuffer(const char* data, size_t size) {
+	if (m_mapped) {
+		close();
+	}
+	m_data  = data;
+	m_size  = size;
+	m_pos   = 0;
+	m_error = false;
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::require -- Check that the given number of bytes
+//     is available for reading.  Sets the error state if not.
+//
+
+bool HumBinaryReader::require(size_t count) {
+	if (m_error) {
+		return false;
+	}
+	if ((m_data == NULL) || (count > m_size - m_pos)) {
+		m_error = true;
+		return false;
+	}
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::readUInt8 --
+//
+
+int HumBinaryReader::readUInt8(void) {
+	if (!require(1)) {
+		return 0;
+	}
+	return (unsigned char)m_data[m_pos++];
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::readInt32 --
+//
+
+int HumBinaryReader::readInt32(void) {
+	return (int)readUInt32();
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::readUInt32 --
+//
+
+unsigned int HumBinaryReader::readUInt32(void) {
+	if (!require(4)) {
+		return 0;
+	}
+	const unsigned char* p = (const unsigned char*)(m_data + m_pos);
+	m_pos += 4;
+	return (unsigned int)p[0]
+	     | ((unsigned int)p[1] << 8)
+	     | ((unsigned int)p[2] << 16)
+	     | ((unsigned int)p[3] << 24);
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::readUInt64 --
+//
+
+unsigned long long HumBinaryReader::readUInt64(void) {
+	unsigned long long low  = readUInt32();
+	unsigned long long high = readUInt32();
+	return low | (high << 32);
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::readVarUInt -- Read a variable-length unsigned integer.
+//
+
+unsigned int HumBinaryReader::readVarUInt(void) {
+	unsigned int value = 0;
+	int shift = 0;
+	while (require(1)) {
+		unsigned char byte = (unsigned char)m_data[m_pos++];
+		value |= (unsigned int)(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0) {
+			return value;
+		}
+		shift += 7;
+		if (shift > 28) {
+			m_error = true;
+			break;
+		}
+	}
+	return 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::readVarInt -- Read a variable-length signed integer.
+//
+
+int HumBinaryReader::readVarInt(void) {
+	unsigned int value = readVarUInt();
+	return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::readString --
+//
+
+string HumBinaryReader::readString(void) {
+	string output;
+	readString(output);
+	return output;
+}
+
+
+void HumBinaryReader::readString(string& value) {
+	size_t length = readVarUInt();
+	if (!require(length)) {
+		value.clear();
+		return;
+	}
+	value.assign(m_data + m_pos, length);
+	m_pos += length;
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::readHumNum --
+//
+
+HumNum HumBinaryReader::readHumNum(void) {
+	int top = readVarInt();
+	int bot = readVarInt();
+	if (bot == 0) {
+		// Corrupt data, and HumNum does not allow a zero denominator.
+		m_error = true;
+		return 0;
+	}
+	return HumNum(top, bot);
+}
+
+
+
+//////////////////////////////
+//
+// HumBinaryReader::readBytes --
+//
+
+bool HumBinaryReader::readBytes(char* data, size_t size) {
+	if (!require(size)) {
+		return false;
+	}
+	memcpy(data, m_data + m_pos, size);
+	m_pos += size;
+	return true;
+}
+
+
+// END_MERGE
+
+} // end namespace hum
+
+
+
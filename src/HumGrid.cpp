@@ -1498,14 +1498,21 @@ void HumGrid::addLastMeasure(void) {
 		return;
 	}
 
-	// probably not the correct timestamp, but probably not important
-	// to get correct:
+	// The final barline is placed at the end of the last measure if its
+	// duration is known (the line times are used by
+	// HumdrumFile::analyzeFromGridTokens()).
 	HumNum timestamp = model->getTimestamp();
 
 	if (this->empty()) {
 		return;
 	}
 	GridMeasure* measure = this->back();
+	if (measure->getDuration() > 0) {
+		HumNum endtime = measure->getTimestamp() + measure->getDuration();
+		if (endtime > timestamp) {
+			timestamp = endtime;
+		}
+	}
 
 	string barstyle = getBarStyle(measure);
 
@@ -0,0 +1,312 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 05:02:44 PDT 2026
+// Last Modified: Mon Oct 19 18:31:40 PDT 2026
+// Filename:      HumMidiExport.cpp
+// URL:           https://github.com/craigsapp/humlib/blob/master/src/HumMidiExport.cpp
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Convert the **kern spines of a Humdrum file into a
+//                MidiFile.  Each **kern spine is placed in a separate MIDI
+//                track after a tempo track, with note times calculated in
+//                integer ticks from the rhythmic analysis of the file.
+//
+//                This file does not have merge markers, so it is compiled
+//                into the humlib library but is not part of the min
+//                distribution, which does not depend on midifile.
+//
+
+#include "HumMidiExport.h"
+#include "Convert.h"
+
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+using namespace smf;
+
+namespace hum {
+
+
+//////////////////////////////
+//
+// HumMidiExport::HumMidiExport --
+//
+
+HumMidiExport::HumMidiExport(void) {
+	// do nothing
+}
+
+
+
+//////////////////////////////
+//
+// HumMidiExport::~HumMidiExport --
+//
+
+HumMidiExport::~HumMidiExport() {
+	// do nothing
+}
+
+
+
+//////////////////////////////
+//
+// HumMidiExport::convert -- Convert the **kern spines of the input file
+//    into MIDI tracks.  Track 0 contains the tempo map from *MM
+//    interpretations, and **kern spine n is stored in track n+1.  Tied
+//    notes are converted into a single note.  The output is left in
+//    absolute tick mode with sorted tracks.  Returns false if the input
+//    does not contain any **kern data.
+//
+
+bool HumMidiExport::convert(HumdrumFile& infile, MidiFile& outfile) {
+	m_midifile = &outfile;
+	outfile.clear();
+	outfile.absoluteTicks();
+
+	vector<HTp> kernstarts = infile.getKernSpineStartList();
+	int kerncount = (int)kernstarts.size();
+	if (kerncount == 0) {
+		return false;
+	}
+	outfile.addTracks(kerncount);
+
+	int tpq = m_tpq > 0 ? m_tpq : infile.tpq();
+	if (tpq <= 0) {
+		tpq = 1;
+	} else if (tpq > 0x7fff) {
+		// Too large for the MIDI file header, so round to a common value.
+		tpq = 960;
+	}
+	outfile.setTPQ(tpq);
+	m_scale = tpq;
+
+	m_trackToKern = infile.getTrackToKernIndex();
+	m_named.assign(kerncount + 1, false);
+	m_tieEnd.assign(kerncount * 128, -1);
+	m_lastTempoTick = -1;
+
+	for (int i=0; i<infile.getLineCount(); i++) {
+		HumdrumLine& line = infile[i];
+		if (!line.hasSpines()) {
+			continue;
+		}
+		if (line.isInterpretation()) {
+			int tick = getTick(line.getDurationFromStart());
+			addTempos(line, tick);
+			addTrackNames(line, tick);
+			continue;
+		}
+		if (!line.isData()) {
+			continue;
+		}
+		int tick = getTick(line.getDurationFromStart());
+		for (int j=0; j<line.getFieldCount(); j++) {
+			HTp token = line.token(j);
+			if (!token->isKern() || token->isNull()) {
+				continue;
+			}
+			addNotes(token, tick);
+		}
+	}
+	flushTies();
+
+	if (m_lastTempoTick < 0) {
+		outfile.addTempo(0, 0, m_tempo);
+	}
+
+	outfile.sortTracks();
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumMidiExport::getTick -- Convert a time in quarter notes to ticks.
+//
+
+int HumMidiExport::getTick(HumNum timestamp) {
+	HumNum value = timestamp * m_scale;
+	if (value.getDenominator() == 1) {
+		return value.getNumerator();
+	}
+	return (int)(value.getFloat() + 0.5);
+}
+
+
+
+//////////////////////////////
+//
+// HumMidiExport::getChannel -- Assign MIDI channels to **kern spines in
+//    order, skipping the percussion channel (channel 10).
+//
+
+int HumMidiExport::getChannel(int kernindex) {
+	int channel = kernindex % 15;
+	if (channel >= 9) {
+		channel++;
+	}
+	return channel;
+}
+
+
+
+//////////////////////////////
+//
+// HumMidiExport::addTempos -- Store tempo changes from *MM interpretations
+//    in track 0.  Only one tempo is stored for each time.
+//
+
+void HumMidiExport::addTempos(HumdrumLine& line, int tick) {
+	if (tick == m_lastTempoTick) {
+		return;
+	}
+	for (int i=0; i<line.getFieldCount(); i++) {
+		HTp token = line.token(i);
+		if (!token->isTempo()) {
+			continue;
+		}
+		double tempo = atof(token->c_str() + 3);
+		if (tempo <= 0.0) {
+			continue;
+		}
+		m_midifile->addTempo(0, tick, tempo);
+		m_lastTempoTick = tick;
+		return;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumMidiExport::addTrackNames -- Use instrument names (*I") as the
+//    names of the MIDI tracks.
+//
+
+void HumMidiExport::addTrackNames(HumdrumLine& line, int tick) {
+	for (int i=0; i<line.getFieldCount(); i++) {
+		HTp token = line.token(i);
+		if (token->compare(0, 3, "*I\"") != 0) {
+			continue;
+		}
+		int kernindex = m_trackToKern.at(token->getTrack());
+		if (kernindex < 0) {
+			continue;
+		}
+		if (m_named.at(kernindex + 1)) {
+			continue;
+		}
+		m_midifile->addTrackName(kernindex + 1, tick, token->substr(3));
+		m_named[kernindex + 1] = true;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumMidiExport::addNotes -- Add the notes of a **kern token (one for each
+//    subtoken of a chord).  Grace notes are not converted.
+//
+
+void HumMidiExport::addNotes(HTp token, int tick) {
+	HumNum duration = token->getDuration();
+	if (duration <= 0) {
+		return;
+	}
+	if (token->isRest()) {
+		return;
+	}
+	int kernindex = m_trackToKern.at(token->getTrack());
+	if (kernindex < 0) {
+		return;
+	}
+	int endtick = getTick(token->getDurationFromStart() + duration);
+
+	if (!token->isChord()) {
+		addNote(*token, kernindex, tick, endtick);
+		return;
+	}
+	int count = token->getSubtokenCount();
+	for (int i=0; i<count; i++) {
+		addNote(token->getSubtoken(i), kernindex, tick, endtick);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumMidiExport::addNote -- Add a note for a single **kern subtoken.  Notes
+//    at the start or in the middle of a tie extend the sounding note, which
+//    is turned off at the end of the tie.
+//
+
+void HumMidiExport::addNote(const string& subtoken, int kernindex,
+		int tick, int endtick) {
+	if (Convert::isKernRest(subtoken)) {
+		// Non-sounding note in a chord.
+		return;
+	}
+	int key = Convert::kernToMidiNoteNumber(subtoken);
+	if ((key < 0) || (key > 127)) {
+		return;
+	}
+	bool tiestart = subtoken.find('[') != string::npos;
+	bool secondary = Convert::isKernSecondaryTiedNote(subtoken);
+	bool tieend = secondary && (subtoken.find(']') != string::npos);
+
+	int track = kernindex + 1;
+	int channel = getChannel(kernindex);
+	int& tie = m_tieEnd[kernindex * 128 + key];
+	if (secondary && (tie >= 0)) {
+		if (tieend) {
+			m_midifile->addNoteOff(track, endtick, channel, key);
+			tie = -1;
+		} else {
+			tie = endtick;
+		}
+		return;
+	}
+
+	if (tie >= 0) {
+		// previous tie on the same key was not closed
+		m_midifile->addNoteOff(track, tick, channel, key);
+		tie = -1;
+	}
+	m_midifile->addNoteOn(track, tick, channel, key, m_velocity);
+	if (tiestart || (secondary && !tieend)) {
+		tie = endtick;
+	} else {
+		m_midifile->addNoteOff(track, endtick, channel, key);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumMidiExport::flushTies -- Turn off tied notes which did not end
+//    before the end of the data.
+//
+
+void HumMidiExport::flushTies(void) {
+	for (int i=0; i<(int)m_tieEnd.size(); i++) {
+		if (m_tieEnd[i] < 0) {
+			continue;
+		}
+		int kernindex = i / 128;
+		m_midifile->addNoteOff(kernindex + 1, m_tieEnd[i], getChannel(kernindex), i % 128);
+		m_tieEnd[i] = -1;
+	}
+}
+
+
+} // end namespace hum
+
+
+
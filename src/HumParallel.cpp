@@ -0,0 +1,112 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 22:31:08 PDT 2026
+// Last Modified: Mon Oct 19 22:31:08 PDT 2026
+// Filename:      HumParallel.cpp
+// URL:           https://github.com/craigsapp/humlib/blob/master/src/HumParallel.cpp
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Process a list of independent work items (such as files,
+//                parts or blocks of rows) in several threads.
+//
+
+#include "HumParallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace hum {
+
+// START_MERGE
+
+
+//////////////////////////////
+//
+// HumParallel::getThreadCount -- Return the number of threads to use for
+//     the given number of work items.  A thread count of 0 (or less) means
+//     to use one thread for each core.  There are never more threads than
+//     work items, and always at least one thread.
+//
+
+int HumParallel::getThreadCount(int threads, int count) {
+	int output = threads;
+	if (output <= 0) {
+		output = (int)std::thread::hardware_concurrency();
+	}
+	return std::max(1, std::min(output, count));
+}
+
+
+
+//////////////////////////////
+//
+// HumParallel::run -- Call the function for each work item from 0 to
+//     count-1.  Each thread takes the next item from a shared counter, so
+//     the items may be processed in any order and must not depend on each
+//     other.  If there is only one thread, the items are processed in order
+//     in the calling thread.  If threads cannot be created, the calling
+//     thread processes the remaining items.
+//
+
+void HumParallel::run(int count, int threads,
+		const std::function<void(int)>& function) {
+	runWorkers(count, threads, [&function](int item, int) { function(item); });
+}
+
+
+
+//////////////////////////////
+//
+// HumParallel::runWorkers -- Same as run(), but the function is also given
+//     the index of the thread which processes the item (from 0 to
+//     getThreadCount(threads, count)-1), so that each thread can keep its
+//     own results which are combined after all items are processed.  The
+//     calling thread is worker 0.
+//
+
+void HumParallel::runWorkers(int count, int threads,
+		const std::function<void(int, int)>& function) {
+	int threadcount = getThreadCount(threads, count);
+	if (threadcount == 1) {
+		for (int i=0; i<count; i++) {
+			function(i, 0);
+		}
+		return;
+	}
+
+	std::atomic<int> nextitem(0);
+	auto worker = [&](int index) {
+		int i;
+		while ((i = nextitem++) < count) {
+			function(i, index);
+		}
+	};
+
+	vector<std::thread> workers;
+	for (int i=1; i<threadcount; i++) {
+		try {
+			workers.emplace_back(worker, i);
+		} catch (const std::system_error&) {
+			// Threads are not available, so finish in this thread.
+			break;
+		}
+	}
+	worker(0);
+	for (int i=0; i<(int)workers.size(); i++) {
+		workers[i].join();
+	}
+}
+
+
+// END_MERGE
+
+} // end namespace hum
+
+
+
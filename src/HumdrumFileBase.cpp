@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sat Aug  8 12:24:49 PDT 2015
-// Last Modified: Fri Aug 14 21:57:09 PDT 2015
+// Last Modified: Mon Oct 19 21:40:31 PDT 2026
 // Filename:      HumdrumFileBase.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/src/HumdrumFileBase.cpp
 // Syntax:        C++11; humlib
@@ -20,6 +20,7 @@
 #include "HumdrumFileBase.h"
 
 #include <cstdarg>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <sstream>
@@ -119,6 +120,7 @@ HumdrumFileBase& HumdrumFileBase::operator=(HumdrumFileBase& infile) {
 	m_quietParse = infile.m_quietParse;
 	m_parseError = infile.m_parseError;
 	m_displayError = infile.m_displayError;
+	clearAnalysisCache();
 
 	m_lines.resize(infile.m_lines.size());
 	for (int i=0; i<(int)m_lines.size(); i++) {
@@ -219,6 +221,24 @@ bool HumdrumFileBase::areStrophesAnalyzed(void) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBase::clearAnalysisCache -- Remove the derived analyses
+//     stored with setCachedAnalysis().  This is done automatically when
+//     lines are added or removed, when the file is re-analyzed, or when
+//     the line text is regenerated from the tokens, but should be called
+//     by any code which changes tokens in some other way while cached
+//     analyses may still be used.  The measure index is also rebuilt
+//     when it is next needed, since it stores line indexes.
+//
+
+void HumdrumFileBase::clearAnalysisCache(void) {
+	m_analyses.m_cache.clear();
+	m_analyses.m_measures_analyzed = false;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFileBase::setXmlIdPrefix -- Set the prefix for a HumdrumXML ID
@@ -839,6 +859,7 @@ vector<int> HumdrumFileBase::getTrackWidths(void) {
 //
 
 void HumdrumFileBase::createLinesFromTokens(void) {
+	clearAnalysisCache();
 	for (int i=0; i<(int)m_lines.size(); i++) {
 		m_lines[i]->createLineFromTokens();
 	}
@@ -853,12 +874,14 @@ void HumdrumFileBase::createLinesFromTokens(void) {
 //
 
 void HumdrumFileBase::appendLine(const string& line) {
+	clearAnalysisCache();
 	HLp s = new HumdrumLine(line);
 	m_lines.push_back(s);
 }
 
 
 void HumdrumFileBase::appendLine(HLp line) {
+	clearAnalysisCache();
 	// deletion will be handled by class.
 	m_lines.push_back(line);
 }
@@ -872,6 +895,7 @@ void HumdrumFileBase::appendLine(HLp line) {
 //
 
 void HumdrumFileBase::insertLine(int index, const string& line) {
+	clearAnalysisCache();
 	HLp s = new HumdrumLine(line);
 	m_lines.insert(m_lines.begin() + index, s);
 
@@ -883,6 +907,7 @@ void HumdrumFileBase::insertLine(int index, const string& line) {
 
 
 void HumdrumFileBase::insertLine(int index, HLp line) {
+	clearAnalysisCache();
 	// deletion will be handled by class.
 	m_lines.insert(m_lines.begin() + index, line);
 
@@ -894,6 +919,33 @@ void HumdrumFileBase::insertLine(int index, HLp line) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBase::insertLines -- Insert a list of lines before the given
+//    line index.  The lines are stored in the file in the same order as in
+//    the list.  This is faster than calling insertLine() for each line, since
+//    the following lines are moved only once.
+//
+
+void HumdrumFileBase::insertLines(int index, const vector<string>& lines) {
+	if (lines.empty()) {
+		return;
+	}
+	clearAnalysisCache();
+	vector<HLp> newlines(lines.size());
+	for (int i=0; i<(int)lines.size(); i++) {
+		newlines[i] = new HumdrumLine(lines[i]);
+	}
+	m_lines.insert(m_lines.begin() + index, newlines.begin(), newlines.end());
+
+	// Update the line indexes for the new lines and the following ones:
+	for (int i=index; i<(int)m_lines.size(); i++) {
+		m_lines[i]->setLineIndex(i);
+	}
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFileBase::deleteLine -- remove a line from the Humdrum file.
@@ -909,6 +961,7 @@ void HumdrumFileBase::deleteLine(int index) {
 	if (index < 0) {
 		return;
 	}
+	clearAnalysisCache();
 	delete m_lines[index];
 	for (int i=index+1; i<(int)m_lines.size(); i++) {
 		m_lines[i-1] = m_lines[i];
@@ -1699,6 +1752,128 @@ bool HumdrumFileBase::stitchLinesTogether(HumdrumLine& previous,
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBase::analyzeGridSpines -- Assign the field indexes, spine
+//    info, tracks and spine links of all tokens in one pass over the lines.
+//    This is used for files created by HumGrid::transferTokens(), where
+//    the only spine manipulators are *^, *v and *-.  Returns false without
+//    setting a parse error if the lines contain anything else (such as
+//    *x or *+ manipulators), in which case analyzeSpines(), analyzeLinks()
+//    and analyzeTracks() have to be used instead.
+//
+
+bool HumdrumFileBase::analyzeGridSpines(void) {
+	clearTokenLinkInfo();
+	m_trackstarts.resize(0);
+	m_trackends.resize(0);
+	addToTrackStarts(NULL);
+
+	vector<string> sinfo;
+	vector<int> tracks;
+	vector<string> newinfo;
+	vector<int> newtracks;
+	HLp previous = NULL;
+
+	for (int i=0; i<(int)m_lines.size(); i++) {
+		HumdrumLine& line = *m_lines[i];
+		if (!line.hasSpines()) {
+			line.token(0)->setFieldIndex(0);
+			continue;
+		}
+		int count = line.getTokenCount();
+		if (previous == NULL) {
+			if (!line.isExclusive()) {
+				return false;
+			}
+			sinfo.resize(count);
+			tracks.resize(count);
+			for (int j=0; j<count; j++) {
+				sinfo[j] = to_string(j+1);
+				tracks[j] = j+1;
+				addToTrackStarts(line.token(j));
+			}
+		} else {
+			// Follow the spines from the previous line to this one:
+			newinfo.clear();
+			newtracks.clear();
+			int ii = 0;
+			for (int j=0; j<previous->getTokenCount(); j++) {
+				HTp token = previous->token(j);
+				if (token->isTerminateInterpretation()) {
+					continue;
+				}
+				int nextcount = 1;
+				if (!token->isManipulator() || token->isExclusiveInterpretation()) {
+					newinfo.push_back(sinfo[j]);
+				} else if (*token == "*^") {
+					newinfo.push_back("(" + sinfo[j] + ")a");
+					newinfo.push_back("(" + sinfo[j] + ")b");
+					nextcount = 2;
+				} else if (token->isMergeInterpretation()) {
+					int mergecount = 0;
+					while ((j + mergecount + 1 < previous->getTokenCount()) &&
+							previous->token(j + mergecount + 1)->isMergeInterpretation()) {
+						mergecount++;
+					}
+					if (ii >= count) {
+						return false;
+					}
+					for (int k=0; k<=mergecount; k++) {
+						previous->token(j+k)->makeForwardLink(*line.token(ii));
+					}
+					newinfo.push_back(getMergedSpineInfo(sinfo, j, mergecount));
+					newtracks.push_back(tracks[j]);
+					ii++;
+					j += mergecount;
+					continue;
+				} else {
+					return false;
+				}
+				if (ii + nextcount > count) {
+					return false;
+				}
+				for (int k=0; k<nextcount; k++) {
+					token->makeForwardLink(*line.token(ii++));
+					newtracks.push_back(tracks[j]);
+				}
+			}
+			if (ii != count) {
+				return false;
+			}
+			sinfo.swap(newinfo);
+			tracks.swap(newtracks);
+		}
+
+		// Tracks with more than one spine on the line have subtracks:
+		vector<int> subtracks(m_trackstarts.size(), 0);
+		vector<int> cursub(m_trackstarts.size(), 0);
+		for (int j=0; j<count; j++) {
+			subtracks[tracks[j]]++;
+		}
+		for (int j=0; j<count; j++) {
+			HTp token = line.token(j);
+			token->setFieldIndex(j);
+			token->setSpineInfo(sinfo[j]);
+			token->setTrack(tracks[j]);
+			if (subtracks[tracks[j]] > 1) {
+				token->setSubtrack(++cursub[tracks[j]]);
+			} else {
+				token->setSubtrack(0);
+			}
+			token->setSubtrackCount(subtracks[tracks[j]]);
+			if (token->isTerminateInterpretation()) {
+				// stored in the same list as adjustSpines() uses:
+				m_trackends[m_trackstarts.size()-1].push_back(token);
+			}
+		}
+		previous = m_lines[i];
+	}
+	return true;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFileBase::analyzeSpines -- Analyze the spine structure of the
@@ -2489,12 +2664,16 @@ int HumdrumFileBase::getMeasureNumber(int line) {
       // to return the measure number of the previous barline.
       return -1;
    }
-   HumRegex hre;
-   int measurenumber = -1;
+   // Same as searching for /^=[^\d]*(\d+)/ in each field, but avoids
+   // compiling a regular expression for every barline.
    for (j=0; j<infile[line].getFieldCount(); j++) {
-      if (hre.search(*infile.token(line, j), "^=[^\\d]*(\\d+)")) {
-         measurenumber = hre.getMatchInt(1);
-         return measurenumber;
+      const string& text = *infile.token(line, j);
+      if (text.empty() || (text[0] != '=')) {
+         continue;
+      }
+      size_t pos = text.find_first_of("0123456789");
+      if (pos != string::npos) {
+         return atoi(text.c_str() + pos);
       }
    }
 	return -1;
@@ -0,0 +1,218 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 11:04:18 PDT 2026
+// Last Modified: Mon Oct 19 17:52:08 PDT 2026
+// Filename:      HumdrumFileContent-measure.cpp
+// URL:           https://github.com/craigsapp/humlib/blob/master/src/HumdrumFileContent-measure.cpp
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Measure index for a Humdrum file.  The index stores the
+//                line range and number of each measure, along with the
+//                spine layout and the prevailing clef, key signature, key,
+//                time signature, mensuration and tempo at the start of
+//                each measure, so that tools can jump directly to a range
+//                of measures without scanning the file from the start.
+//
+
+#include "HumdrumFileContent.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace hum {
+
+// START_MERGE
+
+
+//////////////////////////////
+//
+// HumdrumFileContent::analyzeMeasures -- Build the measure index.  Each
+//    barline starts a new measure, and music before the first barline is
+//    stored as a measure starting at line 0.  For this pickup measure, the
+//    spine layout and interpretation states are taken from the first data
+//    line.  The index is built on demand by the query functions below, so
+//    it is only created for files which use it.
+//
+
+void HumdrumFileContent::analyzeMeasures(void) {
+	if (m_analyses.m_measures_analyzed) {
+		return;
+	}
+	m_analyses.m_measures_analyzed = true;
+	m_measures.clear();
+	m_measureNumbers.clear();
+
+	int tracks = getMaxTrack();
+	vector<HTp> clef(tracks+1, NULL);
+	vector<HTp> keysig(tracks+1, NULL);
+	vector<HTp> key(tracks+1, NULL);
+	vector<HTp> timesig(tracks+1, NULL);
+	vector<HTp> met(tracks+1, NULL);
+	vector<HTp> tempo(tracks+1, NULL);
+
+	HumdrumFileContent& infile = *this;
+	bool foundbarline = false;
+	for (int i=0; i<infile.getLineCount(); i++) {
+		HumdrumLine& line = infile[i];
+		if (!line.hasSpines()) {
+			continue;
+		}
+
+		if (line.isInterpretation()) {
+			if (line.isTerminator()) {
+				if ((!m_measures.empty()) && (m_measures.back().stopLine < 0)) {
+					m_measures.back().stopLine = i;
+				}
+				continue;
+			}
+			for (int j=0; j<line.getFieldCount(); j++) {
+				HTp token = line.token(j);
+				int track = token->getTrack();
+				if ((track < 1) || (track > tracks)) {
+					continue;
+				}
+				if (token->compare(0, 5, "*clef") == 0) {
+					clef[track] = token;
+				} else if (token->isKeySignature()) {
+					keysig[track] = token;
+				} else if (token->isKeyDesignation()) {
+					key[track] = token;
+				} else if (token->isTimeSignature()) {
+					timesig[track] = token;
+				} else if (token->isMensurationSymbol()) {
+					met[track] = token;
+				} else if (token->isTempo()) {
+					tempo[track] = token;
+				}
+			}
+			continue;
+		}
+
+		bool barQ = line.isBarline();
+		if (!barQ && (foundbarline || !line.isData())) {
+			continue;
+		}
+
+		if (!m_measures.empty() && (m_measures.back().stopLine < 0)) {
+			m_measures.back().stopLine = i;
+		}
+		m_measures.resize(m_measures.size() + 1);
+		HumMeasureInfo& info = m_measures.back();
+		info.startLine = barQ ? i : 0;
+		info.number    = barQ ? line.getBarNumber() : -1;
+		info.spines.resize(tracks+1);
+		std::fill(info.spines.begin(), info.spines.end(), 0);
+		for (int j=0; j<line.getFieldCount(); j++) {
+			int track = line.token(j)->getTrack();
+			if ((track > 0) && (track <= tracks)) {
+				info.spines[track]++;
+			}
+		}
+		info.clef    = clef;
+		info.keysig  = keysig;
+		info.key     = key;
+		info.timesig = timesig;
+		info.met     = met;
+		info.tempo   = tempo;
+		foundbarline = true;
+	}
+
+	if (!m_measures.empty() && (m_measures.back().stopLine < 0)) {
+		m_measures.back().stopLine = infile.getLineCount() - 1;
+	}
+
+	m_measureNumbers.reserve(m_measures.size());
+	for (int i=0; i<(int)m_measures.size(); i++) {
+		if (m_measures[i].number >= 0) {
+			m_measureNumbers.emplace_back(m_measures[i].number, i);
+		}
+	}
+	std::stable_sort(m_measureNumbers.begin(), m_measureNumbers.end(),
+		[](const pair<int, int>& a, const pair<int, int>& b) {
+			return a.first < b.first;
+		});
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileContent::getMeasureCount -- Return the number of entries
+//    in the measure index.
+//
+
+int HumdrumFileContent::getMeasureCount(void) {
+	analyzeMeasures();
+	return (int)m_measures.size();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileContent::getMeasureInfo -- Return the given entry in the
+//    measure index.  Negative indexes are counted from the end of the
+//    list.  An empty entry is returned if the index is out of range.
+//
+
+const HumMeasureInfo& HumdrumFileContent::getMeasureInfo(int index) {
+	static const HumMeasureInfo empty;
+	analyzeMeasures();
+	if (index < 0) {
+		index += (int)m_measures.size();
+	}
+	if ((index < 0) || (index >= (int)m_measures.size())) {
+		return empty;
+	}
+	return m_measures[index];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileContent::getMeasureIndexByNumber -- Return the index of the
+//    first measure with the given number, or -1 if there is no such
+//    measure.
+//
+
+int HumdrumFileContent::getMeasureIndexByNumber(int number) {
+	analyzeMeasures();
+	auto it = std::lower_bound(m_measureNumbers.begin(), m_measureNumbers.end(),
+		number, [](const pair<int, int>& entry, int value) {
+			return entry.first < value;
+		});
+	if ((it == m_measureNumbers.end()) || (it->first != number)) {
+		return -1;
+	}
+	return it->second;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileContent::getMeasureIndexByLine -- Return the index of the
+//    measure which contains the given line, or -1 if the line occurs
+//    before the first measure.
+//
+
+int HumdrumFileContent::getMeasureIndexByLine(int lineindex) {
+	analyzeMeasures();
+	auto it = std::upper_bound(m_measures.begin(), m_measures.end(),
+		lineindex, [](int value, const HumMeasureInfo& entry) {
+			return value < entry.startLine;
+		});
+	return (int)(it - m_measures.begin()) - 1;
+}
+
+
+
+// END_MERGE
+
+} // end namespace hum
+
+
+
@@ -118,6 +118,27 @@ void HumdrumFileContent::getMetricLevels(vector<double>& output,
 }
 
 
+
+//////////////////////////////
+//
+// HumdrumFileContent::getCachedMetricLevels -- Return the metric levels
+//     for each line as calculated by getMetricLevels() (with NAN for
+//     undefined lines).  The analysis is calculated once and shared with
+//     other code processing the same file until the file is modified.
+//     default value: track = 0
+//
+
+shared_ptr<vector<double>> HumdrumFileContent::getCachedMetricLevels(int track) {
+	shared_ptr<vector<double>> output = getCachedAnalysis<vector<double>>(track);
+	if (!output) {
+		output = make_shared<vector<double>>();
+		getMetricLevels(*output, track, NAN);
+		setCachedAnalysis(output, track);
+	}
+	return output;
+}
+
+
 // END_MERGE
 
 } // end namespace hum
@@ -18,6 +18,7 @@
 #include "HumdrumFileSet.h"
 #include "HumdrumFileStream.h"
 
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -55,6 +56,12 @@ HumdrumFileStream::HumdrumFileStream(Options& options) {
 	vector<string> list;
 	options.getArgList(list);
 	setFileList(list);
+	// Command-line tools can use cached binary versions of their input
+	// files by setting the HUMLIB_CACHE_DIR environment variable.
+	const char* cachedir = getenv("HUMLIB_CACHE_DIR");
+	if (cachedir) {
+		setCacheDirectory(cachedir);
+	}
 }
 
 HumdrumFileStream::HumdrumFileStream(const string& datastring) {
@@ -116,6 +123,22 @@ void HumdrumFileStream::loadString(const string& data) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFileStream::setCacheDirectory -- Set a directory in which to store
+//     binary versions of the files being read (see
+//     HumdrumFileStructure::readStringNoRhythmCached()).  Files which are
+//     found in the cache will not be parsed.  Files which are not in the
+//     cache are parsed without rhythm analysis as when not caching.  Set
+//     to an empty string to disable caching.
+//
+
+void HumdrumFileStream::setCacheDirectory(const string& directory) {
+	m_cachedir = directory;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFileStream::read -- alias for getFile.
@@ -460,7 +483,11 @@ restarting:
 
 	contents << buffer.str();
 	string oldfilename = infile.getFilename();
-	infile.readNoRhythm(contents);
+	if (m_cachedir.empty()) {
+		infile.readNoRhythm(contents);
+	} else {
+		infile.readStringNoRhythmCached(contents.str(), m_cachedir);
+	}
 	string newfilename = infile.getFilename();
 	if (newfilename.empty() && !oldfilename.empty()) {
 		infile.setFilename(oldfilename);
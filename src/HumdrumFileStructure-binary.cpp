@@ -0,0 +1,824 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 10:04:12 PDT 2026
+// Last Modified: Mon Oct 19 17:20:14 PDT 2026
+// Filename:      HumdrumFileStructure-binary.cpp
+// URL:           https://github.com/craigsapp/humlib/blob/master/src/HumdrumFileStructure-binary.cpp
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Read/write a binary (.humbin) representation of an
+//                analyzed Humdrum file.  The binary file stores the lines,
+//                tokens, spine links, strands, durations and parameters
+//                so that loading it does not require re-running the
+//                structural and rhythmic analyses of the text data.
+//
+//                Layout of a .humbin file (version 1):
+//                   header:   magic, version, content hash, file state
+//                   objects:  line text, tab counts, and token text
+//                   analyses: line and token analysis data
+//                   file:     track starts/ends, barlines, strands, strophes
+//                   trailer:  end marker
+//
+//                Token pointers are stored as (line index, field index)
+//                pairs, and (-1, -1) represents a NULL pointer.
+//
+
+#include "HumdrumFileStructure.h"
+#include "HumBinaryIo.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace hum {
+
+// START_MERGE
+
+#define HUMBIN_MAGIC     "HUMBIN\r\n"
+#define HUMBIN_VERSION   1
+#define HUMBIN_ENDMARKER 0x4e494248
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::getContentHash -- Return a 64-bit FNV-1a hash
+//     of the given text.  Used to key cached binary files.
+//
+
+unsigned long long HumdrumFileStructure::getContentHash(const string& contents) {
+	unsigned long long hash = 0xcbf29ce484222325ULL;
+	for (int i=0; i<(int)contents.size(); i++) {
+		hash ^= (unsigned char)contents[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::getLineHash -- Return the content hash of the given
+//     Humdrum text as it will be stored in HumdrumLines: each line ends
+//     with a newline and does not contain a trailing carriage return.
+//     This is the hash stored in binary files, so it can be used to check
+//     that a binary file was created from the given text.
+//
+
+unsigned long long HumdrumFileStructure::getLineHash(const string& contents) {
+	unsigned long long hash = 0xcbf29ce484222325ULL;
+	size_t start = 0;
+	while (start < contents.size()) {
+		size_t end = contents.find('\n', start);
+		if (end == string::npos) {
+			end = contents.size();
+		}
+		size_t stop = end;
+		if ((stop > start) && (contents[stop-1] == 0x0d)) {
+			stop--;
+		}
+		for (size_t i=start; i<stop; i++) {
+			hash ^= (unsigned char)contents[i];
+			hash *= 0x100000001b3ULL;
+		}
+		hash ^= (unsigned char)'\n';
+		hash *= 0x100000001b3ULL;
+		start = end + 1;
+	}
+	return hash;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::getTextHash -- Return the content hash of the
+//     lines in the file.
+//
+
+unsigned long long HumdrumFileStructure::getTextHash(void) {
+	stringstream text;
+	for (int i=0; i<(int)m_lines.size(); i++) {
+		text << (string)*m_lines[i] << '\n';
+	}
+	return getContentHash(text.str());
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::getCacheFilename -- Return the filename of the cached
+//     binary version of the given Humdrum text in the given directory.
+//
+
+string HumdrumFileStructure::getCacheFilename(const string& contents,
+		const string& cachedir) {
+	char buffer[32] = {0};
+	snprintf(buffer, 32, "%016llx", getContentHash(contents));
+	string output = cachedir;
+	if ((!output.empty()) && (output.back() != '/')) {
+		output += '/';
+	}
+	output += buffer;
+	output += ".humbin";
+	return output;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::writeBinary -- Write the analyzed contents of the
+//     file in binary format.  The structure and rhythm of the file will be
+//     analyzed first if not already done.  Returns false if there was a
+//     problem writing the data.
+//
+
+bool HumdrumFileStructure::writeBinary(const string& filename) {
+	ofstream output(filename, ios::binary);
+	if (!output.is_open()) {
+		return false;
+	}
+	bool status = writeBinary(output);
+	output.close();
+	return status && !output.fail();
+}
+
+
+bool HumdrumFileStructure::writeBinary(ostream& out) {
+	if (!isValid()) {
+		return false;
+	}
+	if (!m_analyses.m_rhythm_analyzed) {
+		analyzeStructure();
+		if (!isValid()) {
+			return false;
+		}
+	}
+	return writeBinaryData(out);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::writeBinaryData -- Write the file in binary format
+//     in its current state of analysis (the analysis flags are stored in
+//     the file, so a file read without rhythm analysis will be restored
+//     without rhythm analysis).
+//
+
+bool HumdrumFileStructure::writeBinaryData(ostream& out) {
+	// The content hash is calculated from the text of the file, which will
+	// be used to verify that a cached file matches its source.
+	HumBinaryWriter writer(out);
+	writer.writeBytes(HUMBIN_MAGIC, 8);
+	writer.writeUInt32(HUMBIN_VERSION);
+	writer.writeUInt64(getTextHash());
+
+	// file state:
+	writer.writeString(m_filename);
+	writer.writeVarInt(m_segmentlevel);
+	writer.writeVarInt(m_ticksperquarternote);
+	writer.writeString(m_idprefix);
+	unsigned int flags = 0;
+	flags |= m_analyses.m_structure_analyzed ? 0x001 : 0;
+	flags |= m_analyses.m_rhythm_analyzed    ? 0x002 : 0;
+	flags |= m_analyses.m_strands_analyzed   ? 0x004 : 0;
+	flags |= m_analyses.m_strophes_analyzed  ? 0x008 : 0;
+	flags |= m_analyses.m_nulls_analyzed     ? 0x010 : 0;
+	flags |= m_analyses.m_barlines_analyzed  ? 0x020 : 0;
+	flags |= m_analyses.m_barlines_different ? 0x040 : 0;
+	flags |= m_quietParse                    ? 0x080 : 0;
+	writer.writeUInt32(flags);
+	writeBinaryHash(writer, *this);
+
+	// objects:
+	writer.writeVarUInt((unsigned int)m_lines.size());
+	for (int i=0; i<(int)m_lines.size(); i++) {
+		HumdrumLine& line = *m_lines[i];
+		writer.writeString(line);
+		writer.writeVarUInt((unsigned int)line.m_tokens.size());
+		for (int j=0; j<(int)line.m_tokens.size(); j++) {
+			writer.writeString(*line.m_tokens[j]);
+			writer.writeVarInt(j < (int)line.m_tabs.size() ? line.m_tabs[j] : 0);
+		}
+	}
+
+	// line and token analyses:
+	for (int i=0; i<(int)m_lines.size(); i++) {
+		HumdrumLine& line = *m_lines[i];
+		writer.writeHumNum(line.m_duration);
+		writer.writeHumNum(line.m_durationFromStart);
+		writer.writeHumNum(line.m_durationFromBarline);
+		writer.writeHumNum(line.m_durationToBarline);
+		writer.writeUInt8(line.m_rhythm_analyzed);
+		writeBinaryTokenList(writer, line.m_linkedParameters);
+		writeBinaryHash(writer, line);
+		for (int j=0; j<(int)line.m_tokens.size(); j++) {
+			HumdrumToken& token = *line.m_tokens[j];
+			writer.writeVarInt(token.getTrack());
+			writer.writeVarInt(token.getSubtrack());
+			writer.writeVarInt(token.m_address.getSubtrackCount());
+			writer.writeString(token.getSpineInfo());
+			writer.writeHumNum(token.m_duration);
+			writer.writeVarInt(token.m_rhycheck);
+			writer.writeVarInt(token.m_strand);
+			int tflags = 0;
+			tflags |= token.m_rhythm_analyzed ? 0x01 : 0;
+			tflags |= token.m_parameterSet    ? 0x02 : 0;
+			writer.writeUInt8(tflags);
+			writeBinaryTokenRef(writer, token.m_nullresolve);
+			writeBinaryTokenRef(writer, token.m_strophe);
+			writeBinaryTokenList(writer, token.m_nextTokens);
+			writeBinaryTokenList(writer, token.m_previousTokens);
+			writeBinaryTokenList(writer, token.m_nextNonNullTokens);
+			writeBinaryTokenList(writer, token.m_previousNonNullTokens);
+			writeBinaryTokenList(writer, token.m_linkedParameterTokens);
+			writeBinaryHash(writer, token);
+		}
+	}
+
+	// file-level analyses:
+	writeBinaryTokenList(writer, m_trackstarts);
+	writer.writeVarUInt((unsigned int)m_trackends.size());
+	for (int i=0; i<(int)m_trackends.size(); i++) {
+		writeBinaryTokenList(writer, m_trackends[i]);
+	}
+	writer.writeVarUInt((unsigned int)m_barlines.size());
+	for (int i=0; i<(int)m_barlines.size(); i++) {
+		writer.writeVarInt(m_barlines[i] ? m_barlines[i]->getLineIndex() : -1);
+	}
+	writeBinaryTokenPairs(writer, m_strand1d);
+	writer.writeVarUInt((unsigned int)m_strand2d.size());
+	for (int i=0; i<(int)m_strand2d.size(); i++) {
+		writeBinaryTokenPairs(writer, m_strand2d[i]);
+	}
+	writeBinaryTokenPairs(writer, m_strophes1d);
+	writer.writeVarUInt((unsigned int)m_strophes2d.size());
+	for (int i=0; i<(int)m_strophes2d.size(); i++) {
+		writeBinaryTokenPairs(writer, m_strophes2d[i]);
+	}
+	vector<int> signifiers;
+	for (int i=0; i<(int)m_lines.size(); i++) {
+		if (m_lines[i]->isSignifier()) {
+			signifiers.push_back(i);
+		}
+	}
+	writer.writeVarUInt((unsigned int)signifiers.size());
+	for (int i=0; i<(int)signifiers.size(); i++) {
+		writer.writeVarInt(signifiers[i]);
+	}
+
+	writer.writeUInt32(HUMBIN_ENDMARKER);
+	return writer.isValid();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::readBinary -- Read a binary file created with
+//     writeBinary().  The file is memory-mapped (when available) while
+//     reconstructing the lines and tokens.  Returns false if the data
+//     is not a valid binary Humdrum file, or if the file's format
+//     version does not match the current version.
+//
+
+bool HumdrumFileStructure::readBinary(const string& filename) {
+	HumBinaryReader reader;
+	if (!reader.open(filename)) {
+		return setParseError("Cannot open binary file >>%s<< for reading",
+				filename.c_str());
+	}
+	return readBinary(reader);
+}
+
+
+bool HumdrumFileStructure::readBinary(const char* data, size_t size) {
+	HumBinaryReader reader(data, size);
+	return readBinary(reader);
+}
+
+
+bool HumdrumFileStructure::readBinary(HumBinaryReader& reader) {
+	clear();
+	m_signifiers.clear();
+	m_displayError = true;
+
+	char magic[8];
+	if (!reader.readBytes(magic, 8) || (string(magic, 8) != string(HUMBIN_MAGIC, 8))) {
+		return setParseError("Data is not in binary Humdrum format");
+	}
+	unsigned int version = reader.readUInt32();
+	if (version != HUMBIN_VERSION) {
+		return setParseError("Unsupported binary Humdrum version %u", version);
+	}
+	unsigned long long hash = reader.readUInt64();
+
+	// file state:
+	reader.readString(m_filename);
+	m_segmentlevel = reader.readVarInt();
+	m_ticksperquarternote = reader.readVarInt();
+	reader.readString(m_idprefix);
+	unsigned int flags = reader.readUInt32();
+	if (!readBinaryHash(reader, *this)) {
+		return setParseError("Corrupted binary Humdrum data in file parameters");
+	}
+
+	// objects:
+	unsigned int linecount = reader.readVarUInt();
+	if (!reader.isValid() || (linecount > reader.getSize())) {
+		return setParseError("Corrupted binary Humdrum data in line count");
+	}
+	m_lines.reserve(linecount);
+	for (unsigned int i=0; i<linecount; i++) {
+		HLp line = new HumdrumLine;
+		reader.readString(*line);
+		line->setOwner(this);
+		line->setLineIndex((int)i);
+		m_lines.push_back(line);
+		unsigned int tokencount = reader.readVarUInt();
+		if (!reader.isValid() || (tokencount > reader.getSize())) {
+			return setParseError("Corrupted binary Humdrum data on line %d", i+1);
+		}
+		line->m_tokens.reserve(tokencount);
+		line->m_tabs.reserve(tokencount);
+		for (unsigned int j=0; j<tokencount; j++) {
+			HTp token = new HumdrumToken;
+			reader.readString(*token);
+			token->setOwner(line);
+			token->setFieldIndex((int)j);
+			line->m_tokens.push_back(token);
+			line->m_tabs.push_back(reader.readVarInt());
+		}
+	}
+	if (!reader.isValid()) {
+		return setParseError("Corrupted binary Humdrum data in line contents");
+	}
+	if (getTextHash() != hash) {
+		return setParseError("Content hash of binary Humdrum data does not match its text");
+	}
+
+	// line and token analyses:
+	for (int i=0; i<(int)m_lines.size(); i++) {
+		HumdrumLine& line = *m_lines[i];
+		line.m_duration            = reader.readHumNum();
+		line.m_durationFromStart   = reader.readHumNum();
+		line.m_durationFromBarline = reader.readHumNum();
+		line.m_durationToBarline   = reader.readHumNum();
+		line.m_rhythm_analyzed     = reader.readUInt8();
+		readBinaryTokenList(reader, line.m_linkedParameters);
+		readBinaryHash(reader, line);
+		for (int j=0; j<(int)line.m_tokens.size(); j++) {
+			HumdrumToken& token = *line.m_tokens[j];
+			int track    = reader.readVarInt();
+			int subtrack = reader.readVarInt();
+			token.setTrack(track, subtrack);
+			token.setSubtrackCount(reader.readVarInt());
+			token.setSpineInfo(reader.readString());
+			token.m_duration = reader.readHumNum();
+			token.m_rhycheck = reader.readVarInt();
+			token.m_strand   = reader.readVarInt();
+			int tflags = reader.readUInt8();
+			token.m_rhythm_analyzed = (tflags & 0x01) ? true : false;
+			if (tflags & 0x02) {
+				token.storeParameterSet();
+			}
+			token.m_nullresolve = readBinaryTokenRef(reader);
+			token.m_strophe     = readBinaryTokenRef(reader);
+			readBinaryTokenList(reader, token.m_nextTokens);
+			readBinaryTokenList(reader, token.m_previousTokens);
+			readBinaryTokenList(reader, token.m_nextNonNullTokens);
+			readBinaryTokenList(reader, token.m_previousNonNullTokens);
+			readBinaryTokenList(reader, token.m_linkedParameterTokens);
+			readBinaryHash(reader, token);
+		}
+		if (!reader.isValid()) {
+			return setParseError("Corrupted binary Humdrum data on line %d", i+1);
+		}
+	}
+
+	// file-level analyses:
+	readBinaryTokenList(reader, m_trackstarts);
+	unsigned int count = reader.readVarUInt();
+	if (!reader.isValid() || (count > reader.getSize())) {
+		return setParseError("Corrupted binary Humdrum data in track ends");
+	}
+	m_trackends.resize(count);
+	for (unsigned int i=0; i<count; i++) {
+		readBinaryTokenList(reader, m_trackends[i]);
+	}
+	count = reader.readVarUInt();
+	if (!reader.isValid() || (count > reader.getSize())) {
+		return setParseError("Corrupted binary Humdrum data in barlines");
+	}
+	m_barlines.reserve(count);
+	for (unsigned int i=0; i<count; i++) {
+		int index = reader.readVarInt();
+		if ((index >= 0) && (index < (int)m_lines.size())) {
+			m_barlines.push_back(m_lines[index]);
+		}
+	}
+	readBinaryTokenPairs(reader, m_strand1d);
+	count = reader.readVarUInt();
+	if (!reader.isValid() || (count > reader.getSize())) {
+		return setParseError("Corrupted binary Humdrum data in strands");
+	}
+	m_strand2d.resize(count);
+	for (unsigned int i=0; i<count; i++) {
+		readBinaryTokenPairs(reader, m_strand2d[i]);
+	}
+	readBinaryTokenPairs(reader, m_strophes1d);
+	count = reader.readVarUInt();
+	if (!reader.isValid() || (count > reader.getSize())) {
+		return setParseError("Corrupted binary Humdrum data in strophes");
+	}
+	m_strophes2d.resize(count);
+	for (unsigned int i=0; i<count; i++) {
+		readBinaryTokenPairs(reader, m_strophes2d[i]);
+	}
+	count = reader.readVarUInt();
+	for (unsigned int i=0; (i<count) && reader.isValid(); i++) {
+		int index = reader.readVarInt();
+		if ((index >= 0) && (index < (int)m_lines.size())) {
+			m_signifiers.addSignifier(m_lines[index]->getText());
+		}
+	}
+
+	if ((reader.readUInt32() != HUMBIN_ENDMARKER) || !reader.isValid()) {
+		return setParseError("Corrupted binary Humdrum data at end of file");
+	}
+
+	m_analyses.m_structure_analyzed = (flags & 0x001) ? true : false;
+	m_analyses.m_rhythm_analyzed    = (flags & 0x002) ? true : false;
+	m_analyses.m_strands_analyzed   = (flags & 0x004) ? true : false;
+	m_analyses.m_strophes_analyzed  = (flags & 0x008) ? true : false;
+	m_analyses.m_nulls_analyzed     = (flags & 0x010) ? true : false;
+	m_analyses.m_barlines_analyzed  = (flags & 0x020) ? true : false;
+	m_analyses.m_barlines_different = (flags & 0x040) ? true : false;
+	m_quietParse                    = (flags & 0x080) ? true : false;
+
+	return isValid();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::readCached -- Read a Humdrum file, using a binary
+//     version of the file in the given cache directory if available.  The
+//     cache is keyed by a hash of the file contents, so changed files will
+//     be reparsed.  If the cached version does not exist, then the text
+//     is parsed and then stored in the cache for later use.
+//
+
+bool HumdrumFileStructure::readCached(const string& filename,
+		const string& cachedir) {
+	ifstream input(filename, ios::binary);
+	if (!input.is_open()) {
+		return setParseError("Cannot open file >>%s<< for reading",
+				filename.c_str());
+	}
+	stringstream contents;
+	contents << input.rdbuf();
+	input.close();
+	bool status = readStringCached(contents.str(), cachedir);
+	setFilename(filename);
+	return status;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::readStringCached -- Similar to readCached(), but
+//     the input is the text contents of a Humdrum file.
+//
+
+bool HumdrumFileStructure::readStringCached(const string& contents,
+		const string& cachedir) {
+	if (cachedir.empty()) {
+		return readString(contents);
+	}
+	string cachename = getCacheFilename(contents, cachedir);
+
+	if (readBinaryCache(contents, cachename)) {
+		if (m_analyses.m_rhythm_analyzed) {
+			return true;
+		}
+		// The cached file was stored by readStringNoRhythmCached(), so
+		// finish the analysis and replace it with the analyzed version.
+		if (!analyzeStructure()) {
+			return isValid();
+		}
+		writeBinaryCache(cachename);
+		return isValid();
+	}
+
+	if (!readString(contents)) {
+		return isValid();
+	}
+	writeBinaryCache(cachename);
+	return isValid();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::readStringNoRhythmCached -- Similar to
+//     readStringCached(), but the text is parsed with readStringNoRhythm()
+//     if it is not in the cache.  The cached file will then store the
+//     unanalyzed structure, so a later read gives the same result as
+//     readStringNoRhythm().  If the cache contains a file stored by
+//     readStringCached(), it will be returned with its analyses.
+//
+
+bool HumdrumFileStructure::readStringNoRhythmCached(const string& contents,
+		const string& cachedir) {
+	if (cachedir.empty()) {
+		return readStringNoRhythm(contents);
+	}
+	string cachename = getCacheFilename(contents, cachedir);
+	if (readBinaryCache(contents, cachename)) {
+		return true;
+	}
+	if (!readStringNoRhythm(contents)) {
+		return isValid();
+	}
+	writeBinaryCache(cachename);
+	return isValid();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::readBinaryCache -- Read a cached binary file,
+//     returning false if it does not exist, cannot be read, or was not
+//     created from the given text.
+//
+
+bool HumdrumFileStructure::readBinaryCache(const string& contents,
+		const string& cachename) {
+	HumBinaryReader reader;
+	if (!reader.open(cachename)) {
+		return false;
+	}
+	bool quiet = m_quietParse;
+	m_quietParse = true;
+	bool status = readBinary(reader);
+	m_quietParse = quiet;
+	if (status && (getTextHash() == getLineHash(contents))) {
+		m_filename.clear();
+		return true;
+	}
+	m_parseError.clear();
+	clear();
+	return false;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::writeBinaryCache -- Store the file in the cache in
+//     its current state of analysis.  The data is written to a temporary
+//     name and then renamed so that concurrent processes will not read a
+//     partially written cache file.
+//
+
+bool HumdrumFileStructure::writeBinaryCache(const string& cachename) {
+	if (!isValid()) {
+		return false;
+	}
+	string tempname = cachename + ".tmp" + to_string((unsigned long long)this);
+	ofstream output(tempname, ios::binary);
+	bool status = output.is_open() && writeBinaryData(output);
+	output.close();
+	if (status && !output.fail() && (rename(tempname.c_str(), cachename.c_str()) == 0)) {
+		return true;
+	}
+	remove(tempname.c_str());
+	return false;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::writeBinaryTokenRef -- Store a token pointer
+//     as a line/field index pair.
+//
+
+void HumdrumFileStructure::writeBinaryTokenRef(HumBinaryWriter& writer,
+		HTp token) {
+	int line  = -1;
+	int field = -1;
+	if (token) {
+		line  = token->getLineIndex();
+		field = token->getFieldIndex();
+		if ((line < 0) || (line >= (int)m_lines.size()) || (field < 0) ||
+				(field >= m_lines[line]->getFieldCount()) ||
+				(m_lines[line]->token(field) != token)) {
+			// token is not owned by this file.
+			line  = -1;
+			field = -1;
+		}
+	}
+	writer.writeVarInt(line);
+	writer.writeVarInt(field);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::readBinaryTokenRef -- Convert a line/field index
+//     pair into a token pointer.
+//
+
+HTp HumdrumFileStructure::readBinaryTokenRef(HumBinaryReader& reader) {
+	int line  = reader.readVarInt();
+	int field = reader.readVarInt();
+	if ((line < 0) || (line >= (int)m_lines.size())) {
+		return NULL;
+	}
+	if ((field < 0) || (field >= (int)m_lines[line]->m_tokens.size())) {
+		return NULL;
+	}
+	return m_lines[line]->m_tokens[field];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::writeBinaryTokenList --
+//
+
+void HumdrumFileStructure::writeBinaryTokenList(HumBinaryWriter& writer,
+		const vector<HTp>& tokens) {
+	writer.writeVarUInt((unsigned int)tokens.size());
+	for (int i=0; i<(int)tokens.size(); i++) {
+		writeBinaryTokenRef(writer, tokens[i]);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::readBinaryTokenList --
+//
+
+void HumdrumFileStructure::readBinaryTokenList(HumBinaryReader& reader,
+		vector<HTp>& tokens) {
+	tokens.clear();
+	unsigned int count = reader.readVarUInt();
+	if (!reader.isValid() || (count > reader.getSize())) {
+		return;
+	}
+	tokens.reserve(count);
+	for (unsigned int i=0; i<count; i++) {
+		tokens.push_back(readBinaryTokenRef(reader));
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::writeBinaryTokenPairs --
+//
+
+void HumdrumFileStructure::writeBinaryTokenPairs(HumBinaryWriter& writer,
+		const vector<TokenPair>& pairs) {
+	writer.writeVarUInt((unsigned int)pairs.size());
+	for (int i=0; i<(int)pairs.size(); i++) {
+		writeBinaryTokenRef(writer, pairs[i].first);
+		writeBinaryTokenRef(writer, pairs[i].last);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::readBinaryTokenPairs --
+//
+
+void HumdrumFileStructure::readBinaryTokenPairs(HumBinaryReader& reader,
+		vector<TokenPair>& pairs) {
+	pairs.clear();
+	unsigned int count = reader.readVarUInt();
+	if (!reader.isValid() || (count > reader.getSize())) {
+		return;
+	}
+	pairs.resize(count);
+	for (unsigned int i=0; i<count; i++) {
+		pairs[i].first = readBinaryTokenRef(reader);
+		pairs[i].last  = readBinaryTokenRef(reader);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::writeBinaryHash -- Store the parameters of a
+//     line, token or file.  Parameter origins and values that are token
+//     pointers (stored in the hash as "HT_" strings) are converted into
+//     line/field indexes.
+//
+
+void HumdrumFileStructure::writeBinaryHash(HumBinaryWriter& writer,
+		HumHash& hash) {
+	writer.writeString(hash.prefix);
+	if (hash.parameters == NULL) {
+		writer.writeVarUInt(0);
+		return;
+	}
+	MapNNKV& ns1map = *hash.parameters;
+	writer.writeVarUInt((unsigned int)ns1map.size());
+	for (auto& ns1 : ns1map) {
+		writer.writeString(ns1.first);
+		writer.writeVarUInt((unsigned int)ns1.second.size());
+		for (auto& ns2 : ns1.second) {
+			writer.writeString(ns2.first);
+			writer.writeVarUInt((unsigned int)ns2.second.size());
+			for (auto& item : ns2.second) {
+				writer.writeString(item.first);
+				const string& value = item.second;
+				if (value.compare(0, 3, "HT_") == 0) {
+					writer.writeUInt8(1);
+					HTp pointer = hash.getValueHTp(ns1.first, ns2.first, item.first);
+					writeBinaryTokenRef(writer, pointer);
+				} else {
+					writer.writeUInt8(0);
+					writer.writeString(value);
+				}
+				writeBinaryTokenRef(writer, item.second.origin);
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::readBinaryHash -- Restore the parameters of a
+//     line, token, or file.  All lines and tokens must already be
+//     allocated.
+//
+
+bool HumdrumFileStructure::readBinaryHash(HumBinaryReader& reader,
+		HumHash& hash) {
+	hash.setPrefix(reader.readString());
+	unsigned int ns1count = reader.readVarUInt();
+	if (ns1count == 0) {
+		return reader.isValid();
+	}
+	hash.initializeParameters();
+	MapNNKV& ns1map = *hash.parameters;
+	string ns1;
+	string ns2;
+	string key;
+	string value;
+	for (unsigned int i=0; (i<ns1count) && reader.isValid(); i++) {
+		reader.readString(ns1);
+		unsigned int ns2count = reader.readVarUInt();
+		for (unsigned int j=0; (j<ns2count) && reader.isValid(); j++) {
+			reader.readString(ns2);
+			unsigned int keycount = reader.readVarUInt();
+			for (unsigned int k=0; (k<keycount) && reader.isValid(); k++) {
+				reader.readString(key);
+				if (reader.readUInt8()) {
+					HTp pointer = readBinaryTokenRef(reader);
+					hash.setValue(ns1, ns2, key, pointer);
+				} else {
+					reader.readString(value);
+					ns1map[ns1][ns2][key] = value;
+				}
+				ns1map[ns1][ns2][key].origin = readBinaryTokenRef(reader);
+			}
+		}
+	}
+	return reader.isValid();
+}
+
+
+// END_MERGE
+
+} // end namespace hum
+
+
+
@@ -198,6 +198,7 @@ bool HumdrumFileStructure::readStringCsv(const string& contents,
 
 bool HumdrumFileStructure::analyzeStructure(void) {
 	m_analyses.m_structure_analyzed = false;
+	clearAnalysisCache();
 	if (!m_analyses.m_strands_analyzed) {
 		if (!analyzeStrands()       ) { return isValid(); }
 	}
@@ -213,6 +214,124 @@ bool HumdrumFileStructure::analyzeStructure(void) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFileStructure::analyzeFromTokens -- Analyze a file which was
+//    built from HumdrumToken objects rather than read from text (see
+//    analyzeFromGridTokens() for files created by HumGrid::transferTokens).
+//    The text of each line is generated from its tokens, but the tokens are
+//    not recreated from the text, so this is equivalent to printing and
+//    then re-reading the file, without the cost of re-tokenizing the data.
+//
+
+bool HumdrumFileStructure::analyzeFromTokens(void) {
+	m_displayError = false;
+	m_analyses.clear();
+	for (int i=0; i<(int)m_lines.size(); i++) {
+		HLp line = m_lines[i];
+		line->setOwner(this);
+		line->createLineFromTokens();
+		for (int j=0; j<line->getTokenCount(); j++) {
+			line->token(j)->setOwner(line);
+		}
+	}
+	clearTokenLinkInfo();
+	if (!analyzeBaseFromTokens()) {
+		return isValid();
+	}
+	return analyzeStructure();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::analyzeFromGridTokens -- Analyze a file created
+//    by HumGrid::transferTokens().  The spine links, tracks and spine info
+//    are assigned while following the grid's *^/*v manipulators in one pass
+//    (see analyzeGridSpines()), and the line start times are the slice
+//    timestamps stored by GridSlice::transferTokens() rather than being
+//    derived from the note durations.  Lines without a start time (such as
+//    reference records added after the transfer) are placed at the time of
+//    the next timed line.  If the file does not have this form, it is
+//    analyzed with analyzeFromTokens() instead.
+//
+
+bool HumdrumFileStructure::analyzeFromGridTokens(void) {
+	m_displayError = false;
+	m_analyses.clear();
+	for (int i=0; i<(int)m_lines.size(); i++) {
+		HLp line = m_lines[i];
+		line->setOwner(this);
+		line->setLineIndex(i);
+		line->createLineFromTokens();
+		for (int j=0; j<line->getTokenCount(); j++) {
+			line->token(j)->setOwner(line);
+		}
+	}
+	if (!analyzeGridSpines() || !assignGridLineTimes()) {
+		return analyzeFromTokens();
+	}
+
+	if (!analyzeStrands()          ) { return isValid(); }
+	if (!analyzeGlobalParameters() ) { return isValid(); }
+	if (!analyzeLocalParameters()  ) { return isValid(); }
+	if (!analyzeTokenDurations()   ) { return isValid(); }
+	m_analyses.m_structure_analyzed = true;
+	m_analyses.m_rhythm_analyzed = true;
+	setLineRhythmAnalyzed();
+	if (!analyzeMeter()            ) { return isValid(); }
+	if (!analyzeNonNullDataTokens()) { return isValid(); }
+	HTp firstspine = getSpineStart(0);
+	if (!(firstspine && firstspine->isDataType("**recip"))) {
+		// as in analyzeRhythmStructure():
+		if (!analyzeDurationsOfNonRhythmicSpines()) { return isValid(); }
+	}
+	analyzeSignifiers();
+	return isValid();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileStructure::assignGridLineTimes -- Calculate the line durations
+//    from the start times stored in the lines by GridSlice::transferTokens().
+//    Returns false if no line has a start time or the times decrease.
+//
+
+bool HumdrumFileStructure::assignGridLineTimes(void) {
+	int lastindex = -1;
+	for (int i=(int)m_lines.size()-1; i>=0; i--) {
+		if (m_lines[i]->m_durationFromStart >= 0) {
+			lastindex = i;
+			break;
+		}
+	}
+	if (lastindex < 0) {
+		return false;
+	}
+
+	// Lines after the last slice are placed at its end:
+	HumNum endtime = m_lines[lastindex]->m_durationFromStart;
+	if (m_lines[lastindex]->m_duration > 0) {
+		endtime += m_lines[lastindex]->m_duration;
+	}
+	HumNum nexttime = endtime;
+	for (int i=(int)m_lines.size()-1; i>=0; i--) {
+		if ((i > lastindex) || (m_lines[i]->m_durationFromStart < 0)) {
+			m_lines[i]->m_durationFromStart = nexttime;
+		} else if (m_lines[i]->m_durationFromStart > nexttime) {
+			return false;
+		}
+		m_lines[i]->m_duration = nexttime - m_lines[i]->m_durationFromStart;
+		nexttime = m_lines[i]->m_durationFromStart;
+	}
+	return true;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFileStructure::analyzeStructureNoRhythm -- Analyze global/local
@@ -210,6 +210,9 @@ void HumdrumLine::setLineFromCsv(const string& csv, const string& separator) {
 
 void HumdrumLine::setText(const string& text) {
 	string::assign(text);
+	if (getOwner()) {
+		getOwner()->clearAnalysisCache();
+	}
 }
 
 
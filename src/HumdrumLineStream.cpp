@@ -0,0 +1,661 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 12:10:32 PDT 2026
+// Last Modified: Mon Oct 19 22:14:07 PDT 2026
+// Filename:      HumdrumLineStream.cpp
+// URL:           https://github.com/craigsapp/humlib/blob/master/src/HumdrumLineStream.cpp
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Read Humdrum data one line at a time, keeping track of
+//                spine manipulators but without storing the file in memory
+//                or doing any rhythmic or content analysis.
+//
+
+#include "HumdrumLineStream.h"
+#include "HumdrumFileBase.h"
+
+using namespace std;
+
+namespace hum {
+
+// START_MERGE
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::HumdrumStreamLine --
+//
+
+HumdrumStreamLine::HumdrumStreamLine(void) {
+	clear();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::~HumdrumStreamLine --
+//
+
+HumdrumStreamLine::~HumdrumStreamLine() {
+	// do nothing
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::clear -- Remove the contents of the line.
+//
+
+void HumdrumStreamLine::clear(void) {
+	m_text.clear();
+	m_lineindex = -1;
+	m_fields.clear();
+	m_spineinfo.clear();
+	m_datatype.clear();
+	m_track.clear();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isComment -- Returns true if the line starts
+//     with an exclamation mark.
+//
+
+bool HumdrumStreamLine::isComment(void) const {
+	return (!m_text.empty()) && (m_text[0] == '!');
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isCommentLocal -- Returns true if a local comment.
+//
+
+bool HumdrumStreamLine::isCommentLocal(void) const {
+	return isComment() && ((m_text.size() < 2) || (m_text[1] != '!'));
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isCommentGlobal -- Returns true if a global comment
+//     (including reference records).
+//
+
+bool HumdrumStreamLine::isCommentGlobal(void) const {
+	return m_text.compare(0, 2, "!!") == 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isReference -- Returns true if a global or universal
+//     reference record.
+//
+
+bool HumdrumStreamLine::isReference(void) const {
+	if (m_text.size() < 5) {
+		return false;
+	}
+	if (m_text.compare(0, 3, "!!!") != 0) {
+		return false;
+	}
+	size_t start = 3;
+	if (m_text[3] == '!') {
+		start = 4;
+	}
+	if (m_text[start] == '!') {
+		return false;
+	}
+	size_t colloc = m_text.find(':');
+	if (colloc == string::npos) {
+		return false;
+	}
+	size_t spaceloc = m_text.find(' ');
+	if ((spaceloc != string::npos) && (spaceloc < colloc)) {
+		return false;
+	}
+	size_t tabloc = m_text.find('\t');
+	if ((tabloc != string::npos) && (tabloc < colloc)) {
+		return false;
+	}
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isInterpretation -- Returns true if the line starts
+//     with an asterisk.
+//
+
+bool HumdrumStreamLine::isInterpretation(void) const {
+	return (!m_text.empty()) && (m_text[0] == '*');
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isExclusive -- Returns true if the line starts
+//     with two asterisks.
+//
+
+bool HumdrumStreamLine::isExclusive(void) const {
+	return m_text.compare(0, 2, "**") == 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isBarline -- Returns true if the line starts
+//     with an equals sign.
+//
+
+bool HumdrumStreamLine::isBarline(void) const {
+	return (!m_text.empty()) && (m_text[0] == '=');
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isData -- Returns true if data (but not measure).
+//
+
+bool HumdrumStreamLine::isData(void) const {
+	if (isComment() || isInterpretation() || isBarline() || isEmpty()) {
+		return false;
+	}
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::hasSpines -- Returns true if the line is not empty
+//     or a global comment.
+//
+
+bool HumdrumStreamLine::hasSpines(void) const {
+	return (isEmpty() || isCommentGlobal()) ? false : true;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isManipulator -- Returns true if any fields on the
+//     line are spine manipulators.
+//
+
+bool HumdrumStreamLine::isManipulator(void) const {
+	if (!isInterpretation()) {
+		return false;
+	}
+	for (int i=0; i<(int)m_fields.size(); i++) {
+		const string& field = m_fields[i];
+		if ((field == "*^") || (field == "*v") || (field == "*x") ||
+				(field == "*+") || (field == "*-")) {
+			return true;
+		}
+		if (field.compare(0, 2, "**") == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isTerminator -- Returns true if all fields on the
+//     line are spine terminators.
+//
+
+bool HumdrumStreamLine::isTerminator(void) const {
+	if (!isInterpretation()) {
+		return false;
+	}
+	for (int i=0; i<(int)m_fields.size(); i++) {
+		if (m_fields[i] != "*-") {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isNullField -- Returns true if the given field is a
+//     null data token, null interpretation or null local comment.
+//
+
+bool HumdrumStreamLine::isNullField(int index) const {
+	const string& field = m_fields[index];
+	return (field == ".") || (field == "*") || (field == "!");
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::isAllNull -- Returns true if all fields on the line
+//     are null.
+//
+
+bool HumdrumStreamLine::isAllNull(void) const {
+	if (!hasSpines()) {
+		return false;
+	}
+	for (int i=0; i<(int)m_fields.size(); i++) {
+		if (!isNullField(i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamLine::equalFieldsQ -- Returns true if all fields are of
+//     the given exclusive interpretation and equal to the given value.
+//
+
+bool HumdrumStreamLine::equalFieldsQ(const string& exinterp,
+		const string& value) const {
+	for (int i=0; i<(int)m_fields.size(); i++) {
+		if (m_datatype[i] != exinterp) {
+			return false;
+		}
+		if (m_fields[i] != value) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// operator<< -- Print the text of a streamed line.
+//
+
+ostream& operator<<(ostream& out, const HumdrumStreamLine& line) {
+	out << line.getText();
+	return out;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::HumdrumLineStream --
+//
+
+HumdrumLineStream::HumdrumLineStream(void) {
+	m_input     = NULL;
+	m_lineindex = 0;
+	m_maxtrack  = 0;
+}
+
+
+HumdrumLineStream::HumdrumLineStream(istream& input) {
+	m_input     = NULL;
+	m_lineindex = 0;
+	m_maxtrack  = 0;
+	setInput(input);
+}
+
+
+HumdrumLineStream::HumdrumLineStream(const string& filename) {
+	m_input     = NULL;
+	m_lineindex = 0;
+	m_maxtrack  = 0;
+	open(filename);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::~HumdrumLineStream --
+//
+
+HumdrumLineStream::~HumdrumLineStream() {
+	close();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::setInput -- Read from an external stream (such
+//    as std::cin).
+//
+
+void HumdrumLineStream::setInput(istream& input) {
+	close();
+	m_input = &input;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::open -- Read from the given file.  A filename of
+//    "-" or an empty string reads from standard input.  URIs such as
+//    http://, humdrum:// and jrp:// are downloaded first (when compiled
+//    with USING_URI, as for HumdrumFileStream).
+//
+
+bool HumdrumLineStream::open(const string& filename) {
+	close();
+	if (filename.empty() || (filename == "-")) {
+		m_input = &cin;
+		return true;
+	}
+	if (filename.find("://") != string::npos) {
+		#ifdef USING_URI
+			m_urlbuffer.str("");
+			m_urlbuffer.clear();
+			string webaddress = HumdrumFileBase::getUriToUrlMapping(filename);
+			HumdrumFileBase::readStringFromHttpUri(m_urlbuffer, webaddress);
+			m_input = &m_urlbuffer;
+			return true;
+		#else
+			return setParseError("Cannot read " + filename + ": URI support is not compiled in.");
+		#endif
+	}
+	m_file.open(filename);
+	if (!m_file.is_open()) {
+		return setParseError("Cannot open file " + filename + " for reading.");
+	}
+	m_input = &m_file;
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::close -- Stop reading from the current input and
+//    reset the spine state.
+//
+
+void HumdrumLineStream::close(void) {
+	if (m_file.is_open()) {
+		m_file.close();
+	}
+	m_urlbuffer.str("");
+	m_input     = NULL;
+	m_lineindex = 0;
+	m_maxtrack  = 0;
+	m_datatype.clear();
+	m_spineinfo.clear();
+	m_track.clear();
+	m_error.clear();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::getLine -- Read the next line from the input and
+//    fill in its fields and spine information.  Returns false at the end
+//    of the input or if there is an error in the spine structure.  The
+//    line object can be reused for each call so that memory is not
+//    reallocated for every line.
+//
+
+bool HumdrumLineStream::getLine(HumdrumStreamLine& line) {
+	if ((m_input == NULL) || !isValid()) {
+		return false;
+	}
+	if (!getline(*m_input, line.m_text)) {
+		return false;
+	}
+	if ((!line.m_text.empty()) && (line.m_text.back() == 0x0d)) {
+		line.m_text.resize(line.m_text.size() - 1);
+	}
+	line.m_lineindex = m_lineindex++;
+	splitFields(line);
+
+	if (!line.hasSpines()) {
+		line.m_spineinfo.assign(1, "");
+		line.m_datatype.assign(1, "");
+		line.m_track.assign(1, 0);
+		return true;
+	}
+	if (!assignSpines(line)) {
+		return false;
+	}
+	if (line.isInterpretation()) {
+		return adjustSpines(line);
+	}
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::process -- Send each line of the input to the callback
+//    function.  Processing stops early if the callback returns false.
+//    Returns false if there is an error in the spine structure.
+//
+
+bool HumdrumLineStream::process(const function<bool(HumdrumStreamLine&)>& callback) {
+	HumdrumStreamLine line;
+	while (getLine(line)) {
+		if (!callback(line)) {
+			break;
+		}
+	}
+	return isValid();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::splitFields -- Split the line into tab-separated
+//    fields.  Multiple tabs in a row are treated as a single separator,
+//    as in HumdrumLine::createTokensFromLine().
+//
+
+void HumdrumLineStream::splitFields(HumdrumStreamLine& line) {
+	const string& text = line.m_text;
+	int count = 0;
+	if (!line.hasSpines()) {
+		line.m_fields.resize(1);
+		line.m_fields[0] = text;
+		return;
+	}
+	size_t start = 0;
+	for (size_t i=0; i<text.size(); i++) {
+		if (text[i] != '\t') {
+			continue;
+		}
+		if ((i == 0) || (text[i-1] != '\t')) {
+			if ((int)line.m_fields.size() <= count) {
+				line.m_fields.resize(count + 1);
+			}
+			line.m_fields[count++].assign(text, start, i - start);
+		}
+		start = i + 1;
+	}
+	if (start < text.size()) {
+		if ((int)line.m_fields.size() <= count) {
+			line.m_fields.resize(count + 1);
+		}
+		line.m_fields[count++].assign(text, start, string::npos);
+	}
+	line.m_fields.resize(count);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::assignSpines -- Store the current spine state in the
+//    line.  If there are no active spines, then the line must be an
+//    exclusive interpretation line which starts a new set of spines.
+//
+
+bool HumdrumLineStream::assignSpines(HumdrumStreamLine& line) {
+	int fieldcount = line.getFieldCount();
+	if (m_spineinfo.empty()) {
+		if (!line.isExclusive()) {
+			return setParseError("Error on line " + to_string(line.getLineNumber())
+					+ ": data found before exclusive interpretation");
+		}
+		m_maxtrack = fieldcount;
+		m_datatype.resize(fieldcount);
+		m_spineinfo.resize(fieldcount);
+		m_track.resize(fieldcount);
+		for (int i=0; i<fieldcount; i++) {
+			m_datatype[i]  = line.m_fields[i];
+			m_spineinfo[i] = to_string(i+1);
+			m_track[i]     = i+1;
+		}
+	} else if (fieldcount != (int)m_spineinfo.size()) {
+		return setParseError("Error on line " + to_string(line.getLineNumber())
+				+ ": field count is " + to_string(fieldcount) + " but should be "
+				+ to_string(m_spineinfo.size()));
+	}
+
+	line.m_datatype  = m_datatype;
+	line.m_spineinfo = m_spineinfo;
+	line.m_track     = m_track;
+	if (line.isInterpretation()) {
+		for (int i=0; i<fieldcount; i++) {
+			if (line.m_fields[i].compare(0, 2, "**") == 0) {
+				line.m_datatype[i] = line.m_fields[i];
+			}
+		}
+	}
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::adjustSpines -- Calculate the active spines after
+//    an interpretation line, following the same rules as
+//    HumdrumFileBase::adjustSpines().
+//
+
+bool HumdrumLineStream::adjustSpines(HumdrumStreamLine& line) {
+	vector<string> newtype;
+	vector<string> newinfo;
+	vector<int>    newtrack;
+	int fieldcount = line.getFieldCount();
+	newtype.reserve(fieldcount + 1);
+	newinfo.reserve(fieldcount + 1);
+	newtrack.reserve(fieldcount + 1);
+
+	for (int i=0; i<fieldcount; i++) {
+		const string& field = line.m_fields[i];
+		if (field == "*^") {
+			newtype.push_back(m_datatype[i]);
+			newtype.push_back(m_datatype[i]);
+			newinfo.push_back('(' + m_spineinfo[i] + ")a");
+			newinfo.push_back('(' + m_spineinfo[i] + ")b");
+			newtrack.push_back(m_track[i]);
+			newtrack.push_back(m_track[i]);
+		} else if (field == "*v") {
+			int mergecount = 0;
+			for (int j=i+1; j<fieldcount; j++) {
+				if (line.m_fields[j] == "*v") {
+					mergecount++;
+				} else {
+					break;
+				}
+			}
+			newinfo.push_back(HumdrumFileBase::getMergedSpineInfo(m_spineinfo, i, mergecount));
+			newtype.push_back(m_datatype[i]);
+			newtrack.push_back(m_track[i]);
+			i += mergecount;
+		} else if (field == "*+") {
+			newtype.push_back(m_datatype[i]);
+			newtype.push_back("");
+			newinfo.push_back(m_spineinfo[i]);
+			newinfo.push_back(to_string(++m_maxtrack));
+			newtrack.push_back(m_track[i]);
+			newtrack.push_back(m_maxtrack);
+		} else if (field == "*x") {
+			if (i >= fieldcount - 1) {
+				return setParseError("Error on line " + to_string(line.getLineNumber())
+						+ ": unpaired *x interpretation");
+			}
+			newtype.push_back(m_datatype[i+1]);
+			newtype.push_back(m_datatype[i]);
+			newinfo.push_back(m_spineinfo[i+1]);
+			newinfo.push_back(m_spineinfo[i]);
+			newtrack.push_back(m_track[i+1]);
+			newtrack.push_back(m_track[i]);
+			i++;
+		} else if (field == "*-") {
+			// spine ends here
+		} else if (field.compare(0, 2, "**") == 0) {
+			if (!m_datatype[i].empty() && (m_datatype[i] != field)) {
+				return setParseError("Error on line " + to_string(line.getLineNumber())
+						+ ": exclusive interpretation with no preparation in spine "
+						+ to_string(i+1));
+			}
+			newtype.push_back(field);
+			newinfo.push_back(m_spineinfo[i]);
+			newtrack.push_back(m_track[i]);
+		} else {
+			newtype.push_back(m_datatype[i]);
+			newinfo.push_back(m_spineinfo[i]);
+			newtrack.push_back(m_track[i]);
+		}
+	}
+
+	m_datatype.swap(newtype);
+	m_spineinfo.swap(newinfo);
+	m_track.swap(newtrack);
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineStream::setParseError -- Store an error message.  Always
+//    returns false.
+//
+
+bool HumdrumLineStream::setParseError(const string& message) {
+	m_error = message;
+	return false;
+}
+
+
+
+// END_MERGE
+
+} // end namespace hum
+
+
+
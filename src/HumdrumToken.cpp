@@ -2759,11 +2759,16 @@ void HumdrumToken::setParameters(const string& pdata, HumdrumToken* ptok) {
 
 //////////////////////////////
 //
-// HumdrumToken::setText --
+// HumdrumToken::setText -- Change the text of the token.  Cached analyses
+//     of the file were calculated from the old text, so they are removed.
 //
 
 void HumdrumToken::setText(const string& text) {
 	string::assign(text);
+	HLp owner = getOwner();
+	if (owner && owner->getOwner()) {
+		owner->getOwner()->clearAnalysisCache();
+	}
 }
 
 
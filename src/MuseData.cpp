@@ -13,6 +13,7 @@
 #include "HumRegex.h"
 #include "MuseData.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstdlib>
 #include <cstring>
@@ -38,14 +39,12 @@ namespace hum {
 //
 
 MuseEventSet::MuseEventSet (void) {
-	events.reserve(20);
 	clear();
 }
 
 
 MuseEventSet::MuseEventSet(HumNum atime) {
 	setTime(atime);
-	events.reserve(20);
 }
 
 MuseEventSet::MuseEventSet(const MuseEventSet& aSet) {
@@ -63,7 +62,7 @@ MuseEventSet::MuseEventSet(const MuseEventSet& aSet) {
 // MuseEventSet::operator= --
 //
 
-MuseEventSet MuseEventSet::operator=(MuseEventSet& anevent) {
+MuseEventSet& MuseEventSet::operator=(const MuseEventSet& anevent) {
 	if (&anevent == this) {
 		return *this;
 	}
@@ -124,6 +123,17 @@ void MuseEventSet::appendRecord(MuseRecord* arecord) {
 
 
 
+//////////////////////////////
+//
+// MuseEventSet::reserve -- Allocate space for the given number of records.
+//
+
+void MuseEventSet::reserve(int count) {
+	events.reserve(count);
+}
+
+
+
 //////////////////////////////
 //
 // MuseEventSet::operator[] --
@@ -172,11 +182,7 @@ MuseData::MuseData(MuseData& input) {
 		m_data[i]->setLineIndex(i);
 		m_data[i]->setOwner(this);
 	}
-	m_sequence.resize(input.m_sequence.size());
-	for (i=0; i<(int)input.m_sequence.size(); i++) {
-	  m_sequence[i] = new MuseEventSet;
-	  *(m_sequence[i]) = *(input.m_sequence[i]);
-	}
+	m_sequence = input.m_sequence;
 
 	m_name = input.m_name;
 }
@@ -316,11 +322,6 @@ void MuseData::clear(void) {
 			m_data[i] = NULL;
 		}
 	}
-	for (int i=0; i<(int)m_sequence.size(); i++) {
-		m_sequence[i]->clear();
-		delete m_sequence[i];
-		m_sequence[i] = NULL;
-	}
 	m_error.clear();
 	m_data.clear();
 	m_sequence.clear();
@@ -525,7 +526,7 @@ void MuseData::analyzePitch() {
 
 void MuseData::analyzeTies(void) {
 	for (int i=0; i<(int)m_sequence.size(); i++) {
-		for (int j=0; j<m_sequence[i]->getEventCount(); j++) {
+		for (int j=0; j<m_sequence[i].getEventCount(); j++) {
 			if (!getEvent(i)[j].tieQ()) {
 				continue;
 			}
@@ -642,7 +643,7 @@ int MuseData::searchForPitch(int eventindex, int b40, int track) {
 	int targetpitch;
 	int targettype;
 
-	for (int j=0; j<m_sequence[eventindex]->getEventCount(); j++) {
+	for (int j=0; j<m_sequence[eventindex].getEventCount(); j++) {
 		targettype = getEvent(eventindex)[j].getType();
 		if ((targettype != E_muserec_note_regular) &&
 			 (targettype != E_muserec_note_chord) ) {
@@ -670,18 +671,22 @@ int MuseData::searchForPitch(int eventindex, int b40, int track) {
 //   absolute time value.  The starting index is given first, and it
 //   is assumed that the target absolute time occurs on or after the
 //   starting index value.  Returns -1 if that absolute time is not
-//   found in the data (or occurs before the start index.
+//   found in the data (or occurs before the start index.  The event
+//   times are unique and sorted, so a binary search is used.
 //
 
 int MuseData::getNextEventIndex(int startindex, HumNum target) {
-	int output = -1;
-	for (int i=startindex; i<(int)m_sequence.size(); i++) {
-		if (m_sequence[i]->getTime() == target) {
-			output = i;
-			break;
-		}
+	if ((startindex < 0) || (startindex >= (int)m_sequence.size())) {
+		return -1;
 	}
-	return output;
+	auto it = std::lower_bound(m_sequence.begin() + startindex, m_sequence.end(),
+		target, [](MuseEventSet& eventset, const HumNum& value) {
+			return eventset.getTime() < value;
+		});
+	if ((it == m_sequence.end()) || (it->getTime() != target)) {
+		return -1;
+	}
+	return (int)(it - m_sequence.begin());
 }
 
 
@@ -986,20 +991,58 @@ int MuseData::getInitialTpq(void) {
 //////////////////////////////
 //
 // constructTimeSequence -- Make a list of the lines in the file
-//    sorted by the absolute time at which they occur.
+//    sorted by the absolute time at which they occur.  The lines are
+//    stable-sorted by time and then grouped into one event set for each
+//    unique time, so lines at the same time stay in file order.  A line
+//    which occurs before the start of the first line in the file is an
+//    error.
 //
 
 void MuseData::constructTimeSequence(void) {
-	// * clear old event set
-	// * allocate the size to match number of lines (* 2 probably).
+	m_sequence.clear();
+	if (m_data.empty()) {
+		return;
+	}
 
-	MuseData& thing = *this;
+	vector<pair<HumNum, int>> times(m_data.size());
+	HumNum mintime = m_data[0]->getQStamp();
 	for (int i=0; i<(int)m_data.size(); i++) {
-		insertEventBackwards(thing[i].getQStamp(), &thing[i]);
-		if (hasError()) {
+		times[i].first = m_data[i]->getQStamp();
+		times[i].second = i;
+		if (times[i].first < mintime) {
+			stringstream ss;
+			ss << "Funny error occurred at time " << times[i].first;
+			setError(ss.str());
 			return;
 		}
 	}
+	std::stable_sort(times.begin(), times.end(),
+		[](const pair<HumNum, int>& a, const pair<HumNum, int>& b) {
+			return a.first < b.first;
+		});
+
+	int count = 1;
+	for (int i=1; i<(int)times.size(); i++) {
+		if (times[i].first != times[i-1].first) {
+			count++;
+		}
+	}
+	m_sequence.resize(count);
+
+	int eindex = 0;
+	int start = 0;
+	for (int i=1; i<=(int)times.size(); i++) {
+		if ((i < (int)times.size()) && (times[i].first == times[start].first)) {
+			continue;
+		}
+		MuseEventSet& eventset = m_sequence[eindex++];
+		eventset.setTime(times[start].first);
+		eventset.reserve(i - start);
+		for (int j=start; j<i; j++) {
+			eventset.appendRecord(m_data[times[j].second]);
+		}
+		start = i;
+	}
 }
 
 
@@ -1022,7 +1065,7 @@ int MuseData::getEventCount(void) {
 //
 
 MuseEventSet& MuseData::getEvent(int eindex) {
-	return *(m_sequence[eindex]);
+	return m_sequence[eindex];
 }
 
 
@@ -1033,71 +1076,6 @@ MuseEventSet& MuseData::getEvent(int eindex) {
 //
 
 
-//////////////////////////////
-//
-// printSequenceTimes --
-//
-
-void printSequenceTimes(vector<MuseEventSet*>& m_sequence) {
-	for (int i=0; i<(int)m_sequence.size(); i++) {
-		cout << m_sequence[i]->getTime().getFloat() << " ";
-	}
-	cout << endl;
-}
-
-
-
-//////////////////////////////
-//
-// MuseData::insertEventBackwards -- insert an event into a time-sorted
-//    organization of the file. Searches for the correct time location to
-//    insert event starting at the end of the list (since MuseData files
-//    are mostly sorted in time.
-//
-//
-
-void MuseData::insertEventBackwards(HumNum atime, MuseRecord* arecord) {
-	if (m_sequence.empty()) {
-		MuseEventSet* anevent = new MuseEventSet;
-		anevent->setTime(atime);
-		anevent->appendRecord(arecord);
-		m_sequence.push_back(anevent);
-		return;
-	}
-
-	for (int i=(int)m_sequence.size()-1; i>=0; i--) {
-		if (m_sequence[i]->getTime() == atime) {
-			m_sequence[i]->appendRecord(arecord);
-			return;
-		} else if (m_sequence[i]->getTime() < atime) {
-			// insert new event entry after the current one since it occurs later.
-			MuseEventSet* anevent = new MuseEventSet;
-			anevent->setTime(atime);
-			anevent->appendRecord(arecord);
-			if (i == (int)m_sequence.size()-1) {
-				// just append the event at the end of the list
-				m_sequence.push_back(anevent);
-	    return;
-			} else {
-				// event has to be inserted before end of list, so move
-				// later ones up in list.
-				m_sequence.resize(m_sequence.size()+1);
-				for (int j=(int)m_sequence.size()-1; j>i+1; j--) {
-					m_sequence[j] = m_sequence[j-1];
-				}
-				// store the newly created event entry in m_sequence:
-				m_sequence[i+1] = anevent;
-				return;
-			}
-		}
-	}
-	stringstream ss;
-	ss << "Funny error occurred at time " << atime;
-	setError(ss.str());
-}
-
-
-
 //////////////////////////////
 //
 // MuseData::getTiedDuration -- these version acess the record lines
@@ -12,7 +12,9 @@
 //
 
 #include "MuseDataSet.h"
+#include "HumParallel.h"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -96,6 +98,24 @@ int MuseDataSet::readPart(istream& input) {
 
 
 
+//////////////////////////////
+//
+// MuseDataSet::readPartFiles -- read a list of MuseData part files,
+//      appending them to the current list of parts in the given order.
+//      The files are read in parallel if the thread count is not 1.
+//      Returns 0 if any of the parts has an error.
+//
+
+int MuseDataSet::readPartFiles(const vector<string>& filenames) {
+	return readParts((int)filenames.size(), [&](MuseData& md, int index) {
+		int status = md.readFile(filenames[index]);
+		md.setFilename(filenames[index]);
+		return status != 0;
+	});
+}
+
+
+
 //////////////////////////////
 //
 // MuseDataSet::read -- read potentially Multiple parts from a single file.
@@ -148,23 +168,55 @@ int MuseDataSet::read(istream& infile) {
 	vector<int> stopindex;
 	analyzePartSegments(startindex, stopindex, datalines);
 
-	stringstream *sstream;
-	MuseData* md;
-	for (int i=0; i<(int)startindex.size(); i++) {
-		sstream = new stringstream;
-		for (int j=startindex[i]; j<=stopindex[i]; j++) {
-			 (*sstream) << datalines[j] << '\n';
+	readParts((int)startindex.size(), [&](MuseData& md, int index) {
+		stringstream sstream;
+		for (int j=startindex[index]; j<=stopindex[index]; j++) {
+			sstream << datalines[j] << '\n';
 		}
-		md = new MuseData;
-		md->read(*sstream);
-		appendPart(md);
-		delete sstream;
-	}
+		return md.read(sstream) != 0;
+	});
 	return 1;
 }
 
 
 
+//////////////////////////////
+//
+// MuseDataSet::readParts -- Create the given number of parts and fill
+//    them with the reader function, then append them to the list of parts
+//    in order.  Parts are independent until they are merged by a converter,
+//    so if the thread count is not 1, each worker thread reads and analyzes
+//    whole parts taken from a shared counter.  If threads cannot be created,
+//    the calling thread reads the remaining parts.
+//
+
+bool MuseDataSet::readParts(int count,
+		const std::function<bool(MuseData&, int)>& reader) {
+	vector<MuseData*> parts(count);
+	for (int i=0; i<count; i++) {
+		parts[i] = new MuseData;
+	}
+
+	vector<char> status(count, 1);
+	HumParallel::run(count, m_threads, [&](int i) {
+		status[i] = reader(*parts[i], i);
+	});
+
+	bool output = true;
+	for (int i=0; i<count; i++) {
+		appendPart(parts[i]);
+		if (!status[i]) {
+			output = false;
+			if (!hasError()) {
+				setError(parts[i]->getError());
+			}
+		}
+	}
+	return output;
+}
+
+
+
 //////////////////////////////
 //
 // MuseDataSet::appendPart -- append a MuseData pointer to the end of the
@@ -313,6 +365,19 @@ void MuseDataSet::analyzePartSegments(vector<int>& startindex,
 
 
 
+//////////////////////////////
+//
+// MuseDataSet::setThreadCount -- Set the number of threads used to read
+//    and analyze parts.  The default of 1 reads the parts one at a time,
+//    and 0 uses all available cores.
+//
+
+void MuseDataSet::setThreadCount(int count) {
+	m_threads = count;
+}
+
+
+
 //////////////////////////////
 //
 // MuseDataSet::getFileCount -- return the number of parts found
@@ -37,7 +37,7 @@ namespace hum {
 class MxmlMeasure;
 class MxmlPart;
 
-int MxmlEvent::m_counter = 0;
+std::atomic<int> MxmlEvent::m_counter(0);
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -119,8 +119,7 @@ void MxmlEvent::makeDummyRest(MxmlMeasure* owner, HumNum starttime,
 	// m_node remains null
 	// m_links remains empty
 	m_linked = false;
-	m_sequence = -m_counter;
-	m_counter++;
+	m_sequence = -(m_counter++);
 	m_voice = 1;  // don't know what the original voice number is
 	m_voiceindex = voiceindex;
 	m_staff = staffindex + 1;
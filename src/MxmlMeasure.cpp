@@ -62,6 +62,8 @@ void MxmlMeasure::clear(void) {
 		m_events[i] = NULL;
 	}
 	m_events.clear();
+	m_sortedevents.clear();
+	m_node = xml_node(NULL);
 	m_owner = NULL;
 	m_timesigdur = -1;
 	m_previous = m_following = NULL;
@@ -70,6 +72,25 @@ void MxmlMeasure::clear(void) {
 
 
 
+//////////////////////////////
+//
+// MxmlMeasure::releaseEvents -- Delete the events in the measure after
+//    they are no longer needed, but keep the timing, style and links
+//    to the neighboring measures.  Used by musicxml2hum -l (--release-measures)
+//    after the measure has been transferred to a HumGrid.
+//
+
+void MxmlMeasure::releaseEvents(void) {
+	for (int i=0; i<(int)m_events.size(); i++) {
+		delete m_events[i];
+		m_events[i] = NULL;
+	}
+	vector<MxmlEvent*>().swap(m_events);
+	vector<SimultaneousEvents>().swap(m_sortedevents);
+}
+
+
+
 //////////////////////////////
 //
 // MxmlMeasure::enableStems --
@@ -93,6 +114,7 @@ bool MxmlMeasure::parseMeasure(xpath_node mel) {
 
 bool MxmlMeasure::parseMeasure(xml_node mel) {
 	bool output = true;
+	m_node = mel;
 	vector<vector<int> > staffVoiceCounts;
 	setStartTimeOfMeasure();
 
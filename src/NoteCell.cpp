@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Fri Nov 25 19:41:43 PST 2016
-// Last Modified: Fri Nov 25 19:41:49 PST 2016
+// Last Modified: Mon Oct 19 19:21:37 PDT 2026
 // Filename:      NoteCell.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/src/NoteCell.cpp
 // Syntax:        C++11; humlib
@@ -23,83 +23,208 @@ namespace hum {
 
 //////////////////////////////
 //
-// NoteCell::NoteCell -- Constructor.
+// NoteCell::NoteCell -- Constructor for a view of the cell in the grid
+//     which contains the given token.  The grid must already be loaded,
+//     and the token must be the primary **kern token of a cell.  If the
+//     token is not found in the grid, the cell is not attached to the
+//     grid, and it will behave as a rest without a token.
 //
 
 NoteCell::NoteCell(NoteGrid* owner, HTp token) {
-	clear();
+	int voice;
+	int slice;
+	if (owner && owner->findCell(token, voice, slice)) {
+		setOwner(owner, voice, slice);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// NoteCell::setOwner -- Set the NoteGrid which contains the data
+//     for the cell, and the location of the cell in the grid.
+//
+
+void NoteCell::setOwner(NoteGrid* owner, int voice, int slice) {
 	m_owner = owner;
-	m_token = token;
-	calculateNumericPitches();
+	m_voice = voice;
+	m_timeslice = slice;
+	m_tiedtokens.clear();
 }
 
 
 
 //////////////////////////////
 //
-// NoteCell::clear -- Clear the contents of the object.
+// NoteCell::getSgnDiatonicPitch -- Diatonic note number; NaN=rest;
+//     negative=sustain.
 //
 
-void NoteCell::clear(void) {
-	m_owner = NULL;
-	m_token = NULL;
-	m_b7  = 0;
-	m_b12 = 0;
-	m_b40 = 0;
-	m_accidental = 0;
-	m_nextAttackIndex = -1;
-	m_prevAttackIndex = -1;
-	m_currAttackIndex = -1;
-	m_timeslice = -1;
-	m_voice = -1;
+double NoteCell::getSgnDiatonicPitch(void) {
+	if (!isAttached()) {
+		return GRIDREST;
+	}
+	return m_owner->getSgnDiatonicPitch(m_voice, m_timeslice);
 }
 
 
 
 //////////////////////////////
 //
-// NoteCell::calculateNumericPitches -- Fills in b7, b12, and b40 variables.
-//    0 = rest, negative values for sustained notes.
+// NoteCell::getSgnMidiPitch -- MIDI note number; NaN=rest;
+//     negative=sustain.
 //
 
-void NoteCell::calculateNumericPitches(void) {
-	if (!m_token) {
-		m_b40        = NAN;
-		m_b12        = NAN;
-		m_b7         = NAN;
-		m_accidental = NAN;
-		return;
+double NoteCell::getSgnMidiPitch(void) {
+	if (!isAttached()) {
+		return GRIDREST;
 	}
+	return m_owner->getSgnMidiPitch(m_voice, m_timeslice);
+}
 
-	bool sustain = m_token->isNull() || m_token->isSecondaryTiedNote();
-	if (m_token->isRest()) {
-		m_b40 = NAN;
-	} else {
-		HTp resolve = m_token->resolveNull();
-		if (resolve->isRest()) {
-			m_b40 = NAN;
-		} else if (resolve->isNull()) {
-			m_b40 = NAN;
-		} else {
-			m_b40 = Convert::kernToBase40(resolve);
-			m_b40 = (sustain ? -m_b40 : m_b40);
-		}
-	}
-
-	// convert to base-7 (diatonic pitch numbers)
-	if (m_b40 > 0) {
-		m_b7         = Convert::base40ToDiatonic((int)m_b40);
-		m_b12        = Convert::base40ToMidiNoteNumber((int)m_b40);
-		m_accidental = Convert::base40ToAccidental((int)m_b40);
-	} else if (m_b40 < 0) {
-		m_b7         = -Convert::base40ToDiatonic(-(int)m_b40);
-		m_b12        = -Convert::base40ToMidiNoteNumber(-(int)m_b40);
-		m_accidental = -Convert::base40ToAccidental(-(int)m_b40);
-	} else {
-		m_b7         = NAN;
-		m_b12        = NAN;
-		m_accidental = NAN;
+
+
+//////////////////////////////
+//
+// NoteCell::getSgnBase40Pitch -- Base-40 note number; NaN=rest;
+//     negative=sustain.
+//
+
+double NoteCell::getSgnBase40Pitch(void) {
+	if (!isAttached()) {
+		return GRIDREST;
+	}
+	return m_owner->getSgnBase40Pitch(m_voice, m_timeslice);
+}
+
+
+
+//////////////////////////////
+//
+// NoteCell::getSgnAccidental -- Chromatic alteration of a diatonic pitch;
+//     NaN=rest; negative=sustain.
+//
+
+double NoteCell::getSgnAccidental(void) {
+	if (!isAttached()) {
+		return GRIDREST;
 	}
+	return m_owner->getSgnAccidental(m_voice, m_timeslice);
+}
+
+
+
+//////////////////////////////
+//
+// NoteCell::getAbsDiatonicPitch --
+//
+
+double NoteCell::getAbsDiatonicPitch(void) {
+	if (!isAttached()) {
+		return GRIDREST;
+	}
+	return m_owner->getAbsDiatonicPitch(m_voice, m_timeslice);
+}
+
+
+
+//////////////////////////////
+//
+// NoteCell::getAbsMidiPitch --
+//
+
+double NoteCell::getAbsMidiPitch(void) {
+	if (!isAttached()) {
+		return GRIDREST;
+	}
+	return m_owner->getAbsMidiPitch(m_voice, m_timeslice);
+}
+
+
+
+//////////////////////////////
+//
+// NoteCell::getAbsBase40Pitch --
+//
+
+double NoteCell::getAbsBase40Pitch(void) {
+	if (!isAttached()) {
+		return GRIDREST;
+	}
+	return m_owner->getAbsBase40Pitch(m_voice, m_timeslice);
+}
+
+
+
+//////////////////////////////
+//
+// NoteCell::getAbsAccidental --
+//
+
+double NoteCell::getAbsAccidental(void) {
+	if (!isAttached()) {
+		return GRIDREST;
+	}
+	return m_owner->getAbsAccidental(m_voice, m_timeslice);
+}
+
+
+
+//////////////////////////////
+//
+// NoteCell::getToken -- Return the token in the original Humdrum file.
+//
+
+HTp NoteCell::getToken(void) {
+	if (!isAttached()) {
+		return NULL;
+	}
+	return m_owner->getToken(m_voice, m_timeslice);
+}
+
+
+
+//////////////////////////////
+//
+// NoteCell::getNextAttackIndex -- Index to next note attack (or rest),
+//     -1 for undefined (interpred as rest).
+//
+
+int NoteCell::getNextAttackIndex(void) {
+	if (!isAttached()) {
+		return -1;
+	}
+	return m_owner->getNextAttackIndex(m_voice, m_timeslice);
+}
+
+
+
+//////////////////////////////
+//
+// NoteCell::getPrevAttackIndex -- Index to previous note attack.
+//
+
+int NoteCell::getPrevAttackIndex(void) {
+	if (!isAttached()) {
+		return -1;
+	}
+	return m_owner->getPrevAttackIndex(m_voice, m_timeslice);
+}
+
+
+
+//////////////////////////////
+//
+// NoteCell::getCurrAttackIndex -- Index to current note attack (useful
+//     for finding the start of a sustained note).
+//
+
+int NoteCell::getCurrAttackIndex(void) {
+	if (!isAttached()) {
+		return -1;
+	}
+	return m_owner->getCurrAttackIndex(m_voice, m_timeslice);
 }
 
 
@@ -112,16 +237,10 @@ void NoteCell::calculateNumericPitches(void) {
 //
 
 string NoteCell::getSgnKernPitch(void) {
-	if (isRest()) {
+	if (!isAttached()) {
 		return "r";
 	}
-	string pitch;
-	pitch = Convert::base40ToKern((int)getAbsBase40Pitch());
-	if (isSustained()) {
-		pitch.insert(0, "(");
-		pitch += ")";
-	}
-	return pitch;
+	return m_owner->getSgnKernPitch(m_voice, m_timeslice);
 }
 
 
@@ -132,10 +251,10 @@ string NoteCell::getSgnKernPitch(void) {
 //
 
 string NoteCell::getAbsKernPitch(void) {
-	if (isRest()) {
+	if (!isAttached()) {
 		return "r";
 	}
-	return Convert::base40ToKern((int)getAbsBase40Pitch());
+	return m_owner->getAbsKernPitch(m_voice, m_timeslice);
 }
 
 
@@ -146,17 +265,10 @@ string NoteCell::getAbsKernPitch(void) {
 //
 
 bool NoteCell::isSustained(void) {
-	if (m_b40 < 0) {
-		return true;
-	} else if (m_b40 > 0) {
-		return false;
-	}
-	// calculate if rest is a "sustain" or an "attack"
-	if (m_currAttackIndex == m_timeslice) {
+	if (!isAttached()) {
 		return false;
-	} else {
-		return true;
 	}
+	return m_owner->isSustained(m_voice, m_timeslice);
 }
 
 
@@ -188,10 +300,11 @@ double NoteCell::operator-(int B) {
 //
 
 int NoteCell::getLineIndex(void) {
-	if (!m_token) {
+	HTp token = getToken();
+	if (!token) {
 		return -1;
 	}
-	return m_token->getLineIndex();
+	return token->getLineIndex();
 }
 
 
@@ -203,10 +316,11 @@ int NoteCell::getLineIndex(void) {
 //
 
 int NoteCell::getFieldIndex(void) {
-	if (!m_token) {
+	HTp token = getToken();
+	if (!token) {
 		return -1;
 	}
-	return m_token->getFieldIndex();
+	return token->getFieldIndex();
 }
 
 
@@ -241,11 +355,8 @@ double NoteCell::getDiatonicIntervalFromPreviousAttack(void) {
 	if (previ < 0) {
 		return NAN;
 	}
-	if (!m_owner) {
-		return NAN;
-	}
 	return getAbsDiatonicPitch()
-			- m_owner->cell(m_voice,previ)->getAbsDiatonicPitch();
+			- m_owner->getAbsDiatonicPitch(m_voice, previ);
 }
 
 
@@ -260,10 +371,7 @@ double NoteCell::getDiatonicIntervalToNextAttack(void) {
 	if (nexti < 0) {
 		return NAN;
 	}
-	if (!m_owner) {
-		return NAN;
-	}
-	return m_owner->cell(m_voice,nexti)->getAbsDiatonicPitch()
+	return m_owner->getAbsDiatonicPitch(m_voice, nexti)
 			- getAbsDiatonicPitch();
 }
 
@@ -275,8 +383,10 @@ double NoteCell::getDiatonicIntervalToNextAttack(void) {
 //
 
 bool NoteCell::isRest(void) {
-	// bug in GCC requires :: prefix to resolve two different isnan() defs.
-	return Convert::isNaN(m_b40);
+	if (!isAttached()) {
+		return true;
+	}
+	return m_owner->isRest(m_voice, m_timeslice);
 }
 
 
@@ -301,8 +411,9 @@ double NoteCell::getMetricLevel(void) {
 //
 
 HumNum NoteCell::getDurationFromStart(void) {
-	if (m_token) {
-		return m_token->getDurationFromStart();
+	HTp token = getToken();
+	if (token) {
+		return token->getDurationFromStart();
 	} else {
 		return -1;
 	}
@@ -316,8 +427,8 @@ HumNum NoteCell::getDurationFromStart(void) {
 //
 
 HumNum NoteCell::getDuration(void) {
-	if (!m_owner) {
-		return Convert::recipToDuration(m_token);
+	if (!isAttached()) {
+		return 0;
 	}
 	return m_owner->getNoteDuration(getVoiceIndex(), getSliceIndex());
 }
@@ -326,12 +437,15 @@ HumNum NoteCell::getDuration(void) {
 
 //////////////////////////////
 //
-// NoteCell::setMeter --
+// NoteCell::setMeter -- Set the prevailing meter signature for the
+//     cell (stored in the NoteGrid).
 //
 
 void NoteCell::setMeter(int topval, HumNum botval) {
-	m_metertop = topval;
-	m_meterbot = botval;
+	if (!isAttached()) {
+		return;
+	}
+	m_owner->setMeter(m_voice, m_timeslice, topval, botval);
 }
 
 
@@ -342,7 +456,10 @@ void NoteCell::setMeter(int topval, HumNum botval) {
 //
 
 int NoteCell::getMeterTop(void) {
-	return m_metertop;
+	if (!isAttached()) {
+		return 0;
+	}
+	return m_owner->getMeterTop(m_voice, m_timeslice);
 }
 
 
@@ -353,7 +470,10 @@ int NoteCell::getMeterTop(void) {
 //
 
 HumNum NoteCell::getMeterBottom(void) {
-	return m_meterbot;
+	if (!isAttached()) {
+		return 0;
+	}
+	return m_owner->getMeterBottom(m_voice, m_timeslice);
 }
 
 
@@ -364,12 +484,13 @@ HumNum NoteCell::getMeterBottom(void) {
 //
 
 double NoteCell::getSgnDiatonicPitchClass(void) {
-	if (Convert::isNaN(m_b7)) {
+	double b7 = getSgnDiatonicPitch();
+	if (Convert::isNaN(b7)) {
 		return GRIDREST;
-	} else if (m_b7 < 0) {
-		return -(double)(((int)-m_b7) % 7);
+	} else if (b7 < 0) {
+		return -(double)(((int)-b7) % 7);
 	} else {
-		return (double)(((int)m_b7) % 7);
+		return (double)(((int)b7) % 7);
 	}
 }
 
@@ -381,10 +502,11 @@ double NoteCell::getSgnDiatonicPitchClass(void) {
 //
 
 double NoteCell::getAbsDiatonicPitchClass(void) {
-	if (Convert::isNaN(m_b7)) {
+	double b7 = getAbsDiatonicPitch();
+	if (Convert::isNaN(b7)) {
 		return GRIDREST;
 	} else {
-		return (double)(((int)fabs(m_b7)) % 7);
+		return (double)(((int)b7) % 7);
 	}
 }
 
@@ -396,12 +518,13 @@ double NoteCell::getAbsDiatonicPitchClass(void) {
 //
 
 double NoteCell::getSgnBase40PitchClass(void) {
-	if (Convert::isNaN(m_b40)) {
+	double b40 = getSgnBase40Pitch();
+	if (Convert::isNaN(b40)) {
 		return GRIDREST;
-	} else if (m_b40 < 0) {
-		return -(double)(((int)-m_b40) % 40);
+	} else if (b40 < 0) {
+		return -(double)(((int)-b40) % 40);
 	} else {
-		return (double)(((int)m_b40) % 40);
+		return (double)(((int)b40) % 40);
 	}
 }
 
@@ -413,10 +536,11 @@ double NoteCell::getSgnBase40PitchClass(void) {
 //
 
 double NoteCell::getAbsBase40PitchClass(void) {
-	if (Convert::isNaN(m_b40)) {
+	double b40 = getAbsBase40Pitch();
+	if (Convert::isNaN(b40)) {
 		return GRIDREST;
 	} else {
-		return (double)(((int)fabs(m_b40)) % 40);
+		return (double)(((int)b40) % 40);
 	}
 }
 
@@ -427,10 +551,10 @@ double NoteCell::getAbsBase40PitchClass(void) {
 //
 
 bool NoteCell::isAttack(void) {
-	if (Convert::isNaN(m_b40)) {
+	if (!isAttached()) {
 		return false;
 	}
-	return m_b40>0? true:false;
+	return m_owner->isAttack(m_voice, m_timeslice);
 }
 
 
@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Fri Nov 25 19:41:43 PST 2016
-// Last Modified: Fri Nov 25 19:41:49 PST 2016
+// Last Modified: Mon Oct 19 22:02:15 PDT 2026
 // Filename:      NoteGrid.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/src/NoteGrid.cpp
 // Syntax:        C++11; humlib
@@ -11,8 +11,11 @@
 //                in the Humdrum file score.
 //
 
+#include "Convert.h"
 #include "NoteGrid.h"
-#include "HumRegex.h"
+
+#include <cctype>
+#include <stdexcept>
 
 using namespace std;
 
@@ -51,46 +54,20 @@ NoteGrid::~NoteGrid() {
 void NoteGrid::clear(void) {
 	m_infile = NULL;
 	m_kernspines.clear();
+	m_metriclevels.reset();
+	m_voices = 0;
+	m_slices = 0;
 
-	vector<vector<NoteCell* > >& grid = m_grid;
-	for (int i=0; i<(int)grid.size(); i++) {
-		for (int j=0; j<(int)grid[i].size(); j++) {
-			if (grid[i][j]) {
-				grid[i][j]->clear();
-				delete grid[i][j];
-				grid[i][j] = NULL;
-			}
-		}
-		grid[i].clear();
-	}
-	grid.clear();
-}
-
-
-
-//////////////////////////////
-//
-// NoteGrid::getVoiceCount -- Return the number of voices/parts in the grid.
-//
-
-int NoteGrid::getVoiceCount(void) {
-	return (int)m_grid.size();
-}
-
-
-
-//////////////////////////////
-//
-// NoteGrid::getSliceCount -- Return the number of time slices in the grid.
-//     the grid.
-//
-
-int NoteGrid::getSliceCount(void) {
-	if (m_grid.size() == 0) {
-		return 0;
-	} else {
-		return (int)m_grid[0].size();
-	}
+	m_cells.clear();
+	m_tokens.clear();
+	m_b40.clear();
+	m_b7.clear();
+	m_b12.clear();
+	m_currAttack.clear();
+	m_prevAttack.clear();
+	m_nextAttack.clear();
+	m_meter.clear();
+	m_meters.clear();
 }
 
 
@@ -111,95 +88,265 @@ bool NoteGrid::load(HumdrumFile& infile) {
 	m_kernspines = infile.getKernSpineStartList();
 	vector<HTp>& kernspines = m_kernspines;
 
-	vector<int> metertops(infile.getMaxTrack() + 1, 0);
-	vector<HumNum> meterbots(infile.getMaxTrack() + 1, 0);
-
 	if (kernspines.size() == 0) {
 		cerr << "Warning: no **kern spines in file" << endl;
 		return false;
 	}
 
-	vector<vector<NoteCell* > >& grid = m_grid;
-	grid.resize(kernspines.size());
-	for (int i=0; i<(int)grid.size(); i++) {
-		grid[i].reserve(infile.getLineCount());
+	int slices = 0;
+	for (int i=0; i<infile.getLineCount(); i++) {
+		if (infile[i].isData()) {
+			slices++;
+		}
 	}
+	m_voices = (int)kernspines.size();
+	m_slices = slices;
+	int size = m_voices * m_slices;
+	m_tokens.resize(size);
+	m_b40.resize(size);
+	m_b7.resize(size);
+	m_b12.resize(size);
+	m_meter.resize(size);
+
+	// m_meters[0] is used for notes without a meter signature:
+	m_meters.emplace_back(0, 0);
+	vector<int> meters(infile.getMaxTrack() + 1, 0);
 
-	//int attack = 0;
 	int track, lasttrack;
-	vector<HTp> current;
-	HumRegex hre;
+	int sindex = 0;
 	for (int i=0; i<infile.getLineCount(); i++) {
 		if (infile[i].isInterpretation()) {
 			for (int j=0; j<infile[i].getFieldCount(); j++) {
-				if (!infile[i].token(j)->isKern()) {
+				HTp token = infile.token(i, j);
+				if (!token->isKern()) {
 					continue;
 				}
-				track = infile.token(i, j)->getTrack();
-				if (hre.search(*infile.token(i, j), "\\*M(\\d+)/(\\d+)%(\\d+)")) {
-					metertops[track] = hre.getMatchInt(1);
-					meterbots[track] = hre.getMatchInt(2);
-					meterbots[track] /= hre.getMatchInt(3);
-				} else if (hre.search(*infile.token(i, j), "\\*M(\\d+)/(\\d+)")) {
-					metertops[track] = hre.getMatchInt(1);
-					meterbots[track] = hre.getMatchInt(2);
-				} else {
-					continue;
+				int meter = getMeterIndex(token);
+				if (meter > 0) {
+					meters[token->getTrack()] = meter;
 				}
-
 			}
 		}
 		if (!infile[i].isData()) {
 			continue;
 		}
 		track = 0;
-		//attack = 0;
-		current.clear();
+		int vindex = 0;
 		for (int j=0; j<infile[i].getFieldCount(); j++) {
 			lasttrack = track;
-			track = infile.token(i, j)->getTrack();
-			if (!infile[i].token(j)->isDataType("**kern")) {
+			HTp token = infile.token(i, j);
+			track = token->getTrack();
+			if (!token->isDataType("**kern")) {
 				continue;
 			}
 			if (track == lasttrack) {
 				// secondary voice: ignore
 				continue;
 			}
-			current.push_back(infile.token(i, j));
-			if (!(current.back()->isRest()
-					|| current.back()->isSecondaryTiedNote())) {
-				//attack++;
+			if (vindex < m_voices) {
+				int index = getIndex(vindex, sindex);
+				m_tokens[index] = token;
+				m_meter[index] = (short)meters[track];
+				setPitch(index, token);
 			}
+			vindex++;
 		}
-		if (current.size() != kernspines.size()) {
-			cerr << "Error: Unequal vector sizes " << current.size()
+		if (vindex != m_voices) {
+			cerr << "Error: Unequal vector sizes " << vindex
 			     << " compared to " << kernspines.size() << endl;
+			clear();
 			return false;
 		}
-		for (int j=0; j<(int)current.size(); j++) {
-			NoteCell* cell = new NoteCell(this, current[j]);
-			track = current[j]->getTrack();
-			cell->setVoiceIndex(j);
-			cell->setSliceIndex((int)grid[j].size());
-			cell->setMeter(metertops[track], meterbots[track]);
-			grid[j].push_back(cell);
+		sindex++;
+	}
+
+	m_cells.resize(size);
+	for (int i=0; i<m_voices; i++) {
+		for (int j=0; j<m_slices; j++) {
+			m_cells[getIndex(i, j)].setOwner(this, i, j);
 		}
 	}
 
 	buildAttackIndexes();
 
+	// The metric levels are stored now rather than when first requested,
+	// so that a grid shared by several tools or threads (see
+	// HumdrumFile::getAnalysis()) is not modified while it is being read.
+	m_metriclevels = infile.getCachedMetricLevels(kernspines[0]->getTrack());
+
 	return true;
 }
 
 
 
+//////////////////////////////
+//
+// NoteGrid::setPitch -- Store the pitch of a token in the given cell.
+//     Null tokens and secondary tied notes are marked as sustains of
+//     the note that they resolve to.
+//
+
+void NoteGrid::setPitch(int index, HTp token) {
+	bool sustain = token->isNull() || token->isSecondaryTiedNote();
+	int b40 = 0;
+	if (!token->isRest()) {
+		HTp resolve = token->resolveNull();
+		if (resolve && !resolve->isRest() && !resolve->isNull()) {
+			b40 = Convert::kernToBase40(resolve);
+		}
+	}
+	// A base-40 pitch of 0 is a rest (also unparsable pitches):
+	if ((b40 <= 0) || (b40 > GRID_PITCH)) {
+		m_b40[index] = GRID_REST;
+		m_b7[index]  = 0;
+		m_b12[index] = 0;
+		return;
+	}
+	m_b40[index] = (short)(sustain ? (b40 | GRID_SUSTAIN) : b40);
+	m_b7[index]  = (short)Convert::base40ToDiatonic(b40);
+	m_b12[index] = (short)Convert::base40ToMidiNoteNumber(b40);
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::getMeterIndex -- Return the index in m_meters for a meter
+//     signature token such as "*M3/4" or "*M3/3%2", adding the meter
+//     to the list if it is new.  Returns 0 if the token is not a meter
+//     signature.
+//
+
+int NoteGrid::getMeterIndex(HTp token) {
+	const string& text = *token;
+	if ((text.size() < 5) || (text[0] != '*') || (text[1] != 'M')) {
+		return 0;
+	}
+	int values[3] = { 0, 0, 1 };
+	int field = 0;
+	int digits = 0;
+	for (int i=2; i<(int)text.size(); i++) {
+		char ch = text[i];
+		if (isdigit(ch)) {
+			values[field] = values[field] * 10 + (ch - '0');
+			digits++;
+			continue;
+		}
+		if (digits == 0) {
+			return 0;
+		}
+		if ((ch == '/') && (field == 0)) {
+			field = 1;
+		} else if ((ch == '%') && (field == 1)) {
+			field = 2;
+			values[2] = 0;
+		} else {
+			break;
+		}
+		digits = 0;
+	}
+	if ((field == 0) || (digits == 0) || (values[2] == 0)) {
+		return 0;
+	}
+
+	HumNum bot = values[1];
+	bot /= values[2];
+	return addMeter(values[0], bot);
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::addMeter -- Return the index in m_meters for the given
+//     meter signature, adding the meter to the list if it is new.
+//
+
+int NoteGrid::addMeter(int top, HumNum bottom) {
+	for (int i=1; i<(int)m_meters.size(); i++) {
+		if ((m_meters[i].first == top) && (m_meters[i].second == bottom)) {
+			return i;
+		}
+	}
+	m_meters.emplace_back(top, bottom);
+	return (int)m_meters.size() - 1;
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::setMeter -- Set the prevailing meter signature for the
+//     given cell.
+//
+
+void NoteGrid::setMeter(int vindex, int sindex, int top, HumNum bottom) {
+	m_meter.at(getIndex(vindex, sindex)) = (short)addMeter(top, bottom);
+}
+
+
+
+//////////////////////////////
+//
+// NoteGrid::findCell -- Find the voice and slice indexes of the cell
+//     for the given token.  Returns false if the token is not the
+//     primary **kern token of a cell in the grid.
+//
+
+bool NoteGrid::findCell(HTp token, int& vindex, int& sindex) {
+	vindex = -1;
+	sindex = -1;
+	if (!token || (m_slices == 0)) {
+		return false;
+	}
+	int track = token->getTrack();
+	for (int i=0; i<(int)m_kernspines.size(); i++) {
+		if (m_kernspines[i]->getTrack() == track) {
+			vindex = i;
+			break;
+		}
+	}
+	if ((vindex < 0) || (vindex >= m_voices)) {
+		vindex = -1;
+		return false;
+	}
+
+	// Slices are in line order, so do a binary search for the line:
+	int line = token->getLineIndex();
+	int low = 0;
+	int high = m_slices - 1;
+	while (low <= high) {
+		int mid = (low + high) / 2;
+		int midline = getLineIndex(mid);
+		if (midline < line) {
+			low = mid + 1;
+		} else if (midline > line) {
+			high = mid - 1;
+		} else {
+			if (m_tokens[getIndex(vindex, mid)] == token) {
+				sindex = mid;
+				return true;
+			}
+			break;
+		}
+	}
+	vindex = -1;
+	return false;
+}
+
+
+
 //////////////////////////////
 //
 // NoteGrid::cell -- Return the given cell in the grid.
 //
 
 NoteCell* NoteGrid::cell(int voiceindex, int sliceindex) {
-	return m_grid.at(voiceindex).at(sliceindex);
+	if ((voiceindex < 0) || (voiceindex >= m_voices) || (sliceindex < 0)
+			|| (sliceindex >= m_slices)) {
+		throw std::out_of_range("NoteGrid::cell");
+	}
+	return &m_cells[getIndex(voiceindex, sliceindex)];
 }
 
 
@@ -307,7 +454,11 @@ void NoteGrid::printKernGrid(ostream& output) {
 //
 
 void NoteGrid::buildAttackIndexes(void) {
-	for (int i=0; i<(int)m_grid.size(); i++) {
+	int size = m_voices * m_slices;
+	m_currAttack.assign(size, -1);
+	m_prevAttack.assign(size, -1);
+	m_nextAttack.assign(size, -1);
+	for (int i=0; i<m_voices; i++) {
 		buildAttackIndex(i);
 	}
 }
@@ -321,7 +472,12 @@ void NoteGrid::buildAttackIndexes(void) {
 //
 
 void NoteGrid::buildAttackIndex(int vindex) {
-	vector<NoteCell*>& part = m_grid[vindex];
+	int offset = getIndex(vindex, 0);
+	int* curr = m_currAttack.data() + offset;
+	int* prev = m_prevAttack.data() + offset;
+	int* next = m_nextAttack.data() + offset;
+	HTp* tokens = m_tokens.data() + offset;
+	int count = m_slices;
 
 	// Set the slice index for the attack of the current note.  This
 	// will be the same as the current slice if the NoteCell is an attack.
@@ -330,46 +486,46 @@ void NoteGrid::buildAttackIndex(int vindex) {
 	// For rests, the first rest in a continuous sequence of rests
 	// will be marked as the "attack" of the rest.
 	NoteCell* currentcell = NULL;
-	for (int i=0; i<(int)part.size(); i++) {
+	for (int i=0; i<count; i++) {
 		if (i == 0) {
-			part[0]->setCurrAttackIndex(0);
+			curr[0] = 0;
 			continue;
 		}
-		if (part[i]->isRest()) {
+		if (isRest(vindex, i)) {
 			// This is a rest, so check for a rest sustain or start
 			// of a rest sequence.
-			if (part[i-1]->isRest()) {
+			if (isRest(vindex, i-1)) {
 				// rest "sustain"
-				if (currentcell && !part[i]->getToken()->isNull()) {
-					currentcell->m_tiedtokens.push_back(part[i]->getToken());
+				if (currentcell && !tokens[i]->isNull()) {
+					currentcell->m_tiedtokens.push_back(tokens[i]);
 				}
-				part[i]->setCurrAttackIndex(part[i-1]->getCurrAttackIndex());
+				curr[i] = curr[i-1];
 			} else {
 				// rest "attack";
-				part[i]->setCurrAttackIndex(i);
+				curr[i] = i;
 			}
-		} else if (part[i]->isAttack()) {
-			part[i]->setCurrAttackIndex(i);
-			currentcell = part[i];
+		} else if (isAttack(vindex, i)) {
+			curr[i] = i;
+			currentcell = &m_cells[offset + i];
 		} else {
 			// This is a sustain, so get the attack index of the
 			// note from the previous slice index.
-			part[i]->setCurrAttackIndex(part[i-1]->getCurrAttackIndex());
-			if (currentcell && !part[i]->getToken()->isNull()) {
-				currentcell->m_tiedtokens.push_back(part[i]->getToken());
+			curr[i] = curr[i-1];
+			if (currentcell && !tokens[i]->isNull()) {
+				currentcell->m_tiedtokens.push_back(tokens[i]);
 			}
 		}
 	}
 
 	// start with note attacks marked in the previous and next note slots:
-	for (int i=0; i<(int)part.size(); i++) {
-		if (part[i]->isAttack()) {
-			part[i]->setNextAttackIndex(i);
-			part[i]->setPrevAttackIndex(i);
-		} else if (part[i]->isRest()) {
-			if (part[i]->getCurrAttackIndex() == i) {
-				part[i]->setNextAttackIndex(i);
-				part[i]->setPrevAttackIndex(i);
+	for (int i=0; i<count; i++) {
+		if (isAttack(vindex, i)) {
+			next[i] = i;
+			prev[i] = i;
+		} else if (isRest(vindex, i)) {
+			if (curr[i] == i) {
+				next[i] = i;
+				prev[i] = i;
 			}
 		}
 	}
@@ -377,27 +533,27 @@ void NoteGrid::buildAttackIndex(int vindex) {
 	// Go back and adjust the next note attack index:
 	int value = -1;
 	int temp  = -1;
-	for (int i=(int)part.size()-1; i>=0; i--) {
-		if (!part[i]->isSustained()) {
-			temp = part[i]->getNextAttackIndex();
-			part[i]->setNextAttackIndex(value);
+	for (int i=count-1; i>=0; i--) {
+		if (!isSustained(vindex, i)) {
+			temp = next[i];
+			next[i] = value;
 			value = temp;
 		} else {
-			part[i]->setNextAttackIndex(value);
+			next[i] = value;
 		}
 	}
 
 	// Go back and adjust the previous note attack index:
 	value = -1;
 	temp  = -1;
-	for (int i=0; i<(int)part.size(); i++) {
-		if (!part[i]->isSustained()) {
-			temp = part[i]->getPrevAttackIndex();
-			part[i]->setPrevAttackIndex(value);
+	for (int i=0; i<count; i++) {
+		if (!isSustained(vindex, i)) {
+			temp = prev[i];
+			prev[i] = value;
 			value = temp;
 		} else {
 			if (i != 0) {
-				part[i]->setPrevAttackIndex(part[i-1]->getPrevAttackIndex());
+				prev[i] = prev[i-1];
 			}
 		}
 	}
@@ -408,108 +564,92 @@ void NoteGrid::buildAttackIndex(int vindex) {
 
 //////////////////////////////
 //
-// NoteGrid::getAbsDiatonicPitch -- Return the diatonic pitch number for
-//     the given cell.
-//
-
-double NoteGrid::getAbsDiatonicPitch(int vindex, int sindex) {
-	return m_grid.at(vindex).at(sindex)->getAbsDiatonicPitch();
-}
-
-
-
-//////////////////////////////
-//
-// NoteGrid::getSgnDiatonicPitch -- Return the diatonic pitch number for
-//     the given cell.
-//
-
-double NoteGrid::getSgnDiatonicPitch(int vindex, int sindex) {
-	return m_grid.at(vindex).at(sindex)->getSgnDiatonicPitch();
-}
-
-
-
-//////////////////////////////
-//
-// NoteGrid::getAbsMidiPitch -- Return the MIDI pitch number for
-//     the given cell.
-//
-
-double NoteGrid::getAbsMidiPitch(int vindex, int sindex) {
-	return m_grid.at(vindex).at(sindex)->getAbsMidiPitch();
-}
-
-
-
-//////////////////////////////
-//
-// NoteGrid::getSgnMidiPitch -- Return the MIDI pitch number for
-//     the given cell.
+// NoteGrid::getSgnAccidental -- Return the chromatic alteration of the
+//     note in the given cell (NaN for rests, negative for sustains).
 //
 
-double NoteGrid::getSgnMidiPitch(int vindex, int sindex) {
-	return m_grid.at(vindex).at(sindex)->getSgnMidiPitch();
+double NoteGrid::getSgnAccidental(int vindex, int sindex) {
+	int b40 = m_b40[getIndex(vindex, sindex)];
+	if (b40 & GRID_REST) {
+		return GRIDREST;
+	}
+	int accid = Convert::base40ToAccidental(b40 & GRID_PITCH);
+	return (b40 & GRID_SUSTAIN) ? -accid : accid;
 }
 
 
 
 //////////////////////////////
 //
-// NoteGrid::getAbsBase40Pitch -- Return the base-40 pitch number for
-//     the given cell.
+// NoteGrid::getAbsAccidental -- Return the chromatic alteration of the
+//     note in the given cell (NaN for rests).
 //
 
-double NoteGrid::getAbsBase40Pitch(int vindex, int sindex) {
-	return m_grid.at(vindex).at(sindex)->getAbsBase40Pitch();
+double NoteGrid::getAbsAccidental(int vindex, int sindex) {
+	int b40 = m_b40[getIndex(vindex, sindex)];
+	if (b40 & GRID_REST) {
+		return GRIDREST;
+	}
+	return abs(Convert::base40ToAccidental(b40 & GRID_PITCH));
 }
 
 
 
 //////////////////////////////
 //
-// NoteGrid::getSgnBase40Pitch -- Return the base-40 pitch number for
+// NoteGrid::getAbsKernPitch -- Return the **kern pitch name for
 //     the given cell.
 //
 
-double NoteGrid::getSgnBase40Pitch(int vindex, int sindex) {
-	return m_grid.at(vindex).at(sindex)->getSgnBase40Pitch();
+string NoteGrid::getAbsKernPitch(int vindex, int sindex) {
+	if (isRest(vindex, sindex)) {
+		return "r";
+	}
+	return Convert::base40ToKern((int)getAbsBase40Pitch(vindex, sindex));
 }
 
 
 
 //////////////////////////////
 //
-// NoteGrid::getAbsKernPitch -- Return the **kern pitch name for
+// NoteGrid::getSgnKernPitch -- Return the **kern pitch name for
 //     the given cell.  Sustained notes are enclosed in parentheses.
 //
 
-string NoteGrid::getAbsKernPitch(int vindex, int sindex) {
-	return m_grid.at(vindex).at(sindex)->getAbsKernPitch();
+string NoteGrid::getSgnKernPitch(int vindex, int sindex) {
+	if (isRest(vindex, sindex)) {
+		return "r";
+	}
+	string pitch = Convert::base40ToKern((int)getAbsBase40Pitch(vindex, sindex));
+	if (isSustained(vindex, sindex)) {
+		pitch.insert(0, "(");
+		pitch += ")";
+	}
+	return pitch;
 }
 
 
 
 //////////////////////////////
 //
-// NoteGrid::getSgnKernPitch -- Return the **kern pitch name for
-//     the given cell.  Sustained notes are enclosed in parentheses.
+// NoteGrid::getMeterTop -- Return the top number of the prevailing
+//     meter signature for the given cell (0 if no meter).
 //
 
-string NoteGrid::getSgnKernPitch(int vindex, int sindex) {
-	return m_grid.at(vindex).at(sindex)->getSgnKernPitch();
+int NoteGrid::getMeterTop(int vindex, int sindex) {
+	return m_meters[m_meter[getIndex(vindex, sindex)]].first;
 }
 
 
 
 //////////////////////////////
 //
-// NoteGrid::getToken -- Return the HumdrumToken pointer for
-//     the given cell.
+// NoteGrid::getMeterBottom -- Return the bottom number of the prevailing
+//     meter signature for the given cell (0 if no meter).
 //
 
-HTp NoteGrid::getToken(int vindex, int sindex) {
-	return m_grid.at(vindex).at(sindex)->getToken();
+HumNum NoteGrid::getMeterBottom(int vindex, int sindex) {
+	return m_meters[m_meter[getIndex(vindex, sindex)]].second;
 }
 
 
@@ -523,12 +663,11 @@ HTp NoteGrid::getToken(int vindex, int sindex) {
 //
 
 int NoteGrid::getPrevAttackDiatonic(int vindex, int sindex) {
-	NoteCell*& cell = m_grid.at(vindex).at(sindex);
-	int index = cell->getPrevAttackIndex();
+	int index = getPrevAttackIndex(vindex, sindex);
 	if (index < 0) {
 		return 0;
 	} else {
-		return (int)this->cell(vindex, index)->getAbsDiatonicPitch();
+		return (int)getAbsDiatonicPitch(vindex, index);
 	}
 }
 
@@ -543,12 +682,11 @@ int NoteGrid::getPrevAttackDiatonic(int vindex, int sindex) {
 //
 
 int NoteGrid::getNextAttackDiatonic(int vindex, int sindex) {
-	NoteCell*& cell = m_grid.at(vindex).at(sindex);
-	int index = cell->getNextAttackIndex();
+	int index = getNextAttackIndex(vindex, sindex);
 	if (index < 0) {
 		return 0;
 	} else {
-		return (int)(this->cell(vindex, index)->getAbsDiatonicPitch());
+		return (int)getAbsDiatonicPitch(vindex, index);
 	}
 }
 
@@ -561,10 +699,10 @@ int NoteGrid::getNextAttackDiatonic(int vindex, int sindex) {
 //
 
 int NoteGrid::getLineIndex(int sindex) {
-	if (m_grid.size() == 0) {
+	if (m_voices == 0) {
 		return -1;
 	}
-	return m_grid.at(0).at(sindex)->getToken()->getLineIndex();
+	return m_tokens.at(sindex)->getLineIndex();
 }
 
 
@@ -576,10 +714,10 @@ int NoteGrid::getLineIndex(int sindex) {
 //
 
 int NoteGrid::getFieldIndex(int sindex) {
-	if (m_grid.size() == 0) {
+	if (m_voices == 0) {
 		return -1;
 	}
-	return m_grid.at(0).at(sindex)->getToken()->getFieldIndex();
+	return m_tokens.at(sindex)->getFieldIndex();
 }
 
 
@@ -625,14 +763,10 @@ double NoteGrid::getMetricLevel(int sindex) {
 	if ((getSliceCount() == 0) || (getVoiceCount() == 0)) {
 		return NAN;
 	}
-	if (m_metriclevels.empty()) {
-		int track = 0;
-		if ((getVoiceCount() > 0) && (getSliceCount() > 0)) {
-			track = cell(0, 0)->getToken()->getTrack();
-		}
-		m_infile->getMetricLevels(m_metriclevels, track, NAN);
+	if (!m_metriclevels) {
+		return NAN;
 	}
-	return m_metriclevels[sindex];
+	return (*m_metriclevels)[sindex];
 }
 
 
@@ -643,16 +777,15 @@ double NoteGrid::getMetricLevel(int sindex) {
 //
 
 HumNum NoteGrid::getNoteDuration(int vindex, int sindex) {
-	NoteCell* curnote = cell(vindex, sindex);
-	int attacki = curnote->getCurrAttackIndex();
-	int nexti   = curnote->getNextAttackIndex();
+	int attacki = getCurrAttackIndex(vindex, sindex);
+	int nexti   = getNextAttackIndex(vindex, sindex);
 	HumNum starttime = 0;
 	if (attacki >= 0) {
-		starttime = cell(vindex, attacki)->getDurationFromStart();
+		starttime = getToken(vindex, attacki)->getDurationFromStart();
 	}
 	HumNum endtime = m_infile->getScoreDuration();
 	if (nexti >= 0) {
-		endtime = cell(vindex, nexti)->getDurationFromStart();
+		endtime = getToken(vindex, nexti)->getDurationFromStart();
 	}
 	return endtime - starttime;
 }
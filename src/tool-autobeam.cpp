@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Wed Nov 30 01:02:57 PST 2016
-// Last Modified: Sun May 21 21:11:12 CEST 2017 Ignore non-kern spines when adding beams
+// Last Modified: Mon Oct 19 16:42:10 PDT 2026 Normalize time signatures once per file
 // Filename:      tool-autobeam.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/src/tool-autobeam.cpp
 // Syntax:        C++11; humlib
@@ -846,7 +846,20 @@ void Tool_autobeam::initialize(HumdrumFile& infile) {
 	vector<HTp>& ks = m_kernspines;
 	m_timesigs.resize(infile.getTrackCount() + 1);
 	for (int i=0; i<(int)ks.size(); i++) {
-		infile.getTimeSigs(m_timesigs[ks[i]->getTrack()], ks[i]->getTrack());
+		vector<pair<int, HumNum> >& timesig = m_timesigs[ks[i]->getTrack()];
+		infile.getTimeSigs(timesig, ks[i]->getTrack());
+		// Force 4/4 time signature if no time siguature (perhaps refine the
+		// top number of the time signature to the duration of the measure, but
+		// currently this is probably not necessary.  This is done once here
+		// rather than for every measure, since there is an entry for every line.
+		for (int j=0; j<(int)timesig.size(); j++) {
+			if (timesig[j].first == 0) {
+				timesig[j].first = 4;
+			}
+			if (timesig[j].second == 0) {
+				timesig[j].second = 4;
+			}
+		}
 	}
 	m_overwriteQ = getBoolean("overwrite");
 
@@ -924,17 +937,6 @@ void Tool_autobeam::processMeasure(vector<HTp>& measure) {
 
 	// First, get the beat positions of all notes in the measure:
 	vector<pair<int, HumNum> >& timesig = m_timesigs[measure[0]->getTrack()];
-	// Force 4/4 time signature if no time siguature (perhaps refine the 
-	// top number of the time signature to the duration of the measure, but
-	// currently this is probably not necessary.
-	for (int i=0; i<(int)timesig.size(); i++) {
-		if (timesig[i].first == 0) {
-			timesig[i].first = 4;
-		}
-		if (timesig[i].second == 0) {
-			timesig[i].second = 4;
-		}
-	}
 
 	for (int i=0; i<(int)measure.size(); i++) {
 		int line = measure[i]->getLineIndex();
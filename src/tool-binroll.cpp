@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sun Mar  4 21:09:10 PST 2018
-// Last Modified: Sun Mar  4 21:09:13 PST 2018
+// Last Modified: Mon Oct 19 19:58:31 PDT 2026
 // Filename:      tool-binroll.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/src/tool-binroll.cpp
 // Syntax:        C++11; humlib
@@ -9,10 +9,19 @@
 //
 // Description:   Extract a binary pinao roll of note in a score.
 //
+//                The roll is calculated one time slice at a time while
+//                reading the score from start to end, and each slice is
+//                written as soon as it is complete, so the full roll is
+//                never stored in memory.  Slices are stored as two sets
+//                of 128 bits: the MIDI keys which are sounding, and the
+//                MIDI keys which are attacked in the slice.
+//
 
 #include "tool-binroll.h"
 #include "Convert.h"
-#include "HumRegex.h"
+#include "HumBinaryIo.h"
+
+#include <algorithm>
 
 using namespace std;
 
@@ -29,6 +38,10 @@ namespace hum {
 Tool_binroll::Tool_binroll(void) {
 	// add options here
 	define("t|timebase=s:16", "timebase to do analysis at");
+	define("tpq=b",           "use ticks per quarter note of the score as timebase");
+	define("b|bitplanes=b",   "write packed sounding and attack bits of slices");
+	define("npy=b",           "write roll as a NumPy .npy array");
+	define("o|output=s",      "write roll to the given file");
 }
 
 
@@ -49,128 +62,227 @@ bool Tool_binroll::run(HumdrumFileSet& infiles) {
 
 bool Tool_binroll::run(const string& indata, ostream& out) {
 	HumdrumFile infile(indata);
-	bool status = run(infile);
-	if (hasAnyText()) {
-		getAllText(out);
-	} else {
-		out << infile;
-	}
-	return status;
+	return run(infile, out);
 }
 
 
+//
+// The roll is written directly to the output stream (or to the file
+// for the -o option) rather than being stored in the tool:
+//
+
 bool Tool_binroll::run(HumdrumFile& infile, ostream& out) {
-	bool status = run(infile);
-	if (hasAnyText()) {
-		getAllText(out);
+	initialize(infile);
+	if (hasError()) {
+		return false;
+	}
+	suppressHumdrumFileOutput();
+	if (m_output.is_open()) {
+		processFile(infile, m_output);
 	} else {
-		out << infile;
+		processFile(infile, out);
 	}
-	return status;
+	return true;
 }
 
 
 bool Tool_binroll::run(HumdrumFile& infile) {
-	m_duration.setValue(1, 4); // 16th note
-	processFile(infile);
-	return true;
+	return run(infile, m_free_text);
 }
 
 
 
 //////////////////////////////
 //
-// Tool_binroll::processFile --
+// Tool_binroll::initialize --
 //
 
-void Tool_binroll::processFile(HumdrumFile& infile) {
-	vector<vector<char>> output;
-	output.resize(128);
-	int count = (infile.getScoreDuration() / m_duration).getInteger() + 1;
-	for (int i=0; i<(int)output.size(); i++) {
-		output[i].resize(count);
-		std::fill(output[i].begin(), output[i].end(), 0);
+void Tool_binroll::initialize(HumdrumFile& infile) {
+	m_npyQ       = getBoolean("npy");
+	m_bitplanesQ = getBoolean("bitplanes");
+	m_tpqQ       = getBoolean("tpq");
+
+	if (m_tpqQ) {
+		m_duration.setValue(1, infile.tpq());
+	} else {
+		m_duration = Convert::recipToDuration(getString("timebase"));
+	}
+	if (m_duration <= 0) {
+		m_duration.setValue(1, 4); // 16th note
 	}
 
-	int strandcount = infile.getStrandCount();
-	for (int i=0; i<strandcount; i++) {
-		HTp starting = infile.getStrandStart(i);
-		if (!starting->isKern()) {
-			continue;
+	// A .npy file contains a single array, so the rolls of several
+	// input files cannot be written to the same output:
+	m_inputCount++;
+	if (m_npyQ && (m_inputCount > 1)) {
+		setError("Error: --npy output can only be used with one input file");
+		return;
+	}
+
+	if (getBoolean("output") && !m_output.is_open()) {
+		string filename = getString("output");
+		m_output.open(filename, ios::binary);
+		if (!m_output.is_open()) {
+			m_error_text << "Error: cannot write to file " << filename << endl;
+		} else {
+			suppressHumdrumFileOutput();
 		}
-		HTp ending = infile.getStrandEnd(i);
-		processStrand(output, starting, ending);
 	}
+}
+
 
-	printAnalysis(infile, output);
 
+//////////////////////////////
+//
+// Tool_binroll::finally -- Close the output file for the -o option.
+//
+
+void Tool_binroll::finally(void) {
+	if (m_output.is_open()) {
+		m_output.close();
+	}
 }
 
 
 
 //////////////////////////////
 //
-// Tool_binroll::printAnalysis --
+// Tool_binroll::processFile -- Write the roll of the score, with one time
+//    slice for each timebase duration.  Slices are written while reading
+//    the data lines of the score: all notes which affect a slice start
+//    on a line at or before the slice, so a slice can be written when
+//    a data line after it is reached.
 //
 
-void Tool_binroll::printAnalysis(HumdrumFile& infile,
-		vector<vector<char>>& roll) {
-	HumRegex hre;
+void Tool_binroll::processFile(HumdrumFile& infile, ostream& out) {
+	int count = (infile.getScoreDuration() / m_duration).getInteger() + 1;
+	bool textQ = !(m_npyQ || m_bitplanesQ);
 
+	int exinterp = 0;
 	for (int i=0; i<infile.getLineCount(); i++) {
 		if (infile[i].isExclusive()) {
+			exinterp = i;
 			break;
 		}
-		if (infile[i].isEmpty()) {
+	}
+	int terminator = infile.getLineCount() - 1;
+	for (int i=infile.getLineCount()-1; i>=0; i--) {
+		if (infile[i].isManipulator()) {
+			terminator = i+1;
+			break;
+		}
+		terminator = i;
+	}
+
+	if (m_npyQ) {
+		writeNpyHeader(out, count);
+	} else if (textQ) {
+		printComments(out, infile, 0, exinterp);
+	}
+
+	m_slice = 0;
+	std::fill(m_ends, m_ends + 128, 0);
+	std::fill(m_nextEnds, m_nextEnds + 128, 0);
+	m_attacks[0] = 0;
+	m_attacks[1] = 0;
+
+	for (int i=0; i<infile.getLineCount(); i++) {
+		if (!infile[i].isData()) {
 			continue;
 		}
-		string line = infile[i].getText();
-		int found = 0;
-		for (int j=0; j<(int)line.size(); j++) {
-			if ((line[j] == '!') && !found) {
-				m_free_text << "#";
-			} else {
-				found = 1;
-				m_free_text << line[j];
+		int startindex = (infile[i].getDurationFromStart() / m_duration).getInteger();
+		writeSlices(out, startindex);
+		for (int j=0; j<infile[i].getFieldCount(); j++) {
+			HTp token = infile.token(i, j);
+			if (!token->isKern()) {
+				continue;
+			}
+			if (token->isNull() || token->isRest()) {
+				continue;
 			}
+			addNotes(token, startindex);
 		}
-		m_free_text << "\n";
 	}
+	writeSlices(out, count);
+
+	if (textQ) {
+		printComments(out, infile, terminator, infile.getLineCount());
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_binroll::addNotes -- Add the notes of a token (one for each note
+//    of a chord), which starts at the given slice.
+//
 
-	for (int i=0; i<(int)roll[0].size(); i++) {
-		for (int j=0; j<(int)roll.size(); j++) {
-			m_free_text << (int)roll[j][i];
-			if (j < (int)roll.size() - 1) {
-				m_free_text << ' ';
+void Tool_binroll::addNotes(HTp token, int startindex) {
+	HumNum starttime = token->getDurationFromStart();
+	if (token->isChord()) {
+		int stcount = token->getSubtokenCount();
+		for (int s=0; s<stcount; s++) {
+			string tok = token->getSubtoken(s);
+			int base12 = Convert::kernToMidiNoteNumber(tok);
+			if ((base12 < 0) || (base12 > 127)) {
+				continue;
 			}
+			HumNum duration = Convert::recipToDuration(tok);
+			addNote(base12, startindex, ((starttime + duration) / m_duration).getInteger());
 		}
-		m_free_text << "\n";
+	} else {
+		int base12 = Convert::kernToMidiNoteNumber(token);
+		if ((base12 < 0) || (base12 > 127)) {
+			return;
+		}
+		HumNum duration = token->getDuration();
+		addNote(base12, startindex, ((starttime + duration) / m_duration).getInteger());
 	}
+}
 
-	int startindex = infile.getLineCount() - 1;
-	for (int i=infile.getLineCount()-1; i>=0; i--) {
-		if (infile[i].isManipulator()) {
-			startindex = i+1;
-			break;
-		}
-		startindex = i;
+
+
+//////////////////////////////
+//
+// Tool_binroll::addNote -- Add a note which is attacked in the slice
+//    which will be written next, and is sustained until the slice before
+//    endindex.
+//
+
+void Tool_binroll::addNote(int key, int startindex, int endindex) {
+	m_attacks[key >> 6] |= 1ULL << (key & 63);
+	if (endindex > m_nextEnds[key]) {
+		m_nextEnds[key] = endindex;
 	}
+}
 
-	for (int i=startindex; i<infile.getLineCount(); i++) {
-		if (infile[i].isEmpty()) {
-			continue;
+
+
+//////////////////////////////
+//
+// Tool_binroll::writeSlices -- Write the slices before endindex which have
+//    not been written yet.  Notes attacked in a slice are added to the
+//    sounding notes after the slice is written.
+//
+
+void Tool_binroll::writeSlices(ostream& out, int endindex) {
+	unsigned long long sounding[2];
+	while (m_slice < endindex) {
+		sounding[0] = m_attacks[0];
+		sounding[1] = m_attacks[1];
+		for (int k=0; k<128; k++) {
+			sounding[k >> 6] |= (unsigned long long)(m_ends[k] > m_slice) << (k & 63);
 		}
-		string line = infile[i].getText();
-		int found = 0;
-		for (int j=0; j<(int)line.size(); j++) {
-			if ((line[j] == '!') && !found) {
-				m_free_text << "#";
-			} else {
-				found = 1;
-				m_free_text << line[j];
-			}
+		writeSlice(out, sounding, m_attacks);
+
+		for (int k=0; k<128; k++) {
+			m_ends[k] = std::max(m_ends[k], m_nextEnds[k]);
+			m_nextEnds[k] = 0;
 		}
-		m_free_text << "\n";
+		m_attacks[0] = 0;
+		m_attacks[1] = 0;
+		m_slice++;
 	}
 }
 
@@ -178,60 +290,98 @@ void Tool_binroll::printAnalysis(HumdrumFile& infile,
 
 //////////////////////////////
 //
-// Tool_binroll::processStrand --
+// Tool_binroll::writeSlice -- Write a single time slice.  Text output and
+//    unpacked .npy data give 0 for silent keys, 1 for sustained keys, and
+//    2 for attacked keys.  Bit planes (-b option) give 16 bytes for the
+//    sounding keys followed by 16 bytes for the attacked keys, with MIDI
+//    key k stored in bit k%8 of byte k/8 (unpack in NumPy with
+//    bitorder='little').
 //
 
-void Tool_binroll::processStrand(vector<vector<char>>& roll, HTp starting,
-		HTp ending) {
-	HTp current = starting;
-	int base12;
-	HumNum starttime;
-	HumNum duration;
-	int startindex;
-	int endindex;
-	while (current && (current != ending)) {
-		if (!current->isNonNullData()) {
-			current = current->getNextToken();
-			continue;
+void Tool_binroll::writeSlice(ostream& out, const unsigned long long* sounding,
+		const unsigned long long* attacks) {
+	if (m_bitplanesQ) {
+		char bytes[32];
+		for (int i=0; i<16; i++) {
+			bytes[i]      = (char)((sounding[i >> 3] >> ((i & 7) * 8)) & 0xff);
+			bytes[i + 16] = (char)((attacks[i >> 3]  >> ((i & 7) * 8)) & 0xff);
 		}
-		if (current->isRest()) {
-			current = current->getNextToken();
+		out.write(bytes, 32);
+		return;
+	}
+
+	char values[128];
+	for (int k=0; k<128; k++) {
+		values[k] = (char)(((sounding[k >> 6] >> (k & 63)) & 1)
+				+ ((attacks[k >> 6] >> (k & 63)) & 1));
+	}
+	if (m_npyQ) {
+		out.write(values, 128);
+		return;
+	}
+
+	char line[256];
+	for (int k=0; k<128; k++) {
+		line[2*k] = '0' + values[k];
+		line[2*k+1] = ' ';
+	}
+	line[255] = '\n';
+	out.write(line, 256);
+}
+
+
+
+//////////////////////////////
+//
+// Tool_binroll::writeNpyHeader -- Write the header of a NumPy (version 1.0)
+//    .npy file containing an array of unsigned bytes with one row for each
+//    time slice: 128 values for each row, or 2x16 bytes with the -b option.
+//
+
+void Tool_binroll::writeNpyHeader(ostream& out, int count) {
+	string header = "{'descr': '|u1', 'fortran_order': False, 'shape': (";
+	header += to_string(count);
+	header += m_bitplanesQ ? ", 2, 16), }" : ", 128), }";
+	// The magic string, version and header length take 10 bytes, and the
+	// data starts on a multiple of 64 bytes after a newline.
+	int padding = 63 - (int)((10 + header.size()) % 64);
+	header.append(padding, ' ');
+	header += '\n';
+
+	HumBinaryWriter writer(out);
+	writer.writeBytes("\x93NUMPY", 6);
+	writer.writeUInt8(1);
+	writer.writeUInt8(0);
+	writer.writeUInt8((int)header.size() & 0xff);
+	writer.writeUInt8((int)header.size() >> 8);
+	writer.writeBytes(header.data(), header.size());
+}
+
+
+
+//////////////////////////////
+//
+// Tool_binroll::printComments -- Print the non-empty lines in the given
+//    range, with the starting "!" characters of comments changed to "#".
+//
+
+void Tool_binroll::printComments(ostream& out, HumdrumFile& infile,
+		int startline, int endline) {
+	for (int i=startline; i<endline; i++) {
+		if (infile[i].isEmpty()) {
 			continue;
 		}
-
-		if (current->isChord()) {
-			int stcount = current->getSubtokenCount();
-			starttime = current->getDurationFromStart();
-			startindex = (starttime / m_duration).getInteger();
-			for (int s=0; s<stcount; s++) {
-				string tok = current->getSubtoken(s);
-				base12 = Convert::kernToMidiNoteNumber(tok);
-				if ((base12 < 0) || (base12 > 127)) {
-					continue;
-				}
-				duration = Convert::recipToDuration(tok);
-				endindex = ((starttime+duration) / m_duration).getInteger();
-				roll[base12][startindex] = 2;
-				for (int i=startindex+1; i<endindex; i++) {
-					roll[base12][i] = 1;
-				}
-			}
-		} else {
-			base12 = Convert::kernToMidiNoteNumber(current);
-			if ((base12 < 0) || (base12 > 127)) {
-				current = current->getNextToken();
-				continue;
-			}
-			starttime = current->getDurationFromStart();
-			duration = current->getDuration();
-			startindex = (starttime / m_duration).getInteger();
-			endindex   = ((starttime+duration) / m_duration).getInteger();
-			roll[base12][startindex] = 2;
-			for (int i=startindex+1; i<endindex; i++) {
-				roll[base12][i] = 1;
+		string line = infile[i].getText();
+		int found = 0;
+		for (int j=0; j<(int)line.size(); j++) {
+			if ((line[j] == '!') && !found) {
+				out << "#";
+			} else {
+				found = 1;
+				out << line[j];
 			}
 		}
-		current = current->getNextToken();
+		out << "\n";
 	}
 }
 
@@ -244,3 +394,4 @@ void Tool_binroll::processStrand(vector<vector<char>>& roll, HTp starting,
 
 
 
+
@@ -14,8 +14,10 @@
 #include "tool-cint.h"
 #include "HumRegex.h"
 #include "Convert.h"
+#include "HumParallel.h"
 
 #include <algorithm>
+#include <cstdio>
 
 using namespace std;
 
@@ -81,6 +83,9 @@ Tool_cint::Tool_cint(void) {
 	define("search=s:",                           "search string");
 	define("mark=b",                              "mark matches notes from searches in data");
 	define("count=b",                             "count matched modules from search query");
+	define("stats|module-stats=b",                "count modules in all input files");
+	define("json=b",                              "print --stats counts as JSON data");
+	define("threads=i:1",                         "number of threads for --stats (0 = all cores)");
 	define("debug=b",                             "determine bad input line number");
 	define("author=b",                            "author of the program");
 	define("version=b",                           "complation info");
@@ -96,6 +101,10 @@ Tool_cint::Tool_cint(void) {
 //
 
 bool Tool_cint::run(HumdrumFileSet& infiles) {
+	if (getBoolean("stats")) {
+		countFileSet(infiles);
+		return true;
+	}
 	bool status = true;
 	for (int i=0; i<infiles.getCount(); i++) {
 		status &= run(infiles[i]);
@@ -104,6 +113,20 @@ bool Tool_cint::run(HumdrumFileSet& infiles) {
 }
 
 
+bool Tool_cint::run(HumdrumFileStream& instream) {
+	if (getBoolean("stats")) {
+		countFileStream(instream);
+		return true;
+	}
+	HumdrumFileSet infiles;
+	bool status = true;
+	while (instream.readSingleSegment(infiles)) {
+		status &= run(infiles);
+	}
+	return status;
+}
+
+
 bool Tool_cint::run(const string& indata, ostream& out) {
 	HumdrumFile infile(indata);
 	bool status = run(infile);
@@ -133,6 +156,13 @@ bool Tool_cint::run(HumdrumFile& infile, ostream& out) {
 //
 
 bool Tool_cint::run(HumdrumFile& infile) {
+	if (getBoolean("stats")) {
+		initialize();
+		countModules(infile, ModuleCounts, ModuleNames);
+		FileCount++;
+		return true;
+	}
+
 	processFile(infile);
 
 
@@ -1029,10 +1059,16 @@ int Tool_cint::getOctaveAdjustForCombinationModule(vector<vector<NoteNode> >& no
 int Tool_cint::printCombinationModule(ostream& out, const string& filename,
 		vector<vector<NoteNode> >& notes, int n, int startline, int part1,
 		int part2, vector<vector<string> >& retrospective, string& notemarker,
-		int markstate) {
+		int markstate, u16string* key) {
 
 	notemarker = "";
 
+	// The module is stored as a key instead of printed (--stats option).
+	bool textQ = (key == NULL);
+	if (key) {
+		key->clear();
+	}
+
 	if (norestsQ) {
 		if (notes[part1][startline].b40 == 0) {
 			return 0;
@@ -1074,7 +1110,7 @@ int Tool_cint::printCombinationModule(ostream& out, const string& filename,
 		return 0;
 	}
 
-	if (raw2Q) {
+	if (raw2Q && textQ) {
 		// print pitch of first bottom note
 		if (filenameQ) {
 			(*outp) << "file_" << filename;
@@ -1096,7 +1132,7 @@ int Tool_cint::printCombinationModule(ostream& out, const string& filename,
 		(*outp) << " ";
 	}
 
-	if (parenQ) {
+	if (parenQ && textQ) {
 		(*outp) << "(";
 	}
 
@@ -1134,7 +1170,7 @@ int Tool_cint::printCombinationModule(ostream& out, const string& filename,
 
 		// print the melodic intervals (if not the first item in chain)
 		if ((count > 0) && !nomelodicQ) {
-			if (mparenQ) {
+			if (mparenQ && textQ) {
 				(*outp) << "{";
 			}
 
@@ -1151,42 +1187,57 @@ int Tool_cint::printCombinationModule(ostream& out, const string& filename,
 			}
 			// bottom melodic interval:
 			if (!toponlyQ) {
-				printInterval((*outp), notes[part1][lastindex],
-						notes[part1][i], INTERVAL_MELODIC);
-				if (mmarkerQ) {
+				if (key) {
+					key->push_back(getModuleItem(notes[part1][lastindex],
+							notes[part1][i], INTERVAL_MELODIC));
+				} else {
+					printInterval((*outp), notes[part1][lastindex],
+							notes[part1][i], INTERVAL_MELODIC);
+				}
+				if (mmarkerQ && textQ) {
 					(*outp) << "m";
 				}
 			}
 
 			// print top melodic interval here if requested
 			if (topQ || toponlyQ) {
-				if (!toponlyQ) {
+				if (!toponlyQ && textQ) {
 					printSpacer((*outp));
 				}
 				// top melodic interval:
-				printInterval((*outp), notes[part2][lastindex],
-						notes[part2][i], INTERVAL_MELODIC);
-				if (mmarkerQ) {
+				if (key) {
+					key->push_back(getModuleItem(notes[part2][lastindex],
+							notes[part2][i], INTERVAL_MELODIC));
+				} else {
+					printInterval((*outp), notes[part2][lastindex],
+							notes[part2][i], INTERVAL_MELODIC);
+				}
+				if (mmarkerQ && textQ) {
 					(*outp) << "m";
 				}
 			}
 
-			if (mparenQ) {
+			if (mparenQ && textQ) {
 				(*outp) << "}";
 			}
-			printSpacer((*outp));
+			if (textQ) {
+				printSpacer((*outp));
+			}
 		}
 
 		countm++;
 
 		// print harmonic interval
 		if (!noharmonicQ) {
-			if (hparenQ) {
+			if (hparenQ && textQ) {
 			  (*outp) << "[";
 			}
 			if (markstate) {
 				notes[part1][i].mark = 1;
 				notes[part2][i].mark = 1;
+			} else if (key) {
+				key->push_back(getModuleItem(notes[part1][i], notes[part2][i],
+						INTERVAL_HARMONIC, octaveadjust));
 			} else {
 				// oldcrossing = crossing;
 				//crossing = printInterval((*outp), notes[part1][i],
@@ -1195,7 +1246,7 @@ int Tool_cint::printCombinationModule(ostream& out, const string& filename,
 						notes[part2][i], INTERVAL_HARMONIC, octaveadjust);
 			}
 
-			if (durationQ) {
+			if (durationQ && textQ) {
 				if (notes[part1][i].isAttack()) {
 					(*outp) << "D" << notes[part1][i].duration;
 				}
@@ -1204,16 +1255,16 @@ int Tool_cint::printCombinationModule(ostream& out, const string& filename,
 				}
 			}
 
-			if (hmarkerQ) {
+			if (hmarkerQ && textQ) {
 				(*outp) << "h";
 			}
-			if (hparenQ) {
+			if (hparenQ && textQ) {
 			  (*outp) << "]";
 			}
 		}
 
 		// prepare the ids string if requested
-		if (idQ) {
+		if (idQ && textQ) {
 		//   if (count == 0) {
 				// insert both first two notes, even if sustain.
 				if (idstart != 0) { idstream << ':'; }
@@ -1248,7 +1299,7 @@ int Tool_cint::printCombinationModule(ostream& out, const string& filename,
 			retroline = i;
 			break;
 		} else {
-			if (!noharmonicQ) {
+			if (!noharmonicQ && textQ) {
 				printSpacer((*outp));
 			}
 		}
@@ -1267,7 +1318,7 @@ int Tool_cint::printCombinationModule(ostream& out, const string& filename,
 
 	}
 
-	if (parenQ) {
+	if (parenQ && textQ) {
 		(*outp) << ")";
 	}
 
@@ -1292,6 +1343,280 @@ int Tool_cint::printCombinationModule(ostream& out, const string& filename,
 
 
 
+//////////////////////////////
+//
+// Tool_cint::countFileStream -- Count the modules of all input files for
+//     the --stats option.  Files given on the command line are read and
+//     counted in separate threads (--threads option), as with
+//     countFileSet().  Standard input is counted one segment at a time.
+//
+
+void Tool_cint::countFileStream(HumdrumFileStream& instream) {
+	initialize();
+	vector<string> filenames;
+	getArgList(filenames);
+	int filecount = (int)filenames.size();
+	if (filecount == 0) {
+		HumdrumFile infile;
+		while (instream.read(infile)) {
+			countModules(infile, ModuleCounts, ModuleNames);
+			FileCount++;
+		}
+		return;
+	}
+
+	string cachedir = instream.getCacheDirectory();
+	int threadcount = HumParallel::getThreadCount(Threads, filecount);
+	vector<unordered_map<u16string, int>> counts(threadcount);
+	vector<unordered_map<u16string, string>> names(threadcount);
+	vector<int> segments(threadcount, 0);
+	HumParallel::runWorkers(filecount, threadcount, [&](int i, int worker) {
+		HumdrumFileStream filestream(vector<string>(1, filenames[i]));
+		filestream.setCacheDirectory(cachedir);
+		HumdrumFile infile;
+		while (filestream.read(infile)) {
+			countModules(infile, counts[worker], names[worker]);
+			segments[worker]++;
+		}
+	});
+	mergeModuleCounts(counts, names);
+	for (int i=0; i<threadcount; i++) {
+		FileCount += segments[i];
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_cint::countFileSet -- Count the modules in a set of files for the
+//     --stats option.  Files are counted in separate threads (--threads
+//     option), each with its own counts which are merged after all of the
+//     files have been counted.
+//
+
+void Tool_cint::countFileSet(HumdrumFileSet& infiles) {
+	initialize();
+	int filecount = infiles.getCount();
+	int threadcount = HumParallel::getThreadCount(Threads, filecount);
+	if (threadcount == 1) {
+		for (int i=0; i<filecount; i++) {
+			countModules(infiles[i], ModuleCounts, ModuleNames);
+		}
+		FileCount += filecount;
+		return;
+	}
+
+	vector<unordered_map<u16string, int>> counts(threadcount);
+	vector<unordered_map<u16string, string>> names(threadcount);
+	HumParallel::runWorkers(filecount, threadcount, [&](int i, int worker) {
+		countModules(infiles[i], counts[worker], names[worker]);
+	});
+	mergeModuleCounts(counts, names);
+	FileCount += filecount;
+}
+
+
+
+//////////////////////////////
+//
+// Tool_cint::mergeModuleCounts -- Add the module counts of each thread to
+//     the total counts.
+//
+
+void Tool_cint::mergeModuleCounts(vector<unordered_map<u16string, int>>& counts,
+		vector<unordered_map<u16string, string>>& names) {
+	for (int i=0; i<(int)counts.size(); i++) {
+		for (auto& it : counts[i]) {
+			ModuleCounts[it.first] += it.second;
+		}
+		for (auto& it : names[i]) {
+			ModuleNames.insert(it);
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_cint::countModules -- Count the modules between all pairs of
+//     voices which printCombinations would print for the file.  The text
+//     of a module is only generated the first time that it is found.
+//
+
+void Tool_cint::countModules(HumdrumFile& infile,
+		unordered_map<u16string, int>& counts,
+		unordered_map<u16string, string>& names) {
+	vector<vector<NoteNode> > notes;
+	vector<int>    ktracks;
+	vector<HTp>    kstarts;
+	vector<int>    reverselookup;
+
+	infile.getSpineStartList(kstarts, "**kern");
+	ktracks.resize(kstarts.size());
+	for (int i=0; i<(int)kstarts.size(); i++) {
+		ktracks[i] = kstarts[i]->getTrack();
+	}
+	if (koptionQ) {
+		adjustKTracks(ktracks, getString("koption"));
+	}
+	if (ktracks.size() < 2) {
+		return;
+	}
+	notes.resize(ktracks.size());
+	reverselookup.resize(infile.getTrackCount()+1);
+	fill(reverselookup.begin(), reverselookup.end(), -1);
+	for (int i=0; i<(int)ktracks.size(); i++) {
+		reverselookup[ktracks[i]] = i;
+	}
+	extractNoteArray(notes, infile, ktracks, reverselookup);
+
+	string filename = infile.getFilename();
+	vector<vector<string> > retrospective;
+	string notemarker;
+	u16string key;
+	stringstream text;
+	int partcount = (int)notes.size();
+	for (int i=0; i<(int)notes[0].size(); i++) {
+		if (!infile[notes[0][i].line].isData()) {
+			// Modules only start on data lines.
+			continue;
+		}
+		for (int part1=0; part1<partcount-1; part1++) {
+			for (int part2=part1+1; part2<partcount; part2++) {
+				if (!printCombinationModule(text, filename, notes, Chaincount, i,
+						part1, part2, retrospective, notemarker, 0, &key)) {
+					continue;
+				}
+				int& count = counts[key];
+				if (count++ > 0) {
+					continue;
+				}
+				text.str("");
+				printCombinationModule(text, filename, notes, Chaincount, i,
+						part1, part2, retrospective, notemarker);
+				names[key] = text.str();
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_cint::getModuleItem -- Pack an interval of a module into a 16-bit
+//     integer.  The low 14 bits contain the interval as displayed by
+//     printInterval (0x2000 for rests), and the top two bits are set for
+//     sustained notes when printInterval displays sustain/attack states.
+//
+
+char16_t Tool_cint::getModuleItem(NoteNode& note1, NoteNode& note2, int type,
+		int octaveadjust) {
+	if ((note1.b40 == REST) || (note2.b40 == REST)) {
+		return 0x2000;
+	}
+	int item = getInterval(note1, note2, type, octaveadjust) & 0x3fff;
+	if (sustainQ || ((type == INTERVAL_HARMONIC) && xoptionQ)) {
+		if (note1.b40 < 0) {
+			item |= 0x4000;
+		}
+		if (note2.b40 < 0) {
+			item |= 0x8000;
+		}
+	}
+	return (char16_t)item;
+}
+
+
+
+//////////////////////////////
+//
+// Tool_cint::finally -- Print the module counts after all files have been
+//     processed with the --stats option.
+//
+
+void Tool_cint::finally(void) {
+	if (statsQ) {
+		printModuleStatistics(m_free_text);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_cint::printModuleStatistics -- Print the counts of modules, sorted
+//     from most to least common, as a tab-separated table or as JSON data
+//     with the --json option.
+//
+
+void Tool_cint::printModuleStatistics(ostream& out) {
+	// Intervals which cannot be named with --chromatic have the same text,
+	// so merge the counts of modules by their text.
+	unordered_map<string, int> totals;
+	for (auto& it : ModuleCounts) {
+		totals[ModuleNames[it.first]] += it.second;
+	}
+	vector<pair<int, string>> table;
+	table.reserve(totals.size());
+	for (auto& it : totals) {
+		table.emplace_back(-it.second, it.first);
+	}
+	sort(table.begin(), table.end());
+
+	if (jsonQ) {
+		out << "{\n";
+		out << "\t\"files\": " << FileCount << ",\n";
+		out << "\t\"modules\": [";
+		for (int i=0; i<(int)table.size(); i++) {
+			out << (i ? ",\n" : "\n");
+			out << "\t\t{\"module\": \"" << getJsonString(table[i].second) << "\"";
+			out << ", \"count\": " << -table[i].first << "}";
+		}
+		out << "\n\t]\n";
+		out << "}\n";
+	} else {
+		out << "count\tmodule\n";
+		for (int i=0; i<(int)table.size(); i++) {
+			out << -table[i].first << "\t" << table[i].second << "\n";
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_cint::getJsonString -- Escape quotes, backslashes and control
+//     characters of a module for printing as a JSON string.
+//
+
+string Tool_cint::getJsonString(const string& text) {
+	string output;
+	output.reserve(text.size());
+	for (char c : text) {
+		switch (c) {
+			case '"':  output += "\\\""; break;
+			case '\\': output += "\\\\"; break;
+			case '\n': output += "\\n";  break;
+			case '\t': output += "\\t";  break;
+			default:
+				if ((unsigned char)c < 0x20) {
+					char buffer[8];
+					snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned char)c);
+					output += buffer;
+				} else {
+					output += c;
+				}
+		}
+	}
+	return output;
+}
+
+
+
 //////////////////////////////
 //
 // Tool_cint::printAsCombination --
@@ -1871,12 +2196,59 @@ int Tool_cint::printInterval(ostream& out, NoteNode& note1, NoteNode& note2,
 		return 0;
 	}
 	int cross = 0;
+	if ((type == INTERVAL_HARMONIC) && (abs(note2.b40) < abs(note1.b40))) {
+		cross = 1;
+	}
+	int interval = getInterval(note1, note2, type, octaveadjust);
+
+	if (chromaticQ) {
+		out << Convert::base40ToIntervalAbbr(interval);
+	} else {
+		int negative = 1;
+		if (interval < 0) {
+			negative = -1;
+			interval = -interval;
+		}
+		if (base7Q && !zeroQ) {
+			out << negative * (interval+1);
+		} else {
+			out << negative * interval;
+		}
+	}
+
+	if (sustainQ || ((type == INTERVAL_HARMONIC) && xoptionQ)) {
+		// print sustain/attack information of intervals.
+		if (note1.b40 < 0) {
+			out << "s";
+		} else {
+			out << "x";
+		}
+		if (note2.b40 < 0) {
+			out << "s";
+		} else {
+			out << "x";
+		}
+	}
+
+	return cross;
+}
+
+
+
+//////////////////////////////
+//
+// Tool_cint::getInterval -- Return the interval between two (non-rest)
+//     notes in the units which printInterval displays (or in base-40
+//     for --chromatic).
+//
+
+int Tool_cint::getInterval(NoteNode& note1, NoteNode& note2, int type,
+		int octaveadjust) {
 	int pitch1 = abs(note1.b40);
 	int pitch2 = abs(note2.b40);
 	int interval = pitch2 - pitch1;
 
 	if ((type == INTERVAL_HARMONIC) && (interval < 0)) {
-		cross = 1;
 		if (uncrossQ) {
 			interval = -interval;
 		}
@@ -1934,37 +2306,7 @@ int Tool_cint::printInterval(ostream& out, NoteNode& note1, NoteNode& note2,
 		interval = interval + octaveadjust  * 7;
 	}
 
-
-	if (chromaticQ) {
-		out << Convert::base40ToIntervalAbbr(interval);
-	} else {
-		int negative = 1;
-		if (interval < 0) {
-			negative = -1;
-			interval = -interval;
-		}
-		if (base7Q && !zeroQ) {
-			out << negative * (interval+1);
-		} else {
-			out << negative * interval;
-		}
-	}
-
-	if (sustainQ || ((type == INTERVAL_HARMONIC) && xoptionQ)) {
-		// print sustain/attack information of intervals.
-		if (note1.b40 < 0) {
-			out << "s";
-		} else {
-			out << "x";
-		}
-		if (note2.b40 < 0) {
-			out << "s";
-		} else {
-			out << "x";
-		}
-	}
-
-	return cross;
+	return interval;
 }
 
 
@@ -2251,11 +2593,8 @@ void Tool_cint::extractNoteArray(vector<vector<NoteNode> >& notes, HumdrumFile&
 
 	HumRegex hre;
 
-	Ids.resize(infile.getTrackCount()+1);
+	vector<string> ids(infile.getTrackCount()+1, EMPTY_ID);
 	int i, j, ii, jj;
-	for (i=0; i<(int)Ids.size(); i++) {
-		Ids[i] = EMPTY_ID;
-	}
 
 	vector<NoteNode> current(ktracks.size());
 	vector<double> beatsizes(infile.getTrackCount()+1, 1);
@@ -2317,7 +2656,7 @@ void Tool_cint::extractNoteArray(vector<vector<NoteNode> >& notes, HumdrumFile&
 			for (j=0; j<infile[i].getFieldCount(); j++) {
 				if (hre.search(*infile.token(i, j), "^!ID:\\s*([^\\s]*)")) {
 					int track = infile.token(i, j)->getTrack();
-					Ids[track] = hre.getMatch(1);
+					ids[track] = hre.getMatch(1);
 				}
 			}
 		}
@@ -2337,8 +2676,8 @@ void Tool_cint::extractNoteArray(vector<vector<NoteNode> >& notes, HumdrumFile&
 				continue;
 			}
 			if (idQ) {
-				current[index].getId() = Ids[track];
-				Ids[track] = "";  // don't assign to next item;
+				current[index].getId() = ids[track];
+				ids[track] = "";  // don't assign to next item;
 			}
 			current[index].line  = i;
 			current[index].spine = j;
@@ -2707,6 +3046,23 @@ void Tool_cint::initialize(void) {
 		SearchString = getString("search");
 	}
 
+	statsQ  = getBoolean("stats");
+	jsonQ   = getBoolean("json");
+	Threads = getInteger("threads");
+	if (statsQ) {
+		// Only count modules: the options below would add file-specific
+		// information to the module text.
+		idQ       = 0;
+		durationQ = 0;
+		raw2Q     = 0;
+		searchQ   = 0;
+		markQ     = 0;
+		retroQ    = 0;
+	}
+	if (debugQ) {
+		Threads = 1;
+	}
+
 }
 
 
@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sun Jul 14 01:03:07 CEST 2019
-// Last Modified: Thu Jun  9 15:23:15 PDT 2022
+// Last Modified: Mon Oct 19 16:58:40 PDT 2026
 // Filename:      tool-composite.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/src/tool-composite.cpp
 // Syntax:        C++11; humlib
@@ -177,6 +177,7 @@ void Tool_composite::initialize(HumdrumFile& infile) {
 
 	initializeNumericAnalyses(infile);
 	m_assignedQ = false;
+	m_onsetsQ = false;
 	m_coinMarkQ = getBoolean("mark");
 	if (getBoolean("mark-input")) {
 		m_coinMarkQ = true;
@@ -1560,17 +1561,14 @@ void Tool_composite::analyzeCoincidenceRhythms(HumdrumFile& infile) {
 		timestamps[i] = infile[i].getDurationFromStart();
 	}
 
+	// A coincident attack requires an attack in both groups, otherwise
+	// the coincidence rhythm is sustaining if both groups are sounding.
+	int bothGroups = 0x3;
 	vector<int> merged(infile.getLineCount(), 0);
 	for (int i=0; i<infile.getLineCount(); i++) {
-		if (groupAstates.at(i) == groupBstates.at(i)) {
-			merged[i] = groupAstates.at(i);
-		} else if (groupAstates[i] == 0 || (groupBstates[i] == 0)) {
-			merged[i] = 0;
-		} else if ((groupAstates[i] > 0) && (groupBstates[i] < 0)) {
-			merged[i] = groupBstates[i];
-		} else if ((groupAstates[i] < 0) && (groupBstates[i] > 0)) {
-			merged[i] = groupAstates[i];
-		} else {
+		if ((m_groupAttacks[i] & bothGroups) == bothGroups) {
+			merged[i] = 1;
+		} else if ((m_groupSounding[i] & bothGroups) == bothGroups) {
 			merged[i] = -1;
 		}
 	}
@@ -1667,8 +1665,7 @@ void Tool_composite::analyzeCoincidenceRhythms(HumdrumFile& infile) {
 			}
 		}
 		if (noteAttack[i]) {
-			HumNum duration = infile[nextAttackIndex[i]].getDurationFromStart() -
-				infile[i].getDurationFromStart();
+			HumNum duration = timestamps[nextAttackIndex[i]] - timestamps[i];
 			HumNum durtobar = infile[i].getDurationToBarline();
 			if (duration > durtobar) {
 				// clip the duration to the duration of the rest of the measure
@@ -1752,105 +1749,83 @@ void Tool_composite::analyzeCoincidenceRhythms(HumdrumFile& infile) {
 
 void Tool_composite::getNumericGroupStates(vector<int>& states,
 		HumdrumFile& infile, const string& tgroup) {
+	if (!m_onsetsQ) {
+		analyzeGroupOnsets(infile);
+	}
 	states.resize(infile.getLineCount());
 	fill(states.begin(), states.end(), 0);
-	bool nullSustain = false;
-	bool tieNote = false;
+	int index = getGroupIndex(tgroup);
+	if (index < 0) {
+		return;
+	}
+	int bit = 1 << index;
 	for (int i=0; i<infile.getLineCount(); i++) {
+		if (m_groupAttacks[i] & bit) {
+			states[i] = 1;
+		} else if (m_groupSounding[i] & bit) {
+			states[i] = -1;
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_composite::analyzeGroupOnsets -- Scan the **kern tokens of each data
+//     line once to fill in the onset bitmaps for groups A and B, and to count
+//     the note onsets for the numeric analyses.  A null token in a group
+//     marks the group as sounding if it resolves to a note.
+//
+
+void Tool_composite::analyzeGroupOnsets(HumdrumFile& infile) {
+	if (!m_assignedQ) {
+		assignGroups(infile);
+	}
+	int lineCount = infile.getLineCount();
+	m_groupAttacks.assign(lineCount, 0);
+	m_groupSounding.assign(lineCount, 0);
+	m_onsetCounts.resize(3);
+	for (int i=0; i<(int)m_onsetCounts.size(); i++) {
+		m_onsetCounts[i].assign(lineCount, 0);
+	}
+
+	for (int i=0; i<lineCount; i++) {
 		if (!infile[i].isData()) {
 			continue;
 		}
-		vector<int> linestates;
-		linestates.clear();
 		for (int j=0; j<infile[i].getFieldCount(); j++) {
 			HTp token = infile.token(i, j);
 			if (!token->isKern()) {
 				continue;
 			}
-			string group = token->getValue("auto", "group");
-			if (group != tgroup) {
-				// need to check if null tokens have groups
+			bool attackQ = false;
+			int onsets = countNoteOnsets(token, attackQ);
+			m_onsetCounts[0][i] += onsets;
+			int group = m_fieldGroups[i][j];
+			if (group < 0) {
 				continue;
 			}
-			nullSustain = false;
+			m_onsetCounts[group + 1][i] += onsets;
+			int bit = 1 << group;
 			if (token->isNull()) {
-				nullSustain = true;
-				token = token->resolveNull();
-				if (!token) {
-					continue;
+				HTp resolved = token->resolveNull();
+				if (resolved && !resolved->isRest()) {
+					m_groupSounding[i] |= bit;
 				}
+				continue;
 			}
 			if (token->isRest()) {
 				// resting is the default state.
 				continue;
 			}
-			vector<string> subtoks = token->getSubtokens();
-			bool suschord = true;
-			bool attackchord = false;
-			for (int k=0; k<(int)subtoks.size(); k++) {
-				if (subtoks[k].find("r") != string::npos) {
-					continue;
-				}
-				if (subtoks[k] == ".") {
-					// Strange null subtoken.
-					continue;
-				}
-				if ((subtoks[k].find("]") == string::npos) &&
-						(subtoks[k].find("_") == string::npos)) {
-					suschord = false;
-					attackchord = true;
-				}
-				if (!nullSustain) {
-					if ((subtoks[k].find("]") != string::npos) ||
-						 	(subtoks[k].find("_") != string::npos)) {
-						tieNote = true;
-					} else {
-						tieNote = false;
-					}
-				} else {
-					tieNote = false;
-				}
-			} // end of chord analysis
-			if (attackchord) {
-				suschord = false;
-			}
-			if (suschord && nullSustain) {
-				linestates.push_back(-1);
-			} else if (nullSustain) {
-				linestates.push_back(-1);
-			} else if (suschord) {
-				if (tieNote) {
-					linestates.push_back(-2);
-				} else {
-					linestates.push_back(-1);
-				}
-			} else {
-				linestates.push_back(1);
-			}
-		} // end of line analysis
-
-		bool allZero = true;
-		for (int m=0; m<(int)linestates.size(); m++) {
-			if (linestates[m] != 0) {
-				allZero = false;
-				break;
+			m_groupSounding[i] |= bit;
+			if (attackQ) {
+				m_groupAttacks[i] |= bit;
 			}
 		}
-		bool hasAttack = false;
-		for (int m=0; m<(int)linestates.size(); m++) {
-			if (linestates[m] > 0) {
-				hasAttack = true;
-				break;
-			}
-		}
-		if (hasAttack) {
-			states[i] = 1;
-		} else if (allZero) {
-			states[i] = 0;
-		} else {
-			states[i] = -1;
-		}
 	}
+	m_onsetsQ = true;
 }
 
 
@@ -2237,10 +2212,17 @@ void Tool_composite::assignGroups(HumdrumFile& infile) {
 		curgroup[i].resize(100);
 	}
 
+	m_fieldGroups.clear();
+	m_fieldGroups.resize(infile.getLineCount());
+
 	for (int i=0; i<infile.getLineCount(); i++) {
 		if (!infile[i].hasSpines()) {
 			continue;
 		}
+		bool dataQ = infile[i].isData();
+		if (dataQ) {
+			m_fieldGroups[i].resize(infile[i].getFieldCount());
+		}
 		for (int j=0; j<infile[i].getFieldCount(); j++) {
 			// checking all spines (not just **kern data).
 			HTp token = infile.token(i, j);
@@ -2283,6 +2265,9 @@ void Tool_composite::assignGroups(HumdrumFile& infile) {
 
 			string group = curgroup.at(track).at(subtrack);
 			token->setValue("auto", "group", group);
+			if (dataQ) {
+				m_fieldGroups[i][j] = getGroupIndex(group);
+			}
 		}
 	}
 	m_assignedQ = true;
@@ -2290,6 +2275,23 @@ void Tool_composite::assignGroups(HumdrumFile& infile) {
 
 
 
+//////////////////////////////
+//
+// Tool_composite::getGroupIndex -- Return 0 for group A, 1 for group B,
+//     or -1 for no group.
+//
+
+int Tool_composite::getGroupIndex(const string& group) {
+	if (group == "A") {
+		return 0;
+	} else if (group == "B") {
+		return 1;
+	}
+	return -1;
+}
+
+
+
 //////////////////////////////
 //
 // Tool_composite::backfillGroup -- Go back and reassign a group to all lines
@@ -2473,14 +2475,14 @@ int Tool_composite::getGroupNoteType(HumdrumFile& infile, int line, const string
 		return TYPE_NONE;
 	}
 
+	int index = getGroupIndex(group);
 	vector<HTp> grouptokens;
 	for (int i=0; i<infile[line].getFieldCount(); i++) {
 		HTp token = infile.token(line, i);
 		if (!token->isKern()) {
 			continue;
 		}
-		string tgroup = token->getValue("auto", "group");
-		if (group == tgroup) {
+		if (m_fieldGroups.at(line).at(i) == index) {
 			grouptokens.push_back(token);
 		}
 	}
@@ -2688,7 +2690,8 @@ void Tool_composite::doOnsetAnalysisCoincidence(vector<double>& output,
 //////////////////////////////
 //
 // Tool_composite::doOnsetAnalysis -- Count all of the notes on each line
-//   (that are in **kern spines, ignoring other kern-like spines).
+//   (that are in **kern spines, ignoring other kern-like spines).  The counts
+//   are taken from the onset analysis done in analyzeGroupOnsets().
 //
 
 void Tool_composite::doOnsetAnalysis(vector<double>& analysis, HumdrumFile& infile,
@@ -2696,28 +2699,20 @@ void Tool_composite::doOnsetAnalysis(vector<double>& analysis, HumdrumFile& infi
 	// analysis should already be sized to the number of lines in infile,
 	// and initialized to zero.
 
-	bool fullQ = (targetGroup == "") ? true : false;
-	string group;
+	if (!m_onsetsQ) {
+		analyzeGroupOnsets(infile);
+	}
+	int index = 0;
+	if (targetGroup != "") {
+		index = getGroupIndex(targetGroup) + 1;
+	}
+	vector<int>& counts = m_onsetCounts.at(index);
 
 	for (int i=0; i<(int)infile.getLineCount(); i++) {
 		if (!infile[i].isData()) {
 			continue;
 		}
-		int csum = 0;
-		for (int j=0; j<infile[i].getFieldCount(); j++) {
-			HTp token = infile.token(i, j);
-			if (!token->isKern()) {
-				continue;
-			}
-			if (!fullQ) {
-				string group = token->getValue("auto", "group");
-				if (group != targetGroup) {
-					continue;
-				}
-			}
-			csum += countNoteOnsets(token);
-		}
-		analysis.at(i) = csum;
+		analysis.at(i) = counts[i];
 	}
 }
 
@@ -2725,29 +2720,38 @@ void Tool_composite::doOnsetAnalysis(vector<double>& analysis, HumdrumFile& infi
 
 //////////////////////////////
 //
-// Tool_composite::countNoteOnsets --
-//
-
-int Tool_composite::countNoteOnsets(HTp token) {
-   vector<string> subtoks;
-   subtoks = token->getSubtokens();
-   int sum = 0;
-   if (*token == ".") {
-      return sum;
-   }
-   for (int i=0; i<(int)subtoks.size(); i++) {
-      if (subtoks[i].find('r') != string::npos) {
-         continue;
-      }
-      if (subtoks[i].find('_') != string::npos) {
-         continue;
-      }
-      if (subtoks[i].find(']') != string::npos) {
-         continue;
-      }
-      sum++;
-   }
-   return sum;
+// Tool_composite::countNoteOnsets -- Return the number of note attacks in
+//    a token (ignoring rests and tied notes).  attackQ is set to true if
+//    there is at least one note attack that is not a null subtoken.
+//
+
+int Tool_composite::countNoteOnsets(HTp token, bool& attackQ) {
+	attackQ = false;
+	if (token->empty() || (*token == ".")) {
+		return 0;
+	}
+	const string& text = *token;
+	int sum = 0;
+	int start = 0;
+	bool skipQ = false;
+	for (int i=0; i<=(int)text.size(); i++) {
+		if ((i < (int)text.size()) && (text[i] != ' ')) {
+			char ch = text[i];
+			if ((ch == 'r') || (ch == '_') || (ch == ']')) {
+				skipQ = true;
+			}
+			continue;
+		}
+		if (!skipQ) {
+			sum++;
+			if (text.compare(start, i - start, ".") != 0) {
+				attackQ = true;
+			}
+		}
+		start = i + 1;
+		skipQ = false;
+	}
+	return sum;
 }
 
 
@@ -14,9 +14,11 @@
 #include "tool-dissonant.h"
 #include "Convert.h"
 #include "HumRegex.h"
+#include "HumParallel.h"
 
 #include <algorithm>
 #include <cmath>
+#include <memory>
 
 using namespace std;
 
@@ -49,6 +51,7 @@ Tool_dissonant::Tool_dissonant(void) {
 	define("i|x|e|exinterp=s:**cdata-rdiss", "specify exinterp for **diss spines");
 	define("color|colorize|color-by-rhythm=b",        "color dissonant notes by beat level");
 	define("color2|colorize2|color-by-interval=b",    "color dissonant notes by dissonant interval");
+	define("t|threads=i:1",                  "number of threads for analyzing voices (0 = all cores)");
 }
 
 
@@ -118,7 +121,8 @@ bool Tool_dissonant::run(HumdrumFile& infile) {
 		fillLabels();
 	}
 
-	NoteGrid grid(infile);
+	shared_ptr<NoteGrid> gridptr = infile.getAnalysis<NoteGrid>();
+	NoteGrid& grid = *gridptr;
 
 	if (getBoolean("debug")) {
 		grid.printGridInfo(cerr);
@@ -140,6 +144,11 @@ bool Tool_dissonant::run(HumdrumFile& infile) {
 		return 1;
 	}
 
+	if (grid.getVoiceCount() == 0) {
+		// No **kern spines, or spines which the grid cannot be built for.
+		return false;
+	}
+
 	diss2Q = false;
 	diss7Q = false;
 	diss4Q = false;
@@ -151,6 +160,13 @@ bool Tool_dissonant::run(HumdrumFile& infile) {
 	suppressQ = getBoolean("suppress");
 	voiceFuncsQ = getBoolean("voice-functions");
 
+	// Colorization changes the note tokens and debugging prints the
+	// analysis of each voice, so these are only done in one thread.
+	m_threads = getInteger("threads");
+	if (getBoolean("debug") || getBoolean("colorize") || getBoolean("colorize2")) {
+		m_threads = 1;
+	}
+
 	vector<vector<string>> results;
 	vector<vector<string>> results2;
 	vector<vector<string>> voiceFuncs;
@@ -172,7 +188,8 @@ bool Tool_dissonant::run(HumdrumFile& infile) {
 		// the durations, there will be no output from the program probably.
 		infile.analyzeStructure();
 
-		NoteGrid grid2(infile);
+		shared_ptr<NoteGrid> grid2ptr = infile.getAnalysis<NoteGrid>();
+		NoteGrid& grid2 = *grid2ptr;
 		results2.resize(grid2.getVoiceCount());
 		for (int i=0; i<(int)results2.size(); i++) {
 			results2[i].clear();
@@ -1174,32 +1191,53 @@ void Tool_dissonant::printColorLegend(HumdrumFile& infile) {
 //////////////////////////////
 //
 // Tool_dissonant::doAnalysis -- do a basic melodic analysis of all parts.
+//    Each stage must finish for all voices before the next one starts.
+//    doAnalysisForVoice, findLs and findYs read (and doAnalysisForVoice
+//    also writes) the labels of other voices, so their voices are analyzed
+//    one after another.  Fake suspensions and appoggiaturas only look at
+//    the labels of their own voice, so their voices can be analyzed in
+//    separate threads.
 //
 
 void Tool_dissonant::doAnalysis(vector<vector<string>>& results,
 		NoteGrid& grid, vector<vector<NoteCell*>>& attacks, bool debug) {
-	attacks.resize(grid.getVoiceCount());
+	int voicecount = grid.getVoiceCount();
+	attacks.resize(voicecount);
 
-	for (int i=0; i<grid.getVoiceCount(); i++) {
+	for (int i=0; i<voicecount; i++) {
 		attacks[i].clear();
 		doAnalysisForVoice(results, grid, attacks[i], i, debug);
 	}
 
-	for (int i=0; i<grid.getVoiceCount(); i++) {
+	runVoiceStage(voicecount, [&](int i) {
 		findFakeSuspensions(results, grid, attacks[i], i);
-	}
+	});
 
-	for (int i=0; i<grid.getVoiceCount(); i++) {
+	for (int i=0; i<voicecount; i++) {
 		findLs(results, grid, attacks[i], i);
 	}
 
-	for (int i=0; i<grid.getVoiceCount(); i++) {
+	for (int i=0; i<voicecount; i++) {
 		findYs(results, grid, attacks[i], i);
 	}
 
-	for (int i=0; i<grid.getVoiceCount(); i++) {
+	runVoiceStage(voicecount, [&](int i) {
 		findAppoggiaturas(results, grid, attacks[i], i);
-	}
+	});
+}
+
+
+
+//////////////////////////////
+//
+// Tool_dissonant::runVoiceStage -- Run one stage of the analysis for
+//    each voice, using the number of threads given by the -t option.
+//    The stage must only access the labels of its own voice.
+//
+
+void Tool_dissonant::runVoiceStage(int voicecount,
+		const function<void(int)>& stage) {
+	HumParallel::run(voicecount, m_threads, stage);
 }
 
 
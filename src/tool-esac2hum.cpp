@@ -231,9 +231,12 @@
 #include "tool-esac2hum.h"
 #include "Convert.h"
 #include "HumRegex.h"
+#include "HumParallel.h"
 
+#include <algorithm>
 #include <ctime>
 #include <iomanip>
+#include <sstream>
 
 using namespace std;
 
@@ -252,6 +255,7 @@ Tool_esac2hum::Tool_esac2hum(void) {
 	define("v|verbose=s", "Print verbose messages");
 	define("e|embed-esac=b", "Eembed EsAC data in output");
 	define("a|analyses|analysis=b", "Generate EsAC analysis fields");
+	define("t|threads=i:1", "Number of threads for converting songs (0 = all cores)");
 }
 
 
@@ -262,7 +266,6 @@ Tool_esac2hum::Tool_esac2hum(void) {
 //
 
 bool Tool_esac2hum::convertFile(ostream& out, const string& filename) {
-	initialize();
 	ifstream file(filename);
 	if (file) {
 		return convert(out, file);
@@ -272,6 +275,7 @@ bool Tool_esac2hum::convertFile(ostream& out, const string& filename) {
 
 
 bool Tool_esac2hum::convert(ostream& out, istream& input) {
+	initialize();
 	convertEsacToHumdrum(out, input);
 	return true;
 }
@@ -280,8 +284,7 @@ bool Tool_esac2hum::convert(ostream& out, istream& input) {
 bool Tool_esac2hum::convert(ostream& out, const string& input) {
 	stringstream ss;
 	ss << input;
-	convertEsacToHumdrum(out, ss);
-	return true;
+	return convert(out, ss);
 }
 
 
@@ -296,6 +299,7 @@ void Tool_esac2hum::initialize(void) {
 	m_verbose    = getString("verbose");     // p = phrase, m=measure, n=note
 	m_embedEsacQ = getBoolean("embed-esac"); // don't print input EsAC data
 	m_analysisQ  = getBoolean("analyses");   // embed analysis in EsAC data
+	m_threads    = getInteger("threads");    // number of songs converted at once
 	if (m_analysisQ) {
 		m_embedEsacQ = true;
 	}
@@ -312,9 +316,19 @@ void Tool_esac2hum::convertEsacToHumdrum(ostream& output, istream& infile) {
 	m_inputline = 0;
 	m_prevline = "";
 
+	std::time_t t = std::time(nullptr);
+	stringstream date;
+	date << std::put_time(std::localtime(&t), "%Y/%m/%d");
+	m_conversionDate = date.str();
+
 	vector<string> song;  // contents of one EsAC song, extracted from input stream
 	song.reserve(1000);
 
+	// songs and comments: used to store the input songs when converting
+	// more than one song at a time.
+	vector<vector<string>> songs;
+	vector<vector<string>> comments;
+
 	while (!infile.eof()) {
 		if (m_debugQ) {
 			cerr << "Getting a song..." << endl;
@@ -335,12 +349,76 @@ void Tool_esac2hum::convertEsacToHumdrum(ostream& output, istream& infile) {
 			cerr << "Song is too short" << endl;
 			continue;
 		}
-		convertSong(output, song);
+		if (m_threads == 1) {
+			convertSong(output, song);
+		} else {
+			songs.push_back(song);
+			comments.push_back(m_globalComments);
+		}
+	}
+
+	if (!songs.empty()) {
+		convertSongs(output, songs, comments);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_esac2hum::convertSongs -- Convert a list of songs from a collection
+//    file, and print them in the input order.  Songs are independent of each
+//    other, so each worker thread converts whole songs taken from a shared
+//    counter, using its own converter so that the parsing buffers are reused
+//    for each song that it converts.  If threads cannot be created, the
+//    calling thread converts the remaining songs.
+//
+
+void Tool_esac2hum::convertSongs(ostream& output, vector<vector<string>>& songs,
+		vector<vector<string>>& comments) {
+	int count = (int)songs.size();
+	int threadcount = HumParallel::getThreadCount(m_threads, count);
+	vector<Tool_esac2hum> converters(threadcount);
+	for (int i=0; i<threadcount; i++) {
+		converters[i].copySettings(*this);
+	}
+
+	vector<string> results(count);
+	HumParallel::runWorkers(count, threadcount, [&](int i, int worker) {
+		Tool_esac2hum& converter = converters[worker];
+		stringstream buffer;
+		converter.m_globalComments.swap(comments[i]);
+		converter.convertSong(buffer, songs[i]);
+		results[i] = buffer.str();
+	});
+
+	for (int i=0; i<count; i++) {
+		output << results[i];
 	}
 }
 
 
 
+//////////////////////////////
+//
+// Tool_esac2hum::copySettings -- Copy the conversion options from another
+//    converter (used for the converters in worker threads).
+//
+
+void Tool_esac2hum::copySettings(const Tool_esac2hum& tool) {
+	m_debugQ         = tool.m_debugQ;
+	m_verboseQ       = tool.m_verboseQ;
+	m_verbose        = tool.m_verbose;
+	m_embedEsacQ     = tool.m_embedEsacQ;
+	m_analysisQ      = tool.m_analysisQ;
+	m_filePrefix     = tool.m_filePrefix;
+	m_filePostfix    = tool.m_filePostfix;
+	m_fileTitleQ     = tool.m_fileTitleQ;
+	m_conversionDate = tool.m_conversionDate;
+}
+
+
+
 //////////////////////////////
 //
 // Tool_esac2hum::getSong -- get a song from a multiple-song EsAC file.
@@ -479,6 +557,28 @@ bool Tool_esac2hum::getSong(vector<string>& song, istream& infile) {
 //
 
 void Tool_esac2hum::cleanText(std::string& buffer) {
+	// Remove MS-DOS newline character at ends of lines:
+	if (!buffer.empty()) {
+		if (buffer.back() == 0x0d) {
+			// windows newline piece
+			buffer.resize(buffer.size() - 1);
+		}
+	}
+	// In VHV, when saving content to the local computer in EsAC mode, the 0x0d character should be added back.
+
+	// The fixes below only change non-ASCII bytes, so most lines
+	// do not need to be searched:
+	bool asciiQ = true;
+	for (int i=0; i<(int)buffer.size(); i++) {
+		if ((unsigned char)buffer[i] >= 0x80) {
+			asciiQ = false;
+			break;
+		}
+	}
+	if (asciiQ) {
+		return;
+	}
+
 	HumRegex hre;
 
 	// Fix UTF-8 double encodings (related to editing with Windows-1252 or ISO-8859-2 programs):
@@ -540,15 +640,6 @@ void Tool_esac2hum::cleanText(std::string& buffer) {
 
 	// Random leftover characters from some character conversion:
 	hre.replaceDestructive(buffer, "", "[\x88\x98]", "g");
-
-	// Remove MS-DOS newline character at ends of lines:
-	if (!buffer.empty()) {
-		if (buffer.back() == 0x0d) {
-			// windows newline piece
-			buffer.resize(buffer.size() - 1);
-		}
-	}
-	// In VHV, when saving content to the local computer in EsAC mode, the 0x0d character should be added back.
 }
 
 
@@ -2091,6 +2182,7 @@ string Tool_esac2hum::createFilename(void) {
 
 void Tool_esac2hum::getParameters(vector<string>& infile) {
 	m_score.m_params.clear();
+	m_dwokQ = false;
 	HumRegex hre;
 	bool expectingCloseQ = false;
 	string lastKey = "";
@@ -2413,11 +2505,7 @@ void Tool_esac2hum::printPdfLinks(ostream& output) {
 //
 
 void Tool_esac2hum::printConversionDate(ostream& output) {
-	std::time_t t = std::time(nullptr);
-	std::tm* now = std::localtime(&t);
-	output << "!!!ONB: Converted on ";
-	output << std::put_time(now, "%Y/%m/%d");
-	output << " with esac2hum" << endl;
+	output << "!!!ONB: Converted on " << m_conversionDate << " with esac2hum" << endl;
 }
 
 
@@ -16,6 +16,7 @@
 
 #include <regex>
 #include <cmath>
+#include <memory>
 
 using namespace std;
 
@@ -155,7 +156,8 @@ void Tool_fb::initialize(void) {
 
 void Tool_fb::processFile(HumdrumFile& infile) {
 
-	NoteGrid grid(infile);
+	shared_ptr<NoteGrid> gridptr = infile.getAnalysis<NoteGrid>();
+	NoteGrid& grid = *gridptr;
 
 	vector<FiguredBassNumber*> numbers;
 
@@ -56,6 +56,7 @@
 #include "tool-kern2mens.h"
 #include "tool-kernify.h"
 #include "tool-kernview.h"
+#include "tool-keytrack.h"
 #include "tool-mei2hum.h"
 #include "tool-melisma.h"
 #include "tool-mens2kern.h"
@@ -320,6 +321,8 @@ bool Tool_filter::run(HumdrumFileSet& infiles) {
 			RUNTOOL(kernify, infile, commands[i].second, status);
 		} else if (commands[i].first == "kernview") {
 			RUNTOOL(kernview, infile, commands[i].second, status);
+		} else if (commands[i].first == "keytrack") {
+			RUNTOOL(keytrack, infile, commands[i].second, status);
 		} else if (commands[i].first == "melisma") {
 			RUNTOOL(melisma, infile, commands[i].second, status);
 		} else if (commands[i].first == "mens2kern") {
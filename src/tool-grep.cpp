@@ -80,6 +80,21 @@ bool Tool_grep::run(HumdrumFile& infile) {
 }
 
 
+bool Tool_grep::run(HumdrumLineStream& instream, ostream& out) {
+	initialize();
+	HumRegex hre;
+	HumdrumStreamLine line;
+	while (instream.getLine(line)) {
+		processLine(hre, line.getText(), out);
+	}
+	if (!instream.isValid()) {
+		m_error_text << instream.getParseError() << endl;
+		return false;
+	}
+	return true;
+}
+
+
 
 //////////////////////////////
 //
@@ -101,20 +116,31 @@ void Tool_grep::initialize(void) {
 
 void Tool_grep::processFile(HumdrumFile& infile) {
 	HumRegex hre;
-	bool match;
 	for (int i=0; i<infile.getLineCount(); i++) {
-		match = hre.search(infile[i], m_regex);
-		if (m_negateQ) {
-			if (match) {
-				continue;
-			}
-		} else {
-			if (!match) {
-				continue;
-			}
+		processLine(hre, infile[i], m_humdrum_text);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_grep::processLine -- Print the line if it matches (or does not
+//     match when using -v) the regular expression.
+//
+
+void Tool_grep::processLine(HumRegex& hre, const string& line, ostream& out) {
+	bool match = hre.search(line, m_regex);
+	if (m_negateQ) {
+		if (match) {
+			return;
+		}
+	} else {
+		if (!match) {
+			return;
 		}
-		m_humdrum_text << infile[i] << "\n";
 	}
+	out << line << "\n";
 }
 
 
@@ -113,7 +113,8 @@ void Tool_homorhythm2::initialize(void) {
 
 void Tool_homorhythm2::processFile(HumdrumFile& infile) {
 	infile.analyzeStructure();
-	NoteGrid grid(infile);
+	shared_ptr<NoteGrid> gridptr = infile.getAnalysis<NoteGrid>();
+	NoteGrid& grid = *gridptr;
 	m_score.resize(infile.getLineCount());
 	fill(m_score.begin(), m_score.end(), 0.0);
 
@@ -34,6 +34,7 @@ Tool_humdiff::Tool_humdiff(void) {
 	define("time-points|times=b", "display timepoint lists for each file");
 	define("note-points|notes=b", "display notepoint lists for each file");
 	define("c|color=s:red",       "color for difference markers");
+	define("a|align=b",           "align notes of each part with minimal edit script");
 }
 
 
@@ -63,8 +64,13 @@ bool Tool_humdiff::run(HumdrumFileSet& infiles) {
 		cerr << "Usage: " << getCommand() << " files" << endl;
 		return false;
 	} else {
+		bool alignQ = getBoolean("align");
 		HumNum targetdur = infiles[0].getScoreDuration();
 		for (int i=1; i<infiles.getSize(); i++) {
+			if (alignQ) {
+				// Alignment allows for inserted or deleted music.
+				break;
+			}
 			HumNum dur = infiles[i].getScoreDuration();
 			if (dur != targetdur) {
 				cerr << "Error: all files must have the same duration" << endl;
@@ -72,11 +78,17 @@ bool Tool_humdiff::run(HumdrumFileSet& infiles) {
 			}
 		}
 
+		m_referenceParts.clear();
+		m_referenceKeys.clear();
 		for (int i=0; i<infiles.getCount(); i++) {
 			if (i == reference) {
 				continue;
 			}
-			compareFiles(infiles[reference], infiles[i]);
+			if (alignQ) {
+				alignFiles(infiles[reference], infiles[i], i+1);
+			} else {
+				compareFiles(infiles[reference], infiles[i]);
+			}
 		}
 
 		if (!getBoolean("report")) {
@@ -440,6 +452,417 @@ void Tool_humdiff::extractTimePoints(vector<TimePoint>& points, HumdrumFile& inf
 
 
 
+//////////////////////////////
+//
+// Tool_humdiff::alignFiles -- Align the notes in each part of the reference
+//     score to the notes in the same part of the alternate score.  Parts are
+//     matched by the order of the **kern spines in each file.  Notes are
+//     considered the same if they have the same pitch and (tied) duration,
+//     so a measure inserted into one score only causes an insertion in the
+//     edit script rather than a mismatch for all following notes.
+//
+
+void Tool_humdiff::alignFiles(HumdrumFile& reference, HumdrumFile& alternate,
+		int source) {
+	if (m_referenceParts.empty()) {
+		extractPartNotes(m_referenceParts, reference);
+		m_referenceKeys.resize(m_referenceParts.size());
+		for (int i=0; i<(int)m_referenceParts.size(); i++) {
+			getNoteKeys(m_referenceKeys[i], m_referenceParts[i]);
+		}
+	}
+
+	vector<vector<NotePoint>> altparts;
+	extractPartNotes(altparts, alternate);
+
+	bool reportQ = getBoolean("report");
+	int partcount = (int)m_referenceParts.size();
+	if ((int)altparts.size() != partcount) {
+		if (reportQ) {
+			m_free_text << "SOURCE " << source << " HAS " << altparts.size()
+			            << " PARTS BUT REFERENCE HAS " << partcount << " PARTS" << endl;
+		}
+		partcount = std::min(partcount, (int)altparts.size());
+	}
+
+	vector<int> altkeys;
+	vector<DiffEdit> edits;
+	for (int p=0; p<partcount; p++) {
+		getNoteKeys(altkeys, altparts[p]);
+		alignNotes(edits, m_referenceKeys[p], altkeys);
+		if (reportQ) {
+			printAlignment(edits, m_referenceParts[p], altparts[p], p+1, source);
+			continue;
+		}
+		for (int i=0; i<(int)edits.size(); i++) {
+			if ((edits[i].type != '-') && (edits[i].type != '~')) {
+				continue;
+			}
+			NotePoint& np = m_referenceParts[p].at(edits[i].refindex);
+			if (!np.processed) {
+				markNote(np);
+				np.processed = 1;
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_humdiff::extractPartNotes -- Extract a list of the note attacks in
+//     each **kern spine of the file (grace notes and tied notes after the
+//     first one are ignored).
+//
+
+void Tool_humdiff::extractPartNotes(vector<vector<NotePoint>>& parts,
+		HumdrumFile& infile) {
+	vector<HTp> kernstarts = infile.getKernSpineStartList();
+	vector<int> partindex(infile.getMaxTrack() + 1, -1);
+	for (int i=0; i<(int)kernstarts.size(); i++) {
+		partindex.at(kernstarts[i]->getTrack()) = i;
+	}
+	parts.clear();
+	parts.resize(kernstarts.size());
+
+	HumRegex hre;
+	int measure = -1;
+	NotePoint np;
+	for (int i=0; i<infile.getLineCount(); i++) {
+		if (infile[i].isBarline()) {
+			if (hre.search(infile.token(i, 0), "(\\d+)")) {
+				measure = hre.getMatchInt(1);
+			}
+			continue;
+		}
+		if (!infile[i].isData()) {
+			continue;
+		}
+		if (infile[i].getDuration() == 0) {
+			// ignore grace notes for now
+			continue;
+		}
+		for (int j=0; j<infile[i].getFieldCount(); j++) {
+			HTp token = infile.token(i, j);
+			if (!token->isKern() || token->isNull() || token->isRest()) {
+				continue;
+			}
+			int track = token->getTrack();
+			if (partindex.at(track) < 0) {
+				continue;
+			}
+			int scount = token->getSubtokenCount();
+			for (int k=0; k<scount; k++) {
+				string subtok = token->getSubtoken(k);
+				if (subtok.find("]") != string::npos) {
+					continue;
+				}
+				if (subtok.find("_") != string::npos) {
+					continue;
+				}
+				np.clear();
+				np.token          = token;
+				np.subtoken       = subtok;
+				np.subindex       = k;
+				np.measure        = measure;
+				np.measurequarter = token->getDurationFromBarline();
+				np.track          = track;
+				np.layer          = token->getSubtrack();
+				np.duration       = token->getTiedDuration();
+				np.b40            = Convert::kernToBase40(subtok);
+				parts[partindex[track]].push_back(np);
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_humdiff::getNoteKeys -- Convert the pitch and duration of each note
+//     into an integer, so that notes can be compared quickly.
+//
+
+void Tool_humdiff::getNoteKeys(vector<int>& keys, vector<NotePoint>& notes) {
+	keys.resize(notes.size());
+	for (int i=0; i<(int)notes.size(); i++) {
+		pair<int, HumNum> note(notes[i].b40, notes[i].duration);
+		auto it = m_noteKeys.find(note);
+		if (it == m_noteKeys.end()) {
+			int key = (int)m_noteKeys.size();
+			m_noteKeys[note] = key;
+			keys[i] = key;
+		} else {
+			keys[i] = it->second;
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_humdiff::alignNotes -- Calculate a minimal edit script between two
+//     note sequences using Myers' O(ND) difference algorithm.  The linear
+//     space version of the algorithm is used, which finds the middle of the
+//     edit path and then aligns both halves separately, so the memory
+//     needed only depends on the length of the sequences.  Neighboring
+//     deletions and insertions are then reported as changed notes.
+//
+
+void Tool_humdiff::alignNotes(vector<DiffEdit>& edits, const vector<int>& a,
+		const vector<int>& b) {
+	edits.clear();
+	edits.reserve(std::max(a.size(), b.size()));
+	alignRange(edits, a, 0, (int)a.size(), b, 0, (int)b.size());
+
+	// Merge neighboring deletions and insertions into changes.
+	vector<DiffEdit> output;
+	output.reserve(edits.size());
+	int i = 0;
+	while (i < (int)edits.size()) {
+		if (edits[i].type == '=') {
+			output.push_back(edits[i++]);
+			continue;
+		}
+		int start = i;
+		while ((i < (int)edits.size()) && (edits[i].type != '=')) {
+			i++;
+		}
+		vector<int> deleted;
+		vector<int> inserted;
+		for (int j=start; j<i; j++) {
+			if (edits[j].type == '-') {
+				deleted.push_back(edits[j].refindex);
+			} else {
+				inserted.push_back(edits[j].altindex);
+			}
+		}
+		int changes = (int)std::min(deleted.size(), inserted.size());
+		for (int j=0; j<changes; j++) {
+			output.emplace_back('~', deleted[j], inserted[j]);
+		}
+		for (int j=changes; j<(int)deleted.size(); j++) {
+			output.emplace_back('-', deleted[j], -1);
+		}
+		for (int j=changes; j<(int)inserted.size(); j++) {
+			output.emplace_back('+', -1, inserted[j]);
+		}
+	}
+	edits.swap(output);
+}
+
+
+
+//////////////////////////////
+//
+// Tool_humdiff::alignRange -- Align a[astart..aend) to b[bstart..bend),
+//     appending the edits to the list.  Matching notes at the start and
+//     end of the ranges are removed before searching for the edit path.
+//
+
+void Tool_humdiff::alignRange(vector<DiffEdit>& edits, const vector<int>& a,
+		int astart, int aend, const vector<int>& b, int bstart, int bend) {
+	while ((astart < aend) && (bstart < bend) && (a[astart] == b[bstart])) {
+		edits.emplace_back('=', astart++, bstart++);
+	}
+	int suffix = 0;
+	while ((astart < aend - suffix) && (bstart < bend - suffix)
+			&& (a[aend-suffix-1] == b[bend-suffix-1])) {
+		suffix++;
+	}
+	aend -= suffix;
+	bend -= suffix;
+
+	if (astart == aend) {
+		for (int j=bstart; j<bend; j++) {
+			edits.emplace_back('+', -1, j);
+		}
+	} else if (bstart == bend) {
+		for (int i=astart; i<aend; i++) {
+			edits.emplace_back('-', i, -1);
+		}
+	} else {
+		bisectRange(edits, a, astart, aend, b, bstart, bend);
+	}
+
+	for (int i=0; i<suffix; i++) {
+		edits.emplace_back('=', aend + i, bend + i);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_humdiff::bisectRange -- Find the middle of the shortest edit path
+//     by searching forwards from the start and backwards from the end of
+//     the ranges at the same time, and then align the two halves.
+//
+
+void Tool_humdiff::bisectRange(vector<DiffEdit>& edits, const vector<int>& a,
+		int astart, int aend, const vector<int>& b, int bstart, int bend) {
+	int n = aend - astart;
+	int m = bend - bstart;
+	int maxd = (n + m + 1) / 2;
+	int offset = maxd;
+	int length = 2 * maxd;
+	vector<int> v1(length, -1);
+	vector<int> v2(length, -1);
+	v1[offset + 1] = 0;
+	v2[offset + 1] = 0;
+	int delta = n - m;
+	bool front = (delta % 2 != 0);
+	int k1start = 0;
+	int k1end   = 0;
+	int k2start = 0;
+	int k2end   = 0;
+
+	for (int d=0; d<maxd; d++) {
+		// forward path
+		for (int k1=-d+k1start; k1<=d-k1end; k1+=2) {
+			int k1offset = offset + k1;
+			int x1;
+			if ((k1 == -d) || ((k1 != d) && (v1[k1offset-1] < v1[k1offset+1]))) {
+				x1 = v1[k1offset+1];
+			} else {
+				x1 = v1[k1offset-1] + 1;
+			}
+			int y1 = x1 - k1;
+			while ((x1 < n) && (y1 < m) && (a[astart+x1] == b[bstart+y1])) {
+				x1++;
+				y1++;
+			}
+			v1[k1offset] = x1;
+			if (x1 > n) {
+				k1end += 2;
+			} else if (y1 > m) {
+				k1start += 2;
+			} else if (front) {
+				int k2offset = offset + delta - k1;
+				if ((k2offset >= 0) && (k2offset < length) && (v2[k2offset] != -1)) {
+					int x2 = n - v2[k2offset];
+					if (x1 >= x2) {
+						alignRange(edits, a, astart, astart+x1, b, bstart, bstart+y1);
+						alignRange(edits, a, astart+x1, aend, b, bstart+y1, bend);
+						return;
+					}
+				}
+			}
+		}
+
+		// reverse path
+		for (int k2=-d+k2start; k2<=d-k2end; k2+=2) {
+			int k2offset = offset + k2;
+			int x2;
+			if ((k2 == -d) || ((k2 != d) && (v2[k2offset-1] < v2[k2offset+1]))) {
+				x2 = v2[k2offset+1];
+			} else {
+				x2 = v2[k2offset-1] + 1;
+			}
+			int y2 = x2 - k2;
+			while ((x2 < n) && (y2 < m) && (a[aend-x2-1] == b[bend-y2-1])) {
+				x2++;
+				y2++;
+			}
+			v2[k2offset] = x2;
+			if (x2 > n) {
+				k2end += 2;
+			} else if (y2 > m) {
+				k2start += 2;
+			} else if (!front) {
+				int k1offset = offset + delta - k2;
+				if ((k1offset >= 0) && (k1offset < length) && (v1[k1offset] != -1)) {
+					int x1 = v1[k1offset];
+					int y1 = offset + x1 - k1offset;
+					if (x1 >= n - x2) {
+						alignRange(edits, a, astart, astart+x1, b, bstart, bstart+y1);
+						alignRange(edits, a, astart+x1, aend, b, bstart+y1, bend);
+						return;
+					}
+				}
+			}
+		}
+	}
+
+	// No overlap found (should not happen): treat as a complete replacement.
+	for (int i=astart; i<aend; i++) {
+		edits.emplace_back('-', i, -1);
+	}
+	for (int j=bstart; j<bend; j++) {
+		edits.emplace_back('+', -1, j);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_humdiff::printAlignment -- Print the differences between a part in
+//     the reference score and the same part in another score.
+//
+
+void Tool_humdiff::printAlignment(vector<DiffEdit>& edits,
+		vector<NotePoint>& refnotes, vector<NotePoint>& altnotes, int part,
+		int source) {
+	int changes    = 0;
+	int deletions  = 0;
+	int insertions = 0;
+	for (int i=0; i<(int)edits.size(); i++) {
+		switch (edits[i].type) {
+			case '~': changes++;    break;
+			case '-': deletions++;  break;
+			case '+': insertions++; break;
+		}
+	}
+	m_free_text << "PART " << part << " SOURCE " << source << ":\t"
+	            << changes << " changed, " << deletions << " deleted, "
+	            << insertions << " inserted" << endl;
+
+	for (int i=0; i<(int)edits.size(); i++) {
+		if (edits[i].type == '=') {
+			continue;
+		}
+		switch (edits[i].type) {
+			case '~': m_free_text << "\tCHANGE\t"; break;
+			case '-': m_free_text << "\tDELETE\t"; break;
+			case '+': m_free_text << "\tINSERT\t"; break;
+		}
+		if (edits[i].refindex >= 0) {
+			m_free_text << "REFERENCE ";
+			printNoteLocation(refnotes.at(edits[i].refindex));
+		}
+		if (edits[i].type == '~') {
+			m_free_text << "\t";
+		}
+		if (edits[i].altindex >= 0) {
+			m_free_text << "TARGET ";
+			printNoteLocation(altnotes.at(edits[i].altindex));
+		}
+		m_free_text << endl;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_humdiff::printNoteLocation -- Print the measure, line number and
+//     text of a note.
+//
+
+void Tool_humdiff::printNoteLocation(NotePoint& np) {
+	m_free_text << "MEASURE " << np.measure;
+	if (np.token) {
+		m_free_text << " LINE " << np.token->getLineNumber();
+	}
+	m_free_text << ": " << np.subtoken;
+}
+
+
+
 //////////////////////////////
 //
 // operator<< == print a TimePoint
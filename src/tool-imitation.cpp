@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sat Jun 17 15:24:23 CEST 2017
-// Last Modified: Fri Aug 11 18:25:50 EDT 2017
+// Last Modified: Mon Oct 19 23:02:41 PDT 2026
 // Filename:      tool-imitation.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/src/tool-imitation.cpp
 // Syntax:        C++11; humlib
@@ -26,7 +26,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <map>
+#include <memory>
 #include <sstream>
+#include <tuple>
 
 using namespace std;
 
@@ -79,6 +82,7 @@ Tool_imitation::Tool_imitation(void) {
 	define("a|add=b",                    "add inversions, retrograde, etc. if specified to normal search");
 	define("v|inversion=b",              "match inversions");
 	define("g|retrograde=b",             "match retrograde");
+	define("S|suffix-array=b",           "report all maximal matches, using a suffix array of all voices");
 }
 
 
@@ -123,7 +127,8 @@ bool Tool_imitation::run(HumdrumFile& infile, ostream& out) {
 bool Tool_imitation::run(HumdrumFile& infile) {
 	Enumerator = 0;
 
-	NoteGrid grid(infile);
+	shared_ptr<NoteGrid> gridptr = infile.getAnalysis<NoteGrid>();
+	NoteGrid& grid = *gridptr;
 
 	if (getBoolean("debug")) {
 		grid.printGridInfo(cerr);
@@ -166,6 +171,7 @@ bool Tool_imitation::run(HumdrumFile& infile) {
 
 	m_inversion  = getBoolean("inversion");
 	m_retrograde = getBoolean("retrograde");
+	m_suffixQ    = getBoolean("suffix-array");
 
 	m_addsearches = false;
 	if (getBoolean("add")) {
@@ -272,6 +278,11 @@ void Tool_imitation::doAnalysis(vector<vector<string> >& results,
 		getIntervals(intervals.at(i), attacks.at(i));
 	}
 
+	if (m_suffixQ) {
+		analyzeImitationBySuffixArray(results, attacks, intervals);
+		return;
+	}
+
 	for (int i=0; i<(int)attacks.size(); i++) {
 		for (int j=i+1; j<(int)attacks.size(); j++) {
 			analyzeImitation(results, attacks, intervals, i, j);
@@ -371,264 +382,577 @@ void Tool_imitation::analyzeImitation(vector<vector<string>>& results,
 				enum1.at(i+k) = Enumerator;
 				enum2.at(j+k) = Enumerator;
 			}
+			addImitation(results, attacks, v1, i, v2, j, count);
 
-			int interval = int(*attacks.at(v2).at(j) - *attacks.at(v1).at(i));
+			// skip over match (need to do in i as well somehow)
+			j += count;
+		} // j loop
+	} // i loop
+}
 
-			if (!m_noInfo) {
-				if (!(m_first && (distance1 < 0))) {
-					int line1 = attacks.at(v1).at(i)->getLineIndex();
-					if (!results.at(v1).at(line1).empty()) {
-						results.at(v1).at(line1) += " ";
-					}
 
-					bool data = false;
-
-					if (!m_noN) {
-						data = true;
-						if (m_inversion) {
-							results.at(v1).at(line1) += "v";
-						} else if (m_retrograde) {
-							results.at(v1).at(line1) += "r";
-						} else {
-							results.at(v1).at(line1) += "n";
-						}
-						results.at(v1).at(line1) += to_string(Enumerator);
-					}
 
-					if (m_measure) {
-						if (data) {
-							results.at(v1).at(line1) += ":";
-						}
-						data = true;
-						results.at(v1).at(line1) += "m";
-						int line = attacks.at(v1).at(i)->getToken()->getLineIndex();
-						results.at(v1).at(line1) += to_string(m_barlines[line]);
-					}
+//////////////////////////////
+//
+// Tool_imitation::analyzeImitationBySuffixArray -- Do imitation analysis
+//     between all voices at once.  The interval sequences of all voices
+//     (and their inversions if searching for inversions) are joined into
+//     one sequence, where each symbol is an interval together with the
+//     duration of the note that starts it.  Matches between voices are
+//     then adjacent entries in a suffix array of the sequence, so only
+//     maximal matches (ones that cannot be extended to the left or right)
+//     are considered, rather than comparing every note pair in every pair
+//     of voices.  The other options are applied as filters on the matches.
+//
 
-					if (m_beat) {
-						if (data) {
-							results.at(v1).at(line1) += ":";
-						}
-						data = true;
-						results.at(v1).at(line1) += "b";
-						HLp humline = attacks.at(v1).at(i)->getToken()->getOwner();
-						stringstream ss;
-						ss.str("");
-						ss << humline->getBeat().getFloat();
-						results.at(v1).at(line1) += ss.str();
-					}
+void Tool_imitation::analyzeImitationBySuffixArray(vector<vector<string>>& results,
+		vector<vector<NoteCell*>>& attacks, vector<vector<double>>& intervals) {
 
-					if (m_length) {
-						if (data) {
-							results.at(v1).at(line1) += ":";
-						}
-						data = true;
-						results.at(v1).at(line1) += "L";
-						// time1 is the starttime
-						HumNum endtime;
-						HTp endtoken = NULL;
-						if (i+count < (int)attacks.at(v1).size()) {
-							endtoken = attacks.at(v1).at(i+count)->getToken();
-							endtime = endtoken->getDurationFromStart();
-						} else {
-							endtime = token1->getOwner()->getOwner()->getScoreDuration();
-						}
-						HumNum duration = endtime - time1;
-						stringstream ss;
-						ss.str("");
-						ss << duration.getFloat();
-						results.at(v1).at(line1) += ss.str();
-					}
+	int min = m_threshold - 1;
+	int copies = m_inversion ? 2 : 1;
+
+	// Symbol keys for each position in the sequence (interval, duration),
+	// with rests marked by -HUGE_VAL, and the voice (-1 for the end of a
+	// voice), attack index and inversion state of each position.
+	vector<std::tuple<double, int, int>> keys;
+	vector<int> voice;
+	vector<int> index;
+	vector<char> inverted;
+	for (int c=0; c<copies; c++) {
+		for (int v=0; v<(int)attacks.size(); v++) {
+			for (int k=0; k<(int)attacks[v].size(); k++) {
+				double interval = intervals[v][k];
+				if (Convert::isNaN(interval)) {
+					interval = -HUGE_VAL;
+				} else if (c) {
+					interval = -interval;
+				}
+				HumNum duration = 0;
+				if (m_duration) {
+					duration = attacks[v][k]->getDuration();
+				}
+				keys.emplace_back(interval, duration.getNumerator(), duration.getDenominator());
+				voice.push_back(v);
+				index.push_back(k);
+				inverted.push_back((char)c);
+			}
+			keys.emplace_back(0.0, 0, 0);
+			voice.push_back(-1);
+			index.push_back(-1);
+			inverted.push_back((char)c);
+		}
+	}
 
-					if (!m_noC) {
-						if (data) {
-							results.at(v1).at(line1) += ":";
-						}
-						data = true;
-						results.at(v1).at(line1) += "c";
-						results.at(v1).at(line1) += to_string(count);
-					}
+	// Convert the keys into integers, with a unique value at the end of
+	// each voice so that matches do not cross voices.
+	vector<std::tuple<double, int, int>> symbols = keys;
+	sort(symbols.begin(), symbols.end());
+	symbols.erase(unique(symbols.begin(), symbols.end()), symbols.end());
+	int n = (int)keys.size();
+	vector<int> sequence(n);
+	int endsymbol = (int)symbols.size();
+	for (int p=0; p<n; p++) {
+		if (voice[p] < 0) {
+			sequence[p] = endsymbol++;
+		} else {
+			sequence[p] = (int)(lower_bound(symbols.begin(), symbols.end(), keys[p]) - symbols.begin());
+		}
+	}
 
-					if (!m_noD) {
-						if (data) {
-							results.at(v1).at(line1) += ":";
-						}
-						data = true;
-						results.at(v1).at(line1) += "d";
-						// maybe allow fractions?
-						results.at(v1).at(line1) += to_string(distance1.getNumerator());
-					}
+	vector<int> suffixes;
+	vector<int> lcp;
+	buildSuffixArray(sequence, suffixes, lcp);
+
+	// A match is a pair of suffixes with a common prefix of at least
+	// minlength symbols (a match of count notes has at least count-1
+	// symbols), which cannot be extended to the left or right.
+	int minlength = std::max(1, min - 1);
+	vector<vector<int>> matches; // v1, i, v2, j, count
+	auto addMatch = [&](int p, int q, int length) {
+		if (inverted[p] > inverted[q]) {
+			std::swap(p, q);
+		}
+		if (m_inversion && (inverted[p] == inverted[q])) {
+			return;
+		}
+		if (voice[p] == voice[q]) {
+			return;
+		}
+		if ((!m_inversion) && (voice[p] > voice[q])) {
+			std::swap(p, q);
+		} else if (m_inversion && (voice[p] > voice[q])) {
+			// The same match is found between the other voice and
+			// the inversion of this one.
+			return;
+		}
+
+		// Matches cannot start with a rest:
+		int v1 = voice[p];
+		int v2 = voice[q];
+		int skip = 0;
+		while ((skip < length) && Convert::isNaN(intervals[v1][index[p] + skip])) {
+			skip++;
+		}
+		if (skip == length) {
+			return;
+		}
+		int i = index[p] + skip;
+		int j = index[q] + skip;
+		int count = length - skip;
+
+		// Count the note after the last matching interval, unless the
+		// end of a voice was reached or the durations do not match
+		// (same as compareSequences()):
+		int p2 = p + length;
+		int q2 = q + length;
+		if ((voice[p2] >= 0) && (voice[q2] >= 0)) {
+			if ((!m_duration) || (get<1>(keys[p2]) == get<1>(keys[q2]) &&
+					get<2>(keys[p2]) == get<2>(keys[q2]))) {
+				count++;
+			}
+		}
 
-					if (!m_noI) {
-						if (data) {
-							results.at(v1).at(line1) += ":";
-						}
-						data = true;
-						if (distance1.getDenominator() != 1) {
-							results.at(v1).at(line1) += '/';
-							results.at(v1).at(line1) += to_string(distance1.getNumerator());
-						}
-						results.at(v1).at(line1) += "i";
-						if (interval > 0) {
-							results.at(v1).at(line1) += to_string(interval + 1);
-						} else {
-							int newinterval = -(interval + 1);
-							if (newinterval == -1) {
-								newinterval = 1; // unison (no sign)
-							}
-							results.at(v1).at(line1) += to_string(newinterval);
-						}
+		if (count < min) {
+			return;
+		}
+		if (m_intervals.size() > 0) {
+			count = checkForIntervalSequence(m_intervals, intervals[v1], i, count);
+			if (count < min) {
+				return;
+			}
+		}
+		if (m_rest || m_rest2) {
+			if ((i > 0) && (!Convert::isNaN(attacks[v1][i-1]->getSgnDiatonicPitch()))) {
+				// match initiator must be preceded by a rest (or start of music)
+				return;
+			}
+		}
+		if (m_rest2) {
+			if ((j > 0) && (!Convert::isNaN(attacks[v2][j-1]->getSgnDiatonicPitch()))) {
+				// match target must be preceded by a rest (or start of music)
+				return;
+			}
+		}
+		HumNum time1 = attacks[v1][i]->getToken()->getDurationFromStart();
+		HumNum time2 = attacks[v2][j]->getToken()->getDurationFromStart();
+		if (m_nozero && (time1 == time2)) {
+			return;
+		}
+		if (m_onlyzero && (time1 != time2)) {
+			return;
+		}
+		HumNum distance = time2 - time1;
+		if (m_maxdistanceQ && (distance.getAbs().getFloat() > m_maxdistance)) {
+			return;
+		}
+		matches.push_back({v1, i, v2, j, count});
+	};
+
+	// Visit the LCP intervals of the suffix array (the internal nodes of
+	// the suffix tree) bottom-up, with the suffixes of each interval
+	// grouped by the symbol before them.  When a child interval is joined
+	// to its parent, the common prefix of a suffix in the child and a
+	// suffix already in the parent is the LCP value of the parent, and
+	// the match is maximal to the left only if the symbols before the two
+	// suffixes differ (or one suffix is at the start of the sequence).
+	// So only maximal pairs are visited, each one once, and the search
+	// time is proportional to the number of maximal pairs even for very
+	// repetitive music.
+	struct LcpInterval {
+		int lcp = 0;
+		int size = 0;
+		map<int, vector<int>> left; // suffixes by preceding symbol
+	};
+	auto join = [&](LcpInterval& target, LcpInterval& child) {
+		if (target.lcp < minlength) {
+			// Too short for a match, and so are all parent intervals.
+			target.left.clear();
+			target.size = 0;
+			return;
+		}
+		for (auto& a : child.left) {
+			for (auto& b : target.left) {
+				if (a.first == b.first) {
+					continue;
+				}
+				for (int p : a.second) {
+					for (int q : b.second) {
+						addMatch(p, q, target.lcp);
 					}
 				}
+			}
+		}
+		if (target.size < child.size) {
+			std::swap(target.left, child.left);
+		}
+		for (auto& a : child.left) {
+			vector<int>& list = target.left[a.first];
+			list.insert(list.end(), a.second.begin(), a.second.end());
+		}
+		target.size += child.size;
+	};
+
+	vector<LcpInterval> pending(1);
+	for (int s=1; s<=n; s++) {
+		int p = suffixes[s-1];
+		LcpInterval child;
+		child.size = 1;
+		child.left[p > 0 ? sequence[p-1] : -1].push_back(p);
+		int h = s < n ? lcp[s] : 0;
+		while (h < pending.back().lcp) {
+			join(pending.back(), child);
+			child = std::move(pending.back());
+			pending.pop_back();
+		}
+		if (h > pending.back().lcp) {
+			child.lcp = h;
+			pending.push_back(std::move(child));
+		} else {
+			join(pending.back(), child);
+		}
+	}
 
-				if (!(m_first && (distance2 <= 0))) {
-					int line2 = attacks.at(v2).at(j)->getLineIndex();
+	// Number the matches in the same order as analyzeImitation():
+	sort(matches.begin(), matches.end());
+	for (int m=0; m<(int)matches.size(); m++) {
+		Enumerator++;
+		addImitation(results, attacks, matches[m][0], matches[m][1],
+				matches[m][2], matches[m][3], matches[m][4]);
+	}
+}
 
-					if (!results.at(v2).at(line2).empty()) {
-						results.at(v2).at(line2) += " ";
-					}
 
-					bool data2 = false;
-
-					if ((!m_noN) && (!m_noNN)) {
-						data2 = true;
-						if (m_inversion) {
-							results.at(v2).at(line2) += "v";
-						} else if (m_retrograde) {
-							results.at(v2).at(line2) += "r";
-						} else {
-							results.at(v2).at(line2) += "n";
-						}
-						results.at(v2).at(line2) += to_string(Enumerator);
-					}
 
-					if (m_measure) {
-						if (data2) {
-							results.at(v2).at(line2) += ":";
-						}
-						data2 = true;
-						results.at(v2).at(line2) += "m";
-						int line = attacks.at(v2).at(j)->getToken()->getLineIndex();
-						results.at(v2).at(line2) += to_string(m_barlines[line]);
-					}
+//////////////////////////////
+//
+// Tool_imitation::buildSuffixArray -- Sort the suffixes of the sequence
+//     by prefix doubling, and then calculate the length of the common
+//     prefix of each suffix with the previous one in the list (lcp[0] is
+//     0), using Kasai's algorithm.
+//
 
-					if (m_beat) {
-						if (data2) {
-							results.at(v2).at(line2) += ":";
-						}
-						data2 = true;
-						results.at(v2).at(line2) += "b";
-						HLp humline = attacks.at(v2).at(j)->getToken()->getOwner();
-						stringstream ss;
-						ss.str("");
-						ss << humline->getBeat().getFloat();
-						results.at(v2).at(line2) += ss.str();
-					}
+void Tool_imitation::buildSuffixArray(vector<int>& sequence,
+		vector<int>& suffixes, vector<int>& lcp) {
+	int n = (int)sequence.size();
+	suffixes.resize(n);
+	lcp.assign(n, 0);
+	if (n == 0) {
+		return;
+	}
+	vector<int> rank = sequence;
+	vector<int> newrank(n);
+	for (int i=0; i<n; i++) {
+		suffixes[i] = i;
+	}
+	for (int k=1; ; k *= 2) {
+		auto before = [&](int a, int b) {
+			if (rank[a] != rank[b]) {
+				return rank[a] < rank[b];
+			}
+			int ra = a + k < n ? rank[a + k] : -1;
+			int rb = b + k < n ? rank[b + k] : -1;
+			return ra < rb;
+		};
+		sort(suffixes.begin(), suffixes.end(), before);
+		newrank[suffixes[0]] = 0;
+		for (int i=1; i<n; i++) {
+			newrank[suffixes[i]] = newrank[suffixes[i-1]] +
+					(before(suffixes[i-1], suffixes[i]) ? 1 : 0);
+		}
+		rank.swap(newrank);
+		if (rank[suffixes[n-1]] == n-1) {
+			break;
+		}
+	}
 
-					if (m_length) {
-						if (data2) {
-							results.at(v2).at(line2) += ":";
-						}
-						data2 = true;
-						results.at(v2).at(line2) += "L";
-						// time1 is the starttime
-						HumNum endtime;
-						HTp endtoken = NULL;
-						if (j+count < (int)attacks.at(v2).size()) {
-							endtoken = attacks.at(v2).at(j+count)->getToken();
-							endtime = endtoken->getDurationFromStart();
-						} else {
-							endtime = token2->getOwner()->getOwner()->getScoreDuration();
-						}
-						HumNum duration = endtime - time2;
-						stringstream ss;
-						ss.str("");
-						ss << duration.getFloat();
-						results.at(v2).at(line2) += ss.str();
-					}
+	int h = 0;
+	for (int i=0; i<n; i++) {
+		if (rank[i] == 0) {
+			h = 0;
+			continue;
+		}
+		int j = suffixes[rank[i] - 1];
+		while ((i + h < n) && (j + h < n) && (sequence[i + h] == sequence[j + h])) {
+			h++;
+		}
+		lcp[rank[i]] = h;
+		if (h > 0) {
+			h--;
+		}
+	}
+}
 
-					if ((!m_noC) && (!m_noCC)) {
-						if (data2) {
-							results.at(v2).at(line2) += ":";
-						}
-						data2 = true;
-						results.at(v2).at(line2) += "c";
-						results.at(v2).at(line2) += to_string(count);
-					}
 
-					if ((!m_noD) && (!m_noDD)) {
-						if (data2) {
-							results.at(v2).at(line2) += ":";
-						}
-						data2 = true;
-						results.at(v2).at(line2) += "d";
-						results.at(v2).at(line2) += to_string(distance2.getNumerator());
-					}
 
-					if ((!m_noI) && (!m_noII)) {
-						if (data2) {
-							results.at(v2).at(line2) += ":";
-						}
-						data2 = true;
-						if (distance2.getDenominator() != 1) {
-							results.at(v2).at(line2) += '/';
-							results.at(v2).at(line2) += to_string(distance2.getNumerator());
-						}
-						results.at(v2).at(line2) += "i";
-						if (interval > 0) {
-							int newinterval = -(interval + 1);
-							if (newinterval == -1) {
-								newinterval = 1; // unison (no sign)
-							}
-							results.at(v2).at(line2) += to_string(newinterval);
-						} else {
-							results.at(v2).at(line2) += to_string(interval + 1);
-						}
-					}
+//////////////////////////////
+//
+// Tool_imitation::addImitation -- Add the analysis information and marks
+//     for a match of count notes starting at attack i in voice v1 and at
+//     attack j in voice v2.  Enumerator is the number of the match.
+//
+
+void Tool_imitation::addImitation(vector<vector<string>>& results,
+		vector<vector<NoteCell*>>& attacks, int v1, int i, int v2, int j,
+		int count) {
+	HTp token1 = attacks.at(v1).at(i)->getToken();
+	HTp token2 = attacks.at(v2).at(j)->getToken();
+	HumNum time1 = token1->getDurationFromStart();
+	HumNum time2 = token2->getDurationFromStart();
+	HumNum distance1 = time2 - time1;
+	HumNum distance2 = time1 - time2;
+
+	int interval = int(*attacks.at(v2).at(j) - *attacks.at(v1).at(i));
+
+	if (!m_noInfo) {
+		if (!(m_first && (distance1 < 0))) {
+			int line1 = attacks.at(v1).at(i)->getLineIndex();
+			if (!results.at(v1).at(line1).empty()) {
+				results.at(v1).at(line1) += " ";
+			}
+
+			bool data = false;
+
+			if (!m_noN) {
+				data = true;
+				if (m_inversion) {
+					results.at(v1).at(line1) += "v";
+				} else if (m_retrograde) {
+					results.at(v1).at(line1) += "r";
+				} else {
+					results.at(v1).at(line1) += "n";
 				}
+				results.at(v1).at(line1) += to_string(Enumerator);
 			}
 
-			if (m_mark) {
-				for (int z=0; z<count; z++) {
-					if (i+z >= (int)attacks.at(v1).size()) {
-						break;
-					}
-					token1 = attacks.at(v1).at(i+z)->getToken();
-					if (j+z >= (int)attacks.at(v2).size()) {
-						break;
-					}
-					token2 = attacks.at(v2).at(j+z)->getToken();
-					if (m_single) {
-						if (token1->find(m_marker) == string::npos) {
-							token1->setText(*token1 + m_marker);
-						}
-						if (token2->find(m_marker) == string::npos) {
-							token2->setText(*token2 + m_marker);
-						}
-					} else {
-						token1->setText(*token1 + m_marker);
-						token2->setText(*token2 + m_marker);
-					}
+			if (m_measure) {
+				if (data) {
+					results.at(v1).at(line1) += ":";
+				}
+				data = true;
+				results.at(v1).at(line1) += "m";
+				int line = attacks.at(v1).at(i)->getToken()->getLineIndex();
+				results.at(v1).at(line1) += to_string(m_barlines[line]);
+			}
+
+			if (m_beat) {
+				if (data) {
+					results.at(v1).at(line1) += ":";
+				}
+				data = true;
+				results.at(v1).at(line1) += "b";
+				HLp humline = attacks.at(v1).at(i)->getToken()->getOwner();
+				stringstream ss;
+				ss.str("");
+				ss << humline->getBeat().getFloat();
+				results.at(v1).at(line1) += ss.str();
+			}
 
-               if (attacks.at(v1).at(i+z)->isRest() && (z < count - 1) ) {
-						markedTiedNotes(attacks.at(v1).at(i+z)->m_tiedtokens);
-					} else if (!attacks.at(v1).at(i+z)->isRest()) {
-						markedTiedNotes(attacks.at(v1).at(i+z)->m_tiedtokens);
+			if (m_length) {
+				if (data) {
+					results.at(v1).at(line1) += ":";
+				}
+				data = true;
+				results.at(v1).at(line1) += "L";
+				// time1 is the starttime
+				HumNum endtime;
+				HTp endtoken = NULL;
+				if (i+count < (int)attacks.at(v1).size()) {
+					endtoken = attacks.at(v1).at(i+count)->getToken();
+					endtime = endtoken->getDurationFromStart();
+				} else {
+					endtime = token1->getOwner()->getOwner()->getScoreDuration();
+				}
+				HumNum duration = endtime - time1;
+				stringstream ss;
+				ss.str("");
+				ss << duration.getFloat();
+				results.at(v1).at(line1) += ss.str();
+			}
+
+			if (!m_noC) {
+				if (data) {
+					results.at(v1).at(line1) += ":";
+				}
+				data = true;
+				results.at(v1).at(line1) += "c";
+				results.at(v1).at(line1) += to_string(count);
+			}
+
+			if (!m_noD) {
+				if (data) {
+					results.at(v1).at(line1) += ":";
+				}
+				data = true;
+				results.at(v1).at(line1) += "d";
+				// maybe allow fractions?
+				results.at(v1).at(line1) += to_string(distance1.getNumerator());
+			}
+
+			if (!m_noI) {
+				if (data) {
+					results.at(v1).at(line1) += ":";
+				}
+				data = true;
+				if (distance1.getDenominator() != 1) {
+					results.at(v1).at(line1) += '/';
+					results.at(v1).at(line1) += to_string(distance1.getNumerator());
+				}
+				results.at(v1).at(line1) += "i";
+				if (interval > 0) {
+					results.at(v1).at(line1) += to_string(interval + 1);
+				} else {
+					int newinterval = -(interval + 1);
+					if (newinterval == -1) {
+						newinterval = 1; // unison (no sign)
 					}
+					results.at(v1).at(line1) += to_string(newinterval);
+				}
+			}
+		}
+
+		if (!(m_first && (distance2 <= 0))) {
+			int line2 = attacks.at(v2).at(j)->getLineIndex();
+
+			if (!results.at(v2).at(line2).empty()) {
+				results.at(v2).at(line2) += " ";
+			}
+
+			bool data2 = false;
+
+			if ((!m_noN) && (!m_noNN)) {
+				data2 = true;
+				if (m_inversion) {
+					results.at(v2).at(line2) += "v";
+				} else if (m_retrograde) {
+					results.at(v2).at(line2) += "r";
+				} else {
+					results.at(v2).at(line2) += "n";
+				}
+				results.at(v2).at(line2) += to_string(Enumerator);
+			}
+
+			if (m_measure) {
+				if (data2) {
+					results.at(v2).at(line2) += ":";
+				}
+				data2 = true;
+				results.at(v2).at(line2) += "m";
+				int line = attacks.at(v2).at(j)->getToken()->getLineIndex();
+				results.at(v2).at(line2) += to_string(m_barlines[line]);
+			}
 
-               if (attacks.at(v2).at(j+z)->isRest() && (z < count - 1) ) {
-						markedTiedNotes(attacks.at(v2).at(j+z)->m_tiedtokens);
-					} else if (!attacks.at(v2).at(j+z)->isRest()) {
-						markedTiedNotes(attacks.at(v2).at(j+z)->m_tiedtokens);
+			if (m_beat) {
+				if (data2) {
+					results.at(v2).at(line2) += ":";
+				}
+				data2 = true;
+				results.at(v2).at(line2) += "b";
+				HLp humline = attacks.at(v2).at(j)->getToken()->getOwner();
+				stringstream ss;
+				ss.str("");
+				ss << humline->getBeat().getFloat();
+				results.at(v2).at(line2) += ss.str();
+			}
+
+			if (m_length) {
+				if (data2) {
+					results.at(v2).at(line2) += ":";
+				}
+				data2 = true;
+				results.at(v2).at(line2) += "L";
+				// time1 is the starttime
+				HumNum endtime;
+				HTp endtoken = NULL;
+				if (j+count < (int)attacks.at(v2).size()) {
+					endtoken = attacks.at(v2).at(j+count)->getToken();
+					endtime = endtoken->getDurationFromStart();
+				} else {
+					endtime = token2->getOwner()->getOwner()->getScoreDuration();
+				}
+				HumNum duration = endtime - time2;
+				stringstream ss;
+				ss.str("");
+				ss << duration.getFloat();
+				results.at(v2).at(line2) += ss.str();
+			}
+
+			if ((!m_noC) && (!m_noCC)) {
+				if (data2) {
+					results.at(v2).at(line2) += ":";
+				}
+				data2 = true;
+				results.at(v2).at(line2) += "c";
+				results.at(v2).at(line2) += to_string(count);
+			}
+
+			if ((!m_noD) && (!m_noDD)) {
+				if (data2) {
+					results.at(v2).at(line2) += ":";
+				}
+				data2 = true;
+				results.at(v2).at(line2) += "d";
+				results.at(v2).at(line2) += to_string(distance2.getNumerator());
+			}
+
+			if ((!m_noI) && (!m_noII)) {
+				if (data2) {
+					results.at(v2).at(line2) += ":";
+				}
+				data2 = true;
+				if (distance2.getDenominator() != 1) {
+					results.at(v2).at(line2) += '/';
+					results.at(v2).at(line2) += to_string(distance2.getNumerator());
+				}
+				results.at(v2).at(line2) += "i";
+				if (interval > 0) {
+					int newinterval = -(interval + 1);
+					if (newinterval == -1) {
+						newinterval = 1; // unison (no sign)
 					}
+					results.at(v2).at(line2) += to_string(newinterval);
+				} else {
+					results.at(v2).at(line2) += to_string(interval + 1);
+				}
+			}
+		}
+	}
 
+	if (m_mark) {
+		for (int z=0; z<count; z++) {
+			if (i+z >= (int)attacks.at(v1).size()) {
+				break;
+			}
+			token1 = attacks.at(v1).at(i+z)->getToken();
+			if (j+z >= (int)attacks.at(v2).size()) {
+				break;
+			}
+			token2 = attacks.at(v2).at(j+z)->getToken();
+			if (m_single) {
+				if (token1->find(m_marker) == string::npos) {
+					token1->setText(*token1 + m_marker);
 				}
+				if (token2->find(m_marker) == string::npos) {
+					token2->setText(*token2 + m_marker);
+				}
+			} else {
+				token1->setText(*token1 + m_marker);
+				token2->setText(*token2 + m_marker);
 			}
 
-			// skip over match (need to do in i as well somehow)
-			j += count;
-		} // j loop
-	} // i loop
+			if (attacks.at(v1).at(i+z)->isRest() && (z < count - 1) ) {
+				markedTiedNotes(attacks.at(v1).at(i+z)->m_tiedtokens);
+			} else if (!attacks.at(v1).at(i+z)->isRest()) {
+				markedTiedNotes(attacks.at(v1).at(i+z)->m_tiedtokens);
+			}
+
+			if (attacks.at(v2).at(j+z)->isRest() && (z < count - 1) ) {
+				markedTiedNotes(attacks.at(v2).at(j+z)->m_tiedtokens);
+			} else if (!attacks.at(v2).at(j+z)->isRest()) {
+				markedTiedNotes(attacks.at(v2).at(j+z)->m_tiedtokens);
+			}
+
+		}
+	}
 }
 
 
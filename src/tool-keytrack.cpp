@@ -0,0 +1,581 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 14:07:31 PDT 2026
+// Last Modified: Mon Oct 19 23:41:12 PDT 2026
+// Filename:      tool-keytrack.cpp
+// URL:           https://github.com/craigsapp/humlib/blob/master/src/tool-keytrack.cpp
+// Syntax:        C++11; humlib
+// vim:           syntax=cpp ts=3 noexpandtab nowrap
+//
+// Description:   Track the key through a score with a sliding window.
+//                Pitch-class durations of the **kern spines in each window
+//                are correlated with major and minor key profiles, and the
+//                best key is added to the score as a **key spine or printed
+//                as a JSON key curve.
+//
+//                The durations of the notes in a window are calculated from
+//                a running pitch-class histogram of the score, so moving a
+//                window costs the same regardless of how many notes it
+//                contains.
+//
+
+#include "tool-keytrack.h"
+#include "Convert.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace hum {
+
+// START_MERGE
+
+
+/////////////////////////////////
+//
+// Tool_keytrack::Tool_keytrack -- Set the recognized options for the tool.
+//
+
+Tool_keytrack::Tool_keytrack(void) {
+	define("w|window=d:8",     "window size in quarter notes (or measures with -m)");
+	define("m|measures=b",     "window size is in measures");
+	define("hop=d:1",          "quarter notes between windows in JSON output");
+	define("j|json=b",         "print key curve as JSON data");
+	define("c|correlations=b", "include correlations for all keys in JSON data");
+	define("k|krumhansl=b",    "use Krumhansl-Kessler key profiles");
+}
+
+
+
+/////////////////////////////////
+//
+// Tool_keytrack::run -- Do the main work of the tool.
+//
+
+bool Tool_keytrack::run(HumdrumFileSet& infiles) {
+	bool status = true;
+	for (int i=0; i<infiles.getCount(); i++) {
+		status &= run(infiles[i]);
+	}
+	return status;
+}
+
+
+bool Tool_keytrack::run(const string& indata, ostream& out) {
+	HumdrumFile infile(indata);
+	bool status = run(infile);
+	if (hasAnyText()) {
+		getAllText(out);
+	} else {
+		out << infile;
+	}
+	return status;
+}
+
+
+bool Tool_keytrack::run(HumdrumFile& infile, ostream& out) {
+	bool status = run(infile);
+	if (hasAnyText()) {
+		getAllText(out);
+	} else {
+		out << infile;
+	}
+	return status;
+}
+
+
+bool Tool_keytrack::run(HumdrumFile& infile) {
+	initialize();
+	processFile(infile);
+	return true;
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::initialize --
+//
+
+void Tool_keytrack::initialize(void) {
+	m_window        = getDouble("window");
+	m_hop           = getDouble("hop");
+	m_measureQ      = getBoolean("measures");
+	m_jsonQ         = getBoolean("json");
+	m_correlationsQ = getBoolean("correlations");
+	m_krumhanslQ    = getBoolean("krumhansl");
+	if (m_window <= 0.0) {
+		m_window = 8.0;
+	}
+	if (m_hop <= 0.0) {
+		m_hop = 1.0;
+	}
+	fillProfiles();
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::processFile --
+//
+
+void Tool_keytrack::processFile(HumdrumFile& infile) {
+	fillPitchClassCurve(infile);
+	if (m_measureQ) {
+		fillMeasureTimes(infile);
+	}
+	if (m_jsonQ) {
+		printJson(m_free_text, infile);
+	} else {
+		addKeySpine(infile);
+		m_humdrum_text << infile;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::fillProfiles -- Store the major and minor key profiles
+//    for each tonic.  The profiles are mean-centered and scaled to unit
+//    length so that correlating with a histogram only requires a dot
+//    product.  The Kostka-Payne profiles are used by default, as in the
+//    key analysis of the transpose tool, or the Krumhansl-Kessler
+//    profiles with -k.
+//
+
+void Tool_keytrack::fillProfiles(void) {
+	// Krumhansl-Kessler probe-tone ratings:
+	static const double kkmajor[12] = { 6.35, 2.23, 3.48, 2.33, 4.38, 4.09,
+			2.52, 5.19, 2.39, 3.66, 2.29, 2.88 };
+	static const double kkminor[12] = { 6.33, 2.68, 3.52, 5.38, 2.60, 3.53,
+			2.54, 4.75, 3.98, 2.69, 3.34, 3.17 };
+
+	// found in David Temperley: Music and Probability 2006
+	static const double kpmajor[12] = { 0.748, 0.060, 0.488, 0.082, 0.670,
+			0.460, 0.096, 0.715, 0.104, 0.366, 0.057, 0.400 };
+	static const double kpminor[12] = { 0.712, 0.084, 0.474, 0.618, 0.049,
+			0.460, 0.105, 0.747, 0.404, 0.067, 0.133, 0.330 };
+
+	for (int mode=0; mode<2; mode++) {
+		const double* base;
+		if (m_krumhanslQ) {
+			base = mode ? kkminor : kkmajor;
+		} else {
+			base = mode ? kpminor : kpmajor;
+		}
+		double mean = 0.0;
+		for (int i=0; i<12; i++) {
+			mean += base[i];
+		}
+		mean /= 12.0;
+		double sum = 0.0;
+		for (int i=0; i<12; i++) {
+			sum += (base[i] - mean) * (base[i] - mean);
+		}
+		double scale = 1.0 / sqrt(sum);
+		for (int tonic=0; tonic<12; tonic++) {
+			for (int i=0; i<12; i++) {
+				m_profiles[mode * 12 + tonic][i] = (base[(i - tonic + 12) % 12] - mean) * scale;
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::fillPitchClassCurve -- Calculate the running pitch-class
+//    histogram of the **kern notes in the score.  Each chord note is
+//    counted separately, and tied notes are counted in each of their
+//    tokens, so the histogram of any time span can be calculated as the
+//    difference between the histograms at the start and end of the span.
+//
+
+void Tool_keytrack::fillPitchClassCurve(HumdrumFile& infile) {
+	// events: time of note onsets (pitch class) and offsets (pitch class + 12).
+	vector<pair<double, int>> events;
+
+	for (int i=0; i<infile.getLineCount(); i++) {
+		if (!infile[i].isData()) {
+			continue;
+		}
+		for (int j=0; j<infile[i].getFieldCount(); j++) {
+			HTp token = infile.token(i, j);
+			if (!token->isKern() || token->isNull() || token->isRest()) {
+				continue;
+			}
+			double duration = token->getDuration().getFloat();
+			if (duration <= 0.0) {
+				// grace note
+				continue;
+			}
+			double starttime = token->getDurationFromStart().getFloat();
+			int count = token->getSubtokenCount();
+			for (int k=0; k<count; k++) {
+				string subtok = token->getSubtoken(k);
+				if (subtok.find('r') != string::npos) {
+					continue;
+				}
+				int pc = Convert::kernToMidiNoteNumber(subtok) % 12;
+				if (pc < 0) {
+					pc += 12;
+				}
+				events.emplace_back(starttime, pc);
+				events.emplace_back(starttime + duration, pc + 12);
+			}
+		}
+	}
+	sort(events.begin(), events.end());
+
+	m_times.clear();
+	m_cumulative.clear();
+	m_sounding.clear();
+	m_times.reserve(events.size());
+	m_cumulative.reserve(events.size() * 12);
+	m_sounding.reserve(events.size() * 12);
+
+	double cumulative[12] = {0};
+	double sounding[12] = {0};
+	int i = 0;
+	while (i < (int)events.size()) {
+		double timepoint = events[i].first;
+		if (!m_times.empty()) {
+			double delta = timepoint - m_times.back();
+			for (int k=0; k<12; k++) {
+				cumulative[k] += sounding[k] * delta;
+			}
+		}
+		while ((i < (int)events.size()) && (events[i].first == timepoint)) {
+			if (events[i].second < 12) {
+				sounding[events[i].second] += 1.0;
+			} else {
+				sounding[events[i].second - 12] -= 1.0;
+			}
+			i++;
+		}
+		m_times.push_back(timepoint);
+		m_cumulative.insert(m_cumulative.end(), cumulative, cumulative + 12);
+		m_sounding.insert(m_sounding.end(), sounding, sounding + 12);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::fillMeasureTimes -- Store the start time of each measure,
+//    followed by the duration of the score, and the bar number of the
+//    barline at the start of each measure (-1 for a pickup measure or an
+//    unnumbered barline).
+//
+
+void Tool_keytrack::fillMeasureTimes(HumdrumFile& infile) {
+	double scoredur = infile.getScoreDuration().getFloat();
+	m_measures.clear();
+	m_barnums.clear();
+	m_measures.push_back(0.0);
+	m_barnums.push_back(-1);
+	for (int i=0; i<infile.getLineCount(); i++) {
+		if (!infile[i].isBarline()) {
+			continue;
+		}
+		double timepoint = infile[i].getDurationFromStart().getFloat();
+		if (timepoint >= scoredur) {
+			continue;
+		}
+		if (timepoint > m_measures.back()) {
+			m_measures.push_back(timepoint);
+			m_barnums.push_back(infile[i].getBarNumber());
+		} else if (m_barnums.back() < 0) {
+			// barline at the start of the score
+			m_barnums.back() = infile[i].getBarNumber();
+		}
+	}
+	m_measures.push_back(scoredur);
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::getMeasureIndex -- Return the index of the measure which
+//    contains the given time.
+//
+
+int Tool_keytrack::getMeasureIndex(double timepoint) {
+	int index = (int)(upper_bound(m_measures.begin(), m_measures.end(), timepoint)
+			- m_measures.begin()) - 1;
+	int count = (int)m_measures.size() - 1;
+	if (index >= count) {
+		index = count - 1;
+	}
+	if (index < 0) {
+		index = 0;
+	}
+	return index;
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::getMeasureWindow -- Return the time span of the window
+//    of measures around the given measure.
+//
+
+void Tool_keytrack::getMeasureWindow(int measure, double& starttime,
+		double& endtime) {
+	int count = (int)m_measures.size() - 1;
+	int size = std::max(1, (int)(m_window + 0.5));
+	int first = std::max(0, measure - (size - 1) / 2);
+	int last = std::min(count, first + size);
+	starttime = m_measures.at(first);
+	endtime = m_measures.at(last);
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::getCumulativeHistogram -- Return the duration of each
+//    pitch class which sounds before the given time.
+//
+
+void Tool_keytrack::getCumulativeHistogram(double* histogram, double timepoint) {
+	int index = (int)(upper_bound(m_times.begin(), m_times.end(), timepoint)
+			- m_times.begin()) - 1;
+	if (index < 0) {
+		std::fill(histogram, histogram + 12, 0.0);
+		return;
+	}
+	double delta = timepoint - m_times[index];
+	const double* cumulative = m_cumulative.data() + index * 12;
+	const double* sounding = m_sounding.data() + index * 12;
+	for (int k=0; k<12; k++) {
+		histogram[k] = cumulative[k] + sounding[k] * delta;
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::analyzeWindow -- Return the best key for the notes
+//    sounding between the given times, or -1 if there are no notes.
+//
+
+int Tool_keytrack::analyzeWindow(double* correlations, double starttime,
+		double endtime) {
+	double start[12];
+	double histogram[12];
+	getCumulativeHistogram(start, starttime);
+	getCumulativeHistogram(histogram, endtime);
+	for (int k=0; k<12; k++) {
+		histogram[k] -= start[k];
+	}
+	return identifyKey(correlations, histogram);
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::identifyKey -- Calculate the Pearson correlation between
+//    the histogram and each key profile.  Returns the index of the best key
+//    (0-11 for major keys and 12-23 for minor keys), or -1 if all pitch
+//    classes have the same duration.
+//
+
+int Tool_keytrack::identifyKey(double* correlations, const double* histogram) {
+	double centered[12];
+	double mean = 0.0;
+	for (int i=0; i<12; i++) {
+		mean += histogram[i];
+	}
+	mean /= 12.0;
+	double sum = 0.0;
+	for (int i=0; i<12; i++) {
+		centered[i] = histogram[i] - mean;
+		sum += centered[i] * centered[i];
+	}
+	if (sum <= 1.0e-12) {
+		std::fill(correlations, correlations + 24, 0.0);
+		return -1;
+	}
+	double scale = 1.0 / sqrt(sum);
+
+	int best = 0;
+	for (int k=0; k<24; k++) {
+		double dot = 0.0;
+		for (int i=0; i<12; i++) {
+			dot += m_profiles[k][i] * centered[i];
+		}
+		correlations[k] = dot * scale;
+		if (correlations[k] > correlations[best]) {
+			best = k;
+		}
+	}
+	return best;
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::getKeyName -- Return the **kern name of the key tonic,
+//    upper case for major keys and lower case for minor keys.
+//
+
+string Tool_keytrack::getKeyName(int key) {
+	static const char* names[24] = {
+		"C", "D-", "D", "E-", "E", "F", "F#", "G", "A-", "A", "B-", "B",
+		"c", "c#", "d", "e-", "e", "f", "f#", "g", "g#", "a", "b-", "b"
+	};
+	if ((key < 0) || (key >= 24)) {
+		return "";
+	}
+	return names[key];
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::addKeySpine -- Add a **key spine to the score.  The key
+//    of each data line is analyzed with a window centered on the line (or
+//    on the measure of the line with -m).  Keys are only displayed when
+//    they change.
+//
+
+void Tool_keytrack::addKeySpine(HumdrumFile& infile) {
+	vector<string> keys(infile.getLineCount());
+	double correlations[24];
+	int lastkey = -2;
+	for (int i=0; i<infile.getLineCount(); i++) {
+		if (!infile[i].isData()) {
+			continue;
+		}
+		double timepoint = infile[i].getDurationFromStart().getFloat();
+		double starttime;
+		double endtime;
+		if (m_measureQ) {
+			getMeasureWindow(getMeasureIndex(timepoint), starttime, endtime);
+		} else {
+			starttime = timepoint - m_window / 2.0;
+			endtime = timepoint + m_window / 2.0;
+		}
+		int key = analyzeWindow(correlations, starttime, endtime);
+		if ((key < 0) || (key == lastkey)) {
+			continue;
+		}
+		keys[i] = getKeyName(key);
+		lastkey = key;
+	}
+	infile.appendDataSpine(keys, "", "**key");
+	infile.createLinesFromTokens();
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::printJson -- Print the key of each window as JSON data.
+//    Windows are spaced by the --hop duration, or one for each measure
+//    with -m.
+//
+
+void Tool_keytrack::printJson(ostream& out, HumdrumFile& infile) {
+	out << "{\n";
+	string filename = infile.getFilename();
+	if (!filename.empty()) {
+		out << "\t\"file\": \"";
+		for (int i=0; i<(int)filename.size(); i++) {
+			if ((filename[i] == '"') || (filename[i] == '\\')) {
+				out << '\\';
+			}
+			out << filename[i];
+		}
+		out << "\",\n";
+	}
+	out << "\t\"window\": " << m_window << ",\n";
+	if (m_measureQ) {
+		out << "\t\"unit\": \"measure\",\n";
+	} else {
+		out << "\t\"unit\": \"quarter\",\n";
+		out << "\t\"hop\": " << m_hop << ",\n";
+	}
+	out << "\t\"keys\": [";
+
+	if (m_measureQ) {
+		int count = (int)m_measures.size() - 1;
+		for (int i=0; i<count; i++) {
+			double starttime;
+			double endtime;
+			getMeasureWindow(i, starttime, endtime);
+			out << (i ? ",\n" : "\n");
+			printJsonEntry(out, m_measures[i], m_barnums[i], starttime, endtime);
+		}
+	} else {
+		double scoredur = infile.getScoreDuration().getFloat();
+		for (int i=0; i * m_hop < scoredur; i++) {
+			double timepoint = i * m_hop;
+			out << (i ? ",\n" : "\n");
+			printJsonEntry(out, timepoint, -1, timepoint - m_window / 2.0,
+					timepoint + m_window / 2.0);
+		}
+	}
+
+	out << "\n\t]\n";
+	out << "}\n";
+}
+
+
+
+//////////////////////////////
+//
+// Tool_keytrack::printJsonEntry -- Print the analysis of a single window.
+//    The bar number is only printed for windows of measures (-m option),
+//    as null if the measure does not start with a numbered barline.
+//
+
+void Tool_keytrack::printJsonEntry(ostream& out, double timepoint,
+		int barnum, double starttime, double endtime) {
+	double correlations[24];
+	int key = analyzeWindow(correlations, starttime, endtime);
+	out << "\t\t{";
+	if (m_measureQ && (barnum >= 0)) {
+		out << "\"measure\": " << barnum << ", ";
+	} else if (m_measureQ) {
+		out << "\"measure\": null, ";
+	}
+	out << "\"qon\": " << timepoint;
+	if (key < 0) {
+		out << ", \"key\": null, \"r\": null";
+	} else {
+		out << ", \"key\": \"" << getKeyName(key) << "\"";
+		out << ", \"r\": " << correlations[key];
+	}
+	if (m_correlationsQ) {
+		out << ", \"correlations\": [";
+		for (int k=0; k<24; k++) {
+			if (k > 0) {
+				out << ", ";
+			}
+			out << correlations[k];
+		}
+		out << "]";
+	}
+	out << "}";
+}
+
+
+// END_MERGE
+
+} // end namespace hum
+
+
+
@@ -134,7 +134,8 @@ bool Tool_mei2hum::convert(ostream& out, xml_document& doc) {
 
 	buildIdLinkMap(doc);
 
-	auto score = doc.select_node("/mei/music/body/mdiv/score").node();
+	static const pugi::xpath_query scorequery("/mei/music/body/mdiv/score");
+	auto score = doc.select_node(scorequery).node();
 
 	if (!score) {
 		cerr << "Cannot find score, so cannot convert MEI file to Humdrum";
@@ -200,7 +201,8 @@ bool Tool_mei2hum::convert(ostream& out, xml_document& doc) {
 		m_outdata.setXmlidsPresent(i);
 	}
 
-	auto measure = doc.select_node("/mei/music/body/mdiv/score/section/measure").node();
+	static const pugi::xpath_query measurequery("/mei/music/body/mdiv/score/section/measure");
+	auto measure = doc.select_node(measurequery).node();
 	auto number = measure.attribute("n");
 	int measurenumber = 0;
 
@@ -372,57 +374,33 @@ void Tool_mei2hum::processHairpin(hairpin_info& info) {
 //
 
 void Tool_mei2hum::addExtMetaRecords(HumdrumFile& outfile, xml_document& doc) {
-	pugi::xpath_node_set metaframes = doc.select_nodes("/mei/meiHead/extMeta/frames/metaFrame");
+	static const pugi::xpath_query metaquery("/mei/meiHead/extMeta/frames/metaFrame");
+	pugi::xpath_node_set metaframes = doc.select_nodes(metaquery);
 	double starttime;
-	string starttimevalue;
 	string token;
-	xml_node node;
-	xml_node timenode;
-
-	// place header reference records, assumed to be time sorted
-	for (int i=(int)metaframes.size()-1; i>=0; i--) {
-		node = metaframes[i].node();
-		timenode = node.select_node("./frameInfo/startTime").node();
-		starttimevalue = timenode.attribute("float").value();
-		if (starttimevalue == "") {
-			starttime = 0.0;
-		} else {
-			starttime = stof(starttimevalue);
-		}
-		if (starttime > 0.0) {
-			continue;
-		}
+	vector<string> header;
+	header.reserve(metaframes.size());
+
+	// Place header reference records (which have a start time of 0) at the
+	// start of the file and the rest at the end.  The frames are assumed
+	// to be sorted by time.
+	for (int i=0; i<(int)metaframes.size(); i++) {
+		xml_node node = metaframes[i].node();
 		token = node.attribute("token").value();
 		if (token.empty()) {
 			continue;
 		}
-		outfile.insertLine(0, token);
-		if (token.find("!!!RDF**kern: < = below") != string::npos) {
-			m_belowQ = false;
-		}
-		if (token.find("!!!RDF**kern: > = above") != string::npos) {
-			m_aboveQ = false;
-		}
-	}
-
-	// place footer reference records, assumed to be time sorted
-	for (int i=0; i<(int)metaframes.size(); i++) {
-		node = metaframes[i].node();
-		timenode = node.select_node("./frameInfo/startTime").node();
-		starttimevalue = timenode.attribute("float").value();
-		if (starttimevalue == "") {
+		const char* starttimevalue = node.child("frameInfo").child("startTime").attribute("float").value();
+		if (*starttimevalue == '\0') {
 			starttime = 0.0;
 		} else {
-			starttime = stof(starttimevalue);
+			starttime = std::stof(starttimevalue);
 		}
-		if (starttime == 0.0) {
-			continue;
-		}
-		token = node.attribute("token").value();
-		if (token.empty()) {
-			continue;
+		if (starttime > 0.0) {
+			outfile.appendLine(token);
+		} else {
+			header.push_back(token);
 		}
-		outfile.appendLine(token);
 		if (token.find("!!!RDF**kern: < = below") != string::npos) {
 			m_belowQ = false;
 		}
@@ -431,6 +409,7 @@ void Tool_mei2hum::addExtMetaRecords(HumdrumFile& outfile, xml_document& doc) {
 		}
 	}
 
+	outfile.insertLines(0, header);
 }
 
 
@@ -442,14 +421,18 @@ void Tool_mei2hum::addExtMetaRecords(HumdrumFile& outfile, xml_document& doc) {
 
 void Tool_mei2hum::addHeaderRecords(HumdrumFile& outfile, xml_document& doc) {
 
+	static const pugi::xpath_query titlequery("/mei/meiHead/fileDesc/titleStmt/title");
+	static const pugi::xpath_query composerquery("/mei/meiHead/fileDesc/titleStmt/respStmt/persName[@role='creator']");
+	static const pugi::xpath_query lyricistquery("/mei/meiHead/fileDesc/titleStmt/respStmt/persName[@role='lyricist']");
+
 	// title is at /mei/meiHead/fileDesc/titleStmt/title
-	string title = cleanReferenceRecordText(doc.select_node("/mei/meiHead/fileDesc/titleStmt/title").node().child_value());
+	string title = cleanReferenceRecordText(doc.select_node(titlequery).node().child_value());
 
 	// composer is at /mei/meiHead/fileDesc/titleStmt/respStmt/persName@role="creator"
-	string composer = cleanReferenceRecordText(doc.select_node("/mei/meiHead/fileDesc/titleStmt/respStmt/persName[@role='creator']").node().child_value());
+	string composer = cleanReferenceRecordText(doc.select_node(composerquery).node().child_value());
 
 	// lyricist is at /mei/meiHead/fileDesc/titleStmt/respStmt/persName@role="lyricist"
-	string lyricist = cleanReferenceRecordText(doc.select_node("/mei/meiHead/fileDesc/titleStmt/respStmt/persName[@role='lyricist']").node().child_value());
+	string lyricist = cleanReferenceRecordText(doc.select_node(lyricistquery).node().child_value());
 
 	if (!m_systemDecoration.empty()) {
 		outfile.insertLine(0, "!!!system-decoration: " + m_systemDecoration);
@@ -496,7 +479,7 @@ void Tool_mei2hum::addFooterRecords(HumdrumFile& outfile, xml_document& doc) {
 //
 
 int Tool_mei2hum::extractStaffCountByFirstMeasure(xml_node element) {
-	auto measure = element.select_node("//measure").node();
+	auto measure = getFirstDescendant(element.root(), "measure");
 	if (!measure) {
 		return 0;
 	}
@@ -521,13 +504,47 @@ int Tool_mei2hum::extractStaffCountByFirstMeasure(xml_node element) {
 //
 
 int Tool_mei2hum::extractStaffCountByScoreDef(xml_node element) {
-	xml_node scoredef = element.select_node("//scoreDef").node();
+	xml_node scoredef = getFirstDescendant(element.root(), "scoreDef");
 	if (!scoredef) {
 		return 0;
 	}
 
-	pugi::xpath_node_set staffdefs = element.select_nodes(".//staffDef");
-	return (int)staffdefs.size();
+	return countDescendants(element, "staffDef");
+}
+
+
+
+//////////////////////////////
+//
+// Tool_mei2hum::getFirstDescendant -- Return the first element with the
+//    given name inside of the input element (in document order), equivalent
+//    to the XPath ".//name" but without compiling an XPath expression.
+//    Returns an empty node if there is no match.
+//
+
+xml_node Tool_mei2hum::getFirstDescendant(xml_node element, const char* name) {
+	return element.find_node([name](xml_node node) {
+		return strcmp(node.name(), name) == 0;
+	});
+}
+
+
+
+//////////////////////////////
+//
+// Tool_mei2hum::countDescendants -- Return the number of elements with
+//    the given name inside of the input element.
+//
+
+int Tool_mei2hum::countDescendants(xml_node element, const char* name) {
+	int count = 0;
+	for (xml_node child : element.children()) {
+		if (strcmp(child.name(), name) == 0) {
+			count++;
+		}
+		count += countDescendants(child, name);
+	}
+	return count;
 }
 
 
@@ -1077,7 +1094,7 @@ void Tool_mei2hum::fillWithStaffDefAttributes(mei_staffDef& staffinfo, xml_node
 	// Fill in possible child element attributes:
 
 	// staffDef/mensur
-	xml_node mensurNode = element.select_node(".//mensur").node();
+	xml_node mensurNode = getFirstDescendant(element, "mensur");
 	if (mensurNode) {
 		for (auto atti = mensurNode.attributes_begin(); atti != mensurNode.attributes_end(); atti++) {
 			string attname = atti->name();
@@ -1094,7 +1111,7 @@ void Tool_mei2hum::fillWithStaffDefAttributes(mei_staffDef& staffinfo, xml_node
 	}
 
 	// staffDef/label
-	xml_node labelNode = element.select_node(".//label").node();
+	xml_node labelNode = getFirstDescendant(element, "label");
 	if (labelNode) {
 		string testlabel = labelNode.child_value();
 		if (!testlabel.empty()) {
@@ -1103,7 +1120,7 @@ void Tool_mei2hum::fillWithStaffDefAttributes(mei_staffDef& staffinfo, xml_node
 	}
 
 	// staffDef/labelAbbr
-	xml_node labelAbbrNode = element.select_node(".//labelAbbr").node();
+	xml_node labelAbbrNode = getFirstDescendant(element, "labelAbbr");
 	if (labelAbbrNode) {
 		string testlabelabbr = labelAbbrNode.child_value();
 		if (!testlabelabbr.empty()) {
@@ -3205,7 +3222,7 @@ int Tool_mei2hum::getDotCount(xml_node node) {
 	string name = node.name();
 	if (name == "chord") {
 		if (!node.attribute("dur")) {
-			node = node.select_node(".//note").node();
+			node = getFirstDescendant(node, "note");
 		}
 	}
 
@@ -3778,7 +3795,7 @@ HumNum Tool_mei2hum::getDuration(xml_node element) {
 	if ((!dur_attr) && (name == "chord")) {
 		// if there is no dur attribute on a chord, then look for it
 		// on the first note subelement of the chord.
-		auto newelement = element.select_node(".//note").node();
+		auto newelement = getFirstDescendant(element, "note");
 		if (newelement) {
 			element = newelement;
 			dur_attr = element.attribute("dur");
@@ -3875,7 +3892,7 @@ HumNum Tool_mei2hum::getDuration_mensural(xml_node element, int& dotcount) {
 	if ((!dur_attr) && (name == "chord")) {
 		// if there is no dur attribute on a chord, then look for it
 		// on the first note subelement of the chord.
-		auto newelement = element.select_node(".//note").node();
+		auto newelement = getFirstDescendant(element, "note");
 		if (newelement) {
 			element = newelement;
 			dur_attr = element.attribute("dur");
@@ -183,7 +183,8 @@ bool Tool_msearch::run(HumdrumFile& infile) {
 	m_debugQ = getBoolean("debug");
 	m_quietQ = getBoolean("quiet");
 	m_nooverlapQ = getBoolean("no-overlap");
-	NoteGrid grid(infile);
+	shared_ptr<NoteGrid> gridptr = infile.getAnalysis<NoteGrid>();
+	NoteGrid& grid = *gridptr;
 	if (m_debugQ) {
 		grid.printGridInfo(cerr);
 		// return 1;
@@ -41,6 +41,7 @@ Tool_musedata2hum::Tool_musedata2hum(void) {
 	define("r|recip=b",       "output **recip spine");
 	define("s|stems=b",       "include stems in output");
 	define("omv|no-omv=b",    "exclude extracted OMV record in output data");
+	define("t|threads=i:1",   "number of threads for reading parts (0 = all cores)");
 }
 
 
@@ -95,6 +96,7 @@ Options Tool_musedata2hum::getOptionDefinitions(void) {
 
 bool Tool_musedata2hum::convertFile(ostream& out, const string& filename) {
 	MuseDataSet mds;
+	mds.setThreadCount(getInteger("threads"));
 	int result = mds.readFile(filename);
 	if (!result) {
 		cerr << "\nMuseData file [" << filename << "] has syntax errors\n";
@@ -107,6 +109,7 @@ bool Tool_musedata2hum::convertFile(ostream& out, const string& filename) {
 
 bool Tool_musedata2hum::convert(ostream& out, istream& input) {
 	MuseDataSet mds;
+	mds.setThreadCount(getInteger("threads"));
 	mds.read(input);
 	return convert(out, mds);
 }
@@ -114,6 +117,7 @@ bool Tool_musedata2hum::convert(ostream& out, istream& input) {
 
 bool Tool_musedata2hum::convertString(ostream& out, const string& input) {
 	MuseDataSet mds;
+	mds.setThreadCount(getInteger("threads"));
 	int result = mds.readString(input);
 	if (!result) {
 		cout << "\nXML content has syntax errors\n";
@@ -149,17 +153,16 @@ bool Tool_musedata2hum::convert(ostream& out, MuseDataSet& mds) {
 
 	HumdrumFile outfile;
 	outdata.transferTokens(outfile);
-	outfile.generateLinesFromTokens();
-	stringstream sss;
-	sss << outfile;
-	outfile.readString(sss.str());
 
 	if (needsAboveBelowKernRdf()) {
 		outfile.appendLine("!!!RDF**kern: > = above");
 		outfile.appendLine("!!!RDF**kern: < = above");
 	}
 
-	outfile.createLinesFromTokens();
+	// Analyze the structure which the grid already knows rather than
+	// printing and re-reading the file, which also keeps the layout
+	// parameters stored in the tokens for printLine().
+	outfile.analyzeFromGridTokens();
 
 	Tool_trillspell trillspell;
 	trillspell.run(outfile);
@@ -20,6 +20,7 @@
 
 #include "Convert.h"
 #include "HumGrid.h"
+#include "HumParallel.h"
 #include "HumRegex.h"
 
 #include <algorithm>
@@ -45,6 +46,8 @@ Tool_musicxml2hum::Tool_musicxml2hum(void) {
 
 	define("r|recip=b", "output **recip spine");
 	define("s|stems=b", "include stems in output");
+	define("l|release-measures=b", "free the XML data of each measure after it is converted");
+	define("t|threads=i:1", "number of threads for parsing parts (0 = all cores)");
 
 	VoiceDebugQ = false;
 	DebugQ = false;
@@ -73,8 +76,18 @@ bool Tool_musicxml2hum::convertFile(ostream& out, const char* filename) {
 
 
 bool Tool_musicxml2hum::convert(ostream& out, istream& input) {
-	string s(istreambuf_iterator<char>(input), {});
-	return convert(out, s.c_str());
+	// Read the stream directly into the document's buffer, which is
+	// parsed in-situ, rather than making an intermediate copy of the data.
+	xml_document doc;
+	auto result = doc.load(input);
+	if (!result) {
+		cout << "\nXML content has syntax errors";
+		cout << " Error description:\t" << result.description() << "\n";
+		cout << "Error offset:\t" << result.offset << "\n\n";
+		return false;
+	}
+
+	return convert(out, doc);
 }
 
 
@@ -204,6 +217,10 @@ bool Tool_musicxml2hum::convert(ostream& out, xml_document& doc) {
 	addHeaderRecords(outfile, doc);
 	addFooterRecords(outfile, doc);
 
+	// Analyze the spine structure and rhythm known to the grid
+	// (otherwise ruthfix would have to print and re-read the file).
+	outfile.analyzeFromGridTokens();
+
 	Tool_ruthfix ruthfix;
 	ruthfix.run(outfile);
 
@@ -664,6 +681,8 @@ void Tool_musicxml2hum::addFooterRecords(HumdrumFile& outfile, xml_document& doc
 void Tool_musicxml2hum::initialize(void) {
 	m_recipQ = getBoolean("recip");
 	m_stemsQ = getBoolean("stems");
+	m_releaseMeasuresQ = getBoolean("release-measures");
+	m_threads = getInteger("threads");
 	m_hasOrnamentsQ = false;
 }
 
@@ -841,11 +860,26 @@ bool Tool_musicxml2hum::fillPartData(vector<MxmlPart>& partdata,
 		const vector<string>& partids, map<string, xml_node>& partinfo,
 		map<string, xml_node>& partcontent) {
 
-	bool output = true;
-	for (int i=0; i<(int)partinfo.size(); i++) {
+	int partcount = (int)partinfo.size();
+	vector<xml_node> declarations(partcount);
+	vector<xml_node> contents(partcount);
+	for (int i=0; i<partcount; i++) {
 		partdata[i].setPartNumber(i+1);
-		output &= fillPartData(partdata[i], partids[i], partinfo[partids[i]],
-				partcontent[partids[i]]);
+		declarations[i] = partinfo[partids[i]];
+		contents[i] = partcontent[partids[i]];
+	}
+
+	// Parts do not interact until they are stitched together, so
+	// each thread parses whole parts taken from a shared counter.
+	vector<char> status(partcount, 1);
+	HumParallel::run(partcount, m_threads, [&](int i) {
+		status[i] = fillPartData(partdata[i], partids[i], declarations[i],
+				contents[i]);
+	});
+
+	bool output = true;
+	for (int i=0; i<partcount; i++) {
+		output &= (bool)status[i];
 	}
 	return output;
 }
@@ -1044,11 +1078,26 @@ bool Tool_musicxml2hum::stitchParts(HumGrid& outdata,
 
 	bool status = true;
 	int m;
+	int released = 0; // first measure which still has XML content
 	for (m=0; m<partdata[0].getMeasureCount(); m++) {
 		status &= insertMeasure(outdata, m, partdata, partstaves);
 		// a hack for now:
 		// insertSingleMeasure(outfile);
 		// measures.push_back(&outfile[outfile.getLineCount()-1]);
+
+		if (m_releaseMeasuresQ) {
+			// The events are no longer needed after the measure has been
+			// stored in the grid.  The XML content for previous measures
+			// can be removed as well if nothing is waiting to be attached
+			// to a later note.
+			for (i=0; i<(int)partdata.size(); i++) {
+				partdata[i].getMeasure(m)->releaseEvents();
+			}
+			if (!hasPendingNodes()) {
+				releaseMeasureNodes(partdata, released, m);
+				released = m;
+			}
+		}
 	}
 
 	moveBreaksToEndOfPreviousMeasure(outdata);
@@ -1060,6 +1109,78 @@ bool Tool_musicxml2hum::stitchParts(HumGrid& outdata,
 
 
 
+//////////////////////////////
+//
+// Tool_musicxml2hum::hasPendingNodes -- Returns true if any XML elements
+//    are being stored for insertion at a later note (such as dynamics or
+//    text which occur before the note they are attached to).
+//
+
+bool Tool_musicxml2hum::hasPendingNodes(void) {
+	if (!m_current_text.empty() || !m_current_tempo.empty()) {
+		return true;
+	}
+	if (!m_post_note_text.empty()) {
+		return true;
+	}
+	for (int i=0; i<(int)m_current_dynamic.size(); i++) {
+		if (!m_current_dynamic[i].empty()) {
+			return true;
+		}
+	}
+	for (int i=0; i<(int)m_current_brackets.size(); i++) {
+		if (!m_current_brackets[i].empty()) {
+			return true;
+		}
+	}
+	for (int i=0; i<(int)m_current_figured_bass.size(); i++) {
+		if (!m_current_figured_bass[i].empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+//////////////////////////////
+//
+// Tool_musicxml2hum::releaseMeasureNodes -- Remove the measure elements
+//    in the range from startm to stopm-1 from the XML document.  Hairpin
+//    endings in those measures are also removed from the used hairpin
+//    list, since they will not be seen again.
+//
+
+void Tool_musicxml2hum::releaseMeasureNodes(vector<MxmlPart>& partdata,
+		int startm, int stopm) {
+	for (int p=0; p<(int)partdata.size(); p++) {
+		vector<xml_node>& hairpins = m_used_hairpins.at(p);
+		for (int m=startm; m<stopm; m++) {
+			MxmlMeasure* measure = partdata[p].getMeasure(m);
+			if (!measure) {
+				continue;
+			}
+			xml_node mnode = measure->getNode();
+			if (!mnode) {
+				continue;
+			}
+			for (int i=(int)hairpins.size() - 1; i>=0; i--) {
+				xml_node ancestor = hairpins[i];
+				while (ancestor && (ancestor != mnode)) {
+					ancestor = ancestor.parent();
+				}
+				if (ancestor) {
+					hairpins.erase(hairpins.begin() + i);
+				}
+			}
+			measure->clearNode();
+			mnode.parent().remove_child(mnode);
+		}
+	}
+}
+
+
+
 //////////////////////////////
 //
 // moveBreaksToEndOfPreviousMeasure --
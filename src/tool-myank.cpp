@@ -249,7 +249,10 @@ void Tool_myank::processFile(HumdrumFile& infile) {
 		return;
 	}
 
-	getMetStates(m_metstates, infile);
+	if (m_debugQ) {
+		// Only needed for the debugging printout.
+		getMetStates(m_metstates, infile);
+	}
 	getMeasureStartStop(m_measureInList, infile);
 
 	string measurestring = getString("measures");
@@ -1893,13 +1896,25 @@ void Tool_myank::getMeasureStartStop(vector<MeasureInfo>& measurelist, HumdrumFi
 
 	insertZerothMeasure(measurelist, infile);
 
-	for (i=0; i<infile.getLineCount(); i++) {
-		if (infile[i].isInterpretation()) {
-			if (*infile.token(i, 0) == "*-") {
-				dataend = i;
+	// Only barlines can start or stop a measure, so walk through the
+	// measure index rather than every line in the file.  Lines that are
+	// not inside of a numbered measure are still checked for the end of
+	// the data.
+	int mcount = infile.getMeasureCount();
+	int nextline = 0;
+	int m, mm;
+	for (m=0; m<=mcount; m++) {
+		i = (m < mcount) ? infile.getMeasureInfo(m).startLine : infile.getLineCount();
+		for (ii=nextline; ii<i; ii++) {
+			if (infile[ii].isInterpretation() && (*infile.token(ii, 0) == "*-")) {
+				dataend = ii;
 				break;
 			}
 		}
+		if ((dataend >= 0) || (m == mcount)) {
+			break;
+		}
+		nextline = i + 1;
 		if (!infile[i].isBarline()) {
 			continue;
 		}
@@ -1913,10 +1928,8 @@ void Tool_myank::getMeasureStartStop(vector<MeasureInfo>& measurelist, HumdrumFi
 		current.clear();
 		current.start = i;
 		current.num   = barnum1;
-		for (ii=i+1; ii<infile.getLineCount(); ii++) {
-			if (!infile[ii].isBarline()) {
-				continue;
-			}
+		for (mm=m+1; mm<mcount; mm++) {
+			ii = infile.getMeasureInfo(mm).startLine;
 			//if (hre.search(infile.token(ii, 0), "^=.*(\\d+)")) {
 			//   barnum2 = stoi(hre.getMatch(1));
 			//   current.stop = ii;
@@ -1930,7 +1943,8 @@ void Tool_myank::getMeasureStartStop(vector<MeasureInfo>& measurelist, HumdrumFi
 				barnum2 = stoi(hre.getMatch(1));
 				current.stop = ii;
 				lastend = ii;
-				i = ii - 1;
+				m = mm - 1;
+				nextline = ii;
 				current.file = &infile;
 				measurelist.push_back(current);
 				break;
@@ -2197,7 +2211,6 @@ void Tool_myank::expandMeasureOutList(vector<MeasureInfo>& measureout,
 		inmap[measurein[i].num] = i;
 	}
 
-	fillGlobalDefaults(infile, measurein, inmap);
 	string ostring = optionstring;
 	removeDollarsFromString(ostring, maxmeasure);
 
@@ -2219,6 +2232,37 @@ void Tool_myank::expandMeasureOutList(vector<MeasureInfo>& measureout,
 		processFieldEntry(range, hre.getMatch(1), infile, maxmeasure, measurein, inmap);
 		value = hre.search(ostring, start, searchexp);
 	}
+
+	// Only calculate the interpretation states of the extracted measures
+	// (all measures are needed for the debugging printouts).
+	int first = (int)measurein.size();
+	int last = -1;
+	if (m_inlistQ || m_debugQ) {
+		first = 0;
+		last = (int)measurein.size() - 1;
+	} else {
+		for (int i=0; i<(int)range.size(); i++) {
+			first = std::min(first, inmap[range[i].num]);
+			last  = std::max(last,  inmap[range[i].num]);
+		}
+	}
+	fillGlobalDefaults(infile, measurein, inmap, first, last);
+	for (int i=0; i<(int)range.size(); i++) {
+		MeasureInfo& minfo = measurein[inmap[range[i].num]];
+		range[i].sclef    = minfo.sclef;
+		range[i].skeysig  = minfo.skeysig;
+		range[i].skey     = minfo.skey;
+		range[i].stimesig = minfo.stimesig;
+		range[i].smet     = minfo.smet;
+		range[i].stempo   = minfo.stempo;
+
+		range[i].eclef    = minfo.eclef;
+		range[i].ekeysig  = minfo.ekeysig;
+		range[i].ekey     = minfo.ekey;
+		range[i].etimesig = minfo.etimesig;
+		range[i].emet     = minfo.emet;
+		range[i].etempo   = minfo.etempo;
+	}
 }
 
 
@@ -2226,10 +2270,16 @@ void Tool_myank::expandMeasureOutList(vector<MeasureInfo>& measureout,
 //////////////////////////////
 //
 // Tool_myank::fillGlobalDefaults -- keep track of the clef, key signature, key, etc.
+//    Only the states of the input measures from first to last are needed,
+//    so the measure index is used to skip to the barline before first,
+//    and the search stops after the last measure.
 //
 
 void Tool_myank::fillGlobalDefaults(HumdrumFile& infile, vector<MeasureInfo>& measurein,
-		vector<int>& inmap) {
+		vector<int>& inmap, int first, int last) {
+	if (last < first) {
+		return;
+	}
 	int i, j;
 	HumRegex hre;
 
@@ -2253,130 +2303,167 @@ void Tool_myank::fillGlobalDefaults(HumdrumFile& infile, vector<MeasureInfo>& me
 	fill(currmet.begin(), currmet.end(), undefMyCoord);
 	fill(currtempo.begin(), currtempo.end(), undefMyCoord);
 
+	// Only **kern spines are tracked.
+	vector<bool> kernQ(tracks+1, false);
+	for (i=1; i<=tracks; i++) {
+		HTp tstart = infile.getTrackStart(i);
+		kernQ[i] = tstart && tstart->isKern();
+	}
+	vector<vector<MyCoord>*> currstates = { NULL, &currclef, &currkeysig,
+			&currkey, &currtimesig, &currmet, &currtempo };
+
 	int currmeasure = -1;
 	int lastmeasure = -1;
-	int datafound   = 0;
-	int track;
-	int thingy = 0;
-
-	for (i=0; i<infile.getLineCount(); i++) {
-		if ((currmeasure == -1) && (thingy == 0) && infile[i].isData()) {
-			currmeasure = 0;
-		}
-		if (infile[i].isBarline()) {
-			if (!hre.search(infile.token(i, 0), "(\\d+)", "")) {
-				continue;
+	int type;
+
+	// The measure index stores the prevailing states at each barline, so
+	// only barlines need to be visited here, starting with the barline
+	// of the measure before first.
+	int mcount = infile.getMeasureCount();
+	int startm = 0;
+	int startpos = std::max(first - 1, 0);
+	while ((startpos > 0) && (inmap[measurein[startpos].num] != startpos)) {
+		// The states of a repeated measure number are only stored in its
+		// last entry, so the earlier entries are filled in by the clean up
+		// at the end of this function.
+		startpos--;
+	}
+	if (startpos > 0) {
+		startm = infile.getMeasureIndexByNumber(measurein[startpos].num);
+		if ((startm < 0) || (infile.getMeasureInfo(startm).startLine != measurein[startpos].start)) {
+			// Repeated measure number.
+			startm = infile.getMeasureIndexByLine(measurein[startpos].start);
+		}
+		currmeasure = measurein[startpos-1].num;
+	} else {
+		// Music before the first numbered barline is in measure 0.
+		for (i=0; i<infile.getLineCount(); i++) {
+			if (infile[i].isData()) {
+				currmeasure = 0;
+				break;
 			}
-			thingy = 1;
-
-			// store state of global music values at end of measure
-			if (currmeasure >= 0) {
-				measurein[inmap[currmeasure]].eclef    = currclef;
-				measurein[inmap[currmeasure]].ekeysig  = currkeysig;
-				measurein[inmap[currmeasure]].ekey     = currkey;
-				measurein[inmap[currmeasure]].etimesig = currtimesig;
-				measurein[inmap[currmeasure]].emet     = currmet;
-				measurein[inmap[currmeasure]].etempo   = currtempo;
+			if (infile[i].isBarline() && hre.search(infile.token(i, 0), "(\\d+)", "")) {
+				break;
 			}
+		}
+	}
 
-			lastmeasure = currmeasure;
-			currmeasure = hre.getMatchInt(1);
-
-			if (currmeasure < (int)inmap.size()) {
-				// [20120818] Had to compensate for last measure being single
-				// and un-numbered.
-				if (inmap[currmeasure] < 0) {
-					// [20111008] Had to compensate for "==85" barline
-					datafound = 0;
-					break;
-				}
-// cerr << "CURRCLEF: ";
-// for (int z=0; z<(int)currclef.size(); z++) {
-// cerr << "(" << currclef[z].x << "," << currclef[z].y << ") ";
-// }
-// cerr << endl;
-				measurein[inmap[currmeasure]].sclef    = currclef;
-				measurein[inmap[currmeasure]].skeysig  = currkeysig;
-				measurein[inmap[currmeasure]].skey     = currkey;
-				measurein[inmap[currmeasure]].stimesig = currtimesig;
-				// measurein[inmap[currmeasure]].smet     = metstates[i];
-				measurein[inmap[currmeasure]].smet     = currmet;
-				measurein[inmap[currmeasure]].stempo   = currtempo;
-			}
-
-			datafound   = 0;
+	bool stopped = false;
+	for (int m=startm; m<mcount; m++) {
+		const HumMeasureInfo& info = infile.getMeasureInfo(m);
+		i = info.startLine;
+		if (!infile[i].isBarline()) {
 			continue;
 		}
-		if (infile[i].isInterpretation()) {
-			for (j=0; j<infile[i].getFieldCount(); j++) {
-				if (!infile.token(i, j)->isKern()) {
-					continue;
-				}
-				track = infile.token(i, j)->getTrack();
+		if (!hre.search(infile.token(i, 0), "(\\d+)", "")) {
+			continue;
+		}
+		fillIndexStates(currclef,    info.clef,    kernQ);
+		fillIndexStates(currkeysig,  info.keysig,  kernQ);
+		fillIndexStates(currkey,     info.key,     kernQ);
+		fillIndexStates(currtimesig, info.timesig, kernQ);
+		fillIndexStates(currmet,     info.met,     kernQ);
+		fillIndexStates(currtempo,   info.tempo,   kernQ);
+
+		// store state of global music values at end of measure
+		if ((currmeasure >= 0) && (currmeasure < (int)inmap.size())
+				&& (inmap[currmeasure] >= 0)) {
+			measurein[inmap[currmeasure]].eclef    = currclef;
+			measurein[inmap[currmeasure]].ekeysig  = currkeysig;
+			measurein[inmap[currmeasure]].ekey     = currkey;
+			measurein[inmap[currmeasure]].etimesig = currtimesig;
+			measurein[inmap[currmeasure]].emet     = currmet;
+			measurein[inmap[currmeasure]].etempo   = currtempo;
+		}
+		if (i > measurein[last].start) {
+			// The end states of the last needed measure are known.
+			stopped = true;
+			break;
+		}
 
-				if ((datafound == 0) && (lastmeasure >= 0)) {
-					if (infile.token(i, j)->compare(0, 5, "*clef") == 0) {
-						measurein[inmap[currmeasure]].sclef[track].x = -1;
-						measurein[inmap[currmeasure]].sclef[track].y = -1;
-					} else if (hre.search(infile.token(i, j), "^\\*k\\[.*\\]", "")) {
-						measurein[inmap[currmeasure]].skeysig[track].x = -1;
-						measurein[inmap[currmeasure]].skeysig[track].y = -1;
-					} else if (hre.search(infile.token(i, j), "^\\*[A-G][#-]?:", "i")) {
-						measurein[inmap[currmeasure]].skey[track].x = -1;
-						measurein[inmap[currmeasure]].skey[track].y = -1;
-					} else if (hre.search(infile.token(i, j), R"(^\*M\d+/\d+)")) {
-						measurein[inmap[currmeasure]].stimesig[track].x = -1;
-						measurein[inmap[currmeasure]].stimesig[track].y = -1;
-					} else if (hre.search(infile.token(i, j), R"(^\*met\(.*\))")) {
-						measurein[inmap[currmeasure]].smet[track].x = -1;
-						measurein[inmap[currmeasure]].smet[track].y = -1;
-					} else if (hre.search(infile.token(i, j), "^\\*MM\\d+", "i")) {
-						measurein[inmap[currmeasure]].stempo[track].x = -1;
-						measurein[inmap[currmeasure]].stempo[track].y = -1;
-					}
-				}
+		lastmeasure = currmeasure;
+		currmeasure = hre.getMatchInt(1);
 
-				if (infile.token(i, j)->compare(0, 5, "*clef") == 0) {
-					currclef[track].x = i;
-					currclef[track].y = j;
-					continue;
-				}
-				if (hre.search(infile.token(i, j), R"(^\*k\[.*\])")) {
-					currkeysig[track].x = i;
-					currkeysig[track].y = j;
-					continue;
-				}
-				if (hre.search(infile.token(i, j), "^\\*[A-G][#-]?:", "i")) {
-					currkey[track].x = i;
-					currkey[track].y = j;
-					continue;
-				}
-				if (hre.search(infile.token(i, j), R"(^\*M\d+/\d+)")) {
-					currtimesig[track].x = i;
-					currtimesig[track].y = j;
-					continue;
-				}
-				if (hre.search(infile.token(i, j), R"(^\*met\(.*\))")) {
-					currmet[track].x = i;
-					currmet[track].y = j;
+		if (currmeasure >= (int)inmap.size()) {
+			continue;
+		}
+		// [20120818] Had to compensate for last measure being single
+		// and un-numbered.
+		if (inmap[currmeasure] < 0) {
+			// [20111008] Had to compensate for "==85" barline
+			break;
+		}
+		MeasureInfo& minfo = measurein[inmap[currmeasure]];
+		minfo.sclef    = currclef;
+		minfo.skeysig  = currkeysig;
+		minfo.skey     = currkey;
+		minfo.stimesig = currtimesig;
+		minfo.smet     = currmet;
+		minfo.stempo   = currtempo;
+		if (lastmeasure < 0) {
+			continue;
+		}
+
+		// Interpretations between the barline and the first data line
+		// will be printed within the measure, so they are not needed
+		// as starting states.
+		vector<vector<MyCoord>*> startstates = { NULL, &minfo.sclef,
+				&minfo.skeysig, &minfo.skey, &minfo.stimesig, &minfo.smet,
+				&minfo.stempo };
+		for (int ii=i+1; ii<infile.getLineCount(); ii++) {
+			if (infile[ii].isData()) {
+				break;
+			}
+			if (infile[ii].isBarline() && hre.search(infile.token(ii, 0), "(\\d+)", "")) {
+				break;
+			}
+			if (!infile[ii].isInterpretation()) {
+				continue;
+			}
+			for (j=0; j<infile[ii].getFieldCount(); j++) {
+				HTp token = infile.token(ii, j);
+				if (!token->isKern()) {
 					continue;
 				}
-				if (hre.search(infile.token(i, j), R"(^\*MM[\d.]+)")) {
-					currtempo[track].x = i;
-					currtempo[track].y = j;
-					continue;
+				type = getGlobalStateType(token);
+				if (type > 0) {
+					(*startstates[type])[token->getTrack()].clear();
 				}
-
 			}
 		}
-		if (infile[i].isData()) {
-			datafound = 1;
-		}
 	}
 
 	// store state of global music values at end of music
-	if ((currmeasure >= 0) && (currmeasure < (int)inmap.size())
+	if (!stopped && (currmeasure >= 0) && (currmeasure < (int)inmap.size())
 			&& (inmap[currmeasure] >= 0)) {
+		int startline = 0;
+		if (mcount > 0) {
+			const HumMeasureInfo& info = infile.getMeasureInfo(mcount - 1);
+			startline = info.startLine;
+			fillIndexStates(currclef,    info.clef,    kernQ);
+			fillIndexStates(currkeysig,  info.keysig,  kernQ);
+			fillIndexStates(currkey,     info.key,     kernQ);
+			fillIndexStates(currtimesig, info.timesig, kernQ);
+			fillIndexStates(currmet,     info.met,     kernQ);
+			fillIndexStates(currtempo,   info.tempo,   kernQ);
+		}
+		for (i=startline; i<infile.getLineCount(); i++) {
+			if (!infile[i].isInterpretation()) {
+				continue;
+			}
+			for (j=0; j<infile[i].getFieldCount(); j++) {
+				HTp token = infile.token(i, j);
+				if (!token->isKern()) {
+					continue;
+				}
+				type = getGlobalStateType(token);
+				if (type > 0) {
+					MyCoord& coord = (*currstates[type])[token->getTrack()];
+					coord.x = i;
+					coord.y = j;
+				}
+			}
+		}
 		measurein[inmap[currmeasure]].eclef    = currclef;
 		measurein[inmap[currmeasure]].ekeysig  = currkeysig;
 		measurein[inmap[currmeasure]].ekey     = currkey;
@@ -2386,7 +2473,7 @@ void Tool_myank::fillGlobalDefaults(HumdrumFile& infile, vector<MeasureInfo>& me
 	}
 
 	// go through the measure list and clean up start/end states
-	for (i=0; i<(int)measurein.size()-2; i++) {
+	for (i=startpos; (i<(int)measurein.size()-2) && (i<=last); i++) {
 
 		if (measurein[i].sclef.size() == 0) {
 			measurein[i].sclef.resize(tracks+1);
@@ -2566,6 +2653,54 @@ void Tool_myank::fillGlobalDefaults(HumdrumFile& infile, vector<MeasureInfo>& me
 
 
 
+
+//////////////////////////////
+//
+// Tool_myank::fillIndexStates -- Convert interpretation states from the
+//    measure index into line/field coordinates for **kern tracks.
+//
+
+void Tool_myank::fillIndexStates(vector<MyCoord>& output, const vector<HTp>& states,
+		vector<bool>& kernQ) {
+	for (int i=1; i<(int)output.size(); i++) {
+		if ((i < (int)states.size()) && kernQ[i] && states[i]) {
+			output[i].x = states[i]->getLineIndex();
+			output[i].y = states[i]->getFieldIndex();
+		} else {
+			output[i].clear();
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_myank::getGlobalStateType -- Return the type of interpretation
+//    tracked by fillGlobalDefaults(): 1 = clef, 2 = key signature, 3 = key,
+//    4 = time signature, 5 = mensuration, 6 = tempo.  Returns 0 for other
+//    tokens.  This matches the classification used by the measure index.
+//
+
+int Tool_myank::getGlobalStateType(HTp token) {
+	if (token->compare(0, 5, "*clef") == 0) {
+		return 1;
+	} else if (token->isKeySignature()) {
+		return 2;
+	} else if (token->isKeyDesignation()) {
+		return 3;
+	} else if (token->isTimeSignature()) {
+		return 4;
+	} else if (token->isMensurationSymbol()) {
+		return 5;
+	} else if (token->isTempo()) {
+		return 6;
+	}
+	return 0;
+}
+
+
+
 //////////////////////////////
 //
 // Tool_myank::processFieldEntry --
@@ -2631,20 +2766,6 @@ void Tool_myank::processFieldEntry(vector<MeasureInfo>& field,
 					current.start = inmeasures[inmap[i]].start;
 					current.stop = inmeasures[inmap[i]].stop;
 
-					current.sclef    = inmeasures[inmap[i]].sclef;
-					current.skeysig  = inmeasures[inmap[i]].skeysig;
-					current.skey     = inmeasures[inmap[i]].skey;
-					current.stimesig = inmeasures[inmap[i]].stimesig;
-					current.smet     = inmeasures[inmap[i]].smet;
-					current.stempo   = inmeasures[inmap[i]].stempo;
-
-					current.eclef    = inmeasures[inmap[i]].eclef;
-					current.ekeysig  = inmeasures[inmap[i]].ekeysig;
-					current.ekey     = inmeasures[inmap[i]].ekey;
-					current.etimesig = inmeasures[inmap[i]].etimesig;
-					current.emet     = inmeasures[inmap[i]].emet;
-					current.etempo   = inmeasures[inmap[i]].etempo;
-
 					field.push_back(current);
 				}
 			}
@@ -2658,20 +2779,6 @@ void Tool_myank::processFieldEntry(vector<MeasureInfo>& field,
 					current.start = inmeasures[inmap[i]].start;
 					current.stop = inmeasures[inmap[i]].stop;
 
-					current.sclef    = inmeasures[inmap[i]].sclef;
-					current.skeysig  = inmeasures[inmap[i]].skeysig;
-					current.skey     = inmeasures[inmap[i]].skey;
-					current.stimesig = inmeasures[inmap[i]].stimesig;
-					current.smet     = inmeasures[inmap[i]].smet;
-					current.stempo   = inmeasures[inmap[i]].stempo;
-
-					current.eclef    = inmeasures[inmap[i]].eclef;
-					current.ekeysig  = inmeasures[inmap[i]].ekeysig;
-					current.ekey     = inmeasures[inmap[i]].ekey;
-					current.etimesig = inmeasures[inmap[i]].etimesig;
-					current.emet     = inmeasures[inmap[i]].emet;
-					current.etempo   = inmeasures[inmap[i]].etempo;
-
 					field.push_back(current);
 				}
 			}
@@ -2694,20 +2801,6 @@ void Tool_myank::processFieldEntry(vector<MeasureInfo>& field,
 			current.start = inmeasures[inmap[value]].start;
 			current.stop = inmeasures[inmap[value]].stop;
 
-			current.sclef    = inmeasures[inmap[value]].sclef;
-			current.skeysig  = inmeasures[inmap[value]].skeysig;
-			current.skey     = inmeasures[inmap[value]].skey;
-			current.stimesig = inmeasures[inmap[value]].stimesig;
-			current.smet     = inmeasures[inmap[value]].smet;
-			current.stempo   = inmeasures[inmap[value]].stempo;
-
-			current.eclef    = inmeasures[inmap[value]].eclef;
-			current.ekeysig  = inmeasures[inmap[value]].ekeysig;
-			current.ekey     = inmeasures[inmap[value]].ekey;
-			current.etimesig = inmeasures[inmap[value]].etimesig;
-			current.emet     = inmeasures[inmap[value]].emet;
-			current.etempo   = inmeasures[inmap[value]].etempo;
-
 			field.push_back(current);
 		}
 	}
@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sat Sep  7 20:22:22 PDT 2019
-// Last Modified: Sat Sep  7 20:22:25 PDT 2019
+// Last Modified: Mon Oct 19 20:14:05 PDT 2026
 // Filename:      tool-pccount.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/src/tool-pccount.cpp
 // Syntax:        C++11; humlib
@@ -14,6 +14,9 @@
 #include "tool-pccount.h"
 #include "Convert.h"
 #include "HumRegex.h"
+#include "HumParallel.h"
+
+#include <algorithm>
 
 using namespace std;
 
@@ -43,6 +46,9 @@ Tool_pccount::Tool_pccount(void) {
 	define("title=s",                     "title for plot");
 	define("t|template|vega-template=b",  "display the vega-lite template.");
 	define("w|width=i:400",               "width of vega-lite plot");
+	define("g|aggregate=b",               "combine counts of all input files");
+	define("per-file=b",                  "also list counts of each input file (implies -g)");
+	define("threads=i:1",                 "number of threads for reading files with -g (0 = all cores)");
 }
 
 
@@ -80,6 +86,233 @@ bool Tool_pccount::run(HumdrumFile& infile) {
 }
 
 
+bool Tool_pccount::run(HumdrumFileStream& instream) {
+	if (getBoolean("aggregate") || getBoolean("per-file")) {
+		aggregateFiles(instream);
+		return true;
+	}
+	HumdrumFileSet infiles;
+	bool status = true;
+	while (instream.readSingleSegment(infiles)) {
+		status &= run(infiles);
+	}
+	return status;
+}
+
+
+
+//////////////////////////////
+//
+// Tool_pccount::aggregateFiles -- Print a table of the pitch-class counts
+//    of all input files combined (-g option), optionally preceded by a
+//    table of the counts for each file (--per-file option).  Files given
+//    on the command line are read and counted by a pool of threads, each
+//    taking whole files from a shared counter, and the counts are added
+//    afterwards in the input order, so the totals do not depend on the
+//    number of threads.  Standard input can only be read one segment at
+//    a time.
+//
+
+void Tool_pccount::aggregateFiles(HumdrumFileStream& instream) {
+	m_attack    = getBoolean("attacks");
+	m_normalize = getBoolean("normalize");
+	m_maximum   = getBoolean("maximum");
+	m_perFile   = getBoolean("per-file");
+	m_threads   = getInteger("threads");
+
+	vector<string> filenames;
+	getArgList(filenames);
+	int count = (int)filenames.size();
+
+	// names, counts: segment names and voice counts for each input.
+	vector<vector<string>> names(std::max(count, 1));
+	vector<vector<vector<_PitchClassCounts>>> counts(std::max(count, 1));
+
+	if (count == 0) {
+		countFileSegments(instream, names[0], counts[0]);
+	} else {
+		string cachedir = instream.getCacheDirectory();
+		HumParallel::run(count, m_threads, [&](int i) {
+			HumdrumFileStream filestream(vector<string>(1, filenames[i]));
+			filestream.setCacheDirectory(cachedir);
+			countFileSegments(filestream, names[i], counts[i]);
+		});
+	}
+
+	vector<string> rownames;
+	vector<vector<_PitchClassCounts>> rowcounts;
+	for (int i=0; i<(int)counts.size(); i++) {
+		for (int j=0; j<(int)counts[i].size(); j++) {
+			rownames.push_back(names[i][j]);
+			rowcounts.emplace_back();
+			rowcounts.back().swap(counts[i][j]);
+		}
+	}
+
+	if (m_perFile) {
+		printFileRows(rownames, rowcounts);
+	}
+	mergeCounts(rowcounts);
+	printHumdrumTable();
+}
+
+
+
+//////////////////////////////
+//
+// Tool_pccount::countFileSegments -- Store the name and the pitch-class
+//    counts of each voice (after the counts for all voices) for each
+//    segment in the input stream.  The counting is done by a separate
+//    tool object, so this can be called from several threads with
+//    different input streams.
+//
+
+void Tool_pccount::countFileSegments(HumdrumFileStream& instream,
+		vector<string>& names, vector<vector<_PitchClassCounts>>& counts) {
+	Tool_pccount counter;
+	counter.m_attack = m_attack;
+	HumdrumFile infile;
+	while (instream.read(infile)) {
+		counter.initializePartInfo(infile);
+		counter.countPitches(infile);
+		vector<HTp> starts = infile.getKernSpineStartList();
+		names.push_back(infile.getFilename());
+		counts.emplace_back(counter.m_counts.size());
+		vector<_PitchClassCounts>& voices = counts.back();
+		for (int i=0; i<(int)voices.size(); i++) {
+			if ((i > 0) && (i <= (int)starts.size())) {
+				voices[i].name = getPartName(starts[i-1]);
+			}
+			for (int j=0; j<40; j++) {
+				voices[i].counts[j] = counter.m_counts[i][j];
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_pccount::getPartName -- Return the instrument name of a **kern
+//    spine, or an empty string if there is no name before the first data.
+//
+
+string Tool_pccount::getPartName(HTp sstart) {
+	HTp current = sstart;
+	while (current) {
+		if (current->isData()) {
+			break;
+		}
+		if (current->compare(0, 3, "*I\"") == 0) {
+			return current->substr(3);
+		}
+		current = current->getNextToken();
+	}
+	return "";
+}
+
+
+
+//////////////////////////////
+//
+// Tool_pccount::mergeCounts -- Add the counts of all segments into
+//    m_counts for printing with printHumdrumTable().  Voices are merged
+//    by instrument name in the order that the names are first found.
+//    Voices without a name are merged into an unlabeled last column.
+//
+
+void Tool_pccount::mergeCounts(vector<vector<_PitchClassCounts>>& counts) {
+	m_names.clear();
+	m_abbreviations.clear();
+	m_names.push_back("all");
+
+	map<string, int> columns;
+	bool unnamed = false;
+	for (int i=0; i<(int)counts.size(); i++) {
+		for (int j=1; j<(int)counts[i].size(); j++) {
+			const string& name = counts[i][j].name;
+			if (name.empty()) {
+				unnamed = true;
+			} else if (columns.find(name) == columns.end()) {
+				columns[name] = (int)m_names.size();
+				m_names.push_back(name);
+			}
+		}
+	}
+	int unnamedcolumn = (int)m_names.size();
+
+	m_counts.assign(m_names.size() + (unnamed ? 1 : 0), vector<double>(40, 0.0));
+	for (int i=0; i<(int)counts.size(); i++) {
+		for (int j=0; j<(int)counts[i].size(); j++) {
+			int column = 0;
+			if (j > 0) {
+				const string& name = counts[i][j].name;
+				column = name.empty() ? unnamedcolumn : columns[name];
+			}
+			for (int k=0; k<40; k++) {
+				m_counts[column][k] += counts[i][j].counts[k];
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_pccount::printFileRows -- Print the pitch-class counts for all voices
+//    of each segment for the --per-file option, with a column for each
+//    pitch class found in any segment.  Each row is scaled separately for
+//    the -n and -m options.
+//
+
+void Tool_pccount::printFileRows(vector<string>& names,
+		vector<vector<_PitchClassCounts>>& counts) {
+	vector<int> pcs;
+	for (int k=0; k<40; k++) {
+		for (int i=0; i<(int)counts.size(); i++) {
+			if (counts[i][0].counts[k] > 0.0) {
+				pcs.push_back(k);
+				break;
+			}
+		}
+	}
+
+	m_free_text << "**file";
+	for (int k=0; k<(int)pcs.size(); k++) {
+		m_free_text << "\t**" << Convert::base40ToKern(pcs[k] + 4*40);
+	}
+	m_free_text << endl;
+
+	for (int i=0; i<(int)counts.size(); i++) {
+		double* values = counts[i][0].counts;
+		double factor = 0.0;
+		for (int k=0; k<40; k++) {
+			if (m_maximum) {
+				factor = std::max(factor, values[k]);
+			} else if (m_normalize) {
+				factor += values[k];
+			}
+		}
+		if (factor <= 0.0) {
+			factor = 1.0;
+		}
+		m_free_text << (names[i].empty() ? "." : names[i]);
+		for (int k=0; k<(int)pcs.size(); k++) {
+			m_free_text << "\t" << values[pcs[k]] / factor;
+		}
+		m_free_text << endl;
+	}
+
+	m_free_text << "*-";
+	for (int k=0; k<(int)pcs.size(); k++) {
+		m_free_text << "\t*-";
+	}
+	m_free_text << endl;
+}
+
+
 
 //////////////////////////////
 //
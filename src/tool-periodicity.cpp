@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sun Jul 15 09:57:12 CEST 2018
-// Last Modified: Sun Jul 15 09:57:16 CEST 2018
+// Last Modified: Mon Oct 19 21:05:37 PDT 2026
 // Filename:      tool-periodicity.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/src/tool-periodicity.cpp
 // Syntax:        C++11; humlib
@@ -15,7 +15,9 @@
 
 #include "pugixml.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <complex>
 
 using namespace std;
 
@@ -39,6 +41,10 @@ Tool_periodicity::Tool_periodicity(void) {
 	define("s|svg=b",         "output svg image");
 	define("p|power=d:2.0",   "scaling power for visual display");
 	define("1|one=b",         "composite rhythms are not weighted by attack");
+	define("a|autocorrelation=b", "autocorrelation of attack grid (calculated with FFT)");
+	define("w|window=d:0",    "window size in quarter notes for short-time autocorrelation (0 = whole score)");
+	define("hop=d:0",         "step between windows in quarter notes (0 = half window)");
+	define("max-lag=d:0",     "maximum autocorrelation lag in quarter notes (0 = window size)");
 }
 
 
@@ -87,7 +93,7 @@ bool Tool_periodicity::run(HumdrumFile& infile, ostream& out) {
 
 bool Tool_periodicity::run(HumdrumFile& infile) {
 	processFile(infile);
-	return true;
+	return !hasError();
 }
 
 
@@ -113,6 +119,11 @@ void Tool_periodicity::processFile(HumdrumFile& infile) {
 	}
 
 	int atrack = getInteger("track");
+	if (getBoolean("autocorrelation") || getBoolean("window")) {
+		processAutocorrelation(attackgrids[atrack], minrhy);
+		return;
+	}
+
 	vector<vector<double>> analysis;
 	doPeriodicityAnalysis(analysis, attackgrids[atrack], minrhy);
 
@@ -179,6 +190,240 @@ void Tool_periodicity::doAnalysis(vector<vector<double>>& analysis, int level, v
 
 
 
+//////////////////////////////
+//
+// Tool_periodicity::processAutocorrelation -- Calculate the autocorrelation
+//    of the attack grid for the whole grid, or for overlapping windows if
+//    the -w option is given.  The autocorrelations are calculated with an
+//    FFT, so the analysis time grows as N log N of the grid length rather
+//    than with the product of the grid length and the number of lags.
+//
+
+void Tool_periodicity::processAutocorrelation(vector<double>& grid, HumNum minrhy) {
+	// Grid positions per quarter note:
+	double scale = minrhy.getFloat() / 4.0;
+	int gridsize = (int)grid.size();
+	if (gridsize == 0) {
+		return;
+	}
+
+	double window = getDouble("window");
+	double hopsize = getDouble("hop");
+	double lagsize = getDouble("max-lag");
+	if ((window < 0.0) || (hopsize < 0.0) || (lagsize < 0.0)) {
+		setError("Error: window, hop and max-lag sizes cannot be negative");
+		return;
+	}
+
+	// A window size of 0 (-w 0) is the whole grid:
+	bool windowed = window > 0.0;
+	int windowsize = gridsize;
+	int hop = gridsize;
+	if (windowed) {
+		windowsize = (int)(window * scale + 0.5);
+		if (windowsize < 2) {
+			windowsize = 2;
+		}
+		hop = (int)(hopsize * scale + 0.5);
+		if (hop <= 0) {
+			hop = std::max(1, windowsize / 2);
+		}
+	}
+	int maxlag = (int)(lagsize * scale + 0.5);
+	if ((maxlag <= 0) || (maxlag >= windowsize)) {
+		maxlag = windowsize - 1;
+	}
+
+	if (!windowed) {
+		vector<double> analysis;
+		doAutocorrelation(analysis, grid, 0, gridsize, maxlag);
+		if (getBoolean("raw")) {
+			vector<vector<double>> rows(1, analysis);
+			printPeriodicityAnalysis(m_free_text, rows);
+		} else {
+			printAutocorrelation(m_free_text, analysis, minrhy);
+		}
+		return;
+	}
+
+	vector<vector<double>> analysis;
+	vector<int> starts;
+	for (int start=0; start<gridsize; start+=hop) {
+		analysis.resize(analysis.size() + 1);
+		int count = std::min(windowsize, gridsize - start);
+		doAutocorrelation(analysis.back(), grid, start, count, maxlag);
+		starts.push_back(start);
+		if (start + windowsize >= gridsize) {
+			break;
+		}
+	}
+
+	if (getBoolean("raw")) {
+		printPeriodicityAnalysis(m_free_text, analysis);
+	} else {
+		printWindowedAutocorrelation(m_free_text, analysis, starts, minrhy);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_periodicity::doAutocorrelation -- Calculate the autocorrelation of
+//    count elements of the grid starting at start, for lags from 0 to
+//    maxlag.  The input is zero-padded to twice its length so that the
+//    circular correlation of the FFT is the same as a linear correlation.
+//    Attack counts are non-negative integers, so the correlations are
+//    rounded to remove FFT rounding errors (and negative zeros), and then
+//    scaled so that lag 0 has a value of 1.0.
+//
+
+void Tool_periodicity::doAutocorrelation(vector<double>& output,
+		vector<double>& grid, int start, int count, int maxlag) {
+	maxlag = std::min(maxlag, count - 1);
+	output.assign(maxlag + 1, 0.0);
+	if (count <= 0) {
+		output.clear();
+		return;
+	}
+
+	int size = 1;
+	while (size < 2 * count) {
+		size *= 2;
+	}
+	m_buffer.assign(size, 0.0);
+	for (int i=0; i<count; i++) {
+		m_buffer[i] = grid[start + i];
+	}
+
+	fft(m_buffer, false);
+	for (int i=0; i<size; i++) {
+		m_buffer[i] = std::norm(m_buffer[i]);
+	}
+	fft(m_buffer, true);
+
+	for (int i=0; i<=maxlag; i++) {
+		output[i] = std::max(0.0, std::round(m_buffer[i].real() / size));
+	}
+	if (output[0] > 0.0) {
+		double norm = output[0];
+		for (int i=0; i<=maxlag; i++) {
+			output[i] /= norm;
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_periodicity::fft -- In-place radix-2 FFT.  The size of the data
+//    must be a power of two.  The inverse transform is not scaled.
+//
+
+void Tool_periodicity::fft(vector<std::complex<double>>& data, bool inverse) {
+	int size = (int)data.size();
+	if (size < 2) {
+		return;
+	}
+
+	if ((int)m_twiddle.size() != size / 2) {
+		m_twiddle.resize(size / 2);
+		for (int i=0; i<size/2; i++) {
+			m_twiddle[i] = std::polar(1.0, -2.0 * M_PI * i / size);
+		}
+	}
+
+	// bit-reversal permutation:
+	for (int i=1, j=0; i<size; i++) {
+		int bit = size >> 1;
+		for (; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j) {
+			std::swap(data[i], data[j]);
+		}
+	}
+
+	for (int length=2; length<=size; length*=2) {
+		int half = length / 2;
+		int step = size / length;
+		for (int i=0; i<size; i+=length) {
+			for (int j=0; j<half; j++) {
+				std::complex<double> w = m_twiddle[j * step];
+				if (inverse) {
+					w = std::conj(w);
+				}
+				std::complex<double> u = data[i + j];
+				std::complex<double> v = data[i + j + half] * w;
+				data[i + j] = u + v;
+				data[i + j + half] = u - v;
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_periodicity::printAutocorrelation -- Print the autocorrelation
+//    of the attack grid as a Humdrum table.  Lags are given in grid
+//    units and as **recip durations.
+//
+
+void Tool_periodicity::printAutocorrelation(ostream& out,
+		vector<double>& analysis, HumNum minrhy) {
+	out << "!!!minrhy: " << minrhy << endl;
+	out << "**lag\t**recip\t**acor\n";
+	for (int i=1; i<(int)analysis.size(); i++) {
+		HumNum rval = i;
+		rval /= minrhy;
+		rval *= 4;
+		out << i << "\t" << Convert::durationToRecip(rval) << "\t" << analysis[i] << "\n";
+	}
+	out << "*-\t*-\t*-\n";
+}
+
+
+
+//////////////////////////////
+//
+// Tool_periodicity::printWindowedAutocorrelation -- Print the strongest
+//    periodicity in each window as a Humdrum table: the starting time
+//    of the window in quarter notes, the lag with the largest
+//    autocorrelation (excluding lag 0), and its autocorrelation value.
+//
+
+void Tool_periodicity::printWindowedAutocorrelation(ostream& out,
+		vector<vector<double>>& analysis, vector<int>& starts, HumNum minrhy) {
+	out << "!!!minrhy: " << minrhy << endl;
+	out << "**qon\t**recip\t**acor\n";
+	for (int i=0; i<(int)analysis.size(); i++) {
+		HumNum qon = starts[i];
+		qon /= minrhy;
+		qon *= 4;
+		int best = -1;
+		for (int j=1; j<(int)analysis[i].size(); j++) {
+			if ((best < 0) || (analysis[i][j] > analysis[i][best])) {
+				best = j;
+			}
+		}
+		if ((best < 0) || (analysis[i][best] <= 0.0)) {
+			out << qon << "\t.\t.\n";
+			continue;
+		}
+		HumNum rval = best;
+		rval /= minrhy;
+		rval *= 4;
+		out << qon << "\t" << Convert::durationToRecip(rval) << "\t" << analysis[i][best] << "\n";
+	}
+	out << "*-\t*-\t*-\n";
+}
+
+
+
 //////////////////////////////
 //
 // Tool_periodicity::printAttackGrid --
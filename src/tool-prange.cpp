@@ -1,7 +1,7 @@
 //
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jul 18 11:23:42 PDT 2005
-// Last Modified: Sat Jun  8 17:37:39 PDT 2024 (ported to humlib)
+// Last Modified: Mon Oct 19 20:14:05 PDT 2026
 // Filename:      src/tool-prange.cpp
 // URL:           https://github.com/craigsapp/humlib/blob/master/src/tool-prange.cpp
 // Syntax:        C++11; humlib
@@ -15,7 +15,9 @@
 #include "tool-prange.h"
 #include "HumRegex.h"
 #include "Convert.h"
+#include "HumParallel.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -148,6 +150,9 @@ Tool_prange::Tool_prange(void) {
 	define("x|extrema=b",               "highlight extrema notes in each part");
 	define("sx|scorexml|score-xml|ScoreXML|scoreXML=b", "output ScoreXML format");
 	define("title=s:",                  "title for SCORE display");
+	define("g|aggregate=b",             "combine pitch counts of all input files");
+	define("per-file=b",                "also list range of each input file (implies -g)");
+	define("threads=i:1",               "number of threads for reading files with -g (0 = all cores)");
 
 }
 
@@ -196,6 +201,21 @@ bool Tool_prange::run(HumdrumFile& infile) {
 }
 
 
+bool Tool_prange::run(HumdrumFileStream& instream) {
+	initialize();
+	if (m_aggregateQ) {
+		aggregateFiles(instream);
+		return true;
+	}
+	HumdrumFileSet infiles;
+	bool status = true;
+	while (instream.readSingleSegment(infiles)) {
+		status &= run(infiles);
+	}
+	return status;
+}
+
+
 
 //////////////////////////////
 //
@@ -232,6 +252,9 @@ void Tool_prange::initialize(void) {
 	m_titleQ       = getBoolean("title");
 	m_embedQ       = getBoolean("embed");
 	m_extremaQ     = getBoolean("extrema");
+	m_perFileQ     = getBoolean("per-file");
+	m_aggregateQ   = getBoolean("aggregate") || m_perFileQ;
+	m_threads      = getInteger("threads");
 
 	getRange(m_rangeL, m_rangeH, getString("range"));
 
@@ -447,6 +470,171 @@ int Tool_prange::getPrangeId(HumdrumFile& infile) {
 
 
 
+//////////////////////////////
+//
+// Tool_prange::aggregateFiles -- Print the pitch analysis of all input
+//    files combined (-g option), optionally preceded by a table of the
+//    range of each file (--per-file option).  Files given on the command
+//    line are read and counted by a pool of threads, each taking whole
+//    files from a shared counter, and the histograms are added afterwards
+//    in the input order, so the totals do not depend on the number of
+//    threads.  Standard input can only be read one segment at a time.
+//    The histograms of the voices are also kept, and voices with the same
+//    instrument name are combined into one row of a table before the
+//    analysis of all voices (unless only a percentile or range count is
+//    printed).  Voices without a name are combined into the last row.
+//
+
+void Tool_prange::aggregateFiles(HumdrumFileStream& instream) {
+	vector<string> filenames;
+	getArgList(filenames);
+	int count = (int)filenames.size();
+
+	// names, voices: segment names and MIDI pitch histograms of all voices
+	// and each voice for each input.
+	vector<vector<string>> names(std::max(count, 1));
+	vector<vector<vector<_VoiceBins>>> voices(std::max(count, 1));
+
+	if (count == 0) {
+		countFileSegments(instream, names[0], voices[0]);
+	} else {
+		string cachedir = instream.getCacheDirectory();
+		HumParallel::run(count, m_threads, [&](int i) {
+			HumdrumFileStream filestream(vector<string>(1, filenames[i]));
+			filestream.setCacheDirectory(cachedir);
+			countFileSegments(filestream, names[i], voices[i]);
+		});
+	}
+
+	vector<double> total(128, 0.0);
+	vector<string> rownames;
+	vector<vector<double>> rowbins;
+	vector<string> voicenames;
+	vector<vector<double>> voicebins;
+	map<string, int> voicerows;
+	vector<double> unnamedbins;
+	for (int i=0; i<(int)voices.size(); i++) {
+		for (int j=0; j<(int)voices[i].size(); j++) {
+			vector<_VoiceBins>& segment = voices[i][j];
+			for (int k=0; k<(int)total.size(); k++) {
+				total[k] += segment[0].midibins[k];
+			}
+			for (int v=1; v<(int)segment.size(); v++) {
+				vector<double>* target = &unnamedbins;
+				const string& name = segment[v].name;
+				if (!name.empty()) {
+					auto found = voicerows.find(name);
+					if (found == voicerows.end()) {
+						voicerows[name] = (int)voicenames.size();
+						voicenames.push_back(name);
+						voicebins.emplace_back(128, 0.0);
+						target = &voicebins.back();
+					} else {
+						target = &voicebins[found->second];
+					}
+				} else if (unnamedbins.empty()) {
+					unnamedbins.resize(128, 0.0);
+				}
+				for (int k=0; k<(int)target->size(); k++) {
+					(*target)[k] += segment[v].midibins[k];
+				}
+			}
+			if (m_perFileQ) {
+				rownames.push_back(names[i][j]);
+				rowbins.emplace_back();
+				rowbins.back().swap(segment[0].midibins);
+			}
+		}
+	}
+	if (!unnamedbins.empty()) {
+		voicenames.push_back("");
+		voicebins.emplace_back();
+		voicebins.back().swap(unnamedbins);
+	}
+
+	if (m_perFileQ) {
+		printFileRows(m_humdrum_text, "**file", rownames, rowbins);
+	}
+	if (!(m_percentileQ || m_rangeQ)) {
+		printFileRows(m_humdrum_text, "**voice", voicenames, voicebins);
+	}
+	printAnalysis(m_humdrum_text, total);
+}
+
+
+
+//////////////////////////////
+//
+// Tool_prange::countFileSegments -- Store the name and the MIDI pitch
+//    histograms of all voices (index 0) and of each **kern voice, with
+//    the instrument name of the voice, for each segment in the input
+//    stream.  Only local variables are modified, so this can be called
+//    from several threads with different input streams.
+//
+
+void Tool_prange::countFileSegments(HumdrumFileStream& instream,
+		vector<string>& names, vector<vector<_VoiceBins>>& voices) {
+	HumdrumFile infile;
+	vector<_VoiceInfo> voiceInfo;
+	while (instream.read(infile)) {
+		getVoiceInfo(voiceInfo, infile);
+		fillHistograms(voiceInfo, infile);
+		names.push_back(infile.getFilename());
+		voices.emplace_back(1);
+		vector<_VoiceBins>& segment = voices.back();
+		segment[0].midibins.swap(voiceInfo[0].midibins);
+		for (int i=1; i<(int)voiceInfo.size(); i++) {
+			if (!voiceInfo[i].kernQ) {
+				continue;
+			}
+			segment.emplace_back();
+			segment.back().name = voiceInfo[i].name;
+			segment.back().midibins.swap(voiceInfo[i].midibins);
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// Tool_prange::printFileRows -- Print the note count, lowest and highest
+//    notes, tessitura, mean and median pitch of each file for the
+//    --per-file option, or of each voice for the -g option.
+//
+
+void Tool_prange::printFileRows(ostream& out, const string& exinterp,
+		vector<string>& names, vector<vector<double>>& bins) {
+	out << exinterp << "\t**count\t**low\t**high\t**tess\t**mean\t**median\n";
+	for (int i=0; i<(int)bins.size(); i++) {
+		vector<double>& midibins = bins[i];
+		out << (names[i].empty() ? "." : names[i]);
+		double sum = accumulate(midibins.begin(), midibins.end(), 0.0);
+		out << "\t" << sum;
+		if (sum <= 0.0) {
+			out << "\t.\t.\t.\t.\t.\n";
+			continue;
+		}
+		int low = 0;
+		while (midibins[low] <= 0.0) {
+			low++;
+		}
+		int high = (int)midibins.size() - 1;
+		while (midibins[high] <= 0.0) {
+			high--;
+		}
+		out << "\t" << Convert::base12ToKern(low);
+		out << "\t" << Convert::base12ToKern(high);
+		out << "\t" << getTessitura(midibins);
+		out << "\t" << getMean12(midibins);
+		out << "\t" << Convert::base12ToKern(getMedian12(midibins));
+		out << "\n";
+	}
+	out << "*-\t*-\t*-\t*-\t*-\t*-\t*-\n";
+}
+
+
+
 //////////////////////////////
 //
 // Tool_prange::mergeAllVoiceInfo --
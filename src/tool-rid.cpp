@@ -94,6 +94,12 @@ bool Tool_rid::run(HumdrumFile& infile) {
 }
 
 
+bool Tool_rid::run(HumdrumLineStream& instream, ostream& out) {
+	initialize();
+	return processStream(instream, out);
+}
+
+
 
 //////////////////////////////
 //
@@ -134,9 +140,6 @@ void Tool_rid::initialize(void) {
 void Tool_rid::processFile(HumdrumFile& infile) {
 	int setcount = 1; // disabled for now.
 
-   HumRegex hre;
-   int revQ = option_V;
-
    // if bibliographic/reference records are not suppressed
    // print the !!!!SEGMENT: marker if present.
    if ((setcount > 1) && (!option_G)) {
@@ -144,118 +147,159 @@ void Tool_rid::processFile(HumdrumFile& infile) {
    }
 
    for (int i=0; i<infile.getLineCount(); i++) {
-      if (option_D && (infile[i].isBarline() || infile[i].isData())) {
-         // remove data lines if -D is specified
-         if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
-         }
-         continue;
-      }
-      if (option_d) {
-         // remove null data lines if -d is specified
-         if (option_k && infile[i].isData() &&
-               infile[i].equalFieldsQ("**kern", ".")) {
-            // remove if only all **kern spines are null.
-            if (revQ) {
-               m_humdrum_text << infile[i] << "\n";
-            }
-            continue;
-         } else if (!option_k && infile[i].isData() &&
-               infile[i].isAllNull()) {
-            // remove null data lines if all spines are null.
-            if (revQ) {
-               m_humdrum_text << infile[i] << "\n";
-            }
-            continue;
-         }
+      processLine(infile[i], m_humdrum_text);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// Tool_rid::processStream -- Filter lines as they are read from the
+//    input, sending the output directly to the given stream rather
+//    than storing the input file in memory.
+//
+
+bool Tool_rid::processStream(HumdrumLineStream& instream, ostream& out) {
+   HumdrumStreamLine line;
+   while (instream.getLine(line)) {
+      processLine(line, out);
+   }
+   if (!instream.isValid()) {
+      m_error_text << instream.getParseError() << endl;
+      return false;
+   }
+   return true;
+}
+
+
+
+//////////////////////////////
+//
+// Tool_rid::processLine -- Filter a single line, which can be either a
+//    HumdrumLine from a HumdrumFile or a HumdrumStreamLine from a
+//    HumdrumLineStream (both are instantiated in this file by
+//    processFile() and processStream()).
+//
+
+template <class LINE>
+void Tool_rid::processLine(LINE& line, ostream& out) {
+   int revQ = option_V;
+
+   if (option_D && (line.isBarline() || line.isData())) {
+      // remove data lines if -D is specified
+      if (revQ) {
+         out << line << "\n";
       }
-      if (option_G && (infile[i].isGlobalComment() ||
-            infile[i].isReference())) {
-         // remove global comments if -G is specified
+      return;
+   }
+   if (option_d) {
+      // remove null data lines if -d is specified
+      if (option_k && line.isData() &&
+            line.equalFieldsQ("**kern", ".")) {
+         // remove if only all **kern spines are null.
          if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
+            out << line << "\n";
          }
-         continue;
-      }
-      if (option_g && hre.search(infile.token(i, 0), "^!!+\\s*$")) {
-         // remove empty global comments if -g is specified
+         return;
+      } else if (!option_k && line.isData() &&
+            line.isAllNull()) {
+         // remove null data lines if all spines are null.
          if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
+            out << line << "\n";
          }
-         continue;
+         return;
       }
-      if (option_I && infile[i].isInterpretation()) {
-         // remove all interpretation records
-         if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
-         }
-         continue;
+   }
+   if (option_G && (line.isGlobalComment() ||
+         line.isReference())) {
+      // remove global comments if -G is specified
+      if (revQ) {
+         out << line << "\n";
       }
-      if (option_i && infile[i].isInterpretation() &&
-            infile[i].isAllNull()) {
-         // remove null interpretation records
+      return;
+   }
+   if (option_g && line.isGlobalComment()) {
+      // remove empty global comments if -g is specified
+      HumRegex hre;
+      if (hre.search(line.getText(), "^!!+\\s*$")) {
          if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
+            out << line << "\n";
          }
-         continue;
+         return;
       }
-      if (option_L && infile[i].isLocalComment()) {
-         // remove all local comments
-         if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
-         }
-         continue;
+   }
+   if (option_I && line.isInterpretation()) {
+      // remove all interpretation records
+      if (revQ) {
+         out << line << "\n";
       }
-      if (option_l && infile[i].isLocalComment() &&
-            infile[i].isAllNull()) {
-         // remove null local comments
-         if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
-         }
-         continue;
+      return;
+   }
+   if (option_i && line.isInterpretation() &&
+         line.isAllNull()) {
+      // remove null interpretation records
+      if (revQ) {
+         out << line << "\n";
       }
-      if (option_T && (infile[i].isInterpretation() && !infile[i].isManipulator())) {
-         // remove tandem (non-manipulator) interpretations
-         if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
-         }
-         continue;
+      return;
+   }
+   if (option_L && line.isLocalComment()) {
+      // remove all local comments
+      if (revQ) {
+         out << line << "\n";
       }
-      if (option_U) {
-         // remove unnecessary (duplicate exclusive) interpretations
-         // HumdrumFile class does not allow duplicate ex. interps.
-         // continue;
+      return;
+   }
+   if (option_l && line.isLocalComment() &&
+         line.isAllNull()) {
+      // remove null local comments
+      if (revQ) {
+         out << line << "\n";
+      }
+      return;
+   }
+   if (option_T && (line.isInterpretation() && !line.isManipulator())) {
+      // remove tandem (non-manipulator) interpretations
+      if (revQ) {
+         out << line << "\n";
       }
+      return;
+   }
+   if (option_U) {
+      // remove unnecessary (duplicate exclusive) interpretations
+      // HumdrumFile class does not allow duplicate ex. interps.
+      // return;
+   }
 
-      // non-classical options:
+   // non-classical options:
 
-      if (option_M && infile[i].isBarline()) {
-         // remove all measure lines
-         if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
-         }
-         continue;
+   if (option_M && line.isBarline()) {
+      // remove all measure lines
+      if (revQ) {
+         out << line << "\n";
       }
-      if (option_C && infile[i].isComment()) {
-         // remove all comments (local & global)
-         if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
-         }
-         continue;
+      return;
+   }
+   if (option_C && line.isComment()) {
+      // remove all comments (local & global)
+      if (revQ) {
+         out << line << "\n";
       }
-      if (option_c && (infile[i].isLocalComment() ||
-            infile[i].isGlobalComment())) {
-         // remove all comments (local & global)
-         if (revQ) {
-            m_humdrum_text << infile[i] << "\n";
-         }
-         continue;
+      return;
+   }
+   if (option_c && (line.isLocalComment() ||
+         line.isGlobalComment())) {
+      // remove all comments (local & global)
+      if (revQ) {
+         out << line << "\n";
       }
+      return;
+   }
 
-      // got past all test, so print the current line:
-      if (!revQ) {
-         m_humdrum_text << infile[i] << "\n";
-      }
+   // got past all test, so print the current line:
+   if (!revQ) {
+      out << line << "\n";
    }
 }
 
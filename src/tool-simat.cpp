@@ -13,10 +13,13 @@
 #include "tool-simat.h"
 #include "Convert.h"
 #include "HumRegex.h"
+#include "HumParallel.h"
 
 #include "pugixml.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <sstream>
 
 using namespace std;
@@ -576,7 +579,118 @@ MeasureComparisonGrid::~MeasureComparisonGrid() {
 //
 
 void MeasureComparisonGrid::clear(void) {
-	m_grid.clear();
+	m_features1.clear();
+	m_features2.clear();
+	m_silent1.clear();
+	m_silent2.clear();
+	m_values.clear();
+	m_rowStart.clear();
+	m_columns.clear();
+	m_topRows.clear();
+	m_rows = 0;
+	m_cols = 0;
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::setBand -- Only compare measures which are
+//     within the given number of measures from the diagonal of the
+//     matrix.  A negative value compares all measures.
+//
+
+void MeasureComparisonGrid::setBand(int band) {
+	m_band = band;
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::setTopCount -- Only store the given number of
+//     most similar measures for each row of the matrix.  A value of 0
+//     stores all measures.
+//
+
+void MeasureComparisonGrid::setTopCount(int count) {
+	m_top = count;
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::setThreadCount -- Set the number of threads
+//     used to calculate the matrix.  A value of 0 uses the number of
+//     hardware threads.
+//
+
+void MeasureComparisonGrid::setThreadCount(int count) {
+	m_threads = count;
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::getRowCount -- Return the number of measures
+//     in the first set.
+//
+
+int MeasureComparisonGrid::getRowCount(void) {
+	return m_rows;
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::getColumnCount -- Return the number of measures
+//     in the second set.
+//
+
+int MeasureComparisonGrid::getColumnCount(void) {
+	return m_cols;
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::isCalculated -- Returns true if the correlation
+//     between the two measures was calculated (all cells are calculated
+//     unless a band or top count is given).
+//
+
+bool MeasureComparisonGrid::isCalculated(int row, int col) {
+	return !std::isnan(getCorrelation7pc(row, col));
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::getCorrelation7pc -- Return the pitch-class
+//     correlation between two measures.  NaN is returned if the cell
+//     was not calculated.
+//
+
+double MeasureComparisonGrid::getCorrelation7pc(int row, int col) {
+	double undefined = std::numeric_limits<double>::quiet_NaN();
+	if ((row < 0) || (row >= m_rows) || (col < 0) || (col >= m_cols)) {
+		return undefined;
+	}
+	if (m_rowStart.empty()) {
+		return m_values[(size_t)row * m_cols + col];
+	}
+	auto first = m_columns.begin() + m_rowStart[row];
+	auto last  = m_columns.begin() + m_rowStart[row+1];
+	auto it = std::lower_bound(first, last, col);
+	if ((it == last) || (*it != col)) {
+		return undefined;
+	}
+	return m_values[it - m_columns.begin()];
 }
 
 
@@ -591,37 +705,258 @@ void MeasureComparisonGrid::analyze(MeasureDataSet* set1, MeasureDataSet* set2)
 }
 
 void MeasureComparisonGrid::analyze(MeasureDataSet& set1, MeasureDataSet& set2) {
-	m_grid.resize(set1.size());
-	for (int i=0; i<(int)m_grid.size(); i++) {
-		m_grid[i].resize(set2.size());
+	clear();
+	m_set1 = &set1;
+	m_set2 = &set2;
+	m_rows = set1.size();
+	m_cols = set2.size();
+	prepareFeatures(set1, m_features1, m_silent1);
+	prepareFeatures(set2, m_features2, m_silent2);
+
+	bool fullQ = (m_top <= 0) && ((m_band < 0) || (m_band >= std::max(m_rows, m_cols)));
+	if (fullQ) {
+		m_values.resize((size_t)m_rows * m_cols);
+	} else if (m_top > 0) {
+		m_topRows.resize(m_rows);
+	} else {
+		// Banded matrix: the columns of each row are known in advance.
+		m_rowStart.resize(m_rows + 1);
+		m_rowStart[0] = 0;
+		for (int i=0; i<m_rows; i++) {
+			int start = std::max(0, i - m_band);
+			int stop  = std::min(m_cols, i + m_band + 1);
+			m_rowStart[i+1] = m_rowStart[i] + std::max(0, stop - start);
+		}
+		m_values.resize(m_rowStart.back());
+		m_columns.resize(m_rowStart.back());
 	}
-	for (int i=0; i<(int)m_grid.size(); i++) {
-		for (int j=0; j<(int)m_grid[i].size(); j++) {
-			m_grid[i][j].compare(set1[i], set2[j]);
+
+	// Each thread processes blocks of rows taken from a shared counter.
+	int blockcount = (m_rows + m_blockSize - 1) / m_blockSize;
+	HumParallel::run(blockcount, m_threads, [&](int block) {
+		int startrow = block * m_blockSize;
+		calculateRows(startrow, std::min(m_rows, startrow + m_blockSize));
+	});
+
+	if (m_top > 0) {
+		// Store the top matches in compressed row order.
+		m_rowStart.resize(m_rows + 1);
+		m_rowStart[0] = 0;
+		for (int i=0; i<m_rows; i++) {
+			m_rowStart[i+1] = m_rowStart[i] + (int)m_topRows[i].size();
 		}
+		m_values.resize(m_rowStart.back());
+		m_columns.resize(m_rowStart.back());
+		for (int i=0; i<m_rows; i++) {
+			int index = m_rowStart[i];
+			for (auto& entry : m_topRows[i]) {
+				m_columns[index] = entry.first;
+				m_values[index] = entry.second;
+				index++;
+			}
+		}
+		m_topRows.clear();
 	}
-	m_set1 = &set1;
-	m_set2 = &set2;
 }
 
 
 
 //////////////////////////////
 //
-// MeasureComparisonGrid::printCorrelationGrid --
+// MeasureComparisonGrid::prepareFeatures -- Store the pitch-class histogram
+//     of each measure in a contiguous array.  Each histogram is
+//     mean-centered and scaled to unit length, so the correlation of two
+//     measures reduces to a dot product.  Histograms with no variation
+//     (but with notes) are set to NaN, since their correlation is
+//     undefined.
+//
+
+void MeasureComparisonGrid::prepareFeatures(MeasureDataSet& set,
+		vector<double>& features, vector<char>& silent) {
+	int count = set.size();
+	features.assign((size_t)count * m_featureSize, 0.0);
+	silent.assign(count, 0);
+	for (int i=0; i<count; i++) {
+		double* feature = features.data() + (size_t)i * m_featureSize;
+		if (set[i].getSum7pc() == 0.0) {
+			silent[i] = 1;
+			continue;
+		}
+		vector<double>& hist = set[i].getHistogram7pc();
+		int size = std::min((int)hist.size(), m_featureSize);
+		double mean = 0.0;
+		for (int j=0; j<size; j++) {
+			mean += hist[j];
+		}
+		mean /= size;
+		double norm = 0.0;
+		for (int j=0; j<size; j++) {
+			feature[j] = hist[j] - mean;
+			norm += feature[j] * feature[j];
+		}
+		norm = sqrt(norm);
+		for (int j=0; j<size; j++) {
+			feature[j] = norm > 0.0 ? feature[j] / norm
+					: std::numeric_limits<double>::quiet_NaN();
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::correlateFeatures -- Dot product of two feature
+//     vectors.  The fixed length allows the compiler to vectorize the loop.
+//
+
+double MeasureComparisonGrid::correlateFeatures(const double* a, const double* b) {
+	double sum = 0.0;
+	for (int i=0; i<m_featureSize; i++) {
+		sum += a[i] * b[i];
+	}
+	if (fabs(sum - 1.0) < 0.00000001) {
+		sum = 1.0;
+	}
+	return sum;
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::calculateRows -- Calculate the given rows of the
+//     matrix.  Columns are processed in blocks so that the feature vectors
+//     of each block stay in the cache while all of the rows are compared
+//     to them.  Measures without notes have a correlation of 1.0 with
+//     each other and 0.0 with all other measures (as in
+//     MeasureComparison::compare()).
+//
+
+void MeasureComparisonGrid::calculateRows(int startrow, int stoprow) {
+	if (m_top > 0) {
+		for (int i=startrow; i<stoprow; i++) {
+			calculateTopRow(i);
+		}
+		return;
+	}
+
+	bool bandQ = !m_rowStart.empty();
+	int colstart = 0;
+	int colstop  = m_cols;
+	if (bandQ) {
+		colstart = std::max(0, startrow - m_band);
+		colstop  = std::min(m_cols, stoprow - 1 + m_band + 1);
+	}
+
+	for (int jj=colstart; jj<colstop; jj+=m_blockSize) {
+		int jjstop = std::min(colstop, jj + m_blockSize);
+		for (int i=startrow; i<stoprow; i++) {
+			const double* a = m_features1.data() + (size_t)i * m_featureSize;
+			int jstart = jj;
+			int jstop  = jjstop;
+			double* output;
+			if (bandQ) {
+				jstart = std::max(jstart, i - m_band);
+				jstop  = std::min(jstop, i + m_band + 1);
+				if (jstart >= jstop) {
+					continue;
+				}
+				int offset = m_rowStart[i] + jstart - std::max(0, i - m_band);
+				output = m_values.data() + offset;
+				for (int j=jstart; j<jstop; j++) {
+					m_columns[offset + j - jstart] = j;
+				}
+			} else {
+				output = m_values.data() + (size_t)i * m_cols + jstart;
+			}
+			for (int j=jstart; j<jstop; j++) {
+				const double* b = m_features2.data() + (size_t)j * m_featureSize;
+				double value;
+				if (m_silent1[i] || m_silent2[j]) {
+					value = (m_silent1[i] && m_silent2[j]) ? 1.0 : 0.0;
+				} else {
+					value = correlateFeatures(a, b);
+				}
+				output[j - jstart] = value;
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::calculateTopRow -- Calculate one row of the
+//     matrix and keep only the most similar measures (within the band
+//     if one is given), stored in column order.
+//
+
+void MeasureComparisonGrid::calculateTopRow(int row) {
+	int jstart = 0;
+	int jstop  = m_cols;
+	if (m_band >= 0) {
+		jstart = std::max(0, row - m_band);
+		jstop  = std::min(m_cols, row + m_band + 1);
+	}
+
+	vector<pair<int, double>>& entries = m_topRows[row];
+	entries.clear();
+	if (jstart >= jstop) {
+		return;
+	}
+	entries.reserve(jstop - jstart);
+	const double* a = m_features1.data() + (size_t)row * m_featureSize;
+	for (int j=jstart; j<jstop; j++) {
+		const double* b = m_features2.data() + (size_t)j * m_featureSize;
+		double value;
+		if (m_silent1[row] || m_silent2[j]) {
+			value = (m_silent1[row] && m_silent2[j]) ? 1.0 : 0.0;
+		} else {
+			value = correlateFeatures(a, b);
+			if (std::isnan(value)) {
+				continue;
+			}
+		}
+		entries.emplace_back(j, value);
+	}
+
+	if ((int)entries.size() > m_top) {
+		std::nth_element(entries.begin(), entries.begin() + (m_top - 1), entries.end(),
+			[](const pair<int, double>& x, const pair<int, double>& y) {
+				if (x.second != y.second) {
+					return x.second > y.second;
+				}
+				return x.first < y.first;
+			});
+		entries.resize(m_top);
+	}
+	std::sort(entries.begin(), entries.end());
+	entries.shrink_to_fit();
+}
+
+
+
+//////////////////////////////
+//
+// MeasureComparisonGrid::printCorrelationGrid -- Cells which were not
+//     calculated are printed as ".".
 //    default value: out = std::cout
 //
 
 ostream& MeasureComparisonGrid::printCorrelationGrid(ostream& out) {
-	for (int i=0; i<(int)m_grid.size(); i++) {
-		for (int j=0; j<(int)m_grid[i].size(); j++) {
-			double correl = m_grid[i][j].getCorrelation7pc();
-			if (correl > 0.0) {
+	for (int i=0; i<m_rows; i++) {
+		for (int j=0; j<m_cols; j++) {
+			double correl = getCorrelation7pc(i, j);
+			if (std::isnan(correl) && !m_rowStart.empty()) {
+				out << '.';
+			} else if (correl > 0.0) {
 				out << int(correl * 100.0 + 0.5)/100.0;
 			} else {
 				out << -int(-correl * 100.0 + 0.5)/100.0;
 			}
-			if (j < (int)m_grid[i].size() - 1) {
+			if (j < m_cols - 1) {
 				out << '\t';
 			}
 		}
@@ -639,18 +974,17 @@ ostream& MeasureComparisonGrid::printCorrelationGrid(ostream& out) {
 //
 
 ostream& MeasureComparisonGrid::printCorrelationDiagonal(ostream& out) {
-	for (int i=0; i<(int)m_grid.size(); i++) {
-		for (int j=0; j<(int)m_grid[i].size(); j++) {
-			if (i != j) {
-				continue;
-			}
-			double correl = m_grid[i][j].getCorrelation7pc();
-			if (correl > 0.0) {
+	for (int i=0; i<m_rows; i++) {
+		if (i < m_cols) {
+			double correl = getCorrelation7pc(i, i);
+			if (std::isnan(correl) && !m_rowStart.empty()) {
+				out << '.';
+			} else if (correl > 0.0) {
 				out << int(correl * 100.0 + 0.5)/100.0;
 			} else {
 				out << -int(-correl * 100.0 + 0.5)/100.0;
 			}
-			if (j < (int)m_grid[i].size() - 1) {
+			if (i < m_cols - 1) {
 				out << '\t';
 			}
 		}
@@ -948,15 +1282,20 @@ ostream& MeasureComparisonGrid::printSvgGrid(ostream& out) {
 	double sdur1 = getScoreDuration1();
 	double sdur2 = getScoreDuration2();
 
-	for (int i=0; i<(int)m_grid.size(); i++) {
-		for (int j=0; j<(int)m_grid[i].size(); j++) {
+	for (int i=0; i<m_rows; i++) {
+		for (int j=0; j<m_cols; j++) {
+			double correl = getCorrelation7pc(i, j);
+			if (std::isnan(correl) && !m_rowStart.empty()) {
+				// not calculated
+				continue;
+			}
 			width = getDuration2(j) / sdur2 * imagewidth;
 			height = getDuration1(i) / sdur1 * imageheight;
 
 			x = getStartTime2(j)/sdur2 * imageheight;
 			y = getStartTime1(i)/sdur1 * imagewidth;
 
-			getColorMapping(m_grid[i][j].getCorrelation7pc(), hue, saturation, lightness);
+			getColorMapping(correl, hue, saturation, lightness);
 			ss << "hsl(" << hue << "," << saturation << "%," << lightness << "%)";
 			crect = grid.append_child("rect");
 			crect.append_attribute("x") = to_string(x).c_str();
@@ -989,6 +1328,9 @@ ostream& MeasureComparisonGrid::printSvgGrid(ostream& out) {
 Tool_simat::Tool_simat(void) {
 	define("r|raw=b",      "output raw correlation matrix");
 	define("d|diagonal=b", "output diagonal of correlation matrix");
+	define("b|band=i:-1",  "only compare measures within given distance of diagonal");
+	define("k|top=i:0",    "only keep given number of most similar measures for each measure");
+	define("t|threads=i:1", "number of threads for calculations (0 = all cores)");
 }
 
 
@@ -1071,6 +1413,9 @@ bool Tool_simat::run(HumdrumFile& infile1, HumdrumFile& infile2) {
 void Tool_simat::processFile(HumdrumFile& infile1, HumdrumFile& infile2) {
 	m_data1.parse(infile1);
 	m_data2.parse(infile2);
+	m_grid.setBand(getInteger("band"));
+	m_grid.setTopCount(getInteger("top"));
+	m_grid.setThreadCount(getInteger("threads"));
 	m_grid.analyze(m_data1, m_data2);
 	if (getBoolean("raw")) {
 		m_grid.printCorrelationGrid(m_free_text);
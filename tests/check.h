@@ -0,0 +1,25 @@
+// Description: Pass/fail reporting shared by the test programs in the
+//              tests directory.  Call check() for each condition that
+//              is tested, and return finish() from main().
+
+#ifndef _TESTS_CHECK_H_INCLUDED
+#define _TESTS_CHECK_H_INCLUDED
+
+#include <iostream>
+#include <string>
+
+static int failures = 0;
+
+static void check(bool status, const std::string& message) {
+   std::cout << (status ? "ok     " : "FAILED ") << message << std::endl;
+   if (!status) {
+      failures++;
+   }
+}
+
+static int finish(void) {
+   std::cout << (failures ? "FAILED" : "PASSED") << std::endl;
+   return failures ? 1 : 0;
+}
+
+#endif /* _TESTS_CHECK_H_INCLUDED */
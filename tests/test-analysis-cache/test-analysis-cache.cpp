@@ -0,0 +1,102 @@
+// Description: Check the cache of derived analyses in HumdrumFile: an
+//              analysis is shared until the file changes, and two tools
+//              in a !!!filter chain give the same output as when each
+//              tool reads the output of the previous tool again.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+string score =
+   "**kern\t**kern\n"
+   "*M4/4\t*M4/4\n"
+   "=1\t=1\n"
+   "4C\t4e\n"
+   "4D\t4f\n"
+   "4E\t[4g\n"
+   "4F\t4g]\n"
+   "=2\t=2\n"
+   "4G\t4cc\n"
+   "4A\t4b\n"
+   "4B\t4a\n"
+   "4c\t4g\n"
+   "==\t==\n"
+   "*-\t*-\n";
+
+// Run a tool on a file and return the Humdrum output of the tool, or the
+// modified file if the tool does not create new output.
+template <class TOOL>
+string runTool(HumdrumFile& infile, const string& options) {
+   TOOL tool;
+   tool.process(options);
+   tool.run(infile);
+   stringstream out;
+   if (tool.hasHumdrumText()) {
+      tool.getHumdrumText(out);
+   } else {
+      out << infile;
+   }
+   return out.str();
+}
+
+int main(int argc, char** argv) {
+   HumdrumFile infile;
+   infile.readString(score);
+
+   // The analysis is only created once:
+   shared_ptr<NoteGrid> grid = infile.getAnalysis<NoteGrid>();
+   check(grid == infile.getAnalysis<NoteGrid>(), "grid is reused");
+   shared_ptr<vector<double>> levels = infile.getCachedMetricLevels();
+   check(levels == infile.getCachedMetricLevels(), "metric levels are reused");
+   check(levels != infile.getCachedMetricLevels(2), "cached by track");
+
+   // Changes to the file remove the cached analyses:
+   infile.insertLine(0, "!! comment");
+   shared_ptr<NoteGrid> grid2 = infile.getAnalysis<NoteGrid>();
+   check(grid2 != grid, "new grid after insertLine");
+   check(grid->getSliceCount() == 8, "old grid is kept by its user");
+
+   infile.deleteLine(0);
+   shared_ptr<NoteGrid> grid3 = infile.getAnalysis<NoteGrid>();
+   check(grid3 != grid2, "new grid after deleteLine");
+
+   infile.createLinesFromTokens();
+   shared_ptr<NoteGrid> grid4 = infile.getAnalysis<NoteGrid>();
+   check(grid4 != grid3, "new grid after createLinesFromTokens");
+
+   infile.token(3, 0)->setText("4CC");
+   shared_ptr<NoteGrid> grid5 = infile.getAnalysis<NoteGrid>();
+   check(grid5 != grid4, "new grid after HumdrumToken::setText");
+   check(grid5->getAbsBase40Pitch(0, 0) == Convert::kernToBase40("CC"),
+         "new grid has the new pitch");
+   check(grid5 == infile.getAnalysis<NoteGrid>(), "new grid is reused");
+
+   infile[0].setText("**kern\t**kern");
+   check(grid5 != infile.getAnalysis<NoteGrid>(), "new grid after HumdrumLine::setText");
+
+   // Two tools using the cached grid in a filter chain:
+   HumdrumFile filtered;
+   filtered.readString(score + "!!!filter: msearch -p cde | dissonant\n");
+   Tool_filter filter;
+   filter.run(filtered);
+   stringstream output;
+   output << filtered;
+
+   // The filter line is marked as done in the output of the filter:
+   HumdrumFile step1;
+   step1.readString(score + "!!!Xfilter: msearch -p cde | dissonant\n");
+   HumdrumFile step2;
+   step2.readString(runTool<Tool_msearch>(step1, "msearch -p cde"));
+   string expected = runTool<Tool_dissonant>(step2, "dissonant");
+   check(output.str() == expected, "filter chain msearch | dissonant");
+   check(expected.find("**cdata-rdiss") != string::npos, "dissonance analysis");
+   if (output.str() != expected) {
+      cout << output.str() << endl << expected;
+   }
+
+   return finish();
+}
@@ -0,0 +1,105 @@
+// Description: Check the NumPy .npy output of the binroll tool: the file
+//              header, the array shape and the roll values, and that
+//              several input files are not written into one .npy file.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+string binroll(const string& data, const string& options, bool& status) {
+   Tool_binroll tool;
+   tool.process("binroll " + options);
+   HumdrumFile infile;
+   infile.readString(data);
+   stringstream out;
+   status = tool.run(infile, out);
+   return out.str();
+}
+
+// Return the header dictionary of a .npy file, or an empty string
+// if the file does not start with a valid version 1.0 header.
+string getNpyHeader(const string& npy, int& datastart) {
+   datastart = 0;
+   if ((npy.size() < 10) || (npy.compare(0, 6, "\x93NUMPY") != 0)) {
+      return "";
+   }
+   if ((npy[6] != 1) || (npy[7] != 0)) {
+      return "";
+   }
+   int length = (unsigned char)npy[8] + 256 * (unsigned char)npy[9];
+   datastart = 10 + length;
+   if ((int)npy.size() < datastart) {
+      return "";
+   }
+   return npy.substr(10, length);
+}
+
+int main(int argc, char** argv) {
+   string data =
+      "**kern\t**kern\n"
+      "*M2/4\t*M2/4\n"
+      "=1\t=1\n"
+      "4c\t8e\n"
+      ".\t8d\n"
+      "4r\t4e\n"
+      "==\t==\n"
+      "*-\t*-\n";
+
+   // Two quarter notes at a timebase of eighth notes give four slices:
+   bool status;
+   string npy = binroll(data, "--npy -t 8", status);
+   check(status, "--npy conversion");
+   int datastart;
+   string header = getNpyHeader(npy, datastart);
+   check(!header.empty(), "magic string and version");
+   check(datastart % 64 == 0, "data is aligned to 64 bytes");
+   check(header.back() == '\n', "header ends with a newline");
+   check(header.find("'descr': '|u1'") != string::npos, "unsigned byte data");
+   check(header.find("'fortran_order': False") != string::npos, "C order");
+   check(header.find("'shape': (5, 128)") != string::npos, "shape");
+   check((int)npy.size() == datastart + 5 * 128, "data size");
+
+   // 0 = silent, 1 = sustained, 2 = attacked
+   string roll = npy.substr(datastart);
+   check(roll[0 * 128 + 60] == 2, "c attack");
+   check(roll[1 * 128 + 60] == 1, "c sustain");
+   check(roll[0 * 128 + 64] == 2, "e attack");
+   check(roll[1 * 128 + 64] == 0, "e released");
+   check(roll[1 * 128 + 62] == 2, "d attack");
+   check(roll[2 * 128 + 60] == 0, "rest");
+   check((roll[2 * 128 + 64] == 2) && (roll[3 * 128 + 64] == 1), "second e");
+
+   // Bit planes: sounding keys followed by attacked keys, key k in bit
+   // k%8 of byte k/8.
+   npy = binroll(data, "--npy -b -t 8", status);
+   header = getNpyHeader(npy, datastart);
+   check(header.find("'shape': (5, 2, 16)") != string::npos, "bit-plane shape");
+   check((int)npy.size() == datastart + 5 * 32, "bit-plane data size");
+   roll = npy.substr(datastart);
+   check((roll[1 * 32 + 60 / 8] >> (60 % 8)) & 1, "bit-plane sounding c");
+   check(!((roll[1 * 32 + 16 + 60 / 8] >> (60 % 8)) & 1), "bit-plane sustained c");
+   check((roll[1 * 32 + 16 + 62 / 8] >> (62 % 8)) & 1, "bit-plane attacked d");
+
+   // A .npy file can only store the roll of one input file:
+   Tool_binroll tool;
+   tool.process("binroll --npy -t 8");
+   HumdrumFile infile1;
+   HumdrumFile infile2;
+   infile1.readString(data);
+   infile2.readString(data);
+   stringstream out;
+   check(tool.run(infile1, out), "first input file");
+   check(!tool.run(infile2, out), "second input file is rejected");
+   check(tool.hasError(), "error message for second input file");
+   getNpyHeader(out.str(), datastart);
+   check((int)out.str().size() == datastart + 5 * 128, "only one roll written");
+
+   return finish();
+}
+
+
+
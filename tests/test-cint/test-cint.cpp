@@ -0,0 +1,142 @@
+// Description: Check that the module counts of cint --stats match the
+//              counts of the modules printed by cint --raw (as with
+//              "cint --raw | sort | uniq -c") for several module options,
+//              and the escaping of modules in the JSON output.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace hum;
+using namespace std;
+
+class TestCint : public Tool_cint {
+   public:
+      using Tool_cint::getJsonString;
+};
+
+// Count the lines printed by cint --raw for each file.
+map<string, int> countRawModules(const vector<string>& filenames, const string& options) {
+   map<string, int> counts;
+   for (const string& filename : filenames) {
+      Tool_cint tool;
+      tool.process("cint --raw " + options);
+      HumdrumFile infile;
+      infile.read(filename);
+      tool.run(infile);
+      stringstream out;
+      tool.getAllText(out);
+      string line;
+      while (getline(out, line)) {
+         counts[line]++;
+      }
+   }
+   return counts;
+}
+
+// Run cint --stats on the files as the command-line interface does.
+string stats(const vector<string>& filenames, const string& options) {
+   string command = "cint --stats " + options;
+   for (const string& filename : filenames) {
+      command += " " + filename;
+   }
+   Tool_cint tool;
+   tool.process(command);
+   HumdrumFileStream instream(static_cast<Options&>(tool));
+   tool.run(instream);
+   tool.finally();
+   stringstream out;
+   tool.getAllText(out);
+   return out.str();
+}
+
+// Read the count of each module from the --stats table.
+map<string, int> getStatsCounts(const string& table) {
+   map<string, int> counts;
+   stringstream input(table);
+   string line;
+   getline(input, line); // header
+   while (getline(input, line)) {
+      size_t tab = line.find('\t');
+      if (tab == string::npos) {
+         counts["invalid line: " + line]++;
+         continue;
+      }
+      counts[line.substr(tab + 1)] += stoi(line.substr(0, tab));
+   }
+   return counts;
+}
+
+int main(int argc, char** argv) {
+   // The input files are written to a new temporary directory:
+   char tempdir[] = "/tmp/test-cint-XXXXXX";
+   if (!mkdtemp(tempdir)) {
+      cerr << "Cannot create temporary directory" << endl;
+      return 1;
+   }
+   vector<string> filenames;
+   filenames.push_back(string(tempdir) + "/test-cint-1.krn");
+   filenames.push_back(string(tempdir) + "/test-cint-2.krn");
+   ofstream(filenames[0]) <<
+      "**kern\t**kern\t**kern\n"
+      "*M4/4\t*M4/4\t*M4/4\n"
+      "=1\t=1\t=1\n"
+      "2C\t4e\t4g\n"
+      ".\t4f\t4a\n"
+      "4D\t2e\t[4b\n"
+      "4E\t.\t4b]\n"
+      "=2\t=2\t=2\n"
+      "4r\t4d\t4cc\n"
+      "4F\t4c\t4a\n"
+      "2G\t2B\t2g\n"
+      "=3\t=3\t=3\n"
+      "1C\t1c\t1e\n"
+      "==\t==\t==\n"
+      "*-\t*-\t*-\n";
+   ofstream(filenames[1]) <<
+      "**kern\t**kern\n"
+      "*M3/4\t*M3/4\n"
+      "=1\t=1\n"
+      "4C\t2e\n"
+      "4D\t.\n"
+      "4E\t4g\n"
+      "=2\t=2\n"
+      "2.C\t8f#\n"
+      ".\t8e\n"
+      ".\t2e\n"
+      "==\t==\n"
+      "*-\t*-\n";
+
+   string options[] = { "", "-n 2", "-n 3 -s", "--attacks -n 2", "-o -t",
+         "-x -n 2", "--12 -U -n 2", "-T -n 2", "--chromatic -n 2", "-R -n 2" };
+   for (const string& option : options) {
+      map<string, int> expected = countRawModules(filenames, option);
+      check(!expected.empty(), "modules with options \"" + option + "\"");
+      check(getStatsCounts(stats(filenames, option)) == expected,
+            "--stats counts with options \"" + option + "\"");
+   }
+
+   check(stats(filenames, "-n 2 --threads 2") == stats(filenames, "-n 2"),
+         "same counts for any thread count");
+
+   string json = stats(filenames, "-n 2 --json");
+   check(json.find("\"files\": 2,") != string::npos, "JSON file count");
+   check(json.find("{\"module\": \"") != string::npos, "JSON modules");
+
+   TestCint tool;
+   check(tool.getJsonString("3 \"2\" \\ x\ty\n\x01") == "3 \\\"2\\\" \\\\ x\\ty\\n\\u0001",
+         "JSON string escapes");
+
+   for (const string& filename : filenames) {
+      remove(filename.c_str());
+   }
+   rmdir(tempdir);
+   return finish();
+}
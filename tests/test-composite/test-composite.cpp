@@ -0,0 +1,119 @@
+// Description: Check the group states of the composite tool: the
+//              coincidence rhythm of groups A and B (-c), the group
+//              rhythms (-g), and the note onset counts (-A n), with
+//              chords, ties, grace notes, rests, spine splits and a
+//              change of group in the middle of a spine.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+string composite(const string& data, const string& options) {
+   Tool_composite tool;
+   HumdrumFile infile;
+   infile.readString(data);
+   tool.process("composite " + options);
+   stringstream out;
+   tool.run(infile, out);
+   return out.str();
+}
+
+int main(int argc, char** argv) {
+   string data =
+      "**kern\t**kern\t**kern\t**dynam\n"
+      "*grp:A\t*grp:B\t*grp:A\t*\n"
+      "*M3/4\t*M3/4\t*M3/4\t*\n"
+      "=1\t=1\t=1\t=1\n"
+      "4c 4e\t[4d 4f\t4r\tp\n"
+      "8cq\t.\t.\t.\n"
+      "4d\t4d] 4f_\t4G\t.\n"
+      "8e 8r\t8r\t4A\t.\n"
+      "8f\t8g\t.\t.\n"
+      "=2\t=2\t=2\t=2\n"
+      "*\t*\t*^\t*\n"
+      "4c\t4e\t[2d\t4r\t.\n"
+      "*grp:B\t*\t*grp:\t*\t*\n"
+      "4r\t4f\t.\t4A\t.\n"
+      "4e 4g]\t4g\t4d]\t4B\tf\n"
+      "*\t*\t*v\t*v\t*\n"
+      "=3\t=3\t=3\t=3\n"
+      "2.c\t2r\t[2.d\t.\n"
+      ".\t4e\t.\t.\n"
+      "=4\t=4\t=4\t=4\n"
+      "2.c\t[4d\t2.d]\t.\n"
+      ".\t2d]\t.\t.\n"
+      "==\t==\t==\t==\n"
+      "*-\t*-\t*-\t*-\n";
+
+   string expected =
+      "**kern-coin\t**kern-comp\t**kern-grpA\t**kern-grpB\t**kern\t**kern\t**kern\t**dynam\n"
+      "*\t*\t*grp:A\t*grp:B\t*grp:A\t*grp:B\t*grp:A\t*\n"
+      "*\t*\t*M3/4\t*M3/4\t*M3/4\t*M3/4\t*M3/4\t*\n"
+      "=1\t=1\t=1\t=1\t=1\t=1\t=1\t=1\n"
+      "2eR\t4eR\t4eR\t[4eR\t4c 4e\t[4d 4f\t4r\tp\n"
+      ".\t.\t.\t.\t8cq\t.\t.\t.\n"
+      ".\t4eR\t4eR\t4]eR\t4d\t4d] 4f_\t4G\t.\n"
+      "8r\t8eRL\t8eRL\t8rR\t8e 8rL\t8r\t4A\t.\n"
+      "8eR\t8eRJ\t8eRJ\t8eR\t8fJ\t8g\t.\t.\n"
+      "=2\t=2\t=2\t=2\t=2\t=2\t=2\t=2\n"
+      "*\t*\t*\t*\t*\t*\t*^\t*\n"
+      "4eR\t4eR\t4eR\t4eR\t4c\t4e\t[2d\t4r\t.\n"
+      "*\t*\t*\t*\t*grp:B\t*\t*grp:\t*\t*\n"
+      "4eR\t4eR\t4eR\t4eR\t4r\t4f\t.\t4A\t.\n"
+      "4eR\t4eR\t4eR\t4eR\t4e 4g]\t4g\t4d]\t4B\tf\n"
+      "*\t*\t*\t*\t*\t*\t*v\t*v\t*\n"
+      "=3\t=3\t=3\t=3\t=3\t=3\t=3\t=3\n"
+      "2.eR\t2eR\t[2.eR\t2eR\t2.c\t2r\t[2.d\t.\n"
+      ".\t4eR\t.\t4eR\t.\t4e\t.\t.\n"
+      "=4\t=4\t=4\t=4\t=4\t=4\t=4\t=4\n"
+      "2.r\t[4eR\t2.]eR\t[4eR\t2.c\t[4d\t2.d]\t.\n"
+      ".\t2eR]\t.\t2]eR\t.\t2d]\t.\t.\n"
+      "==\t==\t==\t==\t==\t==\t==\t==\n"
+      "*-\t*-\t*-\t*-\t*-\t*-\t*-\t*-\n";
+   string output = composite(data, "-cg");
+   check(output == expected, "coincidence and group rhythms (-cg)");
+   if (output != expected) {
+      cout << output;
+   }
+
+   expected =
+      "**kern-comp\t**vdata-onsets\t**kern-grpA\t**vdata-onsets\t**kern-grpB\t**vdata-onsets\t**kern\t**kern\t**kern\t**dynam\n"
+      "*\t*\t*grp:A\t*\t*grp:B\t*\t*grp:A\t*grp:B\t*grp:A\t*\n"
+      "*\t*v:onsets:\t*\t*v:onsets:\t*\t*v:onsets:\t*\t*\t*\t*\n"
+      "*\t*\t*M3/4\t*\t*M3/4\t*\t*M3/4\t*M3/4\t*M3/4\t*\n"
+      "=1\t=1\t=1\t=1\t=1\t=1\t=1\t=1\t=1\t=1\n"
+      "4eR\t4\t4eR\t2\t[4eR\t2\t4c 4e\t[4d 4f\t4r\tp\n"
+      ".\t1\t.\t1\t.\t0\t8cq\t.\t.\t.\n"
+      "4eR\t2\t4eR\t2\t4]eR\t0\t4d\t4d] 4f_\t4G\t.\n"
+      "8eRL\t2\t8eRL\t2\t8rR\t0\t8e 8rL\t8r\t4A\t.\n"
+      "8eRJ\t2\t8eRJ\t1\t8eR\t1\t8fJ\t8g\t.\t.\n"
+      "=2\t=2\t=2\t=2\t=2\t=2\t=2\t=2\t=2\t=2\n"
+      "*\t*\t*\t*\t*\t*\t*\t*\t*^\t*\n"
+      "4eR\t3\t4eR\t2\t4eR\t1\t4c\t4e\t[2d\t4r\t.\n"
+      "*\t*\t*\t*\t*\t*\t*grp:B\t*\t*grp:\t*\t*\n"
+      "4eR\t2\t4eR\t1\t4eR\t1\t4r\t4f\t.\t4A\t.\n"
+      "4eR\t3\t4eR\t1\t4eR\t2\t4e 4g]\t4g\t4d]\t4B\tf\n"
+      "*\t*\t*\t*\t*\t*\t*\t*\t*v\t*v\t*\n"
+      "=3\t=3\t=3\t=3\t=3\t=3\t=3\t=3\t=3\t=3\n"
+      "2eR\t2\t[2.eR\t1\t2eR\t1\t2.c\t2r\t[2.d\t.\n"
+      "4eR\t1\t.\t0\t4eR\t1\t.\t4e\t.\t.\n"
+      "=4\t=4\t=4\t=4\t=4\t=4\t=4\t=4\t=4\t=4\n"
+      "[4eR\t2\t2.]eR\t0\t[4eR\t2\t2.c\t[4d\t2.d]\t.\n"
+      "2eR]\t0\t.\t0\t2]eR\t0\t.\t2d]\t.\t.\n"
+      "==\t==\t==\t==\t==\t==\t==\t==\t==\t==\n"
+      "*-\t*-\t*-\t*-\t*-\t*-\t*-\t*-\t*-\t*-\n";
+   output = composite(data, "-A n -g");
+   check(output == expected, "note onsets of groups (-A n -g)");
+   if (output != expected) {
+      cout << output;
+   }
+
+   return finish();
+}
+
+
+
@@ -0,0 +1,90 @@
+// Description: Measure the throughput of the dissonant tool for a set of
+//              Humdrum files (such as a whole corpus in a batch job).
+//              The files are parsed once, and then analyzed repeatedly
+//              to report files and notes per second.
+// Usage:       bench-dissonant [-n repeats] [-t threads] file.krn [file2.krn ...]
+
+#include "humlib.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+int main(int argc, char** argv) {
+   int repeats = 10;
+   int threads = 1;
+   int start = 1;
+   while ((start + 1 < argc) && (argv[start][0] == '-')) {
+      if (strcmp(argv[start], "-n") == 0) {
+         repeats = atoi(argv[start + 1]);
+      } else if (strcmp(argv[start], "-t") == 0) {
+         threads = atoi(argv[start + 1]);
+      } else {
+         break;
+      }
+      start += 2;
+   }
+   if ((start >= argc) || (repeats < 1)) {
+      cerr << "Usage: " << argv[0] << " [-n repeats] [-t threads] file.krn [file2.krn ...]" << endl;
+      return 1;
+   }
+
+   vector<string> contents;
+   long long notes = 0;
+   for (int i=start; i<argc; i++) {
+      HumdrumFile infile;
+      if (!infile.read(argv[i])) {
+         cerr << "Cannot read " << argv[i] << endl;
+         continue;
+      }
+      stringstream text;
+      text << infile;
+      contents.push_back(text.str());
+      for (int j=0; j<infile.getLineCount(); j++) {
+         for (int k=0; k<infile[j].getFieldCount(); k++) {
+            HTp token = infile.token(j, k);
+            if (token->isKern() && token->isNoteAttack()) {
+               notes++;
+            }
+         }
+      }
+   }
+   if (contents.empty()) {
+      return 1;
+   }
+
+   // The analysis adds spines to the file, so each run analyzes a freshly
+   // parsed copy; the parsing time is measured separately.
+   double parseseconds = 0.0;
+   double seconds = 0.0;
+   for (int r=0; r<repeats; r++) {
+      for (int i=0; i<(int)contents.size(); i++) {
+         auto begin = chrono::steady_clock::now();
+         HumdrumFile infile;
+         infile.readString(contents[i]);
+         auto parsed = chrono::steady_clock::now();
+         Tool_dissonant tool;
+         tool.process("dissonant -t " + to_string(threads));
+         tool.run(infile);
+         auto end = chrono::steady_clock::now();
+         parseseconds += chrono::duration<double>(parsed - begin).count();
+         seconds += chrono::duration<double>(end - parsed).count();
+      }
+   }
+
+   long long files = (long long)contents.size() * repeats;
+   notes *= repeats;
+   cout << "files:          " << files << endl;
+   cout << "notes:          " << notes << endl;
+   cout << "parse seconds:  " << parseseconds << endl;
+   cout << "seconds:        " << seconds << endl;
+   if (seconds > 0.0) {
+      cout << "files/second:   " << files / seconds << endl;
+      cout << "notes/second:   " << notes / seconds << endl;
+   }
+   return 0;
+}
@@ -0,0 +1,94 @@
+// Description: Check that the dissonant tool gives the same analysis when
+//              the voices are analyzed in several threads (-t) as in one
+//              thread, for a score with suspensions which are labeled
+//              against the notes of other voices.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+string dissonant(const string& data, const string& options) {
+   Tool_dissonant tool;
+   tool.process("dissonant " + options);
+   HumdrumFile infile;
+   infile.readString(data);
+   tool.run(infile);
+   stringstream out;
+   if (tool.hasAnyText()) {
+      tool.getAllText(out);
+   } else {
+      out << infile;
+   }
+   return out.str();
+}
+
+// Return the number of fields in the data lines which are equal to the
+// given analysis label.
+int countLabel(const string& output, const string& label) {
+   int count = 0;
+   stringstream input(output);
+   string line;
+   while (getline(input, line)) {
+      if (line.empty() || (line[0] == '!') || (line[0] == '*') || (line[0] == '=')) {
+         continue;
+      }
+      stringstream fields(line);
+      string field;
+      while (getline(fields, field, '\t')) {
+         if (field == label) {
+            count++;
+         }
+      }
+   }
+   return count;
+}
+
+int main(int argc, char** argv) {
+   // A chain of 7-6 and 4-3 suspensions in the upper voices over a
+   // moving bass, with passing and neighbor tones in the inner voice:
+   string data =
+      "**kern\t**kern\t**kern\n"
+      "*M4/4\t*M4/4\t*M4/4\n"
+      "=1\t=1\t=1\n"
+      "2C\t2g\t[2cc\n"
+      "2D\t4f\t4cc]\n"
+      ".\t4e\t4b\n"
+      "=2\t=2\t=2\n"
+      "2E\t[2g\t2cc\n"
+      "2F\t4g]\t4cc\n"
+      ".\t4f\t4a\n"
+      "=3\t=3\t=3\n"
+      "2G\t[2e\t[2dd\n"
+      "2A\t4e]\t4dd]\n"
+      ".\t4d\t4cc\n"
+      "=4\t=4\t=4\n"
+      "2G\t4c\t[2cc\n"
+      ".\t4d\t.\n"
+      "2GG\t4d\t4cc]\n"
+      ".\t4B\t4b\n"
+      "=5\t=5\t=5\n"
+      "1C\t1c\t1cc\n"
+      "==\t==\t==\n"
+      "*-\t*-\t*-\n";
+
+   string single = dissonant(data, "");
+   check(countLabel(single, "s") == 4, "suspensions");
+   check(countLabel(single, "g") == 4, "suspension agents in the bass");
+   check(countLabel(single, "y") == 3, "consonant suspension agents");
+   check(countLabel(single, "e") == 1, "echappee");
+
+   check(dissonant(data, "-t 4") == single, "same analysis with 4 threads");
+   check(dissonant(data, "-t 0") == single, "same analysis with all cores");
+   check(dissonant(data, "-v -f -t 4") == dissonant(data, "-v -f"),
+         "same voice numbers with 4 threads");
+   check(dissonant(data, "-c -t 4") == dissonant(data, "-c"),
+         "same counts with 4 threads");
+   check(dissonant(data, "-u -t 4") == dissonant(data, "-u"),
+         "same undirected labels with 4 threads");
+
+   return finish();
+}
@@ -0,0 +1,101 @@
+// Description: Check that esac2hum prints the same songs in the same order
+//              when the songs of a collection are converted in several
+//              threads, and that the DWOK source state of a song does not
+//              carry over to the following songs converted by the same
+//              thread.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+string esac2hum(const string& options, const string& input) {
+   Tool_esac2hum tool;
+   tool.process("esac2hum " + options);
+   stringstream out;
+   tool.convert(out, input);
+   return out.str();
+}
+
+// Return a song from a DWOK volume or from another collection.
+string makeSong(int number, bool dwokQ) {
+   string id = to_string(number);
+   string output;
+   if (dwokQ) {
+      output += "DWOK18\n";
+      output += "CUT[Song " + id + "]\n";
+      output += "KEY[18" + id + " 16 G 2/4]\n";
+      output += "MEL[1_2_3_4_  5__5__\n";
+      output += "    3_3_2_2_  1__0__ //]\n";
+      output += "TRD[DWOK18 s. " + id + "]\n";
+   } else {
+      output += "Other collection\n";
+      output += "CUT[Song " + id + "]\n";
+      output += "KEY[A" + id + " 16 C 3/4]\n";
+      output += "MEL[5__3__1__  2___.\n";
+      output += "    5__4__3__  1___. //]\n";
+      output += "TRD[Some book s. " + id + "]\n";
+      output += "## Comment for song " + id + "\n";
+   }
+   output += "\n";
+   return output;
+}
+
+// Return the number of lines which contain the given text.
+int countLines(const string& text, const string& search) {
+   stringstream input(text);
+   string line;
+   int count = 0;
+   while (getline(input, line)) {
+      if (line.find(search) != string::npos) {
+         count++;
+      }
+   }
+   return count;
+}
+
+int main(int argc, char** argv) {
+   // Runs of DWOK songs followed by other songs, so that each thread
+   // converts songs of both kinds:
+   string input;
+   int dwokcount = 0;
+   int songcount = 24;
+   for (int i=1; i<=songcount; i++) {
+      bool dwokQ = (i % 5 == 1) || (i % 5 == 2);
+      dwokcount += dwokQ;
+      input += makeSong(i, dwokQ);
+   }
+
+   string serial = esac2hum("-t 1", input);
+   check(countLines(serial, "!!!!SEGMENT:") == songcount, "song count");
+   check(countLines(serial, "!!!OTL: Song") == songcount, "titles");
+   check(countLines(serial, "Oskar Kolberg: Complete Works") == dwokcount,
+         "DWOK URL only for DWOK songs");
+   check(countLines(serial, "WebEsAC") == songcount, "WebEsAC URL for each song");
+
+   bool orderQ = true;
+   size_t position = 0;
+   for (int i=1; orderQ && (i<=songcount); i++) {
+      position = serial.find("!!!OTL: Song " + to_string(i) + "\n", position);
+      orderQ = position != string::npos;
+   }
+   check(orderQ, "songs in input order");
+
+   for (int threads : {2, 4, 0}) {
+      check(esac2hum("-t " + to_string(threads), input) == serial,
+            "same output with " + to_string(threads) + " threads");
+   }
+
+   // The options are also read when converting from a stream:
+   Tool_esac2hum tool;
+   tool.process("esac2hum -t 4");
+   stringstream in(input);
+   stringstream out;
+   tool.convert(out, in);
+   check(out.str() == serial, "stream with 4 threads");
+
+   return finish();
+}
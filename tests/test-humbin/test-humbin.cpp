@@ -0,0 +1,116 @@
+// Description: Check that binary cache files restore the same analyses as
+//              parsing the text, and that stale cache files are not used.
+// Usage:       test-humbin file.krn [cachedir]
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+string getRhythmSummary(HumdrumFile& infile) {
+   stringstream out;
+   for (int i=0; i<infile.getLineCount(); i++) {
+      out << infile[i].getDurationFromStart() << "\t"
+          << infile[i].getDuration() << "\t" << infile[i] << "\n";
+      for (int j=0; j<infile[i].getFieldCount(); j++) {
+         hum::HTp token = infile.token(i, j);
+         out << "\t" << token->getDuration() << ":" << token->getTrack();
+      }
+      out << "\n";
+   }
+   return out.str();
+}
+
+string getText(HumdrumFile& infile) {
+   stringstream out;
+   out << infile;
+   return out.str();
+}
+
+int main(int argc, char** argv) {
+   if (argc < 2) {
+      cerr << "Usage: " << argv[0] << " file.krn [cachedir]" << endl;
+      return 1;
+   }
+   string cachedir = argc > 2 ? argv[2] : "/tmp";
+
+   ifstream input(argv[1], ios::binary);
+   stringstream buffer;
+   buffer << input.rdbuf();
+   string contents = buffer.str();
+
+   HumdrumFile direct;
+   if (!direct.readString(contents)) {
+      cerr << "Cannot parse " << argv[1] << endl;
+      return 1;
+   }
+   string cachename = HumdrumFileStructure::getCacheFilename(contents, cachedir);
+   remove(cachename.c_str());
+
+   // Round trip: a cache miss parses the text and stores it, a cache hit
+   // must restore the same text and rhythm analysis.
+   HumdrumFile first;
+   check(first.readStringCached(contents, cachedir), "cache miss parses text");
+   check(ifstream(cachename).good(), "cache file is written");
+   HumdrumFile second;
+   check(second.readStringCached(contents, cachedir), "cache hit reads binary");
+   check(getText(second) == getText(direct), "cached text matches");
+   check(getRhythmSummary(second) == getRhythmSummary(direct),
+         "cached rhythm analysis matches");
+
+   // A cache file which was created from different contents must not be
+   // used (such as a hash collision in the filename or a stale file).
+   HumdrumFile other;
+   other.readString("**kern\n4c\n*-\n");
+   ofstream stale(cachename, ios::binary);
+   other.writeBinary(stale);
+   stale.close();
+   HumdrumFile third;
+   check(third.readStringCached(contents, cachedir), "stale cache is reparsed");
+   check(getText(third) == getText(direct), "stale cache is not used");
+
+   // A corrupted cache file must not be used (the stale file was replaced
+   // by the reparsed contents above).
+   ifstream cached(cachename, ios::binary);
+   stringstream bytes;
+   bytes << cached.rdbuf();
+   cached.close();
+   string data = bytes.str();
+   size_t position = data.find("**");
+   check(position != string::npos, "cache file contains text");
+   data[position] = '!';
+   ofstream corrupt(cachename, ios::binary);
+   corrupt << data;
+   corrupt.close();
+   HumdrumFile fourth;
+   check(fourth.readStringCached(contents, cachedir), "corrupt cache is reparsed");
+   check(getRhythmSummary(fourth) == getRhythmSummary(direct),
+         "corrupt cache is not used");
+
+   // A cache miss without rhythm analysis must store the unanalyzed
+   // structure, which is then analyzed when read with rhythm.
+   remove(cachename.c_str());
+   HumdrumFile norhythm;
+   check(norhythm.readStringNoRhythmCached(contents, cachedir),
+         "no-rhythm cache miss parses text");
+   check(!norhythm.isRhythmAnalyzed(), "no-rhythm cache miss is not analyzed");
+   HumdrumFile norhythm2;
+   check(norhythm2.readStringNoRhythmCached(contents, cachedir),
+         "no-rhythm cache hit reads binary");
+   check(getText(norhythm2) == getText(direct), "no-rhythm cached text matches");
+   HumdrumFile fifth;
+   check(fifth.readStringCached(contents, cachedir),
+         "analyzed read of no-rhythm cache");
+   check(getRhythmSummary(fifth) == getRhythmSummary(direct),
+         "analysis of no-rhythm cache matches");
+
+   remove(cachename.c_str());
+   return finish();
+}
+
+
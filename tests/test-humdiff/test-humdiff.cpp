@@ -0,0 +1,160 @@
+// Description: Check the edit scripts of the humdiff note alignment (Myers'
+//              difference algorithm in alignRange/bisectRange) against the
+//              length of the longest common subsequence calculated by
+//              dynamic programming, for all short sequences of a few
+//              symbols and for random longer sequences.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <cstdlib>
+
+using namespace hum;
+using namespace std;
+
+class TestHumdiff : public Tool_humdiff {
+   public:
+      using Tool_humdiff::alignRange;
+      using Tool_humdiff::alignNotes;
+};
+
+// Return the length of the longest common subsequence of a and b.
+int getLcsLength(const vector<int>& a, const vector<int>& b) {
+   vector<vector<int>> table(a.size() + 1, vector<int>(b.size() + 1, 0));
+   for (int i=1; i<=(int)a.size(); i++) {
+      for (int j=1; j<=(int)b.size(); j++) {
+         if (a[i-1] == b[j-1]) {
+            table[i][j] = table[i-1][j-1] + 1;
+         } else {
+            table[i][j] = std::max(table[i-1][j], table[i][j-1]);
+         }
+      }
+   }
+   return table[a.size()][b.size()];
+}
+
+// Return true if the edit script uses every element of a and b once, in
+// order, and only matches equal elements.  The number of matches is
+// returned in matches.
+bool isValidScript(const vector<DiffEdit>& edits, const vector<int>& a,
+      const vector<int>& b, int& matches) {
+   int i = 0;
+   int j = 0;
+   matches = 0;
+   for (const DiffEdit& edit : edits) {
+      switch (edit.type) {
+         case '=':
+            if ((edit.refindex != i) || (edit.altindex != j) || (a[i] != b[j])) {
+               return false;
+            }
+            matches++;
+            i++;
+            j++;
+            break;
+         case '~':
+            if ((edit.refindex != i) || (edit.altindex < j)) {
+               return false;
+            }
+            i++;
+            j = edit.altindex + 1;
+            break;
+         case '-':
+            if ((edit.refindex != i) || (edit.altindex != -1)) {
+               return false;
+            }
+            i++;
+            break;
+         case '+':
+            if ((edit.refindex != -1) || (edit.altindex != j)) {
+               return false;
+            }
+            j++;
+            break;
+         default:
+            return false;
+      }
+   }
+   return (i == (int)a.size()) && (j == (int)b.size());
+}
+
+// Check the raw edit script and the script with changes for two sequences.
+bool checkAlignment(TestHumdiff& tool, const vector<int>& a, const vector<int>& b) {
+   int lcs = getLcsLength(a, b);
+   vector<DiffEdit> edits;
+   tool.alignRange(edits, a, 0, (int)a.size(), b, 0, (int)b.size());
+   int matches;
+   if (!isValidScript(edits, a, b, matches) || (matches != lcs)) {
+      return false;
+   }
+   if ((int)edits.size() != (int)a.size() + (int)b.size() - lcs) {
+      // not a minimal edit script
+      return false;
+   }
+   tool.alignNotes(edits, a, b);
+   return isValidScript(edits, a, b, matches) && (matches == lcs);
+}
+
+// Fill the sequence with the digits of number in the given base.
+void makeSequence(vector<int>& sequence, int number, int length, int base) {
+   sequence.resize(length);
+   for (int i=0; i<length; i++) {
+      sequence[i] = number % base;
+      number /= base;
+   }
+}
+
+int main(int argc, char** argv) {
+   TestHumdiff tool;
+
+   // All pairs of sequences of up to 5 symbols from an alphabet of 3:
+   vector<vector<int>> sequences;
+   for (int length=0; length<=5; length++) {
+      int count = 1;
+      for (int i=0; i<length; i++) {
+         count *= 3;
+      }
+      for (int number=0; number<count; number++) {
+         sequences.emplace_back();
+         makeSequence(sequences.back(), number, length, 3);
+      }
+   }
+   bool allQ = true;
+   for (int i=0; (i<(int)sequences.size()) && allQ; i++) {
+      for (int j=0; (j<(int)sequences.size()) && allQ; j++) {
+         allQ = checkAlignment(tool, sequences[i], sequences[j]);
+      }
+   }
+   check(allQ, "all short sequences (" + to_string(sequences.size()) + " x "
+         + to_string(sequences.size()) + ")");
+
+   // Random longer sequences, including ones which are nearly equal:
+   srand(30);
+   bool randomQ = true;
+   for (int test=0; (test<2000) && randomQ; test++) {
+      int base = 2 + test % 4;
+      vector<int> a(rand() % 60);
+      for (int& value : a) {
+         value = rand() % base;
+      }
+      vector<int> b = a;
+      int edits = rand() % 8;
+      for (int e=0; e<edits; e++) {
+         int position = b.empty() ? 0 : rand() % (int)b.size();
+         switch (rand() % 3) {
+            case 0: b.insert(b.begin() + position, rand() % base); break;
+            case 1: if (!b.empty()) { b.erase(b.begin() + position); } break;
+            case 2: if (!b.empty()) { b[position] = rand() % base; } break;
+         }
+      }
+      if (test % 2) {
+         b.resize(rand() % 60);
+         for (int& value : b) {
+            value = rand() % base;
+         }
+      }
+      randomQ = checkAlignment(tool, a, b);
+   }
+   check(randomQ, "random sequences");
+
+   return finish();
+}
@@ -0,0 +1,151 @@
+// Description: Check that a file created by HumGrid::transferTokens() and
+//              analyzed with HumdrumFile::analyzeFromGridTokens() has the
+//              same spine links, tracks and rhythm as the same file read
+//              back from its text.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+// Return the line and field index of each token in the list.
+string getPositions(const vector<HTp>& tokens) {
+   string output;
+   for (int i=0; i<(int)tokens.size(); i++) {
+      output += to_string(tokens[i]->getLineIndex()) + ":"
+            + to_string(tokens[i]->getFieldIndex()) + " ";
+   }
+   return output;
+}
+
+// Return the analysis of each line and token as text so that the two
+// files can be compared.
+string getStructure(HumdrumFile& infile) {
+   stringstream out;
+   out << "tracks " << infile.getMaxTrack() << " strands "
+       << infile.getStrandCount() << "\n";
+   for (int t=1; t<=infile.getMaxTrack(); t++) {
+      out << "track " << t << " start " << getPositions({infile.getTrackStart(t)})
+          << " ends " << infile.getTrackEndCount(t) << "\n";
+   }
+   for (int i=0; i<infile.getLineCount(); i++) {
+      HumdrumLine& line = infile[i];
+      out << i << "\t" << line << "\n\t" << line.getDurationFromStart()
+          << " " << line.getDuration() << " " << line.getDurationFromBarline()
+          << " " << line.getDurationToBarline() << "\n";
+      for (int j=0; j<line.getFieldCount(); j++) {
+         HTp token = line.token(j);
+         out << "\t" << j << " " << token->getSpineInfo() << " "
+             << token->getTrack() << "." << token->getSubtrack()
+             << " field " << token->getFieldIndex()
+             << " dur " << token->getDuration() << " next ";
+         vector<HTp> next;
+         for (int k=0; k<token->getNextTokenCount(); k++) {
+            next.push_back(token->getNextToken(k));
+         }
+         out << getPositions(next) << "previous ";
+         vector<HTp> previous;
+         for (int k=0; k<token->getPreviousTokenCount(); k++) {
+            previous.push_back(token->getPreviousToken(k));
+         }
+         out << getPositions(previous);
+         if (token->isData() && token->isNull() && token->resolveNull()) {
+            out << "null " << getPositions({token->resolveNull()});
+         }
+         out << "\n";
+      }
+   }
+   return out.str();
+}
+
+// Two parts, where the upper part has two voices in the second measure
+// (so that the grid adds *^ and *v manipulators) and a grace note in the
+// third measure.
+void fillGrid(HumGrid& grid) {
+   for (int m=0; m<3; m++) {
+      GridMeasure* gm = grid.addMeasureToBack();
+      gm->setTimestamp(4 * m);
+      gm->setDuration(4);
+      gm->setTimeSigDur(4);
+      gm->setMeasureNumber(m + 1);
+      if (m == 2) {
+         gm->setFinalBarlineStyle();
+      }
+   }
+   GridMeasure* gm = grid.at(0);
+   gm->addClefToken("*clefF4", 0, 0, 0, 0, 2);
+   gm->addClefToken("*clefG2", 0, 1, 0, 0, 2);
+   gm->addTimeSigToken("*M4/4", 0, 0, 0, 0, 2);
+   gm->addTimeSigToken("*M4/4", 0, 1, 0, 0, 2);
+   gm->addDataToken("2C", 0, 0, 0, 0, 2);
+   gm->addDataToken("2G", 2, 0, 0, 0, 2);
+   gm->addDataToken("4c", 0, 1, 0, 0, 2);
+   gm->addDataToken("4d", 1, 1, 0, 0, 2);
+   gm->addDataToken("4e", 2, 1, 0, 0, 2);
+   gm->addDataToken("4f", 3, 1, 0, 0, 2);
+
+   gm = grid.at(1);
+   gm->addDataToken("1C", 4, 0, 0, 0, 2);
+   gm->addDataToken("2g", 4, 1, 0, 0, 2);
+   gm->addDataToken("2a", 6, 1, 0, 0, 2);
+   gm->addDataToken("4e", 4, 1, 0, 1, 2);
+   gm->addDataToken("4f", 5, 1, 0, 1, 2);
+   gm->addDataToken("2e", 6, 1, 0, 1, 2);
+
+   gm = grid.at(2);
+   gm->addGraceToken("8qd", 8, 1, 0, 0, 2, 1);
+   gm->addDataToken("1GG", 8, 0, 0, 0, 2);
+   gm->addDataToken("1c", 8, 1, 0, 0, 2);
+}
+
+int main(int argc, char** argv) {
+   HumGrid grid;
+   fillGrid(grid);
+   HumdrumFile direct;
+   check(grid.transferTokens(direct), "transfer tokens");
+   check(direct.analyzeFromGridTokens(), "analyze from grid tokens");
+
+   stringstream text;
+   text << direct;
+   HumdrumFile reread;
+   reread.readString(text.str());
+   check(text.str().find("*^") != string::npos, "voice split in the test data");
+   check(text.str().find("*v\t*v") != string::npos, "voice merge in the test data");
+   check(text.str().find("8qd") != string::npos, "grace note in the test data");
+   check(getStructure(direct) == getStructure(reread), "same analysis as re-read file");
+
+   // Reference records added after the transfer have no slice time:
+   direct.insertLine(0, "!!!OTL: Test");
+   direct.appendLine("!!!RDF**kern: > = above");
+   check(direct.analyzeFromGridTokens(), "analyze with added records");
+   text.str("");
+   text << direct;
+   reread.readString(text.str());
+   check(getStructure(direct) == getStructure(reread),
+         "same analysis with added records");
+
+   // Files which do not have the form written by the grid (here a *x
+   // manipulator) use the general analysis:
+   HumGrid grid2;
+   fillGrid(grid2);
+   HumdrumFile exchanged;
+   grid2.transferTokens(exchanged);
+   for (int i=0; i<exchanged.getLineCount(); i++) {
+      if (exchanged[i].isData()) {
+         HLp line = new HumdrumLine("*x\t*x");
+         exchanged.insertLine(i, line);
+         break;
+      }
+   }
+   check(exchanged.analyzeFromGridTokens(), "analyze file with *x");
+   text.str("");
+   text << exchanged;
+   reread.readString(text.str());
+   check(getStructure(exchanged) == getStructure(reread),
+         "same analysis for file with *x");
+
+   return finish();
+}
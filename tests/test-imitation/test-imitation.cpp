@@ -0,0 +1,154 @@
+// Description: Check the suffix-array search of imitation (-S) against a
+//              brute-force enumeration of all maximal matches between
+//              pairs of voices, including very repetitive music where
+//              most suffixes share a long common prefix.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+// Return a **kern file with one spine for each voice, with a quarter note
+// on each line for the given diatonic pitches (0 = c, 1 = d, ...).
+string makeScore(const vector<vector<int>>& voices) {
+   stringstream out;
+   for (int v=0; v<(int)voices.size(); v++) {
+      out << (v ? "\t" : "") << "**kern";
+   }
+   out << "\n";
+   for (int k=0; k<(int)voices[0].size(); k++) {
+      for (int v=0; v<(int)voices.size(); v++) {
+         out << (v ? "\t" : "") << "4" << "cdefgab"[voices[v][k]];
+      }
+      out << "\n";
+   }
+   for (int v=0; v<(int)voices.size(); v++) {
+      out << (v ? "\t" : "") << "*-";
+   }
+   out << "\n";
+   return out.str();
+}
+
+// Return the matches found by imitation -S, as "v1 i v2 j count" strings
+// where i and j are the note indexes of the start of the match.
+vector<string> getSuffixMatches(const string& data, int notes) {
+   Tool_imitation tool;
+   tool.process("imitation -S -D -I -DD -II -n " + to_string(notes));
+   HumdrumFile infile;
+   infile.readString(data);
+   stringstream out;
+   tool.run(infile, out);
+   HumdrumFile outfile;
+   outfile.readString(out.str());
+
+   // Occurrences of each match number: voice, note index and count.
+   map<int, vector<vector<int>>> occurrences;
+   HumRegex hre;
+   for (int i=0; i<outfile.getLineCount(); i++) {
+      if (!outfile[i].isData()) {
+         continue;
+      }
+      int voice = -1;
+      for (int j=0; j<outfile[i].getFieldCount(); j++) {
+         HTp token = outfile.token(i, j);
+         if (token->isKern()) {
+            voice++;
+            continue;
+         }
+         if (token->isNull()) {
+            continue;
+         }
+         vector<string> entries;
+         hre.split(entries, *token, " ");
+         for (const string& entry : entries) {
+            if (hre.search(entry, "^n(\\d+):c(\\d+)$")) {
+               occurrences[hre.getMatchInt(1)].push_back({voice, i - 1, hre.getMatchInt(2)});
+            }
+         }
+      }
+   }
+
+   vector<string> matches;
+   for (auto& item : occurrences) {
+      vector<vector<int>>& occ = item.second;
+      if (occ.size() != 2) {
+         matches.push_back("invalid match " + to_string(item.first));
+         continue;
+      }
+      sort(occ.begin(), occ.end());
+      matches.push_back(to_string(occ[0][0]) + " " + to_string(occ[0][1]) + " "
+            + to_string(occ[1][0]) + " " + to_string(occ[1][1]) + " "
+            + to_string(occ[0][2]));
+   }
+   sort(matches.begin(), matches.end());
+   return matches;
+}
+
+// Return all matches of at least the given number of notes between two
+// voices which cannot be extended to the left or right, by comparing
+// the intervals after every pair of notes.
+vector<string> getBruteForceMatches(const vector<vector<int>>& voices, int notes) {
+   vector<string> matches;
+   for (int v1=0; v1<(int)voices.size(); v1++) {
+      for (int v2=v1+1; v2<(int)voices.size(); v2++) {
+         const vector<int>& a = voices[v1];
+         const vector<int>& b = voices[v2];
+         int size1 = (int)a.size() - 1;
+         int size2 = (int)b.size() - 1;
+         for (int i=0; i<(int)a.size(); i++) {
+            for (int j=0; j<(int)b.size(); j++) {
+               if ((i > 0) && (j > 0) && (a[i] - a[i-1] == b[j] - b[j-1])) {
+                  continue;
+               }
+               int length = 0;
+               while ((i + length < size1) && (j + length < size2) &&
+                     (a[i+length+1] - a[i+length] == b[j+length+1] - b[j+length])) {
+                  length++;
+               }
+               if (length + 1 >= notes) {
+                  matches.push_back(to_string(v1) + " " + to_string(i) + " "
+                        + to_string(v2) + " " + to_string(j) + " "
+                        + to_string(length + 1));
+               }
+            }
+         }
+      }
+   }
+   sort(matches.begin(), matches.end());
+   return matches;
+}
+
+int main(int argc, char** argv) {
+   srand(1234);
+   for (int test=0; test<6; test++) {
+      vector<vector<int>> voices(3, vector<int>(40));
+      for (auto& voice : voices) {
+         for (int& pitch : voice) {
+            pitch = rand() % 4;
+         }
+      }
+      string data = makeScore(voices);
+      for (int notes : { 3, 5 }) {
+         vector<string> expected = getBruteForceMatches(voices, notes);
+         check(getSuffixMatches(data, notes) == expected,
+               "random voices " + to_string(test) + ", " + to_string(notes) + " notes ("
+               + to_string(expected.size()) + " matches)");
+      }
+   }
+
+   // Long passages of repeated notes put most suffixes into one group of
+   // similar suffixes:
+   vector<vector<int>> voices(3, vector<int>(1500, 0));
+   voices[1][700] = 2;
+   string data = makeScore(voices);
+   vector<string> expected = getBruteForceMatches(voices, 7);
+   check(expected.size() > 3000, "repeated notes have many maximal matches");
+   check(getSuffixMatches(data, 7) == expected, "repeated notes");
+
+   return finish();
+}
@@ -0,0 +1,64 @@
+// Description: Check that HumdrumFileBase::insertLines() inserts a list of
+//              lines in order at the start, middle and end of a file, gives
+//              the same result as inserting the lines one at a time with
+//              insertLine(), and updates the line indexes.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+string getText(HumdrumFile& infile) {
+   stringstream out;
+   out << infile;
+   return out.str();
+}
+
+// Return true if each line of the file knows its own line index.
+bool checkLineIndexes(HumdrumFile& infile) {
+   for (int i=0; i<infile.getLineCount(); i++) {
+      if (infile[i].getLineIndex() != i) {
+         return false;
+      }
+   }
+   return true;
+}
+
+int main(int argc, char** argv) {
+   string data =
+      "**kern\n"
+      "4c\n"
+      "4d\n"
+      "*-\n";
+   vector<string> lines = {"!!!one: 1", "!!!two: 2", "!!!three: 3"};
+
+   for (int index : {0, 2, 4}) {
+      HumdrumFile infile;
+      infile.readString(data);
+      infile.insertLines(index, lines);
+
+      HumdrumFile expected;
+      expected.readString(data);
+      for (int i=0; i<(int)lines.size(); i++) {
+         expected.insertLine(index + i, lines[i]);
+      }
+
+      string position = " at line " + to_string(index);
+      check(infile.getLineCount() == 4 + (int)lines.size(), "line count" + position);
+      check(getText(infile) == getText(expected), "same as insertLine()" + position);
+      check(infile[index].getText() == lines[0], "first line" + position);
+      check(infile[index + 2].getText() == lines[2], "last line" + position);
+      check(checkLineIndexes(infile), "line indexes" + position);
+   }
+
+   HumdrumFile infile;
+   infile.readString(data);
+   infile.insertLines(1, vector<string>());
+   check(getText(infile) == data, "empty list of lines");
+   check(checkLineIndexes(infile), "line indexes for empty list");
+
+   return finish();
+}
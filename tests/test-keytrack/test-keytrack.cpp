@@ -0,0 +1,171 @@
+// Description: Check the pitch-class histograms of keytrack windows against
+//              the durations of the notes in each window, the key
+//              correlations against Convert::pearsonCorrelation for both
+//              key profiles, and the bar numbers of the JSON key curve.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <cmath>
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+class TestKeytrack : public Tool_keytrack {
+   public:
+      using Tool_keytrack::initialize;
+      using Tool_keytrack::fillPitchClassCurve;
+      using Tool_keytrack::getCumulativeHistogram;
+      using Tool_keytrack::analyzeWindow;
+};
+
+// Return the duration of each pitch class which sounds between the given
+// times, from the **kern tokens of the file.
+vector<double> getWindowHistogram(HumdrumFile& infile, double starttime,
+      double endtime) {
+   vector<double> histogram(12, 0.0);
+   for (int i=0; i<infile.getLineCount(); i++) {
+      if (!infile[i].isData()) {
+         continue;
+      }
+      for (int j=0; j<infile[i].getFieldCount(); j++) {
+         HTp token = infile.token(i, j);
+         if (!token->isKern() || token->isNull() || token->isRest()) {
+            continue;
+         }
+         double start = token->getDurationFromStart().getFloat();
+         double end = start + token->getDuration().getFloat();
+         double overlap = std::min(end, endtime) - std::max(start, starttime);
+         if (overlap <= 0.0) {
+            continue;
+         }
+         for (int k=0; k<token->getSubtokenCount(); k++) {
+            int pc = Convert::kernToMidiNoteNumber(token->getSubtoken(k)) % 12;
+            histogram[pc] += overlap;
+         }
+      }
+   }
+   return histogram;
+}
+
+// Return the key profile transposed to the given tonic.
+vector<double> getProfile(const double* base, int tonic) {
+   vector<double> profile(12);
+   for (int i=0; i<12; i++) {
+      profile[i] = base[(i - tonic + 12) % 12];
+   }
+   return profile;
+}
+
+string keytrack(const string& data, const string& options) {
+   Tool_keytrack tool;
+   tool.process("keytrack " + options);
+   HumdrumFile infile;
+   infile.readString(data);
+   stringstream out;
+   tool.run(infile, out);
+   return out.str();
+}
+
+int main(int argc, char** argv) {
+   // Pickup measure, chords, ties, rests and a grace note:
+   string data =
+      "**kern\t**kern\n"
+      "*M3/4\t*M3/4\n"
+      "4G\t4d\n"
+      "=1\t=1\n"
+      "2C\t4c 4e\n"
+      ".\t8dq\n"
+      ".\t4f#\n"
+      "4r\t[4g\n"
+      "=2\t=2\n"
+      "2.F\t4g]\n"
+      ".\t8a\n"
+      ".\t8b-\n"
+      ".\t4cc\n"
+      "=3\t=3\n"
+      "2.G\t2.d g b\n"
+      "==\t==\n"
+      "*-\t*-\n";
+   HumdrumFile infile;
+   infile.readString(data);
+
+   static const double kpmajor[12] = { 0.748, 0.060, 0.488, 0.082, 0.670,
+         0.460, 0.096, 0.715, 0.104, 0.366, 0.057, 0.400 };
+   static const double kpminor[12] = { 0.712, 0.084, 0.474, 0.618, 0.049,
+         0.460, 0.105, 0.747, 0.404, 0.067, 0.133, 0.330 };
+   static const double kkmajor[12] = { 6.35, 2.23, 3.48, 2.33, 4.38, 4.09,
+         2.52, 5.19, 2.39, 3.66, 2.29, 2.88 };
+   static const double kkminor[12] = { 6.33, 2.68, 3.52, 5.38, 2.60, 3.53,
+         2.54, 4.75, 3.98, 2.69, 3.34, 3.17 };
+
+   double windows[][2] = { { -4, 4 }, { 0, 1 }, { 0.5, 2.25 }, { 1, 4 },
+         { 3.5, 7 }, { 2, 10 }, { 6.75, 12 }, { -10, 20 } };
+
+   for (int p=0; p<2; p++) {
+      TestKeytrack tool;
+      tool.process(p ? "keytrack -k" : "keytrack");
+      tool.initialize();
+      tool.fillPitchClassCurve(infile);
+      const double* major = p ? kkmajor : kpmajor;
+      const double* minor = p ? kkminor : kpminor;
+      string profile = p ? "Krumhansl-Kessler" : "Kostka-Payne";
+
+      bool histogramsQ = true;
+      bool correlationsQ = true;
+      bool bestQ = true;
+      for (auto& window : windows) {
+         double start[12];
+         double end[12];
+         tool.getCumulativeHistogram(start, window[0]);
+         tool.getCumulativeHistogram(end, window[1]);
+         vector<double> expected = getWindowHistogram(infile, window[0], window[1]);
+         vector<double> histogram(12);
+         for (int k=0; k<12; k++) {
+            histogram[k] = end[k] - start[k];
+            if (fabs(histogram[k] - expected[k]) > 1.0e-9) {
+               histogramsQ = false;
+            }
+         }
+
+         double correlations[24];
+         int key = tool.analyzeWindow(correlations, window[0], window[1]);
+         int best = 0;
+         vector<double> r(24);
+         for (int k=0; k<24; k++) {
+            r[k] = Convert::pearsonCorrelation(getProfile(k < 12 ? major : minor, k % 12),
+                  expected);
+            if (fabs(correlations[k] - r[k]) > 1.0e-9) {
+               correlationsQ = false;
+            }
+            if (r[k] > r[best]) {
+               best = k;
+            }
+         }
+         if (key != best) {
+            bestQ = false;
+         }
+      }
+      check(histogramsQ, "window histograms");
+      check(correlationsQ, profile + " correlations");
+      check(bestQ, profile + " best key");
+   }
+
+   double correlations[24];
+   TestKeytrack tool;
+   tool.process("keytrack");
+   tool.initialize();
+   tool.fillPitchClassCurve(infile);
+   check(tool.analyzeWindow(correlations, 20, 30) == -1, "no key after the end");
+
+   // The bar number of each measure is taken from its starting barline:
+   string json = keytrack(data, "-j -m -w 1");
+   check(json.find("\"measure\": null, \"qon\": 0,") != string::npos, "pickup measure");
+   check(json.find("\"measure\": 1, \"qon\": 1,") != string::npos, "measure 1");
+   check(json.find("\"measure\": 3, \"qon\": 7,") != string::npos, "measure 3");
+   check(keytrack(data, "-j").find("\"measure\"") == string::npos,
+         "no measures for quarter-note windows");
+
+   return finish();
+}
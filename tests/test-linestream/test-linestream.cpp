@@ -0,0 +1,165 @@
+// Description: Check the spine tracking of HumdrumLineStream against the
+//              analysis of HumdrumFile, the parse errors for invalid spine
+//              structures, the restart of the spines for each segment of
+//              a multi-file stream, and the stream interface of rid.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+// Return the spine info and track of each spined line, as read by
+// HumdrumLineStream.
+string getStreamSpines(const string& data) {
+   stringstream input(data);
+   HumdrumLineStream instream(input);
+   HumdrumStreamLine line;
+   stringstream out;
+   while (instream.getLine(line)) {
+      if (!line.hasSpines()) {
+         continue;
+      }
+      for (int i=0; i<line.getFieldCount(); i++) {
+         out << line.getSpineInfo(i) << "/" << line.getTrack(i) << "\t";
+      }
+      out << "\n";
+   }
+   return out.str();
+}
+
+// Return the spine info and track of each spined line, as analyzed by
+// HumdrumFile.
+string getFileSpines(const string& data) {
+   HumdrumFile infile;
+   infile.readString(data);
+   stringstream out;
+   for (int i=0; i<infile.getLineCount(); i++) {
+      if (!infile[i].hasSpines()) {
+         continue;
+      }
+      for (int j=0; j<infile[i].getFieldCount(); j++) {
+         HTp token = infile.token(i, j);
+         out << token->getSpineInfo() << "/" << token->getTrack() << "\t";
+      }
+      out << "\n";
+   }
+   return out.str();
+}
+
+// Return the error message after reading all of the lines of the data.
+string getStreamError(const string& data, int& linecount) {
+   stringstream input(data);
+   HumdrumLineStream instream(input);
+   HumdrumStreamLine line;
+   linecount = 0;
+   while (instream.getLine(line)) {
+      linecount++;
+   }
+   return instream.getParseError();
+}
+
+string rid(const string& data, const string& options, bool stream) {
+   Tool_rid tool;
+   tool.process("rid " + options);
+   stringstream out;
+   if (stream) {
+      stringstream input(data);
+      HumdrumLineStream instream(input);
+      tool.run(instream, out);
+   } else {
+      HumdrumFile infile;
+      infile.readString(data);
+      tool.run(infile, out);
+   }
+   return out.str();
+}
+
+int main(int argc, char** argv) {
+   string data =
+      "!!!OTL: Test\n"
+      "**kern\t**kern\n"
+      "*^\t*\n"
+      "!\t!\t!\n"
+      "4c\t4e\t4G\n"
+      "=1\t=1\t=1\n"
+      "*x\t*x\t*\n"
+      "4d\t4f\t4A\n"
+      "*\t*^\t*\n"
+      "4e\t4f\t4g\t4B\n"
+      "*\t*v\t*v\t*\n"
+      "*v\t*v\t*+\n"
+      "*\t*\t**text\n"
+      "4c\t4C\tla\n"
+      "*-\t*-\t*-\n";
+   check(getStreamSpines(data) == getFileSpines(data), "*^, *x, *v and *+ manipulators");
+
+   stringstream input(data);
+   HumdrumLineStream instream(input);
+   int maxtrack = 0;
+   int count = 0;
+   string datatype;
+   check(instream.process([&](HumdrumStreamLine& line) {
+      count++;
+      maxtrack = instream.getMaxTrack();
+      if (line.getText() == "4c\t4C\tla") {
+         datatype = line.getDataType(2);
+         return false;
+      }
+      return true;
+   }), "process callback");
+   check(count == 14, "callback stops when it returns false");
+   check(maxtrack == 3, "track added by *+");
+   check(datatype == "**text", "data type of the added spine");
+
+   // Spine structure errors:
+   int linecount;
+   string error = getStreamError("**kern\t**kern\n4c\t4d\t4e\n*-\t*-\n", linecount);
+   check(error.find("line 2") != string::npos, "field count error line");
+   check(error.find("field count") != string::npos, "field count error");
+   check(linecount == 1, "reading stops at the error");
+   error = getStreamError("!! comment\n4c\n*-\n", linecount);
+   check(error.find("before exclusive") != string::npos, "data before exclusive interpretation");
+   error = getStreamError("**kern\t**kern\n*\t*x\n", linecount);
+   check(error.find("*x") != string::npos, "unpaired *x");
+   error = getStreamError("**kern\n*^\n**text\t*\n*-\t*-\n", linecount);
+   check(error.find("exclusive") != string::npos, "exclusive interpretation without *+");
+
+   // Each segment of a multi-file stream starts a new set of spines:
+   string segments =
+      "!!!!SEGMENT: a.krn\n"
+      "**kern\t**kern\n"
+      "*^\t*\n"
+      "4c\t4e\t4g\n"
+      "*v\t*v\t*\n"
+      "*-\t*-\n"
+      "!!!!SEGMENT: b.krn\n"
+      "**kern\t**kern\t**kern\n"
+      "4C\t4E\t4G\n"
+      "*-\t*-\t*-\n";
+   check(getStreamSpines(segments) ==
+         getFileSpines(segments.substr(0, segments.find("!!!!SEGMENT: b")))
+         + getFileSpines(segments.substr(segments.find("!!!!SEGMENT: b"))),
+         "spines of second segment");
+   error = getStreamError(segments, linecount);
+   check(error.empty() && (linecount == 10), "all segments read");
+
+#ifndef USING_URI
+   HumdrumLineStream webstream;
+   check(!webstream.open("humdrum://osu/classical/bach/inventions/inven01.krn"),
+         "URI needs USING_URI");
+   check(webstream.getParseError().find("humdrum://") != string::npos,
+         "URI error message");
+#endif
+
+   // rid gives the same output from a stream as from a file:
+   string options[] = { "-d", "-G", "-I", "-i", "-L -T", "-M -V", "-C", "-c" };
+   for (const string& option : options) {
+      check(rid(data, option, true) == rid(data, option, false),
+            "rid " + option + " from a stream");
+   }
+
+   return finish();
+}
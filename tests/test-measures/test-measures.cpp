@@ -0,0 +1,117 @@
+// Description: Check the measure index of HumdrumFileContent and measure
+//              extraction with myank, which seeks to measures with the index.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+string myank(const string& data, const string& options) {
+   Tool_myank tool;
+   HumdrumFile infile;
+   infile.readString(data);
+   tool.process("myank " + options);
+   stringstream out;
+   tool.run(infile, out);
+   return out.str();
+}
+
+int main(int argc, char** argv) {
+   string data =
+      "**kern\t**kern\n"
+      "*clefF4\t*clefG2\n"
+      "*k[]\t*k[]\n"
+      "*M3/4\t*M3/4\n"
+      "4c\t4e\n"
+      "=1\t=1\n"
+      "2.C\t2.g\n"
+      "=2\t=2\n"
+      "*k[b-]\t*k[b-]\n"
+      "2.F\t2.a\n"
+      "=3\t=3\n"
+      "*clefG2\t*\n"
+      "*M2/4\t*M2/4\n"
+      "2f\t2a\n"
+      "=4\t=4\n"
+      "*\t*^\n"
+      "2g\t4b-\t4d\n"
+      ".\t4cc\t4e\n"
+      "*\t*v\t*v\n"
+      "==\t==\n"
+      "*-\t*-\n";
+
+   HumdrumFile infile;
+   infile.readString(data);
+
+   check(infile.getMeasureCount() == 6, "measure count includes pickup");
+   check(infile.getMeasureInfo(0).startLine == 0, "pickup starts at line 0");
+   check(infile.getMeasureInfo(0).number == -1, "pickup is not numbered");
+
+   int index = infile.getMeasureIndexByNumber(3);
+   check(index == 3, "measure 3 found by number");
+   const HumMeasureInfo& m3 = infile.getMeasureInfo(index);
+   check(m3.startLine == 10, "measure 3 start line");
+   check(m3.stopLine == 14, "measure 3 stop line");
+   check(m3.keysig[1] && (*m3.keysig[1] == "*k[b-]"), "measure 3 key signature");
+   check(m3.clef[1] && (*m3.clef[1] == "*clefF4"), "measure 3 clef");
+   check(m3.timesig[2] && (*m3.timesig[2] == "*M3/4"), "measure 3 time signature");
+   check(infile.getMeasureIndexByNumber(7) == -1, "missing measure number");
+   check(infile.getMeasureIndexByLine(12) == 3, "measure containing line 12");
+   check(infile.getMeasureInfo(4).spines[2] == 1, "spines at start of measure 4");
+   check(infile.getMeasureInfo(-2).number == 4, "negative index from end");
+
+   // Extracting a later measure must restore the clef, key signature and
+   // meter which are active at its start.
+   string expected =
+      "**kern\t**kern\n"
+      "*clefG2\t*clefG2\n"
+      "*k[b-]\t*k[b-]\n"
+      "*M2/4\t*M2/4\n"
+      "=4\t=4\n"
+      "*\t*^\n"
+      "2g\t4b-\t4d\n"
+      ".\t4cc\t4e\n"
+      "*\t*v\t*v\n"
+      "==\t==\n"
+      "*-\t*-\n";
+   string output = myank(data, "-m 4");
+   check(output == expected, "myank -m 4");
+   if (output != expected) {
+      cout << output;
+   }
+
+   // Extracting a range must not be affected by the measures after it.
+   expected =
+      "**kern\t**kern\n"
+      "*clefF4\t*clefG2\n"
+      "*k[]\t*k[]\n"
+      "*M3/4\t*M3/4\n"
+      "=2\t=2\n"
+      "*k[b-]\t*k[b-]\n"
+      "2.F\t2.a\n"
+      "=3\t=3\n"
+      "*clefG2\t*\n"
+      "*M2/4\t*M2/4\n"
+      "2f\t2a\n"
+      "=\t=\n"
+      "*-\t*-\n";
+   output = myank(data, "-m 2-3");
+   check(output == expected, "myank -m 2-3");
+   if (output != expected) {
+      cout << output;
+   }
+
+   // The index is rebuilt after lines are added or removed:
+   infile.insertLine(0, "!! comment");
+   check(infile.getMeasureInfo(3).startLine == 11, "start line after insertLine");
+   check(infile.getMeasureIndexByLine(12) == 3, "measure of line after insertLine");
+   infile.deleteLine(0);
+   check(infile.getMeasureInfo(3).startLine == 10, "start line after deleteLine");
+
+   return finish();
+}
+
+
@@ -0,0 +1,102 @@
+// Description: Check that mei2hum places the reference records of the
+//              extMeta frames in an MEI file at the start of the Humdrum
+//              data if they have a start time of zero or less (or no start
+//              time), and at the end of the data otherwise, in the order
+//              of the frames and only once each.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+// Return a metaFrame element for a token and an optional start time.
+string frame(const string& token, const string& starttime) {
+   string output = "<metaFrame token=\"" + token + "\">";
+   if (!starttime.empty()) {
+      output += "<frameInfo><startTime float=\"" + starttime + "\"/></frameInfo>";
+   }
+   output += "</metaFrame>\n";
+   return output;
+}
+
+// Return the index of the first line which starts with the given text,
+// and count the number of lines which start with it.
+int findLine(const vector<string>& lines, const string& text, int& count) {
+   int index = -1;
+   count = 0;
+   for (int i=0; i<(int)lines.size(); i++) {
+      if (lines[i].compare(0, text.size(), text) == 0) {
+         if (index < 0) {
+            index = i;
+         }
+         count++;
+      }
+   }
+   return index;
+}
+
+int main(int argc, char** argv) {
+   string mei =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<mei xmlns=\"http://www.music-encoding.org/ns/mei\" meiversion=\"4.0.0\">\n"
+      "<meiHead><fileDesc><titleStmt><title>Test</title></titleStmt></fileDesc>\n"
+      "<extMeta><frames>\n" +
+      frame("!!!COM: Composer", "0") +
+      frame("!!!early: Negative start time", "-1") +
+      frame("!!!OTL: No start time", "") +
+      frame("!!!RDF**kern: &lt; = below", "0") +
+      frame("!!!footer1: First footer", "4") +
+      frame("", "0") +
+      frame("!!!footer2: Second footer", "4.5") +
+      "</frames></extMeta>\n"
+      "</meiHead>\n"
+      "<music><body><mdiv><score>\n"
+      "<scoreDef meter.count=\"4\" meter.unit=\"4\"><staffGrp>"
+      "<staffDef n=\"1\" lines=\"5\" clef.shape=\"G\" clef.line=\"2\"/>"
+      "</staffGrp></scoreDef>\n"
+      "<section><measure n=\"1\"><staff n=\"1\"><layer n=\"1\">"
+      "<note pname=\"c\" oct=\"4\" dur=\"1\"/>"
+      "</layer></staff></measure></section>\n"
+      "</score></mdiv></body></music></mei>\n";
+
+   Tool_mei2hum tool;
+   stringstream out;
+   check(tool.convert(out, mei.c_str()), "conversion");
+   vector<string> lines;
+   string line;
+   while (getline(out, line)) {
+      lines.push_back(line);
+   }
+
+   int count;
+   int exclusive = findLine(lines, "**kern", count);
+   int terminator = findLine(lines, "*-", count);
+   check((exclusive > 0) && (terminator > exclusive), "score data");
+
+   vector<string> header = {"!!!COM:", "!!!early:", "!!!OTL: No start", "!!!RDF**kern: <"};
+   int previous = -1;
+   bool headerQ = true;
+   bool onceQ = true;
+   for (const string& text : header) {
+      int index = findLine(lines, text, count);
+      headerQ &= (index > previous) && (index < exclusive);
+      onceQ &= count == 1;
+      previous = index;
+   }
+   check(headerQ, "header records before the data in frame order");
+   check(onceQ, "header records printed once");
+   findLine(lines, "!!!early:", count);
+   check(count == 1, "negative start time printed once");
+
+   int footer1 = findLine(lines, "!!!footer1:", count);
+   onceQ = count == 1;
+   int footer2 = findLine(lines, "!!!footer2:", count);
+   onceQ &= count == 1;
+   check((footer1 > terminator) && (footer2 > footer1), "footer records after the data in frame order");
+   check(onceQ, "footer records printed once");
+
+   return finish();
+}
@@ -0,0 +1,82 @@
+// Description: Measure the throughput of HumMidiExport for a set of
+//              Humdrum files (such as a whole corpus in a batch job).
+//              The files are parsed once, and then converted to MIDI
+//              repeatedly to report files, MIDI events and notes per second.
+// Usage:       bench-midiexport [-n repeats] file.krn [file2.krn ...]
+
+#include "humlib.h"
+#include "HumMidiExport.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+using namespace hum;
+using namespace smf;
+using namespace std;
+
+int main(int argc, char** argv) {
+   int repeats = 10;
+   int start = 1;
+   if ((argc > 2) && (strcmp(argv[1], "-n") == 0)) {
+      repeats = atoi(argv[2]);
+      start = 3;
+   }
+   if ((start >= argc) || (repeats < 1)) {
+      cerr << "Usage: " << argv[0] << " [-n repeats] file.krn [file2.krn ...]" << endl;
+      return 1;
+   }
+
+   vector<HumdrumFile*> infiles;
+   for (int i=start; i<argc; i++) {
+      HumdrumFile* infile = new HumdrumFile;
+      if (!infile->read(argv[i])) {
+         cerr << "Cannot read " << argv[i] << endl;
+         delete infile;
+         continue;
+      }
+      infiles.push_back(infile);
+   }
+   if (infiles.empty()) {
+      return 1;
+   }
+
+   long long events = 0;
+   long long notes = 0;
+   auto begin = chrono::steady_clock::now();
+   for (int r=0; r<repeats; r++) {
+      for (int i=0; i<(int)infiles.size(); i++) {
+         HumMidiExport exporter;
+         MidiFile midifile;
+         exporter.convert(*infiles[i], midifile);
+         for (int t=0; t<midifile.getTrackCount(); t++) {
+            events += midifile[t].size();
+            for (int e=0; e<midifile[t].size(); e++) {
+               if (midifile[t][e].isNoteOn()) {
+                  notes++;
+               }
+            }
+         }
+      }
+   }
+   double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+   long long files = (long long)infiles.size() * repeats;
+   cout << "files:          " << files << endl;
+   cout << "MIDI events:    " << events << endl;
+   cout << "notes:          " << notes << endl;
+   cout << "seconds:        " << seconds << endl;
+   if (seconds > 0.0) {
+      cout << "files/second:   " << files / seconds << endl;
+      cout << "events/second:  " << events / seconds << endl;
+      cout << "notes/second:   " << notes / seconds << endl;
+   }
+
+   for (int i=0; i<(int)infiles.size(); i++) {
+      delete infiles[i];
+   }
+   return 0;
+}
+
+
+
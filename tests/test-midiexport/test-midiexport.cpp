@@ -0,0 +1,94 @@
+// Description: Check the pitches and note durations created by
+//              HumMidiExport, in particular for ties, chords and tokens
+//              with ornament signifiers.
+
+#include "humlib.h"
+#include "HumMidiExport.h"
+#include "../check.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace hum;
+using namespace smf;
+using namespace std;
+
+// Return the notes in a MIDI track as "key:start-end" strings in ticks,
+// sorted by start time and then key.
+string getNotes(MidiFile& midifile, int track) {
+   midifile.linkNotePairs();
+   vector<pair<pair<int, int>, string>> notes;
+   for (int i=0; i<midifile[track].size(); i++) {
+      MidiEvent& event = midifile[track][i];
+      if (!event.isNoteOn()) {
+         continue;
+      }
+      stringstream note;
+      note << event.getKeyNumber() << ":" << event.tick << "-";
+      if (event.isLinked()) {
+         note << event.getLinkedEvent()->tick;
+      } else {
+         note << "?";
+      }
+      notes.push_back(make_pair(make_pair(event.tick, event.getKeyNumber()), note.str()));
+   }
+   sort(notes.begin(), notes.end());
+   string output;
+   for (int i=0; i<(int)notes.size(); i++) {
+      output += notes[i].second + " ";
+   }
+   return output;
+}
+
+int main(int argc, char** argv) {
+   string data =
+      "**kern\t**kern\n"
+      "*M4/4\t*M4/4\n"
+      "*MM90\t*\n"
+      "=1\t=1\n"
+      "4cR\t4r\n"             // 'R' is an ornament, not a rest
+      "4cc#T\t[4e [4g\n"      // trill, and a chord tied on both notes
+      "8B-\t4e_ 4g]\n"        // one chord note continues the tie
+      "8dd\t.\n"
+      "4qE\t.\n"              // grace note
+      "4G\t4e] 4b\n"          // end of tie, plus a new chord note
+      "==\t==\n"
+      "*-\t*-\n";
+
+   HumdrumFile infile;
+   infile.readString(data);
+
+   HumMidiExport exporter;
+   exporter.setTicksPerQuarterNote(4);
+   MidiFile midifile;
+   check(exporter.convert(infile, midifile), "conversion");
+   check(midifile.getTrackCount() == 3, "tempo track plus one track per spine");
+   check(midifile.getTicksPerQuarterNote() == 4, "ticks per quarter note");
+
+   // Grace notes are not converted, and the ornament letters do not
+   // change the pitch.
+   string notes = getNotes(midifile, 1);
+   check(notes == "60:0-4 73:4-8 58:8-10 74:10-12 55:12-16 ", "first spine notes");
+   if (notes != "60:0-4 73:4-8 58:8-10 74:10-12 55:12-16 ") {
+      cout << notes << endl;
+   }
+
+   // Tied notes are merged into one note for each key.
+   notes = getNotes(midifile, 2);
+   check(notes == "64:4-16 67:4-12 71:12-16 ", "tied chord notes");
+   if (notes != "64:4-16 67:4-12 71:12-16 ") {
+      cout << notes << endl;
+   }
+
+   bool foundTempo = false;
+   for (int i=0; i<midifile[0].size(); i++) {
+      if (midifile[0][i].isTempo()) {
+         foundTempo = (int)(midifile[0][i].getTempoBPM() + 0.5) == 90;
+      }
+   }
+   check(foundTempo, "tempo from *MM90");
+
+   return finish();
+}
+
+
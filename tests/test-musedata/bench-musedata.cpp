@@ -0,0 +1,114 @@
+// Description: Measure the time to read MuseData stage-2 parts in which
+//              each measure has several voices separated by back records
+//              (which used to make the construction of the time sequence
+//              slow).  Generated parts are used unless files are given.
+// Usage:       bench-musedata [-n repeats] [-m measures] [-q quarters] [file.msd ...]
+
+#include "humlib.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+// Return a stage-2 part with four voices of eighth notes in each measure.
+string makePart(int measures, int quarters) {
+   stringstream out;
+   out << "(C) 2026 test\n"
+       << "ID: {test/1}\n"
+       << "TIMESTAMP: OCT/19/2026\n"
+       << "\n"
+       << "Test\n"
+       << "Movement\n"
+       << "Part\n"
+       << "1 0\n"
+       << "Group memberships: score\n"
+       << "score: part 1 of 1\n"
+       << "$  K:0   Q:2   T:" << quarters << "/4   C:4\n";
+   const char* pitches[] = { "C5", "A4", "E4", "C4" };
+   int ticks = 2 * quarters;
+   for (int m=0; m<measures; m++) {
+      for (int v=0; v<4; v++) {
+         if (v > 0) {
+            out << "back " << (ticks < 100 ? " " : "") << (ticks < 10 ? " " : "") << ticks << "\n";
+         }
+         for (int k=0; k<ticks; k++) {
+            out << pitches[v] << "     1        e     " << (v < 2 ? "d" : "u") << "\n";
+         }
+      }
+      out << "measure " << (m + 2) << "\n";
+   }
+   out << "/END\n";
+   return out.str();
+}
+
+int main(int argc, char** argv) {
+   int repeats = 10;
+   int measures = 1000;
+   int quarters = 4;
+   int start = 1;
+   while ((start + 1 < argc) && (argv[start][0] == '-')) {
+      if (strcmp(argv[start], "-n") == 0) {
+         repeats = atoi(argv[start + 1]);
+      } else if (strcmp(argv[start], "-m") == 0) {
+         measures = atoi(argv[start + 1]);
+      } else if (strcmp(argv[start], "-q") == 0) {
+         quarters = atoi(argv[start + 1]);
+      } else {
+         break;
+      }
+      start += 2;
+   }
+   if ((repeats < 1) || (measures < 1) || (quarters < 1) || (quarters > 40)) {
+      cerr << "Usage: " << argv[0]
+           << " [-n repeats] [-m measures] [-q quarters] [file.msd ...]" << endl;
+      return 1;
+   }
+
+   vector<string> inputs;
+   for (int i=start; i<argc; i++) {
+      MuseData md;
+      if (!md.readFile(argv[i]) || md.hasError()) {
+         cerr << "Cannot read " << argv[i] << endl;
+         continue;
+      }
+      stringstream data;
+      for (int j=0; j<md.getLineCount(); j++) {
+         data << md.getLine(j) << "\n";
+      }
+      inputs.push_back(data.str());
+   }
+   if (start >= argc) {
+      inputs.push_back(makePart(measures, quarters));
+   }
+   if (inputs.empty()) {
+      return 1;
+   }
+
+   long long lines = 0;
+   long long events = 0;
+   auto begin = chrono::steady_clock::now();
+   for (int r=0; r<repeats; r++) {
+      for (int i=0; i<(int)inputs.size(); i++) {
+         MuseData md;
+         md.readString(inputs[i]);
+         lines += md.getLineCount();
+         events += md.getEventCount();
+      }
+   }
+   double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+   long long files = (long long)inputs.size() * repeats;
+   cout << "files:          " << files << endl;
+   cout << "lines:          " << lines << endl;
+   cout << "time events:    " << events << endl;
+   cout << "seconds:        " << seconds << endl;
+   if (seconds > 0.0) {
+      cout << "ms/file:        " << 1000.0 * seconds / files << endl;
+      cout << "lines/second:   " << lines / seconds << endl;
+   }
+   return 0;
+}
@@ -0,0 +1,129 @@
+// Description: Check the time sequence of MuseData files with back records
+//              which move to times before the last event (including times
+//              between two earlier events): the events must be sorted by
+//              time, with the records of each time in file order, and ties
+//              must be linked across the back records.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <map>
+
+using namespace hum;
+using namespace std;
+
+string header =
+   "(C) 2026 test\n"
+   "ID: {test/1}\n"
+   "TIMESTAMP: OCT/19/2026\n"
+   "\n"
+   "Test\n"
+   "Movement\n"
+   "Treble\n"
+   "1 0\n"
+   "Group memberships: score\n"
+   "score: part 1 of 1\n";
+
+// Return the line indexes of the records at each time, in file order.
+map<HumNum, vector<int>> getLinesByTime(MuseData& md) {
+   map<HumNum, vector<int>> lines;
+   for (int i=0; i<md.getLineCount(); i++) {
+      lines[md.getQStamp(i)].push_back(i);
+   }
+   return lines;
+}
+
+// Return the line indexes of the records in each event of the sequence.
+map<HumNum, vector<int>> getLinesByEvent(MuseData& md) {
+   map<HumNum, vector<int>> lines;
+   for (int i=0; i<md.getEventCount(); i++) {
+      vector<int>& list = lines[md.getEvent(i).getTime()];
+      for (int j=0; j<md.getEvent(i).getEventCount(); j++) {
+         list.push_back(md.getLineIndex(i, j));
+      }
+   }
+   return lines;
+}
+
+// Return the index of the first line which starts with the given text
+// after the given line.
+int findLine(MuseData& md, const string& text, int start = 0) {
+   for (int i=start; i<md.getLineCount(); i++) {
+      if (md.getLine(i).compare(0, text.size(), text) == 0) {
+         return i;
+      }
+   }
+   return -1;
+}
+
+int main(int argc, char** argv) {
+   // The second voice goes back to the start of the measure, the third
+   // voice goes back to the second beat and then has a note halfway
+   // between the second and third beats (a time which no earlier record
+   // has), and the fourth voice goes back to the start again.
+   string data = header +
+      "$  K:0   Q:4   T:4/4   C:4\n"
+      "C5     4        q     d\n"
+      "D5     4        q     d\n"
+      "E5     8-       h     d\n"
+      "back  16\n"
+      "C4     8        h     u\n"
+      "back   4\n"
+      "G3     2        e     u\n"
+      "A3     2        e     u\n"
+      "B3     8        h     u\n"
+      "back  16\n"
+      "F4    16        w     u\n"
+      "measure 2\n"
+      "E5    16        w     d\n"
+      "back  16\n"
+      "C4    16        w     u\n"
+      "/END\n";
+
+   MuseData md;
+   md.readString(data);
+   check(!md.hasError(), "file with back records");
+
+   bool sorted = true;
+   for (int i=1; i<md.getEventCount(); i++) {
+      if (md.getEvent(i-1).getTime() >= md.getEvent(i).getTime()) {
+         sorted = false;
+      }
+   }
+   check(sorted, "event times are sorted and unique");
+   check(getLinesByEvent(md) == getLinesByTime(md),
+         "records of each time are in file order");
+
+   int g3 = findLine(md, "G3");
+   int a3 = findLine(md, "A3");
+   int d5 = findLine(md, "D5");
+   check(md.getQStamp(g3) == 1, "G3 at the second beat");
+   check(md.getQStamp(a3) == HumNum(3, 2), "A3 between two earlier events");
+   bool order = false;
+   for (int i=0; i<md.getEventCount(); i++) {
+      if (md.getEvent(i).getTime() == 1) {
+         MuseEventSet& eventset = md.getEvent(i);
+         order = (eventset.getEventCount() >= 2) &&
+               (md.getLineIndex(i, 0) == d5) && (md.getLineIndex(i, 1) == g3);
+      }
+   }
+   check(order, "record after a back record is after earlier records of the same time");
+
+   int e5 = findLine(md, "E5");
+   int e5tied = findLine(md, "E5", e5 + 1);
+   check(md.getTiedDuration(e5) == 6, "tie across back records");
+   check(md[e5tied].getQStamp() == 4, "tied note at the next measure");
+
+   // A back record to a time before the start of the file is an error.
+   MuseData bad;
+   bad.readString(header +
+      "$  K:0   Q:4   T:4/4   C:4\n"
+      "C5     4        q     d\n"
+      "back   8\n"
+      "C4     4        q     u\n"
+      "/END\n");
+   check(bad.hasError(), "back record before the start of the file");
+   check(bad.getError().find("Funny error") != string::npos, "error message");
+
+   return finish();
+}
@@ -0,0 +1,137 @@
+// Description: Check that MuseDataSet reads the parts of a multi-part
+//              file and a list of part files in order for any thread
+//              count, and that the error of the first part in the list
+//              which cannot be read is stored in the set.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace hum;
+using namespace std;
+
+// Return a part with a whole note of the given pitch in each measure.  If
+// back is not 0, the part starts with a back record which moves before the
+// start of the part, which is a time sequence error.
+string makePart(int number, const string& pitch, int back = 0) {
+   string output =
+      "(C) 2026 test\n"
+      "ID: {test/" + to_string(number) + "}\n"
+      "TIMESTAMP: OCT/19/2026\n"
+      "\n"
+      "Test\n"
+      "Part " + to_string(number) + "\n"
+      "Treble\n"
+      "1 0\n"
+      "Group memberships: score\n"
+      "score: part " + to_string(number) + " of 8\n"
+      "$  K:0   Q:4   T:4/4   C:4\n";
+   if (back) {
+      output += "back  " + to_string(back) + "\n";
+   }
+   for (int m=1; m<=number; m++) {
+      output += pitch + "    16        w     d\n";
+      output += "measure " + to_string(m + 1) + "\n";
+   }
+   output += "/END\n";
+   return output;
+}
+
+// Return the text of all parts in the set, one line per record.
+string getText(MuseDataSet& set) {
+   string output;
+   for (int i=0; i<set.getFileCount(); i++) {
+      output += "PART " + to_string(i) + "\n";
+      for (int j=0; j<set[i].getLineCount(); j++) {
+         output += set[i].getLine(j) + "\n";
+      }
+   }
+   return output;
+}
+
+int main(int argc, char** argv) {
+   vector<string> pitches = {"C4", "D4", "E4", "F4", "G4", "A4", "B4", "C5"};
+
+   // Multiple parts in one file:
+   string data;
+   for (int i=0; i<(int)pitches.size(); i++) {
+      data += makePart(i + 1, pitches[i]) + "/eof\n";
+   }
+   MuseDataSet serial;
+   serial.readString(data);
+   check(serial.getFileCount() == (int)pitches.size(), "part count in string");
+   check(!serial.hasError(), "no error in string");
+   bool orderQ = serial.getFileCount() == (int)pitches.size();
+   for (int i=0; orderQ && (i<serial.getFileCount()); i++) {
+      orderQ = serial[i].getLine(11).compare(0, 2, pitches[i]) == 0;
+   }
+   check(orderQ, "parts of string in order");
+   for (int threads : {0, 2, 4}) {
+      MuseDataSet parallel;
+      parallel.setThreadCount(threads);
+      parallel.readString(data);
+      check(getText(parallel) == getText(serial),
+            "string with " + to_string(threads) + " threads");
+   }
+
+   // A list of part files, written to a new temporary directory:
+   char tempdir[] = "/tmp/test-musedata-XXXXXX";
+   if (!mkdtemp(tempdir)) {
+      cerr << "Cannot create temporary directory" << endl;
+      return 1;
+   }
+   vector<string> filenames;
+   for (int i=0; i<(int)pitches.size(); i++) {
+      filenames.push_back(string(tempdir) + "/part" + to_string(i + 1) + ".md");
+      ofstream(filenames.back()) << makePart(i + 1, pitches[i]) << "/eof\n";
+   }
+   MuseDataSet files;
+   check(files.readPartFiles(filenames) != 0, "read part files");
+   check(getText(files) == getText(serial), "part files in order");
+   bool filenameQ = files.getFileCount() == (int)filenames.size();
+   for (int i=0; filenameQ && (i<files.getFileCount()); i++) {
+      filenameQ = files[i].getFilename() == filenames[i];
+   }
+   check(filenameQ, "filenames of parts");
+   for (int threads : {0, 3, 8}) {
+      MuseDataSet parallel;
+      parallel.setThreadCount(threads);
+      check(parallel.readPartFiles(filenames) != 0,
+            "read part files with " + to_string(threads) + " threads");
+      check(getText(parallel) == getText(files),
+            "part files with " + to_string(threads) + " threads");
+   }
+
+   // Parts 3 and 6 cannot be read, and each has a different error.  The
+   // error of part 3 is stored in the set for any thread count, and all
+   // parts are still added to the set.
+   ofstream(filenames[2]) << makePart(3, pitches[2], 4) << "/eof\n";
+   ofstream(filenames[5]) << makePart(6, pitches[5], 8) << "/eof\n";
+   MuseData bad3;
+   MuseData bad6;
+   bad3.readFile(filenames[2]);
+   bad6.readFile(filenames[5]);
+   check(bad3.hasError() && bad6.hasError()
+         && (bad3.getError() != bad6.getError()), "two different errors");
+   for (int threads : {1, 0, 2, 8}) {
+      MuseDataSet parallel;
+      parallel.setThreadCount(threads);
+      check(parallel.readPartFiles(filenames) == 0,
+            "error status with " + to_string(threads) + " threads");
+      check(parallel.hasError() && (parallel.getError() == bad3.getError()),
+            "first error with " + to_string(threads) + " threads");
+      check(parallel.getFileCount() == (int)filenames.size(),
+            "all parts added with " + to_string(threads) + " threads");
+   }
+
+   for (int i=0; i<(int)filenames.size(); i++) {
+      remove(filenames[i].c_str());
+   }
+   rmdir(tempdir);
+   return finish();
+}
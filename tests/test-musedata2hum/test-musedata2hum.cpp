@@ -0,0 +1,54 @@
+// Description: Check that musedata2hum writes the !LO:N:vis layout line of
+//              notes whose visual type differs from their duration (this
+//              line was lost when the converted data was printed and read
+//              back in before the layout parameters were written).
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+string musedata2hum(const string& data) {
+   Tool_musedata2hum tool;
+   tool.process("musedata2hum");
+   stringstream out;
+   tool.convertString(out, data);
+   return out.str();
+}
+
+int main(int argc, char** argv) {
+   // The first note has the duration of a dotted quarter note (Q:4
+   // divisions per quarter note) but is printed as a quarter note:
+   string data =
+      "(C) 2026 test\n"
+      "ID: {test/1}\n"
+      "TIMESTAMP: OCT/19/2026\n"
+      "\n"
+      "Test\n"
+      "Movement\n"
+      "Treble\n"
+      "1 0\n"
+      "Group memberships: score\n"
+      "score: part 1 of 1\n"
+      "$  K:1   Q:4   T:4/4   C:4\n"
+      "G5     6        q     d\n"
+      "D5     2        e     d\n"
+      "E5     8        h     d\n"
+      "measure 2\n"
+      "/END\n";
+
+   string output = musedata2hum(data);
+   check(output.find("!LO:N:vis=4\n4.gg") != string::npos,
+         "layout line before the dotted note");
+   check(output.find("!LO:N:vis") == output.rfind("!LO:N:vis"),
+         "only one layout line");
+
+   HumdrumFile infile;
+   check(infile.readString(output), "output can be read");
+   check(infile.getScoreDuration() == 4, "score duration");
+
+   return finish();
+}
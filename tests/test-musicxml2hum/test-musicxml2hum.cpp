@@ -0,0 +1,93 @@
+// Description: Check that musicxml2hum gives the same output when the
+//              parts of a score are parsed in several threads (-t), and
+//              when the XML data of each measure is freed after it is
+//              converted (-l).
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+// Return a note element for the given pitch and duration in divisions
+// (one division is an eighth note).
+string note(const string& step, int octave, int duration, const string& type,
+      const string& extra = "") {
+   stringstream out;
+   out << "<note><pitch><step>" << step << "</step><octave>" << octave
+       << "</octave></pitch><duration>" << duration << "</duration>"
+       << extra << "<voice>1</voice><type>" << type << "</type></note>\n";
+   return out.str();
+}
+
+// Create a score with the given number of parts and measures.  The parts
+// have dynamics, text directions, lyrics and ties, which are attached to
+// notes in later measures.
+string createScore(int parts, int measures) {
+   const char* steps[] = { "C", "D", "E", "F", "G", "A", "B" };
+   stringstream out;
+   out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+       << "<score-partwise version=\"3.1\">\n<part-list>\n";
+   for (int p=1; p<=parts; p++) {
+      out << "<score-part id=\"P" << p << "\"><part-name>Voice " << p
+          << "</part-name></score-part>\n";
+   }
+   out << "</part-list>\n";
+   for (int p=1; p<=parts; p++) {
+      out << "<part id=\"P" << p << "\">\n";
+      for (int m=1; m<=measures; m++) {
+         out << "<measure number=\"" << m << "\">\n";
+         if (m == 1) {
+            out << "<attributes><divisions>2</divisions><key><fifths>" << p - 1
+                << "</fifths></key><time><beats>3</beats><beat-type>4</beat-type>"
+                << "</time><clef><sign>G</sign><line>2</line></clef></attributes>\n";
+         }
+         if (m % 2 == 1) {
+            out << "<direction placement=\"below\"><direction-type><dynamics><"
+                << (m % 4 == 1 ? "p" : "f") << "/></dynamics></direction-type></direction>\n";
+         }
+         if (m % 3 == 0) {
+            out << "<direction placement=\"above\"><direction-type><words>dolce"
+                << "</words></direction-type></direction>\n";
+         }
+         int octave = 3 + p % 3;
+         // The last note of each measure is tied to the first note
+         // of the next measure:
+         out << note(steps[(m + p) % 7], octave, 4, "half",
+                     string(m > 1 ? "<tie type=\"stop\"/>" : "")
+                     + "<lyric number=\"1\"><syllabic>single</syllabic>"
+                     + "<text>la</text></lyric>");
+         out << note(steps[(m + 2 * p) % 7], octave, 1, "eighth");
+         out << note(steps[(m + 1 + p) % 7], octave, 1, "eighth",
+                     m < measures ? "<tie type=\"start\"/>" : "");
+         out << "</measure>\n";
+      }
+      out << "</part>\n";
+   }
+   out << "</score-partwise>\n";
+   return out.str();
+}
+
+string musicxml2hum(const string& input, const string& options) {
+   Tool_musicxml2hum tool;
+   tool.process("musicxml2hum " + options);
+   stringstream out;
+   tool.convert(out, input.c_str());
+   return out.str();
+}
+
+int main(int argc, char** argv) {
+   string score = createScore(4, 12);
+   string output = musicxml2hum(score, "");
+   check(output.find("**kern\t**text\t**dynam\t**kern\t**text\t**dynam") != string::npos,
+         "parts are converted");
+   check(output.find("*-") != string::npos, "output is complete");
+   check(musicxml2hum(score, "-t 4") == output, "same output with four threads");
+   check(musicxml2hum(score, "-t 0") == output, "same output with all cores");
+   check(musicxml2hum(score, "-l") == output, "same output with -l");
+   check(musicxml2hum(score, "-l -t 4") == output, "same output with -l -t 4");
+
+   return finish();
+}
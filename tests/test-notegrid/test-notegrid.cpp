@@ -0,0 +1,69 @@
+// Description: Check the NoteGrid pitch and attack data, and the NoteCell
+//              constructor and setMeter() functions which access cells
+//              stored in the grid.
+
+#include "humlib.h"
+#include "../check.h"
+
+using namespace hum;
+using namespace std;
+
+int main(int argc, char** argv) {
+   string data =
+      "**kern\t**kern\n"
+      "*M3/4\t*M3/4\n"
+      "4C\t4e\n"
+      "2r\t[4f\n"
+      ".\t4f]\n"
+      "=1\t=1\n"
+      "2.G\t2.c\n"
+      "*-\t*-\n";
+
+   HumdrumFile infile;
+   infile.readString(data);
+   NoteGrid grid(infile);
+
+   check(grid.getVoiceCount() == 2, "voice count");
+   check(grid.getSliceCount() == 4, "slice count");
+   check(grid.getAbsBase40Pitch(0, 0) == Convert::kernToBase40("C"), "bass pitch");
+   check(grid.isRest(0, 1), "rest");
+   check(grid.isSustained(0, 2), "rest continuation");
+   check(grid.isAttack(1, 1), "tie start is an attack");
+   check(grid.isSustained(1, 2), "tie continuation is sustained");
+   check(grid.getSgnBase40Pitch(1, 2) == -Convert::kernToBase40("f"),
+         "sustained pitch is negative");
+   check(grid.getMeterTop(1, 3) == 3, "meter top");
+   check(grid.getMeterBottom(1, 3) == 4, "meter bottom");
+
+   // NoteCell(owner, token) is a view of the grid cell for the token:
+   hum::HTp token = infile.token(6, 1);
+   NoteCell cell(&grid, token);
+   check(cell.getToken() == token, "cell for token");
+   check(cell.getVoiceIndex() == 1, "cell voice index");
+   check(cell.getSliceIndex() == 3, "cell slice index");
+   check(cell.getAbsBase40Pitch() == grid.cell(1, 3)->getAbsBase40Pitch(),
+         "cell pitch");
+   check(cell.getPrevAttackIndex() == 1, "cell previous attack");
+
+   cell.setMeter(6, 8);
+   check(grid.cell(1, 3)->getMeterTop() == 6, "setMeter top");
+   check(grid.cell(1, 3)->getMeterBottom() == 8, "setMeter bottom");
+   check(grid.getMeterTop(0, 3) == 3, "setMeter only changes one cell");
+
+   // Tokens which are not in the grid give a detached cell:
+   NoteCell detached(&grid, infile.token(1, 0));
+   check(detached.getToken() == NULL, "detached cell has no token");
+   check(detached.isRest(), "detached cell is a rest");
+
+   // A base-40 pitch of 0 is a rest:
+   HumdrumFile infile2;
+   infile2.readString("**kern\n4CCCC--\n4CCCC-\n*-\n");
+   NoteGrid grid2(infile2);
+   check(grid2.isRest(0, 0), "base-40 pitch 0 is a rest");
+   check(grid2.getAbsBase40Pitch(0, 1) == 1, "base-40 pitch 1 is a note");
+
+   return finish();
+}
+
+
+
@@ -0,0 +1,189 @@
+// Description: Check the FFT autocorrelation of the periodicity tool (-a)
+//              and its windowed version (-w) against a direct calculation
+//              of the correlation at each lag, for random attack grids and
+//              for the attack grid of a random score.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+class TestPeriodicity : public Tool_periodicity {
+   public:
+      using Tool_periodicity::doAutocorrelation;
+      using Tool_periodicity::fillAttackGrids;
+};
+
+// Calculate the autocorrelation of count elements of the grid starting at
+// start one lag at a time, scaled so that lag 0 has a value of 1.0.
+vector<double> getAutocorrelation(const vector<double>& grid, int start,
+      int count, int maxlag) {
+   maxlag = std::min(maxlag, count - 1);
+   vector<double> output(std::max(0, maxlag + 1), 0.0);
+   for (int lag=0; lag<=maxlag; lag++) {
+      for (int i=0; i+lag<count; i++) {
+         output[lag] += grid[start + i] * grid[start + i + lag];
+      }
+   }
+   if (!output.empty() && (output[0] > 0.0)) {
+      double norm = output[0];
+      for (int lag=0; lag<=maxlag; lag++) {
+         output[lag] /= norm;
+      }
+   }
+   return output;
+}
+
+// Print the rows of an analysis in the same format as --raw.
+string getRawText(const vector<vector<double>>& analysis) {
+   stringstream out;
+   for (int i=0; i<(int)analysis.size(); i++) {
+      for (int j=0; j<(int)analysis[i].size(); j++) {
+         out << analysis[i][j];
+         if (j < (int)analysis[i].size() - 1) {
+            out << "\t";
+         }
+      }
+      out << "\n";
+   }
+   return out.str();
+}
+
+// Calculate the windowed autocorrelation with sizes given in grid units.
+// Windows start every hop elements until a window reaches the end of the
+// grid, and the last window may be shorter than the others.
+vector<vector<double>> getWindowedAutocorrelation(const vector<double>& grid,
+      int windowsize, int hop, int maxlag) {
+   vector<vector<double>> output;
+   for (int start=0; start<(int)grid.size(); start+=hop) {
+      int count = std::min(windowsize, (int)grid.size() - start);
+      output.push_back(getAutocorrelation(grid, start, count, maxlag));
+      if (start + windowsize >= (int)grid.size()) {
+         break;
+      }
+   }
+   return output;
+}
+
+string periodicity(HumdrumFile& infile, const string& options, bool& status) {
+   Tool_periodicity tool;
+   tool.process("periodicity " + options);
+   stringstream out;
+   status = tool.run(infile, out);
+   return out.str();
+}
+
+// Return a score with two voices of random eighth and sixteenth notes,
+// rests and dotted eighth notes.
+string makeScore(int measures) {
+   string output = "**kern\t**kern\n*M2/4\t*M2/4\n";
+   vector<vector<string>> voices(2);
+   for (int v=0; v<2; v++) {
+      for (int m=0; m<measures; m++) {
+         int sixteenths = 0;
+         while (sixteenths < 8) {
+            int choice = rand() % 4;
+            if ((choice == 3) && (sixteenths <= 5)) {
+               voices[v].push_back("8.c");
+               voices[v].push_back(".");
+               voices[v].push_back(".");
+               sixteenths += 3;
+            } else if ((choice == 2) && (sixteenths <= 6)) {
+               voices[v].push_back("8r");
+               voices[v].push_back(".");
+               sixteenths += 2;
+            } else if ((choice == 1) && (sixteenths <= 6)) {
+               voices[v].push_back("8e");
+               voices[v].push_back(".");
+               sixteenths += 2;
+            } else {
+               voices[v].push_back("16g");
+               sixteenths++;
+            }
+         }
+      }
+   }
+   for (int i=0; i<(int)voices[0].size(); i++) {
+      if (i % 8 == 0) {
+         output += "=\t=\n";
+      }
+      if ((voices[0][i] == ".") && (voices[1][i] == ".")) {
+         continue;
+      }
+      output += voices[0][i] + "\t" + voices[1][i] + "\n";
+   }
+   output += "==\t==\n*-\t*-\n";
+   return output;
+}
+
+int main(int argc, char** argv) {
+   srand(45);
+
+   // The FFT autocorrelation of random attack counts, including windows
+   // at an offset in the grid and lags larger than the window:
+   TestPeriodicity tool;
+   bool gridQ = true;
+   for (int test=0; (test<500) && gridQ; test++) {
+      vector<double> grid(1 + rand() % 300);
+      for (double& value : grid) {
+         value = (rand() % 3 == 0) ? rand() % 4 : 0;
+      }
+      int start = rand() % (int)grid.size();
+      int count = 1 + rand() % ((int)grid.size() - start);
+      int maxlag = rand() % (count + 10);
+      vector<double> fftoutput;
+      tool.doAutocorrelation(fftoutput, grid, start, count, maxlag);
+      gridQ = getRawText({fftoutput}) == getRawText({getAutocorrelation(grid, start, count, maxlag)});
+   }
+   check(gridQ, "random grids");
+
+   // The analysis of a score, where a quarter note is 4 grid elements:
+   HumdrumFile infile;
+   infile.readString(makeScore(24));
+   TestPeriodicity gridtool;
+   gridtool.process("periodicity");
+   vector<vector<double>> grids(infile.getTrackCount() + 1);
+   HumNum minrhy = infile.tpq() * 4;
+   gridtool.fillAttackGrids(infile, grids, minrhy);
+   vector<double>& grid = grids[0];
+   int scale = infile.tpq();
+   check(scale == 4, "sixteenth-note grid");
+   check((int)grid.size() == 24 * 8, "grid size");
+
+   bool status;
+   string whole = getRawText({getAutocorrelation(grid, 0, (int)grid.size(), (int)grid.size())});
+   check(periodicity(infile, "-a --raw", status) == whole, "whole score");
+   check(periodicity(infile, "-w 0 --raw", status) == whole, "window size 0 is the whole score");
+   check(periodicity(infile, "-a --raw --max-lag 2", status)
+         == getRawText({getAutocorrelation(grid, 0, (int)grid.size(), 2 * scale)}),
+         "whole score with maximum lag");
+
+   check(periodicity(infile, "-w 4 --raw", status)
+         == getRawText(getWindowedAutocorrelation(grid, 4 * scale, 2 * scale, 4 * scale - 1)),
+         "windows with default hop");
+   check(periodicity(infile, "-w 4 --hop 1 --max-lag 2 --raw", status)
+         == getRawText(getWindowedAutocorrelation(grid, 4 * scale, scale, 2 * scale)),
+         "windows with hop and maximum lag");
+   check(periodicity(infile, "-w 5 --hop 3 --raw", status)
+         == getRawText(getWindowedAutocorrelation(grid, 5 * scale, 3 * scale, 5 * scale - 1)),
+         "windows with a short last window");
+   check(periodicity(infile, "-w 100 --raw", status)
+         == getRawText(getWindowedAutocorrelation(grid, 100 * scale, 50 * scale, 100 * scale - 1)),
+         "window larger than the score");
+
+   for (string option : {"-w -1", "-a --hop -1", "-a --max-lag -2"}) {
+      Tool_periodicity errortool;
+      errortool.process("periodicity --raw " + option);
+      stringstream out;
+      status = errortool.run(infile, out);
+      check(!status && (errortool.getError().find("negative") != string::npos),
+            "error for " + option);
+   }
+
+   return finish();
+}
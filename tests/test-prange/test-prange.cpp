@@ -0,0 +1,86 @@
+// Description: Check the aggregate mode of prange (-g), which combines the
+//              pitch counts of several input files, both for all voices
+//              and for each voice by instrument name.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace hum;
+using namespace std;
+
+string prange(const string& options) {
+   Tool_prange tool;
+   tool.process("prangex " + options);
+   HumdrumFileStream instream(static_cast<Options&>(tool));
+   tool.run(instream);
+   stringstream out;
+   tool.getAllText(out);
+   return out.str();
+}
+
+// Return the line of a table which starts with the given text.
+string getRow(const string& table, const string& start) {
+   stringstream input(table);
+   string line;
+   while (getline(input, line)) {
+      if (line.compare(0, start.size(), start) == 0) {
+         return line;
+      }
+   }
+   return "";
+}
+
+int main(int argc, char** argv) {
+   // The input files are written to a new temporary directory:
+   char tempdir[] = "/tmp/test-prange-XXXXXX";
+   if (!mkdtemp(tempdir)) {
+      cerr << "Cannot create temporary directory" << endl;
+      return 1;
+   }
+   string file1 = string(tempdir) + "/test-prange-1.krn";
+   string file2 = string(tempdir) + "/test-prange-2.krn";
+   ofstream(file1) <<
+      "**kern\t**kern\t**kern\n"
+      "*I\"Bass\t*I\"Tenor\t*\n"
+      "4C\t4c\t4g\n"
+      "4D\t4e\t4a\n"
+      "*-\t*-\t*-\n";
+   ofstream(file2) <<
+      "**kern\t**kern\n"
+      "*I\"Tenor\t*I\"Bass\n"
+      "2B\t2GG\n"
+      "*-\t*-\n";
+
+   string output = prange("-g " + file1 + " " + file2);
+   check(getRow(output, "**voice\t**count") != "", "voice table");
+   check(getRow(output, "Bass\t3\tGG\tD\t") != "", "Bass voice of both files");
+   check(getRow(output, "Tenor\t3\tB\te\t") != "", "Tenor voice of both files");
+   check(getRow(output, ".\t2\tg\ta\t") != "", "unnamed voice");
+   check(getRow(output, "**keyno\t**kern\t**count") != "", "analysis of all voices");
+
+   output = prange("-g --per-file " + file1 + " " + file2);
+   check(getRow(output, file1 + "\t6\tC\ta\t") != "", "first file row");
+   check(getRow(output, file2 + "\t2\tGG\tB\t") != "", "second file row");
+
+   check(prange("-g --threads 2 " + file1 + " " + file2)
+         == prange("-g --threads 1 " + file1 + " " + file2),
+         "same output for any thread count");
+
+   check(prange("-g -p 50 " + file1 + " " + file2).find("**voice") == string::npos,
+         "no voice table for percentile");
+
+   remove(file1.c_str());
+   remove(file2.c_str());
+   rmdir(tempdir);
+   return finish();
+}
+
+
+
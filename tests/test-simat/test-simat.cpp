@@ -0,0 +1,138 @@
+// Description: Check the measure similarity matrix of simat, which is
+//              calculated in blocks of rows (in several threads), against
+//              the correlation of each pair of measures calculated with
+//              MeasureComparison, and check the band (-b) and top (-k)
+//              modes against the full matrix.
+
+#include "humlib.h"
+#include "../check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using namespace hum;
+using namespace std;
+
+// Create a score with the given number of 4/4 measures with random
+// pitches.  Every tenth measure only contains a rest.
+string createScore(int measures) {
+   const char* pitches[] = { "c", "d", "e", "f", "g", "a", "b", "cc", "B", "A" };
+   unsigned int seed = 12345;
+   stringstream out;
+   out << "**kern\n*M4/4\n";
+   for (int m=1; m<=measures; m++) {
+      out << "=" << m << "\n";
+      if (m % 10 == 0) {
+         out << "1r\n";
+         continue;
+      }
+      for (int i=0; i<4; i++) {
+         seed = seed * 1103515245 + 12345;
+         out << "4" << pitches[(seed >> 16) % 10] << "\n";
+      }
+   }
+   out << "==\n*-\n";
+   return out.str();
+}
+
+void analyze(MeasureComparisonGrid& grid, MeasureDataSet& measures,
+      int threads, int band = -1, int top = 0) {
+   grid.setThreadCount(threads);
+   grid.setBand(band);
+   grid.setTopCount(top);
+   grid.analyze(measures, measures);
+}
+
+int main(int argc, char** argv) {
+   HumdrumFile infile;
+   infile.readString(createScore(150));
+   MeasureDataSet measures(infile);
+   int count = measures.size();
+   // The lines before the first and after the last barline are also
+   // stored as measures:
+   check(count == 152, "measure count");
+
+   // The full matrix (three blocks of rows) against each pair of measures:
+   MeasureComparisonGrid dense;
+   analyze(dense, measures, 1);
+   bool same = (dense.getRowCount() == count) && (dense.getColumnCount() == count);
+   for (int i=0; same && (i<count); i++) {
+      for (int j=0; j<count; j++) {
+         MeasureComparison pair(measures[i], measures[j]);
+         if (fabs(pair.getCorrelation7pc() - dense.getCorrelation7pc(i, j)) > 1e-9) {
+            cout << "Measures " << i << " and " << j << ": "
+                 << pair.getCorrelation7pc() << " "
+                 << dense.getCorrelation7pc(i, j) << endl;
+            same = false;
+            break;
+         }
+      }
+   }
+   check(same, "full matrix matches pairwise correlations");
+
+   // Any thread count gives the same matrix:
+   MeasureComparisonGrid threaded;
+   analyze(threaded, measures, 4);
+   same = true;
+   for (int i=0; same && (i<count); i++) {
+      for (int j=0; j<count; j++) {
+         if (threaded.getCorrelation7pc(i, j) != dense.getCorrelation7pc(i, j)) {
+            same = false;
+            break;
+         }
+      }
+   }
+   check(same, "same matrix with four threads");
+
+   // -b: only the cells within the band are calculated:
+   MeasureComparisonGrid banded;
+   analyze(banded, measures, 4, 5);
+   same = true;
+   for (int i=0; same && (i<count); i++) {
+      for (int j=0; j<count; j++) {
+         bool inband = abs(i - j) <= 5;
+         if (banded.isCalculated(i, j) != inband) {
+            same = false;
+         } else if (inband && (banded.getCorrelation7pc(i, j) != dense.getCorrelation7pc(i, j))) {
+            same = false;
+         }
+      }
+   }
+   check(same, "band matches full matrix");
+
+   // -k: the most similar measures of each row (ties go to the lower
+   // column), within the band if one is given:
+   for (int band : { -1, 20 }) {
+      MeasureComparisonGrid topgrid;
+      analyze(topgrid, measures, 4, band, 3);
+      same = true;
+      for (int i=0; same && (i<count); i++) {
+         vector<pair<double, int>> row;
+         for (int j=0; j<count; j++) {
+            if ((band < 0) || (abs(i - j) <= band)) {
+               row.emplace_back(-dense.getCorrelation7pc(i, j), j);
+            }
+         }
+         sort(row.begin(), row.end());
+         int found = 0;
+         for (int j=0; j<count; j++) {
+            if (topgrid.isCalculated(i, j)) {
+               found++;
+            }
+         }
+         if (found != 3) {
+            same = false;
+         }
+         for (int k=0; k<3; k++) {
+            int j = row[k].second;
+            if (topgrid.getCorrelation7pc(i, j) != dense.getCorrelation7pc(i, j)) {
+               same = false;
+            }
+         }
+      }
+      check(same, band < 0 ? "top matches full matrix" : "top within band matches full matrix");
+   }
+
+   return finish();
+}